@@ -0,0 +1,304 @@
+/** @file
+ * Generator wejść do testów wydajności programu phone_forward.
+ * Wypisuje na standardowe wyjście polecenia programu tworzące przypadki
+ * pesymistyczne dla struktur przechowujących przekierowania.
+ * Użycie: bench_gen RODZAJ N
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Liczba zapytań powtarzanych na końcu wejścia.
+ */
+#define BENCH_QUERIES 3
+
+/**
+ * @brief Mnożnik liczby przekierowań w przypadku fanin.
+ */
+#define BENCH_FANIN_FACTOR 10
+
+/**
+ * @brief Mnożnik liczby rund w przypadku churn.
+ */
+#define BENCH_CHURN_FACTOR 5
+
+/**
+ * @brief Liczba rund dodawania i usuwania w przypadku targetchurn.
+ */
+#define BENCH_TARGET_CHURN_ROUNDS 10000
+
+/**
+ * @brief Liczba przekierowań w przypadku long.
+ */
+#define BENCH_LONG_RULES 20
+
+/**
+ * @brief Mnożnik długości numerów w przypadku long.
+ */
+#define BENCH_LONG_FACTOR 50
+
+/**
+ * @brief Liczba przekierowań na prefiksy numeru w przypadkach reverse.
+ */
+#define BENCH_REVERSE_RULES 2000
+
+/**
+ * @brief Rozmiar bufora na przekierowywany numer w przypadkach reverse.
+ */
+#define BENCH_REVERSE_SOURCE 32
+
+/**
+ * @brief Dzielnik długości numeru dający największą długość
+ * prefiksu, na który jest przekierowanie, w przypadkach reverse.
+ */
+#define BENCH_REVERSE_DEPTH_DIVISOR 50
+
+/**
+ * @brief Stan generatora liczb pseudolosowych.
+ */
+static unsigned long long benchSeed = 1;
+
+/**
+ * @brief Losuje cyfrę.
+ * @return Znak cyfry od '0' do '9'.
+ */
+static char benchRandomDigit() {
+    benchSeed = benchSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (char) ('0' + (benchSeed >> 33) % 10);
+}
+
+/**
+ * @brief Tworzy napis złożony z losowych cyfr.
+ * @remarks Wynik musi zostać zwolniony przy pomocy free.
+ * @param[in] length - długość napisu.
+ * @return Wskaźnik na napis lub NULL w przypadku problemów z pamięcią.
+ */
+static char *benchRandomNumber(size_t length) {
+    char *num = malloc(length + 1);
+    if (num == NULL) {
+        return NULL;
+    }
+    size_t i;
+    for (i = 0; i < length; i++) {
+        num[i] = benchRandomDigit();
+    }
+    num[length] = '\0';
+    return num;
+}
+
+/**
+ * @brief Wypisuje łańcuch przekierowań wszystkich prefiksów jednego numeru.
+ * Ścieżka w drzewie ma długość @p n, a każdy jej węzeł przechowuje
+ * przekierowanie.
+ * @param[in] n - długość numeru.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool benchChain(size_t n) {
+    char *num = malloc(n + 2);
+    if (num == NULL) {
+        return false;
+    }
+    memset(num, '7', n);
+    num[n] = '\0';
+
+    size_t i;
+    for (i = 1; i <= n; i++) {
+        printf("%.*s>9\n", (int) i, num);
+    }
+    num[n] = '1';
+    num[n + 1] = '\0';
+    for (i = 0; i < BENCH_QUERIES; i++) {
+        printf("? 9\n%s ?\n", num);
+    }
+    free(num);
+    return true;
+}
+
+/**
+ * @brief Wypisuje wiele przekierowań na jeden numer.
+ * @param[in] n - liczba przekierowań to @p n * BENCH_FANIN_FACTOR.
+ * @return true
+ */
+static bool benchFanIn(size_t n) {
+    size_t i;
+    for (i = 0; i < n * BENCH_FANIN_FACTOR; i++) {
+        printf("%zu5>42\n", i);
+    }
+    for (i = 0; i < BENCH_QUERIES; i++) {
+        printf("? 42\n");
+    }
+    printf("@ 4200000000000000\n");
+    return true;
+}
+
+/**
+ * @brief Wypisuje dodawanie i usuwanie przekierowań o wspólnym prefiksie.
+ * W każdej rundzie powstaje nowe rozgałęzienie, które zaraz jest usuwane.
+ * @param[in] n - liczba rund to @p n * BENCH_CHURN_FACTOR.
+ * @return true
+ */
+static bool benchChurn(size_t n) {
+    size_t i;
+    for (i = 0; i < n * BENCH_CHURN_FACTOR; i++) {
+        printf("55%zu0>1\n55%zu1>1\nDEL 55%zu0\nDEL 55%zu1\n", i, i, i, i);
+    }
+    printf("559 ?\n");
+    return true;
+}
+
+/**
+ * @brief Wypisuje dodawanie i usuwanie przekierowania na numer, którego
+ * prefiksem jest wiele celów innych przekierowań.
+ * Najpierw dodaje @p n przekierowań na numery z prefiksem 1, a potem
+ * w każdej rundzie dodaje i usuwa przekierowanie na 1 i pyta o przeciwobraz
+ * jednego z celów. Czas rundy nie powinien zależeć od @p n.
+ * @param[in] n - liczba celów z prefiksem 1.
+ * @return true
+ */
+static bool benchTargetChurn(size_t n) {
+    size_t i;
+    for (i = 0; i < n; i++) {
+        printf("9%zu>1%zu5\n", i, i);
+    }
+    for (i = 0; i < BENCH_TARGET_CHURN_ROUNDS; i++) {
+        printf("55>1\nDEL 55\n? 1%zu5\n", i * (n / BENCH_TARGET_CHURN_ROUNDS));
+    }
+    return true;
+}
+
+/**
+ * @brief Wypisuje przekierowania i zapytania o bardzo długich numerach.
+ * @param[in] n - długość numerów to @p n * BENCH_LONG_FACTOR.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool benchLong(size_t n) {
+    size_t length = n * BENCH_LONG_FACTOR;
+    size_t i;
+    for (i = 0; i < BENCH_LONG_RULES; i++) {
+        char *num1 = benchRandomNumber(length);
+        char *num2 = benchRandomNumber(length);
+        if (num1 == NULL || num2 == NULL) {
+            free(num1);
+            free(num2);
+            return false;
+        }
+        printf("%s>%s\n%s ?\n? %s\nDEL %.*s\n", num1, num2, num1, num2,
+               (int) (length / 2), num1);
+        free(num1);
+        free(num2);
+    }
+    return true;
+}
+
+/**
+ * @brief Wypisuje przekierowania na krótkie prefiksy jednego długiego numeru
+ * i zapytanie o przeciwobraz tego numeru.
+ * Wyniki mają długość rzędu @p n i współdzielą długie sufiksy numeru,
+ * więc ich sortowanie porównuje długie wspólne fragmenty.
+ * @param[in] n - długość numeru.
+ * @param[in] zeros - czy numer składa się z samych zer.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool benchReverse(size_t n, bool zeros) {
+    char *num = benchRandomNumber(n);
+    if (num == NULL) {
+        return false;
+    }
+    if (zeros) {
+        memset(num, '0', n);
+    }
+
+    size_t maxDepth = n / BENCH_REVERSE_DEPTH_DIVISOR + 1;
+    size_t i;
+    for (i = 0; i < BENCH_REVERSE_RULES; i++) {
+        size_t depth = 1 + i * maxDepth / BENCH_REVERSE_RULES;
+        char source[BENCH_REVERSE_SOURCE];
+        int length = sprintf(source, "%zu", BENCH_REVERSE_RULES + i);
+        if ((size_t) length != depth || strncmp(source, num, depth) != 0) {
+            printf("%s>%.*s\n", source, (int) depth, num);
+        }
+    }
+    printf("? %s\n", num);
+    free(num);
+    return true;
+}
+
+/**
+ * @brief Wypisuje przypadek reverse dla losowego numeru.
+ * @param[in] n - długość numeru.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool benchReverseRandom(size_t n) {
+    return benchReverse(n, false);
+}
+
+/**
+ * @brief Wypisuje przypadek reverse dla numeru złożonego z samych zer.
+ * @param[in] n - długość numeru.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool benchReverseZeros(size_t n) {
+    return benchReverse(n, true);
+}
+
+/**
+ * @brief Rodzaj generowanego wejścia.
+ */
+struct BenchKind {
+    /**
+     * @brief Nazwa rodzaju podawana w wierszu poleceń.
+     */
+    const char *name;
+
+    /**
+     * @brief Funkcja wypisująca polecenia.
+     */
+    bool (*generate)(size_t n);
+};
+
+/**
+ * @brief Dostępne rodzaje wejść.
+ */
+static const struct BenchKind benchKinds[] = {
+        {"chain", benchChain},
+        {"fanin", benchFanIn},
+        {"churn", benchChurn},
+        {"targetchurn", benchTargetChurn},
+        {"long",  benchLong},
+        {"reverse", benchReverseRandom},
+        {"reversezero", benchReverseZeros},
+};
+
+/**
+ * @brief Wypisuje polecenia wybranego rodzaju.
+ * @param[in] argc - liczba argumentów.
+ * @param[in] argv - argumenty: rodzaj i rozmiar wejścia.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main(int argc, char *argv[]) {
+    char *end = NULL;
+    size_t n = argc == 3 ? strtoul(argv[2], &end, 10) : 0;
+    if (argc != 3 || *end != '\0' || n == 0) {
+        fprintf(stderr, "Usage: %s <kind> <n>\n", argv[0]);
+        return 1;
+    }
+
+    size_t i;
+    for (i = 0; i < sizeof(benchKinds) / sizeof(benchKinds[0]); i++) {
+        if (strcmp(argv[1], benchKinds[i].name) == 0) {
+            printf("NEW bench\n");
+            bool success = benchKinds[i].generate(n);
+            return success && fflush(stdout) == 0 ? 0 : 1;
+        }
+    }
+
+    fprintf(stderr, "Unknown kind %s\n", argv[1]);
+    return 1;
+}
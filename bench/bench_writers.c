@@ -0,0 +1,224 @@
+/** @file
+ * Test wydajności równoległych zapisów do struktury przekierowań.
+ * Każdy wątek piszący dodaje i usuwa przekierowania numerów o własnej
+ * pierwszej cyfrze, więc wątki korzystają z rozłącznych pasów blokad.
+ * Co pewien czas wątek dodaje przekierowanie na numer o innej pierwszej
+ * cyfrze, które blokuje dwa pasy naraz. Ta sama praca jest wykonywana
+ * najpierw przez jeden wątek, a potem przez wiele wątków, po czym
+ * sprawdzane są wyniki.
+ * Użycie: bench_writers WĄTKI N
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "phone_forward.h"
+
+/**
+ * @brief Największa liczba wątków piszących (po jednym na cyfrę).
+ */
+#define BENCH_WRITERS_MAX_THREADS 10
+
+/**
+ * @brief Co który numer jest przekierowany do pasa innego wątku.
+ */
+#define BENCH_WRITERS_CROSS_PERIOD 16
+
+/**
+ * @brief Co który numer jest usuwany zaraz po dodaniu.
+ */
+#define BENCH_WRITERS_REMOVE_PERIOD 4
+
+/**
+ * @brief Liczba cyfr numeru przekierowania po pierwszej cyfrze.
+ */
+#define BENCH_WRITERS_WIDTH 12
+
+/**
+ * @brief Rozmiar bufora na numer.
+ */
+#define BENCH_WRITERS_NUMBER 32
+
+/**
+ * @brief Praca jednego wątku piszącego.
+ */
+struct BenchWriter {
+    /**
+     * @brief Wskaźnik na strukturę przechowującą przekierowania.
+     */
+    struct PhoneForward *pf;
+
+    /**
+     * @brief Pierwsza cyfra numerów przekierowywanych przez wątek.
+     */
+    size_t digit;
+
+    /**
+     * @brief Liczba przekierowań dodawanych przez wątek.
+     */
+    size_t n;
+
+    /**
+     * @brief Czy wszystkie operacje się powiodły.
+     */
+    bool success;
+};
+
+/**
+ * @brief Wyznacza przekierowanie i-tego numeru wątku.
+ * @param[out] num1 - bufor na numer przekierowywany.
+ * @param[out] num2 - bufor na numer, na który jest przekierowanie.
+ * @param[in] digit - pierwsza cyfra numerów wątku.
+ * @param[in] i - numer przekierowania.
+ */
+static void benchWritersRule(char *num1, char *num2, size_t digit, size_t i) {
+    size_t target = i % BENCH_WRITERS_CROSS_PERIOD == 0
+                    ? (digit + 1) % BENCH_WRITERS_MAX_THREADS : digit;
+    sprintf(num1, "%zu%0*zu", digit, BENCH_WRITERS_WIDTH, i);
+    sprintf(num2, "%zu9%0*zu", target, BENCH_WRITERS_WIDTH, i);
+}
+
+/**
+ * @brief Czy i-te przekierowanie wątku jest usuwane zaraz po dodaniu.
+ * @param[in] i - numer przekierowania.
+ * @return Wartość @p true, jeśli przekierowanie jest usuwane.
+ */
+static bool benchWritersRemoved(size_t i) {
+    return i % BENCH_WRITERS_REMOVE_PERIOD == BENCH_WRITERS_REMOVE_PERIOD - 1;
+}
+
+/**
+ * @brief Wykonuje pracę wątku piszącego.
+ * Numery mają stałą długość, więc usunięcie jednego z nich nie usuwa
+ * przekierowań innych numerów.
+ * @param[in, out] arg - wskaźnik na strukturę BenchWriter.
+ * @return NULL
+ */
+static void *benchWritersRun(void *arg) {
+    struct BenchWriter *writer = arg;
+    char num1[BENCH_WRITERS_NUMBER];
+    char num2[BENCH_WRITERS_NUMBER];
+    size_t i;
+    for (i = 0; i < writer->n; i++) {
+        benchWritersRule(num1, num2, writer->digit, i);
+        if (!phfwdAdd(writer->pf, num1, num2)) {
+            writer->success = false;
+        }
+        if (benchWritersRemoved(i)) {
+            phfwdRemove(writer->pf, num1);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Sprawdza przekierowania dodane przez wątek.
+ * @param[in] writer - wskaźnik na pracę wątku.
+ * @return Wartość @p true, jeśli każdy numer jest przekierowany zgodnie
+ *         z ostatnią operacją na nim.
+ */
+static bool benchWritersCheck(const struct BenchWriter *writer) {
+    char num1[BENCH_WRITERS_NUMBER];
+    char num2[BENCH_WRITERS_NUMBER];
+    size_t i;
+    for (i = 0; i < writer->n; i++) {
+        benchWritersRule(num1, num2, writer->digit, i);
+        const struct PhoneNumbers *pnum = phfwdGet(writer->pf, num1);
+        const char *result = phnumGet(pnum, 0);
+        const char *expected = benchWritersRemoved(i) ? num1 : num2;
+        bool correct = result != NULL && strcmp(result, expected) == 0;
+        phnumDelete(pnum);
+        if (!correct) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Wykonuje pracę wszystkich wątków i mierzy jej czas.
+ * @param[in] threads - liczba wątków piszących.
+ * @param[in] n - liczba przekierowań dodawanych przez każdy wątek.
+ * @param[in] parallel - czy praca jest wykonywana równolegle.
+ * @param[out] seconds - czas wykonania pracy w sekundach.
+ * @return Wartość @p true w przypadku sukcesu i poprawnych wyników.
+ */
+static bool benchWritersMeasure(size_t threads, size_t n, bool parallel,
+                                double *seconds) {
+    struct PhoneForward *pf = phfwdNew();
+    if (pf == NULL) {
+        return false;
+    }
+    struct BenchWriter writers[BENCH_WRITERS_MAX_THREADS];
+    pthread_t ids[BENCH_WRITERS_MAX_THREADS];
+    size_t started = 0;
+    size_t i;
+    for (i = 0; i < threads; i++) {
+        writers[i] = (struct BenchWriter) {pf, i, n, true};
+    }
+
+    struct timespec begin, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    bool success = true;
+    for (i = 0; i < threads; i++) {
+        if (!parallel) {
+            benchWritersRun(&writers[i]);
+        } else if (pthread_create(&ids[i], NULL, benchWritersRun,
+                                  &writers[i]) == 0) {
+            started++;
+        } else {
+            success = false;
+        }
+    }
+    for (i = 0; i < started; i++) {
+        pthread_join(ids[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    *seconds = (double) (end.tv_sec - begin.tv_sec)
+               + (double) (end.tv_nsec - begin.tv_nsec) / 1e9;
+
+    for (i = 0; i < threads && success; i++) {
+        success = writers[i].success && benchWritersCheck(&writers[i]);
+    }
+    phfwdDelete(pf);
+    return success;
+}
+
+/**
+ * @brief Mierzy czas pracy jednego i wielu wątków piszących.
+ * @param[in] argc - liczba argumentów.
+ * @param[in] argv - argumenty: liczba wątków i liczba przekierowań
+ *        dodawanych przez każdy wątek.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main(int argc, char *argv[]) {
+    char *end1 = NULL, *end2 = NULL;
+    size_t threads = argc == 3 ? strtoul(argv[1], &end1, 10) : 0;
+    size_t n = argc == 3 ? strtoul(argv[2], &end2, 10) : 0;
+    if (argc != 3 || *end1 != '\0' || *end2 != '\0' || threads == 0
+        || threads > BENCH_WRITERS_MAX_THREADS || n == 0) {
+        fprintf(stderr, "Usage: %s <threads 1-%d> <n>\n", argv[0],
+                BENCH_WRITERS_MAX_THREADS);
+        return 1;
+    }
+
+    double sequential, parallel;
+    if (!benchWritersMeasure(threads, n, false, &sequential)
+        || !benchWritersMeasure(threads, n, true, &parallel)) {
+        fprintf(stderr, "Writers benchmark failed\n");
+        return 1;
+    }
+    printf("%-20s %8.3f s\n", "writers 1", sequential);
+    printf("writers %-12zu %8.3f s\n", threads, parallel);
+    return 0;
+}
@@ -0,0 +1,44 @@
+#!/bin/bash
+
+#Uruchamia testy wydajności programu phone_forward na wejściach
+#z generatora bench_gen i wypisuje czas działania dla każdego z nich.
+#Podwojenie rozmiaru wejścia powinno co najwyżej w przybliżeniu
+#podwajać czas, o ile przypadek nie jest z natury kwadratowy
+#(na przykład łańcuch n przekierowań o łącznej długości O(n^2)).
+#Użycie: run.sh <program> <bench_gen>
+
+if [ "$#" != "2" ]
+then
+	echo 'Zła liczba argumentów oczekiwano <program> <bench_gen>'
+	exit 1
+fi
+
+PROGRAM_PATH=$1
+GENERATOR_PATH=$2
+
+CASES=(
+	'chain 2000' 'chain 4000'
+	'fanin 20000' 'fanin 40000'
+	'churn 20000' 'churn 40000'
+	'targetchurn 100000' 'targetchurn 200000'
+	'long 2000' 'long 4000'
+	'reverse 50000' 'reverse 100000'
+	'reversezero 50000' 'reversezero 100000'
+)
+
+TMP_INPUT=$(mktemp) || { echo 'Nie udało się stworzyć pliku tymczasowego.'; exit 1; }
+trap "rm -f $TMP_INPUT" EXIT
+
+TIMEFORMAT='%R'
+for c in "${CASES[@]}"
+do
+	"$GENERATOR_PATH" $c > $TMP_INPUT || exit 1
+	seconds=$( { time "$PROGRAM_PATH" < $TMP_INPUT > /dev/null 2>&1; } 2>&1 )
+	exitCode=$?
+	if [ "$exitCode" != "0" ]
+	then
+		echo "$c: program zakończony kodem $exitCode"
+		exit 1
+	fi
+	printf '%-20s %8s s\n' "$c" "$seconds"
+done
@@ -357,6 +357,18 @@ size_t charSequenceLength(CharSequence sequence) {
     return result;
 }
 
+size_t charSequenceBlocksTo(CharSequence sequence, CharSequenceIterator *it) {
+    size_t result = 0;
+    CharSequence ptr;
+    for (ptr = sequence; ptr != NULL; ptr = ptr->next) {
+        result++;
+        if (!it->isEnd && ptr == it->sequenceBlockPtr) {
+            break;
+        }
+    }
+    return result;
+}
+
 size_t charSequenceLengthLimited(CharSequence sequence, size_t limit,
                                  bool *greater) {
 
@@ -423,6 +435,15 @@ char charSequenceGetChar(CharSequenceIterator *it) {
     return charSequenceIteratorGetChar(it);
 }
 
+size_t charSequenceDigitMask(CharSequence sequence) {
+    size_t result = 0;
+    CharSequence ptr;
+    for (ptr = sequence; ptr != NULL; ptr = ptr->next) {
+        result |= ptr->availableDigits;
+    }
+    return result;
+}
+
 bool charSequenceCheckDigits(CharSequence sequence, const bool *digits) {
     CharSequence ptr = sequence;
     size_t i;
@@ -67,7 +67,13 @@ bool charSequenceIteratorsEqual(CharSequenceIterator *a,
 /**
  * @brief Łączy ciągi.
  * Poszerza ciąg @p a o ciąg @p b,
- * ciąg @p b przestaje istnieć.
+ * ciąg @p b przestaje istnieć. Ostatni blok @p a jest łączony z pierwszym
+ * blokiem @p b, jeżeli mieszczą się razem w jednym bloku, dzięki czemu
+ * każde dwa sąsiednie bloki mają razem co najmniej tyle znaków, ile
+ * mieści blok, a liczba bloków jest proporcjonalna do długości ciągu
+ * niezależnie od liczby scaleń i rozcięć.
+ * #### Złożoność
+ * Proporcjonalna do liczby bloków @p a i rozmiaru bloku.
  * @param[in, out] a - wskaźnik na ciąg, aktualny po operacji.
  * @param[in, out] b - wskaźnik na ciąg, nieaktualny po operacji.
  */
@@ -81,6 +87,8 @@ void charSequenceMerge(CharSequence a, CharSequence b);
  * @return Wskaźnik na ciąg [it; ..],
  *         w przypadku problemów z pamięcią NULL.
  * @remarks Zakłada, że punkt przecięcia generuje dwa niepuste ciągi.
+ * #### Złożoność
+ * Proporcjonalna do liczby bloków przed @p it i rozmiaru bloku.
  */
 CharSequence charSequenceSplitByIterator(CharSequence sequence,
                                          CharSequenceIterator *it);
@@ -125,6 +133,15 @@ bool charSequenceNextChar(CharSequenceIterator *it, char *ch);
  */
 size_t charSequenceLength(CharSequence sequence);
 
+/**
+ * @brief Liczba bloków ciągu przeglądanych od początku do pozycji @p it.
+ * @param[in] sequence - wskaźnik na ciąg znaków.
+ * @param[in] it - wskaźnik na pozycję w ciągu @p sequence.
+ * @return Liczba bloków od pierwszego do zawierającego pozycję @p it
+ *         włącznie, wszystkie bloki, jeżeli @p it wskazuje na koniec ciągu.
+ */
+size_t charSequenceBlocksTo(CharSequence sequence, CharSequenceIterator *it);
+
 
 /**
  * @brief Liczba elementów w ciągu @p sequence.
@@ -172,5 +189,13 @@ CharSequenceIterator charSequenceSequenceEnd(CharSequence sequence);
  */
 bool charSequenceCheckDigits(CharSequence sequence, const bool *digits);
 
+/**
+ * @brief Zwraca maskę cyfr występujących w @p sequence.
+ * @param[in] sequence - wskaźnik na ciąg znaków.
+ * @return Maska bitowa, w której bit i jest ustawiony, jeżeli cyfra
+ *         o numerze i (kod_ascii - '0') występuje w @p sequence.
+ */
+size_t charSequenceDigitMask(CharSequence sequence);
+
 
 #endif //TELEFONY_CHAR_SEQUENCE_H
@@ -0,0 +1,244 @@
+/** @file
+ * Implementacja modułu skompilowanych skryptów.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <ctype.h>
+#include <string.h>
+
+#include "compiled_script.h"
+#include "character.h"
+
+/**
+ * @brief Liczba bitów liczby zapisywanych w jednym bajcie.
+ */
+#define COMPILED_SCRIPT_VARINT_BITS 7
+
+/**
+ * @brief Bit oznaczający, że liczba jest kontynuowana w następnym bajcie.
+ */
+#define COMPILED_SCRIPT_VARINT_CONTINUE 0x80
+
+/**
+ * @brief Maska bitów jednej cyfry.
+ */
+#define COMPILED_SCRIPT_NIBBLE_MASK 0x0F
+
+bool compiledScriptWriteVarint(FILE *out, size_t value) {
+    while (value >= COMPILED_SCRIPT_VARINT_CONTINUE) {
+        if (putc((int) ((value & (COMPILED_SCRIPT_VARINT_CONTINUE - 1))
+                        | COMPILED_SCRIPT_VARINT_CONTINUE), out) == EOF) {
+            return false;
+        }
+        value >>= COMPILED_SCRIPT_VARINT_BITS;
+    }
+    return putc((int) value, out) != EOF;
+}
+
+bool compiledScriptReadVarint(FILE *in, size_t *value) {
+    size_t shift = 0;
+    *value = 0;
+    while (shift < sizeof(size_t) * 8) {
+        int byte = getc(in);
+        if (byte == EOF) {
+            return false;
+        }
+        *value |= ((size_t) byte & (COMPILED_SCRIPT_VARINT_CONTINUE - 1))
+                << shift;
+        if ((byte & COMPILED_SCRIPT_VARINT_CONTINUE) == 0) {
+            return true;
+        }
+        shift += COMPILED_SCRIPT_VARINT_BITS;
+    }
+    return false;
+}
+
+/**
+ * @brief Zapisuje numer, upakowując po dwie cyfry w bajcie.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] number - numer.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+static bool compiledScriptWriteNumber(FILE *out, const char *number) {
+    size_t length = strlen(number);
+    if (!compiledScriptWriteVarint(out, length)) {
+        return false;
+    }
+
+    size_t i;
+    for (i = 0; i < length; i += 2) {
+        int byte = (number[i] - '0') << 4;
+        if (i + 1 < length) {
+            byte |= number[i + 1] - '0';
+        }
+        if (putc(byte, out) == EOF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Zapisuje identyfikator.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] id - identyfikator.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+static bool compiledScriptWriteIdentificator(FILE *out, const char *id) {
+    size_t length = strlen(id);
+    return compiledScriptWriteVarint(out, length)
+           && fwrite(id, 1, length, out) == length;
+}
+
+bool compiledScriptWriteHeader(FILE *out) {
+    return fwrite(COMPILED_SCRIPT_MAGIC, 1, COMPILED_SCRIPT_MAGIC_LENGTH, out)
+           == COMPILED_SCRIPT_MAGIC_LENGTH;
+}
+
+bool compiledScriptWriteOperation(FILE *out, const struct Operation *op,
+                                  size_t *previousEnd) {
+    if (putc(op->type, out) == EOF
+        || !compiledScriptWriteVarint(out, op->operatorPos - *previousEnd)
+        || !compiledScriptWriteVarint(out, op->endPos - op->operatorPos)) {
+        return false;
+    }
+    *previousEnd = op->endPos;
+
+    bool (*writeArgument)(FILE *, const char *);
+    if (operationArgumentsAreNumbers(op->type)) {
+        writeArgument = compiledScriptWriteNumber;
+    } else {
+        writeArgument = compiledScriptWriteIdentificator;
+    }
+
+    int arguments = operationArgumentsNumber(op->type);
+    return (arguments < 1 || writeArgument(out, vectorBegin(op->arg1)))
+           && (arguments < 2 || writeArgument(out, vectorBegin(op->arg2)));
+}
+
+bool compiledScriptReadHeader(FILE *in) {
+    char magic[COMPILED_SCRIPT_MAGIC_LENGTH];
+    return fread(magic, 1, COMPILED_SCRIPT_MAGIC_LENGTH, in)
+           == COMPILED_SCRIPT_MAGIC_LENGTH
+           && memcmp(magic, COMPILED_SCRIPT_MAGIC,
+                     COMPILED_SCRIPT_MAGIC_LENGTH) == 0;
+}
+
+/**
+ * @brief Wczytuje numer.
+ * @param[in, out] in - strumień wejściowy.
+ * @param[out] destination - Vector, do którego zostanie zapisany numer
+ *        zakończony '\0'.
+ * @return COMPILED_SCRIPT_OPERATION w przypadku sukcesu,
+ *         COMPILED_SCRIPT_MALFORMED lub COMPILED_SCRIPT_MEMORY_ERROR.
+ */
+static int compiledScriptReadNumber(FILE *in, Vector destination) {
+    size_t length;
+    if (!compiledScriptReadVarint(in, &length) || length == 0) {
+        return COMPILED_SCRIPT_MALFORMED;
+    }
+    if (vectorSoftResize(destination, length + 1) != VECTOR_SUCCES) {
+        return COMPILED_SCRIPT_MEMORY_ERROR;
+    }
+
+    char *number = vectorBegin(destination);
+    size_t i;
+    for (i = 0; i < length; i += 2) {
+        int byte = getc(in);
+        if (byte == EOF) {
+            return COMPILED_SCRIPT_MALFORMED;
+        }
+
+        int high = byte >> 4;
+        int low = byte & COMPILED_SCRIPT_NIBBLE_MASK;
+        if (high >= CHARACTER_NUMBER_OF_DIGITS
+            || (i + 1 < length && low >= CHARACTER_NUMBER_OF_DIGITS)) {
+            return COMPILED_SCRIPT_MALFORMED;
+        }
+
+        number[i] = (char) ('0' + high);
+        if (i + 1 < length) {
+            number[i + 1] = (char) ('0' + low);
+        }
+    }
+    number[length] = CHARACTER_STRING_TERMINATOR;
+    return COMPILED_SCRIPT_OPERATION;
+}
+
+/**
+ * @brief Wczytuje identyfikator.
+ * @param[in, out] in - strumień wejściowy.
+ * @param[out] destination - Vector, do którego zostanie zapisany
+ *        identyfikator zakończony '\0'.
+ * @return COMPILED_SCRIPT_OPERATION w przypadku sukcesu,
+ *         COMPILED_SCRIPT_MALFORMED lub COMPILED_SCRIPT_MEMORY_ERROR.
+ */
+static int compiledScriptReadIdentificator(FILE *in, Vector destination) {
+    size_t length;
+    if (!compiledScriptReadVarint(in, &length) || length == 0) {
+        return COMPILED_SCRIPT_MALFORMED;
+    }
+    if (vectorSoftResize(destination, length + 1) != VECTOR_SUCCES) {
+        return COMPILED_SCRIPT_MEMORY_ERROR;
+    }
+
+    char *id = vectorBegin(destination);
+    if (fread(id, 1, length, in) != length
+        || !characterIsLetter((unsigned char) id[0])) {
+        return COMPILED_SCRIPT_MALFORMED;
+    }
+
+    size_t i;
+    for (i = 1; i < length; i++) {
+        if (!characterIsLetter((unsigned char) id[i])
+            && !isdigit((unsigned char) id[i])) {
+            return COMPILED_SCRIPT_MALFORMED;
+        }
+    }
+    id[length] = CHARACTER_STRING_TERMINATOR;
+    return COMPILED_SCRIPT_OPERATION;
+}
+
+int compiledScriptReadOperation(FILE *in, struct Operation *op,
+                                size_t *previousEnd) {
+    operationClear(op);
+
+    int type = getc(in);
+    if (type == EOF) {
+        return COMPILED_SCRIPT_END;
+    }
+
+    size_t operatorDelta, endDelta;
+    if (type <= OPERATION_NONE || type >= OPERATION_TYPES_NUMBER
+        || !compiledScriptReadVarint(in, &operatorDelta)
+        || !compiledScriptReadVarint(in, &endDelta)) {
+        return COMPILED_SCRIPT_MALFORMED;
+    }
+    op->type = type;
+    op->operatorPos = *previousEnd + operatorDelta;
+    op->endPos = op->operatorPos + endDelta;
+    if (op->operatorPos < *previousEnd || op->endPos < op->operatorPos) {
+        return COMPILED_SCRIPT_MALFORMED;
+    }
+    *previousEnd = op->endPos;
+
+    int (*readArgument)(FILE *, Vector);
+    if (operationArgumentsAreNumbers(type)) {
+        readArgument = compiledScriptReadNumber;
+    } else {
+        readArgument = compiledScriptReadIdentificator;
+    }
+
+    int arguments = operationArgumentsNumber(type);
+    int result = COMPILED_SCRIPT_OPERATION;
+    if (arguments >= 1) {
+        result = readArgument(in, op->arg1);
+    }
+    if (arguments >= 2 && result == COMPILED_SCRIPT_OPERATION) {
+        result = readArgument(in, op->arg2);
+    }
+    return result;
+}
@@ -0,0 +1,117 @@
+/** @file
+ * Interfejs modułu skompilowanych skryptów.
+ * Skompilowany skrypt to zweryfikowany ciąg operacji zapisany binarnie,
+ * który można wykonać bez ponownego parsowania tekstu. Plik zaczyna się
+ * od COMPILED_SCRIPT_MAGIC, po którym następują operacje:
+ * kod operacji (1 bajt), pozycje operatora i końca operacji w oryginalnym
+ * skrypcie, a następnie argumenty. Pozycje są zapisywane jako przyrosty
+ * (operatora względem końca poprzedniej operacji, końca względem
+ * operatora) w postaci liczb o zmiennej długości.
+ * Numer zapisywany jest jako długość i cyfry upakowane po dwie w bajcie
+ * (po 4 bity), identyfikator jako długość i znaki.
+ * Liczby o zmiennej długości są zapisywane po 7 bitów w bajcie, zaczynając
+ * od najmniej znaczących, najstarszy bit oznacza kontynuację.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_COMPILED_SCRIPT_H
+#define TELEFONY_COMPILED_SCRIPT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "operation.h"
+
+/**
+ * @brief Ciąg bajtów rozpoczynający skompilowany skrypt.
+ */
+#define COMPILED_SCRIPT_MAGIC "PFWDBIN1"
+
+/**
+ * @brief Długość COMPILED_SCRIPT_MAGIC.
+ */
+#define COMPILED_SCRIPT_MAGIC_LENGTH 8
+
+/**
+ * @brief Wczytano operację.
+ * @see compiledScriptReadOperation
+ */
+#define COMPILED_SCRIPT_OPERATION 1
+
+/**
+ * @brief Skrypt się zakończył.
+ * @see compiledScriptReadOperation
+ */
+#define COMPILED_SCRIPT_END 0
+
+/**
+ * @brief Skrypt jest uszkodzony.
+ * @see compiledScriptReadOperation
+ */
+#define COMPILED_SCRIPT_MALFORMED 2
+
+/**
+ * @brief Wystąpił problem z pamięcią.
+ * @see compiledScriptReadOperation
+ */
+#define COMPILED_SCRIPT_MEMORY_ERROR 3
+
+/**
+ * @brief Zapisuje liczbę o zmiennej długości.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] value - zapisywana liczba.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+bool compiledScriptWriteVarint(FILE *out, size_t value);
+
+/**
+ * @brief Wczytuje liczbę o zmiennej długości.
+ * @param[in, out] in - strumień wejściowy.
+ * @param[out] value - wczytana liczba.
+ * @return true w przypadku sukcesu, false jeżeli liczba jest niekompletna
+ *         lub za duża.
+ */
+bool compiledScriptReadVarint(FILE *in, size_t *value);
+
+/**
+ * @brief Zapisuje nagłówek skompilowanego skryptu.
+ * @param[in, out] out - strumień wyjściowy.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+bool compiledScriptWriteHeader(FILE *out);
+
+/**
+ * @brief Zapisuje operację.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] op - wskaźnik na zapisywaną operację.
+ * @param[in, out] previousEnd - pozycja końca poprzedniej operacji
+ *        (początkowo 0), uaktualniana po zapisie.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+bool compiledScriptWriteOperation(FILE *out, const struct Operation *op,
+                                  size_t *previousEnd);
+
+/**
+ * @brief Wczytuje i sprawdza nagłówek skompilowanego skryptu.
+ * @param[in, out] in - strumień wejściowy.
+ * @return true jeżeli nagłówek jest poprawny, false w przeciwnym przypadku.
+ */
+bool compiledScriptReadHeader(FILE *in);
+
+/**
+ * @brief Wczytuje operację.
+ * Sprawdza poprawność kodu operacji i argumentów.
+ * @param[in, out] in - strumień wejściowy.
+ * @param[out] op - wskaźnik na wczytywaną operację.
+ * @param[in, out] previousEnd - pozycja końca poprzedniej operacji
+ *        (początkowo 0), uaktualniana po odczycie.
+ * @return COMPILED_SCRIPT_OPERATION, COMPILED_SCRIPT_END,
+ *         COMPILED_SCRIPT_MALFORMED lub COMPILED_SCRIPT_MEMORY_ERROR.
+ */
+int compiledScriptReadOperation(FILE *in, struct Operation *op,
+                                size_t *previousEnd);
+
+#endif //TELEFONY_COMPILED_SCRIPT_H
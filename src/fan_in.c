@@ -0,0 +1,301 @@
+/** @file
+ * Implementacja rankingu kluczy według liczników zmienianych o jeden.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "fan_in.h"
+
+/**
+ * @brief Wskaźnik na kubełek.
+ * @see struct FanInBucket
+ */
+typedef struct FanInBucket *FanInBucket;
+
+/**
+ * @brief Kubełek kluczy o tym samym liczniku.
+ */
+struct FanInBucket {
+    /**
+     * @brief Licznik kluczy w kubełku.
+     */
+    size_t count;
+
+    /**
+     * @brief Kubełek o najmniejszym większym liczniku lub NULL.
+     */
+    FanInBucket higher;
+
+    /**
+     * @brief Kubełek o największym mniejszym liczniku lub NULL.
+     * W kubełkach zapasowych następny kubełek zapasowy.
+     */
+    FanInBucket lower;
+
+    /**
+     * @brief Pierwszy klucz w kubełku.
+     */
+    FanInEntry first;
+};
+
+struct FanInEntry {
+    /**
+     * @brief Klucz.
+     */
+    void *key;
+
+    /**
+     * @brief Kubełek zawierający klucz.
+     */
+    FanInBucket bucket;
+
+    /**
+     * @brief Poprzedni klucz w kubełku lub NULL.
+     */
+    FanInEntry previous;
+
+    /**
+     * @brief Następny klucz w kubełku lub NULL.
+     */
+    FanInEntry next;
+};
+
+struct FanIn {
+    /**
+     * @brief Kubełek o największym liczniku lub NULL.
+     */
+    FanInBucket highest;
+
+    /**
+     * @brief Kubełek o najmniejszym liczniku lub NULL.
+     */
+    FanInBucket lowest;
+
+    /**
+     * @brief Lista kubełków zapasowych (połączonych polem lower).
+     * Kubełków używanych i zapasowych jest łącznie tyle, ile kluczy.
+     */
+    FanInBucket spare;
+};
+
+FanIn fanInCreate(void) {
+    FanIn result = malloc(sizeof(struct FanIn));
+    if (result != NULL) {
+        result->highest = NULL;
+        result->lowest = NULL;
+        result->spare = NULL;
+    }
+    return result;
+}
+
+/**
+ * @brief Zwalnia listę kubełków połączonych polem lower.
+ * @param[in] bucket - pierwszy kubełek.
+ * @param[in] entries - czy zwolnić również klucze w kubełkach.
+ */
+static void fanInFreeBuckets(FanInBucket bucket, bool entries) {
+    while (bucket != NULL) {
+        FanInBucket next = bucket->lower;
+        FanInEntry entry = entries ? bucket->first : NULL;
+        while (entry != NULL) {
+            FanInEntry nextEntry = entry->next;
+            free(entry);
+            entry = nextEntry;
+        }
+        free(bucket);
+        bucket = next;
+    }
+}
+
+void fanInDelete(FanIn fanIn) {
+    if (fanIn != NULL) {
+        fanInFreeBuckets(fanIn->highest, true);
+        fanInFreeBuckets(fanIn->spare, false);
+        free(fanIn);
+    }
+}
+
+/**
+ * @brief Wstawia zapasowy kubełek z licznikiem @p count między
+ * kubełki @p higher i @p lower.
+ * @param[in, out] fanIn - wskaźnik na ranking.
+ * @param[in] count - licznik kubełka.
+ * @param[in, out] higher - kubełek o większym liczniku lub NULL.
+ * @param[in, out] lower - kubełek o mniejszym liczniku lub NULL.
+ * @return Wstawiony kubełek.
+ */
+static FanInBucket fanInLinkBucket(FanIn fanIn, size_t count,
+                                   FanInBucket higher, FanInBucket lower) {
+    FanInBucket bucket = fanIn->spare;
+    assert(bucket != NULL);
+    fanIn->spare = bucket->lower;
+
+    bucket->count = count;
+    bucket->first = NULL;
+    bucket->higher = higher;
+    bucket->lower = lower;
+    if (higher != NULL) {
+        higher->lower = bucket;
+    } else {
+        fanIn->highest = bucket;
+    }
+    if (lower != NULL) {
+        lower->higher = bucket;
+    } else {
+        fanIn->lowest = bucket;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Odłącza pusty kubełek i dodaje go do zapasowych.
+ * @param[in, out] fanIn - wskaźnik na ranking.
+ * @param[in, out] bucket - pusty kubełek.
+ */
+static void fanInUnlinkBucket(FanIn fanIn, FanInBucket bucket) {
+    assert(bucket->first == NULL);
+    if (bucket->higher != NULL) {
+        bucket->higher->lower = bucket->lower;
+    } else {
+        fanIn->highest = bucket->lower;
+    }
+    if (bucket->lower != NULL) {
+        bucket->lower->higher = bucket->higher;
+    } else {
+        fanIn->lowest = bucket->higher;
+    }
+    bucket->lower = fanIn->spare;
+    fanIn->spare = bucket;
+}
+
+/**
+ * @brief Wstawia klucz do kubełka.
+ * @param[in, out] bucket - kubełek.
+ * @param[in, out] entry - pozycja klucza.
+ */
+static void fanInAttach(FanInBucket bucket, FanInEntry entry) {
+    entry->bucket = bucket;
+    entry->previous = NULL;
+    entry->next = bucket->first;
+    if (bucket->first != NULL) {
+        bucket->first->previous = entry;
+    }
+    bucket->first = entry;
+}
+
+/**
+ * @brief Usuwa klucz z jego kubełka (pusty kubełek pozostaje na liście).
+ * @param[in, out] entry - pozycja klucza.
+ */
+static void fanInDetach(FanInEntry entry) {
+    if (entry->previous != NULL) {
+        entry->previous->next = entry->next;
+    } else {
+        entry->bucket->first = entry->next;
+    }
+    if (entry->next != NULL) {
+        entry->next->previous = entry->previous;
+    }
+}
+
+/**
+ * @brief Przenosi klucz do kubełka z licznikiem większym lub mniejszym o 1.
+ * Jeżeli klucz jest jedynym w kubełku, a kubełek o docelowym liczniku nie
+ * istnieje, zmienia licznik kubełka w miejscu.
+ * @param[in, out] fanIn - wskaźnik na ranking.
+ * @param[in, out] entry - pozycja klucza.
+ * @param[in] up - czy licznik jest zwiększany.
+ */
+static void fanInMove(FanIn fanIn, FanInEntry entry, bool up) {
+    FanInBucket bucket = entry->bucket;
+    size_t count = up ? bucket->count + 1 : bucket->count - 1;
+    FanInBucket target = up ? bucket->higher : bucket->lower;
+
+    if (target == NULL || target->count != count) {
+        if (entry->previous == NULL && entry->next == NULL) {
+            bucket->count = count;
+            return;
+        } else if (up) {
+            target = fanInLinkBucket(fanIn, count, bucket->higher, bucket);
+        } else {
+            target = fanInLinkBucket(fanIn, count, bucket, bucket->lower);
+        }
+    }
+
+    fanInDetach(entry);
+    if (bucket->first == NULL) {
+        fanInUnlinkBucket(fanIn, bucket);
+    }
+    fanInAttach(target, entry);
+}
+
+FanInEntry fanInIncrement(FanIn fanIn, FanInEntry entry, void *key) {
+    if (entry != NULL) {
+        fanInMove(fanIn, entry, true);
+        return entry;
+    }
+
+    entry = malloc(sizeof(struct FanInEntry));
+    FanInBucket spare = malloc(sizeof(struct FanInBucket));
+    if (entry == NULL || spare == NULL) {
+        free(entry);
+        free(spare);
+        return NULL;
+    }
+    spare->lower = fanIn->spare;
+    fanIn->spare = spare;
+
+    entry->key = key;
+    FanInBucket bucket = fanIn->lowest;
+    if (bucket == NULL || bucket->count != 1) {
+        bucket = fanInLinkBucket(fanIn, 1, fanIn->lowest, NULL);
+    }
+    fanInAttach(bucket, entry);
+    return entry;
+}
+
+FanInEntry fanInDecrement(FanIn fanIn, FanInEntry entry) {
+    FanInBucket bucket = entry->bucket;
+    if (bucket->count > 1) {
+        fanInMove(fanIn, entry, false);
+        return entry;
+    }
+
+    fanInDetach(entry);
+    if (bucket->first == NULL) {
+        fanInUnlinkBucket(fanIn, bucket);
+    }
+    free(entry);
+
+    FanInBucket spare = fanIn->spare;
+    assert(spare != NULL);
+    fanIn->spare = spare->lower;
+    free(spare);
+    return NULL;
+}
+
+size_t fanInCount(FanInEntry entry) {
+    return entry->bucket->count;
+}
+
+bool fanInForEachTop(FanIn fanIn, size_t k,
+                     bool (*f)(void *, size_t, void *), void *data) {
+    FanInBucket bucket;
+    for (bucket = fanIn->highest; bucket != NULL && k > 0;
+         bucket = bucket->lower) {
+        FanInEntry entry;
+        for (entry = bucket->first; entry != NULL && k > 0;
+             entry = entry->next) {
+            if (!f(entry->key, bucket->count, data)) {
+                return false;
+            }
+            k--;
+        }
+    }
+    return true;
+}
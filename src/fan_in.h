@@ -0,0 +1,103 @@
+/** @file
+ * Interfejs rankingu kluczy według liczników zmienianych o jeden.
+ * Klucze o tym samym liczniku tworzą kubełek, a kubełki są ułożone
+ * w liście malejąco według licznika, dlatego zwiększenie i zmniejszenie
+ * licznika działa w czasie stałym, a k kluczy o największych licznikach
+ * można przejrzeć w czasie O(k). Kubełków nigdy nie jest więcej niż kluczy,
+ * więc każdy klucz przy dodaniu rezerwuje jeden kubełek i zmiany liczników
+ * istniejących kluczy nie alokują pamięci.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_FAN_IN_H
+#define TELEFONY_FAN_IN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Wskaźnik na ranking.
+ * @see struct FanIn
+ */
+typedef struct FanIn *FanIn;
+
+/**
+ * @brief Wskaźnik na pozycję klucza w rankingu.
+ * @see struct FanInEntry
+ */
+typedef struct FanInEntry *FanInEntry;
+
+/**
+ * @brief Struktura przechowująca ranking.
+ */
+struct FanIn;
+
+/**
+ * @brief Struktura przechowująca klucz i jego licznik.
+ */
+struct FanInEntry;
+
+/**
+ * @brief Tworzy pusty ranking.
+ * @return Wskaźnik na ranking lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+FanIn fanInCreate(void);
+
+/**
+ * @brief Usuwa ranking wraz ze wszystkimi pozycjami.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] fanIn - wskaźnik na ranking.
+ */
+void fanInDelete(FanIn fanIn);
+
+/**
+ * @brief Zwiększa licznik klucza o jeden.
+ * #### Złożoność
+ * O(1)
+ * @param[in, out] fanIn - wskaźnik na ranking.
+ * @param[in, out] entry - pozycja klucza lub NULL, gdy klucza nie ma
+ *        w rankingu (wtedy jest dodawany z licznikiem 1).
+ * @param[in] key - klucz dodawany, gdy @p entry ma wartość NULL.
+ * @return Pozycja klucza. NULL, gdy nie udało się zaalokować pamięci
+ *         dla nowego klucza (tylko gdy @p entry ma wartość NULL).
+ */
+FanInEntry fanInIncrement(FanIn fanIn, FanInEntry entry, void *key);
+
+/**
+ * @brief Zmniejsza licznik klucza o jeden.
+ * Klucz, którego licznik spada do zera, jest usuwany z rankingu.
+ * Nie alokuje pamięci.
+ * #### Złożoność
+ * O(1)
+ * @param[in, out] fanIn - wskaźnik na ranking.
+ * @param[in, out] entry - pozycja klucza.
+ * @return Pozycja klucza lub NULL, jeżeli klucz został usunięty.
+ */
+FanInEntry fanInDecrement(FanIn fanIn, FanInEntry entry);
+
+/**
+ * @param[in] entry - pozycja klucza.
+ * @return Licznik klucza.
+ */
+size_t fanInCount(FanInEntry entry);
+
+/**
+ * @brief Przegląda klucze o największych licznikach.
+ * Wywołuje f(klucz, licznik, data) dla co najwyżej @p k kluczy w kolejności
+ * nierosnących liczników. Przeglądanie zostaje przerwane, jeżeli @p f
+ * zwróci false.
+ * #### Złożoność
+ * O(k)
+ * @param[in] fanIn - wskaźnik na ranking.
+ * @param[in] k - maksymalna liczba przeglądanych kluczy.
+ * @param[in] f - wskaźnik na funkcję przetwarzającą klucz.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p f.
+ * @return false jeżeli @p f zwróciła false, true w przeciwnym przypadku.
+ */
+bool fanInForEachTop(FanIn fanIn, size_t k,
+                     bool (*f)(void *, size_t, void *), void *data);
+
+#endif /* TELEFONY_FAN_IN_H */
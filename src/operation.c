@@ -0,0 +1,112 @@
+/** @file
+ * Implementacja struktury opisującej wczytaną operację.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include "operation.h"
+
+bool operationInit(struct Operation *op) {
+    op->type = OPERATION_NONE;
+    op->operatorPos = 0;
+    op->endPos = 0;
+    op->arg1 = vectorCreate();
+    op->arg2 = vectorCreate();
+
+    if (op->arg1 == NULL || op->arg2 == NULL) {
+        operationDestroy(op);
+        return false;
+    }
+    return true;
+}
+
+void operationClear(struct Operation *op) {
+    op->type = OPERATION_NONE;
+    op->operatorPos = 0;
+    op->endPos = 0;
+    vectorSoftClear(op->arg1);
+    vectorSoftClear(op->arg2);
+}
+
+void operationDestroy(struct Operation *op) {
+    if (op->arg1 != NULL) {
+        vectorDelete(op->arg1);
+        op->arg1 = NULL;
+    }
+
+    if (op->arg2 != NULL) {
+        vectorDelete(op->arg2);
+        op->arg2 = NULL;
+    }
+}
+
+int operationArgumentsNumber(int type) {
+    switch (type) {
+        case OPERATION_REDIRECT:
+            return 2;
+        case OPERATION_NEW:
+        case OPERATION_DELETE_NUMBER:
+        case OPERATION_DELETE_BASE:
+        case OPERATION_REVERSE:
+        case OPERATION_NONTRIVIAL:
+        case OPERATION_GET:
+        case OPERATION_TOP:
+        case OPERATION_EXPLAIN_GET:
+        case OPERATION_EXPLAIN_REVERSE:
+        case OPERATION_EXPLAIN_NONTRIVIAL:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+bool operationArgumentsAreNumbers(int type) {
+    return operationArgumentsNumber(type) > 0
+           && type != OPERATION_NEW && type != OPERATION_DELETE_BASE;
+}
+
+int operationExplained(int type) {
+    switch (type) {
+        case OPERATION_GET:
+            return OPERATION_EXPLAIN_GET;
+        case OPERATION_REVERSE:
+            return OPERATION_EXPLAIN_REVERSE;
+        case OPERATION_NONTRIVIAL:
+            return OPERATION_EXPLAIN_NONTRIVIAL;
+        default:
+            return OPERATION_NONE;
+    }
+}
+
+const char *operationName(int type) {
+    switch (type) {
+        case OPERATION_NEW:
+            return PARSER_OPERATOR_NEW;
+        case OPERATION_DELETE_NUMBER:
+            return PARSER_OPERATOR_DELETE "_NUMBER";
+        case OPERATION_DELETE_BASE:
+            return PARSER_OPERATOR_DELETE "_BASE";
+        case OPERATION_REVERSE:
+            return PARSER_OPERATOR_QM_STRING "_REVERSE";
+        case OPERATION_NONTRIVIAL:
+            return PARSER_OPERATOR_NONTRIVIAL_STRING;
+        case OPERATION_GET:
+            return PARSER_OPERATOR_QM_STRING "_GET";
+        case OPERATION_REDIRECT:
+            return PARSER_OPERATOR_REDIRECT_STRING;
+        case OPERATION_SAVE:
+            return PARSER_OPERATOR_SAVE;
+        case OPERATION_TOP:
+            return PARSER_OPERATOR_TOP;
+        case OPERATION_EXPLAIN_GET:
+            return PARSER_OPERATOR_EXPLAIN "_?_GET";
+        case OPERATION_EXPLAIN_REVERSE:
+            return PARSER_OPERATOR_EXPLAIN "_?_REVERSE";
+        case OPERATION_EXPLAIN_NONTRIVIAL:
+            return PARSER_OPERATOR_EXPLAIN "_@";
+        default:
+            return "NONE";
+    }
+}
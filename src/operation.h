@@ -0,0 +1,228 @@
+/** @file
+ * Interfejs struktury opisującej wczytaną operację.
+ * Operacja jest wynikiem parsowania polecenia i przechowuje jego argumenty
+ * oraz pozycje (w bajtach wejścia) potrzebne do zgłaszania błędów.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_OPERATION_H
+#define TELEFONY_OPERATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "vector.h"
+#include "stdfunc.h"
+
+/**
+ * @brief Ciąg znaków rozpoczynający i kończący komentarz.
+ */
+#define PARSER_COMMENT_SEQUENCE "$$"
+
+/**
+ * @brief Ciąg znaków reprezentujący operator ?.
+ */
+#define PARSER_OPERATOR_QM_STRING "?"
+
+/**
+ * @brief Znak odpowiadający operatorowi ?.
+ */
+#define PARSER_OPERATOR_QM (STRING_TO_CHAR(PARSER_OPERATOR_QM_STRING))
+
+/**
+ * @brief Ciąg znaków reprezentujący operator przekierowania.
+ */
+#define PARSER_OPERATOR_REDIRECT_STRING ">"
+
+/**
+ * @brief Znak odpowiadający operatorowi przekierowania.
+ */
+#define PARSER_OPERATOR_REDIRECT (STRING_TO_CHAR(PARSER_OPERATOR_REDIRECT_STRING))
+
+/**
+ * @brief Ciąg znaków reprezentujący operator liczby nietrywialnych numerów.
+ */
+#define PARSER_OPERATOR_NONTRIVIAL_STRING "@"
+
+/**
+ * @brief Znak reprezentujący operator liczby nietrywialnych numerów.
+ */
+#define PARSER_OPERATOR_NONTRIVIAL (STRING_TO_CHAR(PARSER_OPERATOR_NONTRIVIAL_STRING))
+
+/**
+ * @brief Ciąg znaków odpowiadający operatorowi stworzenia nowej bazy.
+ */
+#define PARSER_OPERATOR_NEW "NEW"
+
+/**
+ * @brief Ciąg znaków odpowiadający operatorowi usunięcia bazy.
+ */
+#define PARSER_OPERATOR_DELETE "DEL"
+
+/**
+ * @brief Ciąg znaków odpowiadający operatorowi zapisania migawki baz.
+ */
+#define PARSER_OPERATOR_SAVE "SAVE"
+
+/**
+ * @brief Ciąg znaków odpowiadający operatorowi najczęstszych celów
+ * przekierowań.
+ */
+#define PARSER_OPERATOR_TOP "TOP"
+
+/**
+ * @brief Ciąg znaków odpowiadający przedrostkowi wypisującemu koszt
+ * zapytania ?, lub @.
+ */
+#define PARSER_OPERATOR_EXPLAIN "EXPLAIN"
+
+/**
+ * @brief Brak operacji.
+ */
+#define OPERATION_NONE 0
+
+/**
+ * @brief Utworzenie lub wybranie bazy (NEW identyfikator).
+ */
+#define OPERATION_NEW 1
+
+/**
+ * @brief Usunięcie przekierowań z prefiksem (DEL numer).
+ */
+#define OPERATION_DELETE_NUMBER 2
+
+/**
+ * @brief Usunięcie bazy (DEL identyfikator).
+ */
+#define OPERATION_DELETE_BASE 3
+
+/**
+ * @brief Wyznaczenie przekierowań na numer (? numer).
+ */
+#define OPERATION_REVERSE 4
+
+/**
+ * @brief Liczba nietrywialnych numerów (@ numer).
+ */
+#define OPERATION_NONTRIVIAL 5
+
+/**
+ * @brief Wyznaczenie przekierowania numeru (numer ?).
+ */
+#define OPERATION_GET 6
+
+/**
+ * @brief Dodanie przekierowania (numer > numer).
+ */
+#define OPERATION_REDIRECT 7
+
+/**
+ * @brief Zapisanie migawki baz (SAVE).
+ */
+#define OPERATION_SAVE 8
+
+/**
+ * @brief Najczęstsze cele przekierowań (TOP liczba).
+ */
+#define OPERATION_TOP 9
+
+/**
+ * @brief phfwdGet z kosztem zapytania (EXPLAIN numer ?).
+ */
+#define OPERATION_EXPLAIN_GET 10
+
+/**
+ * @brief phfwdReverse z kosztem zapytania (EXPLAIN ? numer).
+ */
+#define OPERATION_EXPLAIN_REVERSE 11
+
+/**
+ * @brief phfwdNonTrivialCount z kosztem zapytania (EXPLAIN @ numer).
+ */
+#define OPERATION_EXPLAIN_NONTRIVIAL 12
+
+/**
+ * @brief Liczba rodzajów operacji (wraz z OPERATION_NONE).
+ */
+#define OPERATION_TYPES_NUMBER 13
+
+/**
+ * @brief Struktura opisująca wczytaną operację.
+ */
+struct Operation {
+    /**
+     * @brief Rodzaj operacji (OPERATION_*).
+     */
+    int type;
+
+    /**
+     * @brief Pierwszy argument zakończony '\0' (numer lub identyfikator).
+     */
+    Vector arg1;
+
+    /**
+     * @brief Drugi argument zakończony '\0' (numer w OPERATION_REDIRECT).
+     */
+    Vector arg2;
+
+    /**
+     * @brief Pozycja operatora, używana w komunikatach o błędach operacji.
+     */
+    size_t operatorPos;
+
+    /**
+     * @brief Liczba bajtów wejścia wczytanych po zakończeniu operacji.
+     */
+    size_t endPos;
+};
+
+/**
+ * @brief Inicjuje operację.
+ * @param[out] op - wskaźnik na inicjowaną operację.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool operationInit(struct Operation *op);
+
+/**
+ * @brief Czyści operację, pozostawiając zarezerwowaną pamięć.
+ * @param[in, out] op - wskaźnik na operację.
+ */
+void operationClear(struct Operation *op);
+
+/**
+ * @brief Zwalnia pamięć zajmowaną przez operację.
+ * @param[in, out] op - wskaźnik na operację.
+ */
+void operationDestroy(struct Operation *op);
+
+/**
+ * @param[in] type - rodzaj operacji.
+ * @return Liczba argumentów operacji rodzaju @p type.
+ */
+int operationArgumentsNumber(int type);
+
+/**
+ * @param[in] type - rodzaj operacji.
+ * @return true jeżeli argumenty operacji rodzaju @p type są numerami,
+ *         false jeżeli są identyfikatorami lub operacja nie ma argumentów.
+ */
+bool operationArgumentsAreNumbers(int type);
+
+/**
+ * @param[in] type - rodzaj operacji.
+ * @return Rodzaj operacji @p type poprzedzonej PARSER_OPERATOR_EXPLAIN
+ *         lub OPERATION_NONE, jeżeli nie można jej poprzedzić.
+ */
+int operationExplained(int type);
+
+/**
+ * @param[in] type - rodzaj operacji.
+ * @return Nazwa operacji rodzaju @p type w raportach (bez spacji),
+ *         "NONE" dla OPERATION_NONE i nieznanych rodzajów.
+ */
+const char *operationName(int type);
+
+#endif //TELEFONY_OPERATION_H
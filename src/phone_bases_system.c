@@ -11,6 +11,7 @@
 
 #include "phone_bases_system.h"
 #include "text.h"
+#include "vector.h"
 
 /**
  * @see struct PhoneBaseInfo
@@ -40,6 +41,12 @@ struct PhoneBaseInfo {
      * @brief Wskaźnik na bazę przekierowań.
      */
     struct PhoneForward *base;
+
+    /**
+     * @brief Czy baza istniała w chwili ostatniego wywołania
+     * phoneBasesClearChanges.
+     */
+    bool checkpointed;
 };
 
 
@@ -75,6 +82,18 @@ struct PhoneBases {
      * @brief Liczba przechowywanych baz.
      */
     size_t numberOfBases;
+
+    /**
+     * @brief Identyfikatory baz usuniętych od ostatniego wywołania
+     * phoneBasesClearChanges, które wtedy istniały.
+     * Kolejne identyfikatory są zakończone znakiem '\0'.
+     */
+    Vector removedIds;
+
+    /**
+     * @brief Czy nie udało się zapamiętać którejś ze zmian.
+     */
+    bool changesLost;
 };
 
 /**
@@ -135,6 +154,7 @@ static void phoneBasesFreeNode(PhoneBasesNode pbn) {
 static void phoneBasesInitPhoneBases(PhoneBases pb) {
     pb->basesList = NULL;
     pb->numberOfBases = 0;
+    pb->changesLost = false;
 }
 
 PhoneBases phoneBasesCreateNewPhoneBases() {
@@ -144,6 +164,12 @@ PhoneBases phoneBasesCreateNewPhoneBases() {
     }
     phoneBasesInitPhoneBases(pb);
 
+    pb->removedIds = vectorCreate();
+    if (pb->removedIds == NULL) {
+        free(pb);
+        return NULL;
+    }
+
     return pb;
 }
 
@@ -162,6 +188,7 @@ static void phoneBasesDeleteNodesList(PhoneBasesNode node) {
 void phoneBasesDestroyPhoneBases(PhoneBases pb) {
     phoneBasesDeleteNodesList(pb->basesList);
     pb->basesList = NULL;
+    vectorDelete(pb->removedIds);
     free(pb);
 }
 
@@ -207,6 +234,7 @@ struct PhoneForward *phoneBasesAddBase(PhoneBases pb, const char *id) {
                 } else {
                     newNode->baseInfo.hash = phoneBasesHashId(copyId);
                     newNode->baseInfo.id = copyId;
+                    newNode->baseInfo.checkpointed = false;
                     newNode->next = pb->basesList;
                     pb->basesList = newNode;
 
@@ -233,6 +261,11 @@ bool phoneBasesDelBase(PhoneBases pb, const char *id) {
                 mnt = &pb->basesList;
             }
             (*mnt) = cur->next;
+            if (cur->baseInfo.checkpointed
+                && vectorPushBackString(pb->removedIds, cur->baseInfo.id)
+                   != VECTOR_SUCCES) {
+                pb->changesLost = true;
+            }
             phoneBasesFreeNode(cur);
 
             pb->numberOfBases--;
@@ -244,4 +277,73 @@ bool phoneBasesDelBase(PhoneBases pb, const char *id) {
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+bool phoneBasesForEach(PhoneBases pb,
+                       bool (*f)(const char *, struct PhoneForward *, void *),
+                       void *data) {
+    PhoneBasesNode ptr = pb->basesList;
+    while (ptr != NULL) {
+        if (!f(ptr->baseInfo.id, ptr->baseInfo.base, data)) {
+            return false;
+        }
+        ptr = ptr->next;
+    }
+    return true;
+}
+
+bool phoneBasesForEachChange(PhoneBases pb,
+                             bool (*removed)(const char *, void *),
+                             bool (*changed)(const char *,
+                                             struct PhoneForward *,
+                                             bool, void *),
+                             void *data) {
+    const char *id = vectorBegin(pb->removedIds);
+    const char *end = vectorEnd(pb->removedIds);
+    while (id != end) {
+        if (!removed(id, data)) {
+            return false;
+        }
+        id += strlen(id) + 1;
+    }
+
+    PhoneBasesNode ptr = pb->basesList;
+    while (ptr != NULL) {
+        PhoneBaseInfo *info = &ptr->baseInfo;
+        if (!info->checkpointed || phfwdHasChanges(info->base)) {
+            if (!changed(info->id, info->base, !info->checkpointed, data)) {
+                return false;
+            }
+        }
+        ptr = ptr->next;
+    }
+    return true;
+}
+
+bool phoneBasesChangesComplete(PhoneBases pb) {
+    if (pb->changesLost) {
+        return false;
+    }
+
+    PhoneBasesNode ptr = pb->basesList;
+    while (ptr != NULL) {
+        if (ptr->baseInfo.checkpointed
+            && !phfwdChangesComplete(ptr->baseInfo.base)) {
+            return false;
+        }
+        ptr = ptr->next;
+    }
+    return true;
+}
+
+void phoneBasesClearChanges(PhoneBases pb) {
+    vectorClear(pb->removedIds);
+    pb->changesLost = false;
+
+    PhoneBasesNode ptr = pb->basesList;
+    while (ptr != NULL) {
+        ptr->baseInfo.checkpointed = true;
+        phfwdClearChanges(ptr->baseInfo.base);
+        ptr = ptr->next;
+    }
+}
@@ -72,5 +72,59 @@ struct PhoneForward *phoneBasesAddBase(PhoneBases pb, const char *id);
  */
 bool phoneBasesDelBase(PhoneBases pb, const char *id);
 
+/**
+ * @brief Przegląda bazy przekierowań.
+ * Dla każdej bazy wywołuje f(identyfikator_bazy, baza, data).
+ * Przeglądanie zostaje przerwane, jeżeli @p f zwróci false.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in] f - wskaźnik na funkcję przetwarzającą bazę.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p f.
+ * @return true jeżeli przejrzano wszystkie bazy, false w przeciwnym przypadku.
+ */
+bool phoneBasesForEach(PhoneBases pb,
+                       bool (*f)(const char *, struct PhoneForward *, void *),
+                       void *data);
+
+/**
+ * @brief Przegląda zmiany baz przekierowań.
+ * Przegląda zmiany wykonane od ostatniego wywołania
+ * @ref phoneBasesClearChanges (lub od utworzenia struktury).
+ * Najpierw dla każdej usuniętej bazy, która wtedy istniała, wywołuje
+ * removed(identyfikator_bazy, data), a następnie dla każdej bazy nowej
+ * lub zmienionej wywołuje changed(identyfikator_bazy, baza, czy_nowa, data).
+ * Zmiany w bazie, która nie jest nowa, można przejrzeć przy pomocy
+ * @ref phfwdForEachChange. Przeglądanie zostaje przerwane, jeżeli któraś
+ * z funkcji zwróci false.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in] removed - wskaźnik na funkcję przetwarzającą usuniętą bazę.
+ * @param[in] changed - wskaźnik na funkcję przetwarzającą zmienioną bazę.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p removed i @p changed.
+ * @return true jeżeli przejrzano wszystkie zmiany, false w przeciwnym
+ *         przypadku.
+ */
+bool phoneBasesForEachChange(PhoneBases pb,
+                             bool (*removed)(const char *, void *),
+                             bool (*changed)(const char *,
+                                             struct PhoneForward *,
+                                             bool, void *),
+                             void *data);
+
+/**
+ * @brief Sprawdza czy wszystkie zmiany zostały zapamiętane.
+ * @see phfwdChangesComplete
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @return true jeżeli @ref phoneBasesForEachChange opisuje wszystkie zmiany,
+ *         false w przeciwnym przypadku.
+ */
+bool phoneBasesChangesComplete(PhoneBases pb);
+
+/**
+ * @brief Zapomina zmiany.
+ * Po wykonaniu aktualny stan baz jest punktem odniesienia dla
+ * @ref phoneBasesForEachChange.
+ * @param[in, out] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ */
+void phoneBasesClearChanges(PhoneBases pb);
+
 
 #endif //TELEFONY_PHONE_BASES_SYSTEM_H
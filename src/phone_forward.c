@@ -6,18 +6,52 @@
  * @date 06.05.2018
  */
 
+#define _XOPEN_SOURCE 700
+
 #include <assert.h>
+#include <math.h>
+#include <pthread.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <time.h>
 #include "phone_forward.h"
 #include "radix_tree.h"
 #include "list.h"
 #include "text.h"
 #include "character.h"
+#include "vector.h"
+#include "fan_in.h"
+#include "timer_wheel.h"
+#include "probes.h"
+#include "suffix_rank.h"
+
+/**
+ * @brief Liczba pasów blokad struktury PhoneForward.
+ * Pas odpowiada poddrzewu korzenia drzew PhoneForward->forward
+ * i PhoneForward->backward, czyli pierwszej cyfrze numeru.
+ */
+#define PHFWD_STRIPES_NUMBER RADIX_TREE_NUMBER_OF_SONS
+
+/**
+ * @brief Maska wszystkich pasów blokad.
+ */
+#define PHFWD_ALL_STRIPES ((1u << PHFWD_STRIPES_NUMBER) - 1)
+
+/**
+ * @brief Liczba znaków porównywanych bezpośrednio przy porównaniu dwóch
+ * różnych sufiksów numeru.
+ * Jeżeli nie rozstrzygają one porównania, to wyznaczane są pozycje
+ * wszystkich sufiksów numeru (@ref suffixRanks).
+ */
+#define PHFWD_ROPE_SCAN 64
 
 /**
  * @brief Struktura przechowująca przekierowania numerów telefonów.
+ * Operacje na numerach o różnych pierwszych cyfrach mogą być wykonywane
+ * równolegle: każda operacja blokuje pasy (@p stripes) wszystkich poddrzew
+ * korzeni, które odczytuje lub zmienia, zawsze w kolejności rosnących
+ * numerów pasów, co wyklucza zakleszczenie.
  */
 struct PhoneForward {
     /**
@@ -40,6 +74,80 @@ struct PhoneForward {
      * Sam węzeł reprezentuje numer.
      */
     RadixTree backward;
+
+    /**
+     * @brief Prefiksy usunięte od ostatniego wywołania phfwdClearChanges.
+     * Kolejne prefiksy są zakończone znakiem '\0'.
+     * @see phfwdForEachChange
+     */
+    Vector removed;
+
+    /**
+     * @brief Czy nie udało się zapamiętać którejś ze zmian.
+     * @see phfwdChangesComplete
+     */
+    bool changesLost;
+
+    /**
+     * @brief Blokady pasów.
+     * Pas i chroni i-te poddrzewa korzeni drzew @p forward i @p backward.
+     */
+    pthread_mutex_t stripes[PHFWD_STRIPES_NUMBER];
+
+    /**
+     * @brief Chroni @p removed i @p changesLost przed równoczesnymi
+     * usunięciami w różnych pasach.
+     */
+    pthread_mutex_t changesLock;
+
+    /**
+     * @brief Ranking węzłów drzewa @p backward według liczby przekierowań
+     * na nie.
+     * @see phfwdForEachTopTarget
+     */
+    FanIn fanIn;
+
+    /**
+     * @brief Chroni @p fanIn przed równoczesnymi zmianami w różnych pasach.
+     */
+    pthread_mutex_t fanInLock;
+
+    /**
+     * @brief Koło czasowe terminów wygaśnięcia przekierowań.
+     * Tworzone przy dodaniu pierwszego wygasającego przekierowania.
+     * Dane terminu to węzeł drzewa @p forward.
+     * @see phfwdAddExpiring
+     */
+    TimerWheel expiry;
+
+    /**
+     * @brief Bieżący czas logiczny.
+     * @see phfwdAdvanceClock
+     */
+    uint64_t clock;
+
+    /**
+     * @brief Chroni @p expiry przed równoczesnymi zmianami w różnych pasach.
+     * Przesuwanie czasu blokuje wszystkie pasy, więc nie potrzebuje tej
+     * blokady.
+     */
+    pthread_mutex_t expiryLock;
+
+    /**
+     * @brief Czy phfwdGet zlicza użycia przekierowań.
+     * Zmieniane przy zablokowanych wszystkich pasach.
+     * @see phfwdSetHitCounting
+     */
+    bool countHits;
+
+    /**
+     * @brief Drzewo obserwowanych numerów.
+     * Jego węzły przechowują listy obserwatorów (PhoneForwardWatch)
+     * numeru reprezentowanego przez węzeł. Pas i chroni również i-te
+     * poddrzewo korzenia tego drzewa.
+     * @see phfwdWatch
+     */
+    RadixTree watch;
 };
 
 /**
@@ -48,6 +156,8 @@ struct PhoneForward {
 struct PhoneNumbers {
     /**
      * @brief Tablica wskaźników na numery.
+     * Numer zapisany jako prefiks i sufiks zapytania ma wartość NULL
+     * do pierwszego wywołania phnumGet.
      */
     char **numbers;
 
@@ -55,20 +165,104 @@ struct PhoneNumbers {
      * @brief Liczba numerów.
      */
     size_t howMany;
+
+    /**
+     * @brief Tablica prefiksów numerów (NULL oznacza prefiks pusty)
+     * lub NULL, jeżeli wszystkie numery są zapisane w numbers.
+     * Numer i to prefixes[i] z dopisanym query + suffixes[i].
+     */
+    char **prefixes;
+
+    /**
+     * @brief Tablica pozycji w query, od których zaczynają się
+     * sufiksy numerów.
+     */
+    size_t *suffixes;
+
+    /**
+     * @brief Kopia numeru zapytania, wspólna dla wszystkich numerów.
+     */
+    char *query;
+
+    /**
+     * @brief Długość query.
+     */
+    size_t queryLength;
+
+    /**
+     * @brief Pozycje sufiksów query (@ref suffixRanks) wyznaczane
+     * w trakcie sortowania lub NULL.
+     */
+    size_t *ranks;
 };
 
 /**
- * @brief Tworzy strukturę do przechowywania numerów.
+ * @brief Obserwator numeru.
+ * Obserwatorzy tego samego numeru tworzą listę dwukierunkową przechowywaną
+ * w węźle drzewa PhoneForward->watch reprezentującym ten numer.
+ * @see phfwdWatch
+ */
+struct PhoneForwardWatch {
+    /**
+     * @brief Obserwowany numer.
+     */
+    char *num;
+
+    /**
+     * @brief Węzeł drzewa PhoneForward->watch reprezentujący @p num.
+     */
+    RadixTreeNode node;
+
+    /**
+     * @brief Przekierowanie wyznaczające wynik phfwdGet dla @p num lub NULL,
+     * jeżeli żaden prefiks @p num nie jest przekierowany.
+     * Służy tylko do porównań: każda zmiana, po której wskaźnik mógłby stać
+     * się nieaktualny, uaktualnia go.
+     */
+    struct ForwardData *rule;
+
+    /**
+     * @brief Funkcja powiadamiana o zmianie.
+     */
+    void (*f)(const char *, void *);
+
+    /**
+     * @brief Dane do funkcji @p f.
+     */
+    void *data;
+
+    /**
+     * @brief Poprzedni obserwator numeru lub NULL.
+     */
+    struct PhoneForwardWatch *previous;
+
+    /**
+     * @brief Następny obserwator numeru lub NULL.
+     */
+    struct PhoneForwardWatch *next;
+};
+
+/**
+ * @brief Tworzy strukturę do przechowywania numerów, doliczając
+ * zaalokowane bloki pamięci do @p stats.
  * @param[in] howMany - ilość przechowywanych numerów.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
  * @return Wskaźnik na strukturę do przechowywania @p howMany numerów,
  *         NULL w przypadku problemów z pamięcią.
  */
-static struct PhoneNumbers *phfwdCreatePhoneNumbersStructure(size_t howMany) {
+static struct PhoneNumbers *
+phfwdCreatePhoneNumbersStructureCounted(size_t howMany,
+                                        struct RadixTreeStats *stats) {
     struct PhoneNumbers *result = malloc(sizeof(struct PhoneNumbers));
     if (result == NULL) {
         return NULL;
     } else {
         result->howMany = howMany;
+        result->prefixes = NULL;
+        result->suffixes = NULL;
+        result->query = NULL;
+        result->queryLength = 0;
+        result->ranks = NULL;
         result->numbers = malloc(result->howMany * sizeof(char *));
         if (result->numbers == NULL) {
             free(result);
@@ -78,11 +272,24 @@ static struct PhoneNumbers *phfwdCreatePhoneNumbersStructure(size_t howMany) {
             for (i = 0; i < result->howMany; i++) {
                 result->numbers[i] = NULL;
             }
+            if (stats != NULL) {
+                stats->allocations += 2;
+            }
             return result;
         }
     }
 }
 
+/**
+ * @brief Tworzy strukturę do przechowywania numerów.
+ * @param[in] howMany - ilość przechowywanych numerów.
+ * @return Wskaźnik na strukturę do przechowywania @p howMany numerów,
+ *         NULL w przypadku problemów z pamięcią.
+ */
+static struct PhoneNumbers *phfwdCreatePhoneNumbersStructure(size_t howMany) {
+    return phfwdCreatePhoneNumbersStructureCounted(howMany, NULL);
+}
+
 /**
  * @brief Tworzy strukturę przechowującą zero numerów.
  * @see phfwdCreatePhoneNumbersStructure.
@@ -94,6 +301,49 @@ static struct PhoneNumbers *phfwdEmptySequenceResult() {
     return result;
 }
 
+/**
+ * @brief Tworzy strukturę do przechowywania numerów zapisanych jako prefiks
+ * i sufiks numeru @p num.
+ * Kopiuje @p num raz, a wszystkie prefiksy są puste.
+ * @see phfwdCreatePhoneNumbersStructure.
+ * @param[in] howMany - ilość przechowywanych numerów.
+ * @param[in] num - wskaźnik na numer zapytania.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ * @return Wskaźnik na strukturę do przechowywania @p howMany numerów,
+ *         NULL w przypadku problemów z pamięcią.
+ */
+static struct PhoneNumbers *phfwdCreateRopeStructure(size_t howMany,
+                                                     const char *num,
+                                                     struct RadixTreeStats *stats) {
+    struct PhoneNumbers *result =
+            phfwdCreatePhoneNumbersStructureCounted(howMany, stats);
+    if (result == NULL) {
+        return NULL;
+    }
+    result->prefixes = malloc(howMany * sizeof(char *));
+    result->suffixes = malloc(howMany * sizeof(size_t));
+    result->queryLength = strlen(num);
+    result->query = malloc(result->queryLength + 1);
+    if (result->prefixes == NULL || result->suffixes == NULL
+        || result->query == NULL) {
+        free(result->prefixes);
+        result->prefixes = NULL;
+        phnumDelete(result);
+        return NULL;
+    }
+    memcpy(result->query, num, result->queryLength + 1);
+    if (stats != NULL) {
+        stats->allocations += 3;
+    }
+
+    size_t i;
+    for (i = 0; i < howMany; i++) {
+        result->prefixes[i] = NULL;
+        result->suffixes[i] = 0;
+    }
+    return result;
+}
+
 
 struct PhoneForward *phfwdNew(void) {
     struct PhoneForward *result = malloc(sizeof(struct PhoneForward));
@@ -112,7 +362,45 @@ struct PhoneForward *phfwdNew(void) {
                 free(result);
                 return NULL;
             } else {
-                return result;
+                result->removed = vectorCreate();
+                if (result->removed == NULL) {
+                    radixTreeDelete(result->forward,
+                                    radixTreeEmptyDelFunction, NULL);
+                    radixTreeDelete(result->backward,
+                                    radixTreeEmptyDelFunction, NULL);
+                    free(result);
+                    return NULL;
+                } else if ((result->fanIn = fanInCreate()) == NULL) {
+                    vectorDelete(result->removed);
+                    radixTreeDelete(result->forward,
+                                    radixTreeEmptyDelFunction, NULL);
+                    radixTreeDelete(result->backward,
+                                    radixTreeEmptyDelFunction, NULL);
+                    free(result);
+                    return NULL;
+                } else if ((result->watch = radixTreeCreate()) == NULL) {
+                    fanInDelete(result->fanIn);
+                    vectorDelete(result->removed);
+                    radixTreeDelete(result->forward,
+                                    radixTreeEmptyDelFunction, NULL);
+                    radixTreeDelete(result->backward,
+                                    radixTreeEmptyDelFunction, NULL);
+                    free(result);
+                    return NULL;
+                } else {
+                    result->changesLost = false;
+                    result->expiry = NULL;
+                    result->clock = 0;
+                    result->countHits = false;
+                    size_t i;
+                    for (i = 0; i < PHFWD_STRIPES_NUMBER; i++) {
+                        pthread_mutex_init(&result->stripes[i], NULL);
+                    }
+                    pthread_mutex_init(&result->changesLock, NULL);
+                    pthread_mutex_init(&result->fanInLock, NULL);
+                    pthread_mutex_init(&result->expiryLock, NULL);
+                    return result;
+                }
             }
         }
     }
@@ -148,12 +436,43 @@ static void phfwdBackwardJustDelete(void *ptrA, void *ptrB) {
     listDestroy(ptrA);
 }
 
+/**
+ * @brief Do usuwania drzewa PhoneForward->watch.
+ * @see PhoneForward
+ * @see radixTreeDelete
+ * @param[in] ptrA - wskaźnik na pierwszego obserwatora listy do usunięcia.
+ * @param ptrB - nieużywany wskaźnik (powinien wskazywać na NULL).
+ */
+static void phfwdWatchJustDelete(void *ptrA, void *ptrB) {
+    assert(ptrA != NULL);
+    assert(ptrB == NULL);
+    (void) ptrB;
+    struct PhoneForwardWatch *watch = ptrA;
+    while (watch != NULL) {
+        struct PhoneForwardWatch *next = watch->next;
+        free(watch->num);
+        free(watch);
+        watch = next;
+    }
+}
+
 void phfwdDelete(struct PhoneForward *pf) {
     if (pf == NULL) {
         return;
     } else {
         radixTreeDelete(pf->forward, phfwdForwardJustDelete, NULL);
         radixTreeDelete(pf->backward, phfwdBackwardJustDelete, NULL);
+        radixTreeDelete(pf->watch, phfwdWatchJustDelete, NULL);
+        vectorDelete(pf->removed);
+        fanInDelete(pf->fanIn);
+        timerWheelDelete(pf->expiry);
+        size_t i;
+        for (i = 0; i < PHFWD_STRIPES_NUMBER; i++) {
+            pthread_mutex_destroy(&pf->stripes[i]);
+        }
+        pthread_mutex_destroy(&pf->changesLock);
+        pthread_mutex_destroy(&pf->fanInLock);
+        pthread_mutex_destroy(&pf->expiryLock);
         free(pf);
     }
 }
@@ -222,6 +541,7 @@ static ListNode phfwdPrepareBw(RadixTreeNode bw, RadixTreeNode redirection) {
         return NULL;
     } else {
         radixTreeSetData(bw, list);
+        radixTreeSetWeight(bw, radixTreeGetWeight(bw) + 1);
         return result;
     }
 }
@@ -249,8 +569,99 @@ struct ForwardData {
      * @see PhoneForward
      */
     ListNode listNode;
+
+    /**
+     * @brief Pas, w którym znajduje się węzeł @p treeNode.
+     */
+    unsigned int stripe;
+
+    /**
+     * @brief Pozycja węzła @p treeNode w rankingu PhoneForward->fanIn,
+     * wspólna dla wszystkich przekierowań na ten węzeł.
+     */
+    FanInEntry fanIn;
+
+    /**
+     * @brief Termin wygaśnięcia przekierowania w kole PhoneForward->expiry
+     * lub NULL, jeżeli przekierowanie nie wygasa.
+     */
+    TimerWheelEntry expiry;
+
+    /**
+     * @brief Liczba wyników phfwdGet wyznaczonych przez to przekierowanie.
+     * Zmieniana tylko przy zablokowanym pasie węzła przekierowywanego,
+     * więc zliczanie w różnych pasach nie rywalizuje o wspólne dane.
+     * @see phfwdSetHitCounting
+     */
+    uint64_t hits;
 };
 
+/**
+ * @param[in] num - wskaźnik na poprawny numer.
+ * @return Maska pasa zawierającego numer @p num.
+ */
+static unsigned int phfwdStripeOf(const char *num) {
+    return 1u << (unsigned int) (num[0] - '0');
+}
+
+/**
+ * @brief Blokuje pasy w kolejności rosnących numerów.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] mask - maska blokowanych pasów.
+ */
+static void phfwdLockStripes(struct PhoneForward *pf, unsigned int mask) {
+    unsigned int i;
+    for (i = 0; i < PHFWD_STRIPES_NUMBER; i++) {
+        if (mask & (1u << i)) {
+            pthread_mutex_lock(&pf->stripes[i]);
+        }
+    }
+}
+
+/**
+ * @brief Odblokowuje pasy.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] mask - maska odblokowywanych pasów.
+ */
+static void phfwdUnlockStripes(struct PhoneForward *pf, unsigned int mask) {
+    unsigned int i;
+    for (i = 0; i < PHFWD_STRIPES_NUMBER; i++) {
+        if (mask & (1u << i)) {
+            pthread_mutex_unlock(&pf->stripes[i]);
+        }
+    }
+}
+
+/**
+ * @brief Blokuje pasy potrzebne operacji.
+ * Blokuje pasy @p mask, a następnie sprawdza funkcją @p needed, czy
+ * operacja nie sięga do innych pasów (np. przez dane wskazujące na węzły
+ * drugiego drzewa). Jeżeli sięga, zwalnia blokady i blokuje powiększony
+ * zbiór pasów w kolejności rosnących numerów. Maska tylko rośnie, więc
+ * powtórzeń jest co najwyżej PHFWD_STRIPES_NUMBER.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] mask - maska pasów wynikająca z argumentów operacji.
+ * @param[in] needed - funkcja wyznaczająca dodatkowe pasy przy
+ *        zablokowanych pasach @p mask.
+ * @param[in] num - numer przekazywany funkcji @p needed.
+ * @return Maska zablokowanych pasów.
+ */
+static unsigned int phfwdLockValidated(struct PhoneForward *pf,
+                                       unsigned int mask,
+                                       unsigned int (*needed)(
+                                               struct PhoneForward *,
+                                               const char *),
+                                       const char *num) {
+    phfwdLockStripes(pf, mask);
+    unsigned int required;
+    while ((required = mask | needed(pf, num)) != mask) {
+        phfwdUnlockStripes(pf, mask);
+        mask = required;
+        phfwdLockStripes(pf, mask);
+    }
+    return mask;
+}
+
 /**
  * @brief Do balansowania drzewa w przypadku nieudanego wstawienia.
  * Usuwa zbyteczne węzły.
@@ -265,17 +676,24 @@ static void phfwdPrepareClean(RadixTreeNode fwInsert, RadixTreeNode bwInsert) {
 
 /**
  * @brief Usuwa odwrócone przekierowanie.
- * Usuwa informacje o przekierowaniu z drzewa PhoneForward->backward.
+ * Usuwa informacje o przekierowaniu z drzewa PhoneForward->backward
+ * i zmniejsza licznik jego celu w rankingu PhoneForward->fanIn.
  * @see ForwardData
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
  * @param[in] fd - informacje o przekierowaniu.
  */
-static void phfwdDeleteNodeFromBackwardTree(ForwardData fd) {
+static void phfwdDeleteNodeFromBackwardTree(struct PhoneForward *pf,
+                                            ForwardData fd) {
     assert(fd != NULL);
     assert(fd->treeNode != NULL);
     assert(fd->listNode != NULL);
+    pthread_mutex_lock(&pf->fanInLock);
+    fanInDecrement(pf->fanIn, fd->fanIn);
+    pthread_mutex_unlock(&pf->fanInLock);
     List list = radixTreeGetNodeData(fd->treeNode);
     assert(list != NULL);
     listDeleteNode(fd->listNode);
+    radixTreeSetWeight(fd->treeNode, radixTreeGetWeight(fd->treeNode) - 1);
     if (listIsEmpty(list)) {
         listDestroy(list);
         radixTreeSetData(fd->treeNode, NULL);
@@ -283,23 +701,84 @@ static void phfwdDeleteNodeFromBackwardTree(ForwardData fd) {
     }
 }
 
+/**
+ * @brief Anuluje termin wygaśnięcia przekierowania.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in, out] fd - informacje o przekierowaniu.
+ */
+static void phfwdCancelExpiry(struct PhoneForward *pf, ForwardData fd) {
+    if (fd->expiry != NULL) {
+        pthread_mutex_lock(&pf->expiryLock);
+        timerWheelCancel(pf->expiry, fd->expiry);
+        pthread_mutex_unlock(&pf->expiryLock);
+        fd->expiry = NULL;
+    }
+}
+
+/**
+ * @brief Wyznacza pozycję węzła drzewa PhoneForward->backward w rankingu.
+ * Pozycja jest przechowywana w danych każdego przekierowania na węzeł.
+ * @param[in] bw - wskaźnik na węzeł.
+ * @return Pozycja węzła lub NULL, jeżeli nic nie jest na niego
+ *         przekierowane.
+ */
+static FanInEntry phfwdFanInOf(RadixTreeNode bw) {
+    List list = radixTreeGetNodeData(bw);
+    if (list == NULL || listIsEmpty(list)) {
+        return NULL;
+    } else {
+        RadixTreeNode source = listNodeGetValue(listFirstNode(list));
+        ForwardData fd = radixTreeGetNodeData(source);
+        return fd->fanIn;
+    }
+}
+
 /**
  * @brief Wstawia dane o przekierowaniach do węzłów.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
  * @param[in] fwInsert - wskaźnik na węzeł do wstawienia danych w drzewie
  *        PhoneForward->forward.
  * @param[in] bwInsert wskaźnik na węzeł do wstawienia danych w drzewie
  *        PhoneForward->backward.
+ * @param[in] stripe - numer pasu zawierającego węzeł @p bwInsert.
+ * @param[in] expiresAt - termin wygaśnięcia lub PHFWD_NO_EXPIRY.
  * @return W przypadku sukcesu zwraca true, w przeciwnym przypadku false.
  */
-static bool phfwdAddSetNodes(RadixTreeNode fwInsert, RadixTreeNode bwInsert) {
+static bool phfwdAddSetNodes(struct PhoneForward *pf, RadixTreeNode fwInsert,
+                             RadixTreeNode bwInsert, unsigned int stripe,
+                             uint64_t expiresAt) {
+    FanInEntry fanIn = phfwdFanInOf(bwInsert);
     ListNode newNode = phfwdPrepareBw(bwInsert, fwInsert);
     if (newNode == NULL) {
         phfwdPrepareClean(fwInsert, bwInsert);
         return false;
     } else {
         ForwardData fd = malloc(sizeof(struct ForwardData));
+        if (fd != NULL) {
+            pthread_mutex_lock(&pf->fanInLock);
+            fanIn = fanInIncrement(pf->fanIn, fanIn, bwInsert);
+            pthread_mutex_unlock(&pf->fanInLock);
+            if (fanIn == NULL) {
+                free(fd);
+                fd = NULL;
+            }
+        }
+        TimerWheelEntry expiry = NULL;
+        if (fd != NULL && expiresAt != PHFWD_NO_EXPIRY) {
+            pthread_mutex_lock(&pf->expiryLock);
+            expiry = timerWheelAdd(pf->expiry, expiresAt, fwInsert);
+            pthread_mutex_unlock(&pf->expiryLock);
+            if (expiry == NULL) {
+                pthread_mutex_lock(&pf->fanInLock);
+                fanInDecrement(pf->fanIn, fanIn);
+                pthread_mutex_unlock(&pf->fanInLock);
+                free(fd);
+                fd = NULL;
+            }
+        }
         if (fd == NULL) {
             listDeleteNode(newNode);
+            radixTreeSetWeight(bwInsert, radixTreeGetWeight(bwInsert) - 1);
             List list = radixTreeGetNodeData(bwInsert);
             if (listIsEmpty(list)) {
                 listDestroy(list);
@@ -310,13 +789,18 @@ static bool phfwdAddSetNodes(RadixTreeNode fwInsert, RadixTreeNode bwInsert) {
         } else {
             ForwardData old = radixTreeGetNodeData(fwInsert);
             if (old != NULL) {
-                phfwdDeleteNodeFromBackwardTree(old);
+                phfwdCancelExpiry(pf, old);
+                phfwdDeleteNodeFromBackwardTree(pf, old);
                 free(old);
                 radixTreeSetData(fwInsert, NULL);
             }
 
             fd->treeNode = bwInsert;
             fd->listNode = newNode;
+            fd->stripe = stripe;
+            fd->fanIn = fanIn;
+            fd->expiry = expiry;
+            fd->hits = 0;
             radixTreeSetData(fwInsert, fd);
 
             return true;
@@ -328,71 +812,29 @@ static bool phfwdAddSetNodes(RadixTreeNode fwInsert, RadixTreeNode bwInsert) {
 }
 
 /**
- * @brief Sprawdza czy @p num1 to poprawny numer.
- * @param[in] num1 - wskaźnik na numer.
- * @return Jeżeli odpowiedź jest pozytywna to true,
- *         w przeciwnym przypadku false.
- */
-static bool phfwdIsNumber(const char *num1) {
-    if (num1 == NULL || *num1 == '\0') {
-        return false;
-    } else {
-        const char *ptr = num1;
-        while (*ptr != '\0') {
-            if (!(characterIsDigit(*ptr))) {
-                return false;
-            }
-            ptr++;
-        }
-        return true;
-    }
-}
-
-bool phfwdAdd(struct PhoneForward *pf, const char *num1, const char *num2) {
-    if (!phfwdIsNumber(num1) || !phfwdIsNumber(num2)
-        || strcmp(num1, num2) == 0) {
-        return false;
-    } else {
-        RadixTree fwInsert;
-        RadixTree bwInsert;
-        return phfwdPrepareTreesForAdd(pf, num1, num2, &fwInsert, &bwInsert)
-               && phfwdAddSetNodes(fwInsert, bwInsert);
-    }
-
-}
-
-/**
- * @brief Usuwa odpowiedniki danych z PhoneForward->forward w backward.
- * Używany w radixTreeDeleteSubTree.
- * @see radixTreeDeleteSubTree
- * @see phfwdRemove
- * @param[in] data - wskaźnik na dane z węzła drzewa PhoneForward->forward.
- * @param[in] backwardTree - wskaźnik na drzewo PhoneForward->backward.
+ * @brief Poprawia wskaźniki dla phfwdGetNumber, doliczając koszt
+ * przejścia do @p stats.
+ * @see phfwdSetPointersForGettingText
+ * @param[in] tree - wskaźnik na drzewo numerów.
+ * @param[in] num - wskaźnik na tekst reprezentujący numer.
+ * @param[out] ptr - jak w @ref phfwdSetPointersForGettingText.
+ * @param[out] matchedTxt - jak w @ref phfwdSetPointersForGettingText.
+ * @param[in, out] stats - wskaźnik na licznik kosztu przejścia lub NULL.
  */
-static void phfwdRemoveCleaner(void *data, void *backwardTree) {
-    assert(data != NULL);
-    assert(backwardTree != NULL);
-    (void) backwardTree;
-    ForwardData fd = (ForwardData) data;
-    phfwdDeleteNodeFromBackwardTree(fd);
-    free(fd);
-
-}
-
-void phfwdRemove(struct PhoneForward *pf, const char *num) {
-    if (!phfwdIsNumber(num)) {
-        return;
-    } else {
-        RadixTreeNode subTreeNode;
-        int findResult = radixTreeFindLite(pf->forward, num, &subTreeNode);
+static void
+phfwdSetPointersForGettingTextCounted(RadixTree tree, const char *num,
+                                      RadixTreeNode *ptr,
+                                      const char **matchedTxt,
+                                      struct RadixTreeStats *stats) {
+    size_t nodeMatch = 0;
+    int matchMode;
+    int findResult = radixTreeFindCounted(tree, num, ptr, matchedTxt,
+                                          &nodeMatch, &matchMode, stats);
+    if (findResult != RADIX_TREE_FOUND
+        && (matchMode != RADIX_TREE_NODE_MATCH_FULL)) {
 
-        if (findResult == RADIX_TREE_FOUND
-            || findResult == RADIX_TREE_SUBSTR) {
-            radixTreeDeleteSubTree(subTreeNode, phfwdRemoveCleaner,
-                                   pf->backward);
-        } else {
-            return;
-        }
+        *matchedTxt = (*matchedTxt) - nodeMatch;
+        *ptr = radixTreeFather(*ptr);
     }
 }
 
@@ -416,68 +858,564 @@ static void
 phfwdSetPointersForGettingText(RadixTree tree,
                                const char *num, RadixTreeNode *ptr,
                                const char **matchedTxt) {
-    size_t nodeMatch = 0;
-    int matchMode;
-    int findResult = radixTreeFind(tree, num, ptr, matchedTxt,
-                                   &nodeMatch, &matchMode);
-    if (findResult != RADIX_TREE_FOUND
-        && (matchMode != RADIX_TREE_NODE_MATCH_FULL)) {
-
-        *matchedTxt = (*matchedTxt) - nodeMatch;
-        *ptr = radixTreeFather(*ptr);
-    }
+    phfwdSetPointersForGettingTextCounted(tree, num, ptr, matchedTxt, NULL);
 }
 
 /**
- * @brief Pobiera przekierowany numer.
+ * @brief Znajduje węzeł najdłuższego przekierowanego prefiksu numeru.
  * @param[in] forward - wskaźnik na węzeł reprezentujący drzewo.
  * @param[in] num - wskaźnik na numer.
- * @return Przekierowany numer.
+ * @param[out] ptr - wskaźnik na węzeł z przekierowaniem lub na korzeń,
+ *        jeżeli żaden prefiks nie jest przekierowany.
+ * @param[out] matchedTxt - wskaźnik na część @p num następującą po
+ *        prefiksie reprezentowanym przez @p ptr.
  */
-static const char *phfwdGetNumber(RadixTree forward, const char *num) {
-    RadixTreeNode ptr;
-    const char *matchedTxt;
+static void phfwdFindRedirection(RadixTree forward, const char *num,
+                                 RadixTreeNode *ptr, const char **matchedTxt) {
+    phfwdSetPointersForGettingText(forward, num, ptr, matchedTxt);
 
-    phfwdSetPointersForGettingText(forward, num, &ptr, &matchedTxt);
+    RadixTreeNode redirection = radixTreeDataAncestor(forward, *ptr);
+    *ptr = redirection == NULL ? forward : redirection;
+    *matchedTxt = num + radixTreeTextLength(*ptr);
+}
 
-    while (!radixTreeIsRoot(ptr) && radixTreeGetNodeData(ptr) == NULL) {
-        matchedTxt = matchedTxt - radixTreeHowManyChars(ptr);
-        ptr = radixTreeFather(ptr);
-    }
-    char *result = NULL;
-    if (radixTreeIsRoot(ptr)) {
-        assert(matchedTxt == num);
-        result = malloc(strlen(matchedTxt) + (size_t) 1);
-        if (result == NULL) {
-            return NULL;
+/**
+ * @brief Sprawdza czy @p num1 to poprawny numer.
+ * @param[in] num1 - wskaźnik na numer.
+ * @return Jeżeli odpowiedź jest pozytywna to true,
+ *         w przeciwnym przypadku false.
+ */
+static bool phfwdIsNumber(const char *num1) {
+    if (num1 == NULL || *num1 == '\0') {
+        return false;
+    } else {
+        const char *ptr = num1;
+        while (*ptr != '\0') {
+            if (!(characterIsDigit(*ptr))) {
+                return false;
+            }
+            ptr++;
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Wyznacza przekierowanie, które wyznacza wynik phfwdGet dla numeru.
+ * @param[in] forward - wskaźnik na drzewo PhoneForward->forward.
+ * @param[in] num - wskaźnik na numer.
+ * @return Informacje o przekierowaniu lub NULL, jeżeli żaden prefiks
+ *         @p num nie jest przekierowany.
+ */
+static ForwardData phfwdRuleOf(RadixTree forward, const char *num) {
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+
+    phfwdFindRedirection(forward, num, &ptr, &matchedTxt);
+    return radixTreeIsRoot(ptr) ? NULL : radixTreeGetNodeData(ptr);
+}
+
+/**
+ * @brief Powiadamia obserwatorów numeru, jeżeli jego przekierowanie się
+ * zmieniło.
+ * @see radixTreeFoldNodes
+ * @param[in] node - węzeł drzewa PhoneForward->watch z przypisanymi danymi.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ */
+static void phfwdNotifyVisit(RadixTreeNode node, void *pf) {
+    struct PhoneForwardWatch *watch = radixTreeGetNodeData(node);
+    ForwardData rule = phfwdRuleOf(((struct PhoneForward *) pf)->forward,
+                                   watch->num);
+    for (; watch != NULL; watch = watch->next) {
+        if (watch->rule != rule) {
+            watch->rule = rule;
+            watch->f(watch->num, watch->data);
+        }
+    }
+}
+
+/**
+ * @brief Powiadamia obserwatorów numerów z prefiksem @p prefix, których
+ * przekierowanie się zmieniło.
+ * Po zmianie przekierowań z prefiksem @p prefix wynik phfwdGet może się
+ * zmienić tylko dla numerów z tym prefiksem, dlatego wystarczy sprawdzić
+ * poddrzewo drzewa PhoneForward->watch, a zmiany w nieobserwowanych
+ * poddrzewach kosztują jedno wyszukiwanie. Wymaga zablokowanego pasu
+ * @p prefix.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] prefix - wskaźnik na zmieniony prefiks lub NULL, jeżeli należy
+ *        sprawdzić wszystkich obserwatorów (wymaga zablokowania wszystkich
+ *        pasów).
+ */
+static void phfwdNotifyWatchers(struct PhoneForward *pf, const char *prefix) {
+    RadixTreeNode subTreeNode = pf->watch;
+    if (prefix != NULL) {
+        int findResult = radixTreeFindLite(pf->watch, prefix, &subTreeNode);
+        if (findResult != RADIX_TREE_FOUND
+            && findResult != RADIX_TREE_SUBSTR) {
+            return;
+        }
+    }
+    radixTreeFoldNodes(subTreeNode, phfwdNotifyVisit, pf);
+}
+
+struct PhoneForwardWatch *phfwdWatch(struct PhoneForward *pf, const char *num,
+                                     void (*f)(const char *, void *),
+                                     void *data) {
+    if (!phfwdIsNumber(num) || f == NULL) {
+        return NULL;
+    }
+
+    struct PhoneForwardWatch *watch = malloc(sizeof(struct PhoneForwardWatch));
+    if (watch == NULL) {
+        return NULL;
+    }
+    watch->num = malloc(strlen(num) + (size_t) 1);
+    if (watch->num == NULL) {
+        free(watch);
+        return NULL;
+    }
+    strcpy(watch->num, num);
+    watch->f = f;
+    watch->data = data;
+    watch->previous = NULL;
+
+    unsigned int mask = phfwdStripeOf(num);
+    phfwdLockStripes(pf, mask);
+    watch->node = radixTreeInsert(pf->watch, num);
+    if (watch->node == NULL) {
+        phfwdUnlockStripes(pf, mask);
+        free(watch->num);
+        free(watch);
+        return NULL;
+    }
+    watch->rule = phfwdRuleOf(pf->forward, num);
+    watch->next = radixTreeGetNodeData(watch->node);
+    if (watch->next != NULL) {
+        watch->next->previous = watch;
+    }
+    radixTreeSetData(watch->node, watch);
+    phfwdUnlockStripes(pf, mask);
+
+    return watch;
+}
+
+void phfwdUnwatch(struct PhoneForward *pf, struct PhoneForwardWatch *watch) {
+    if (watch == NULL) {
+        return;
+    }
+
+    unsigned int mask = phfwdStripeOf(watch->num);
+    phfwdLockStripes(pf, mask);
+    if (watch->previous != NULL) {
+        watch->previous->next = watch->next;
+    } else {
+        radixTreeSetData(watch->node, watch->next);
+    }
+    if (watch->next != NULL) {
+        watch->next->previous = watch->previous;
+    }
+    if (radixTreeGetNodeData(watch->node) == NULL) {
+        radixTreeBalance(watch->node);
+    }
+    phfwdUnlockStripes(pf, mask);
+
+    free(watch->num);
+    free(watch);
+}
+
+/**
+ * @brief Wyznacza pas dotychczasowego przekierowania @p num1.
+ * Zastąpienie przekierowania usuwa jego odwrócenie z pasu, w którym
+ * znajduje się poprzedni cel.
+ * @see phfwdLockValidated
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] num1 - przekierowywany prefiks.
+ * @return Maska pasa poprzedniego celu lub 0.
+ */
+static unsigned int phfwdAddStripes(struct PhoneForward *pf,
+                                    const char *num1) {
+    RadixTreeNode node;
+    if (radixTreeFindLite(pf->forward, num1, &node) == RADIX_TREE_FOUND
+        && radixTreeGetNodeData(node) != NULL) {
+        ForwardData fd = radixTreeGetNodeData(node);
+        return 1u << fd->stripe;
+    }
+    return 0;
+}
+
+/**
+ * @brief Dodaje przekierowanie przy zablokowanych pasach.
+ * Wymaga zablokowanych pasów @p num1, @p num2 i dotychczasowego celu
+ * @p num1 (np. wszystkich pasów).
+ * @see phfwdAddStripes
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] num1 - poprawny prefiks do przekierowania.
+ * @param[in] num2 - poprawny prefiks różny od @p num1, na który zostanie
+ *        przekierowany @p num1.
+ * @param[in] expiresAt - termin wygaśnięcia lub PHFWD_NO_EXPIRY.
+ * @return Wartość @p true, jeśli przekierowanie zostało dodane.
+ */
+static bool phfwdAddLocked(struct PhoneForward *pf, const char *num1,
+                           const char *num2, uint64_t expiresAt) {
+    RadixTree fwInsert;
+    RadixTree bwInsert;
+    bool result = phfwdPrepareTreesForAdd(pf, num1, num2,
+                                          &fwInsert, &bwInsert)
+                  && phfwdAddSetNodes(pf, fwInsert, bwInsert,
+                                      (unsigned int) (num2[0] - '0'),
+                                      expiresAt);
+    if (result) {
+        phfwdNotifyWatchers(pf, num1);
+    }
+    return result;
+}
+
+/**
+ * @brief Dodaje przekierowanie z terminem wygaśnięcia.
+ * @see phfwdAdd
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] num1 - prefiks do przekierowania.
+ * @param[in] num2 - prefiks na który zostanie przekierowany @p num1.
+ * @param[in] expiresAt - termin wygaśnięcia lub PHFWD_NO_EXPIRY.
+ * @return Wartość @p true, jeśli przekierowanie zostało dodane.
+ */
+static bool phfwdAddWithExpiry(struct PhoneForward *pf, const char *num1,
+                               const char *num2, uint64_t expiresAt) {
+    if (!phfwdIsNumber(num1) || !phfwdIsNumber(num2)
+        || strcmp(num1, num2) == 0) {
+        return false;
+    } else {
+        unsigned int mask = phfwdLockValidated(pf, phfwdStripeOf(num1)
+                                                   | phfwdStripeOf(num2),
+                                               phfwdAddStripes, num1);
+        bool result = phfwdAddLocked(pf, num1, num2, expiresAt);
+        phfwdUnlockStripes(pf, mask);
+        return result;
+    }
+
+}
+
+bool phfwdAdd(struct PhoneForward *pf, const char *num1, const char *num2) {
+    PROBE2(add__entry, num1, num2);
+    bool result = phfwdAddWithExpiry(pf, num1, num2, PHFWD_NO_EXPIRY);
+    PROBE1(add__return, result);
+    return result;
+}
+
+bool phfwdAddExpiring(struct PhoneForward *pf, const char *num1,
+                      const char *num2, uint64_t expiresAt) {
+    if (expiresAt != PHFWD_NO_EXPIRY) {
+        pthread_mutex_lock(&pf->expiryLock);
+        if (pf->expiry == NULL) {
+            pf->expiry = timerWheelCreate(pf->clock);
+        }
+        bool created = pf->expiry != NULL;
+        pthread_mutex_unlock(&pf->expiryLock);
+        if (!created) {
+            return false;
+        }
+    }
+    return phfwdAddWithExpiry(pf, num1, num2, expiresAt);
+}
+
+/**
+ * @brief Dane dla funkcji usuwającej wygasłe przekierowania.
+ * Obserwatorzy są powiadamiani dopiero po usunięciu wszystkich wygasłych
+ * przekierowań, więc każdy co najwyżej raz.
+ * @see phfwdAdvanceClock
+ */
+struct ExpireData {
+    /**
+     * @brief Struktura przechowująca przekierowania.
+     */
+    struct PhoneForward *pf;
+
+    /**
+     * @brief Prefiksy usuniętych przekierowań zakończone znakiem '\0'
+     * lub NULL.
+     */
+    Vector expired;
+
+    /**
+     * @brief Czy nie udało się zapamiętać któregoś z prefiksów.
+     */
+    bool expiredLost;
+};
+
+/**
+ * @brief Usuwa wygasłe przekierowanie.
+ * Usuwa tylko przekierowanie z węzła @p node (nie jego poddrzewo)
+ * i zapamiętuje zmianę dla @ref phfwdForEachChange: prefiks jako usunięty
+ * oraz poddrzewo węzła jako zmienione, co odtwarza pozostałe
+ * przekierowania z tym prefiksem. Używany w timerWheelAdvance przy
+ * zablokowanych wszystkich pasach.
+ * @param[in] node - węzeł drzewa PhoneForward->forward.
+ * @param[in, out] edData - wskaźnik na ExpireData.
+ */
+static void phfwdExpire(void *node, void *edData) {
+    struct ExpireData *ed = (struct ExpireData *) edData;
+    struct PhoneForward *pf = ed->pf;
+    ForwardData fd = radixTreeGetNodeData(node);
+    assert(fd != NULL);
+    fd->expiry = NULL;
+
+    char *num = radixGetFullText(node);
+    pthread_mutex_lock(&pf->changesLock);
+    if (num == NULL
+        || vectorPushBackString(pf->removed, num) != VECTOR_SUCCES) {
+        pf->changesLost = true;
+    }
+    pthread_mutex_unlock(&pf->changesLock);
+    if (num == NULL || ed->expired == NULL
+        || vectorPushBackString(ed->expired, num) != VECTOR_SUCCES) {
+        ed->expiredLost = true;
+    }
+    free(num);
+    radixTreeMarkChanged(node);
+
+    phfwdDeleteNodeFromBackwardTree(pf, fd);
+    free(fd);
+    radixTreeSetData(node, NULL);
+    radixTreeBalance(node);
+}
+
+size_t phfwdAdvanceClock(struct PhoneForward *pf, uint64_t now) {
+    size_t result = 0;
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    if (now > pf->clock) {
+        pf->clock = now;
+        if (pf->expiry != NULL) {
+            struct ExpireData ed;
+            ed.pf = pf;
+            ed.expired = vectorCreate();
+            ed.expiredLost = false;
+            result = timerWheelAdvance(pf->expiry, now, phfwdExpire, &ed);
+
+            if (ed.expiredLost) {
+                phfwdNotifyWatchers(pf, NULL);
+            } else if (result != 0) {
+                const char *ptr = vectorBegin(ed.expired);
+                const char *end = vectorEnd(ed.expired);
+                while (ptr != end) {
+                    phfwdNotifyWatchers(pf, ptr);
+                    ptr += strlen(ptr) + 1;
+                }
+            }
+            if (ed.expired != NULL) {
+                vectorDelete(ed.expired);
+            }
+        }
+    }
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+    return result;
+}
+
+/**
+ * @brief Usuwa odpowiedniki danych z PhoneForward->forward w backward.
+ * Używany w radixTreeDeleteSubTree.
+ * @see radixTreeDeleteSubTree
+ * @see phfwdRemove
+ * @param[in] data - wskaźnik na dane z węzła drzewa PhoneForward->forward.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ */
+static void phfwdRemoveCleaner(void *data, void *pf) {
+    assert(data != NULL);
+    assert(pf != NULL);
+    ForwardData fd = (ForwardData) data;
+    phfwdCancelExpiry(pf, fd);
+    phfwdDeleteNodeFromBackwardTree(pf, fd);
+    free(fd);
+
+}
+
+/**
+ * @brief Dodaje pas celu przekierowania do maski.
+ * Używany w radixTreeFold.
+ * @param[in] data - wskaźnik na dane z węzła drzewa PhoneForward->forward.
+ * @param[in, out] mask - wskaźnik na maskę pasów.
+ */
+static void phfwdRemoveStripesVisit(void *data, void *mask) {
+    ForwardData fd = (ForwardData) data;
+    *(unsigned int *) mask |= 1u << fd->stripe;
+}
+
+/**
+ * @brief Wyznacza pasy celów usuwanych przekierowań.
+ * @see phfwdLockValidated
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] num - usuwany prefiks.
+ * @return Maska pasów, z których zostaną usunięte odwrócenia.
+ */
+static unsigned int phfwdRemoveStripes(struct PhoneForward *pf,
+                                       const char *num) {
+    RadixTreeNode subTreeNode;
+    int findResult = radixTreeFindLite(pf->forward, num, &subTreeNode);
+    unsigned int mask = 0;
+    if (findResult == RADIX_TREE_FOUND || findResult == RADIX_TREE_SUBSTR) {
+        radixTreeFold(subTreeNode, phfwdRemoveStripesVisit, &mask);
+    }
+    return mask;
+}
+
+/**
+ * @brief Usuwa przekierowania przy zablokowanych pasach.
+ * Wymaga zablokowanych pasów @p num i celów usuwanych przekierowań
+ * (np. wszystkich pasów).
+ * @see phfwdRemoveStripes
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] num - poprawny usuwany prefiks.
+ * @return Wartość @p true, jeśli usunięto jakieś przekierowanie.
+ */
+static bool phfwdRemoveLocked(struct PhoneForward *pf, const char *num) {
+    RadixTreeNode subTreeNode;
+    int findResult = radixTreeFindLite(pf->forward, num, &subTreeNode);
+
+    if (findResult == RADIX_TREE_FOUND
+        || findResult == RADIX_TREE_SUBSTR) {
+        pthread_mutex_lock(&pf->changesLock);
+        if (vectorPushBackString(pf->removed, num) != VECTOR_SUCCES) {
+            pf->changesLost = true;
+        }
+        pthread_mutex_unlock(&pf->changesLock);
+        RadixTreeNode father = radixTreeFather(subTreeNode);
+        radixTreeDeleteSubTree(subTreeNode, phfwdRemoveCleaner, pf);
+        radixTreeBalance(father);
+        phfwdNotifyWatchers(pf, num);
+        return true;
+    }
+    return false;
+}
+
+void phfwdRemove(struct PhoneForward *pf, const char *num) {
+    if (!phfwdIsNumber(num)) {
+        return;
+    } else {
+        PROBE1(remove__entry, num);
+        unsigned int mask = phfwdLockValidated(pf, phfwdStripeOf(num),
+                                               phfwdRemoveStripes, num);
+        bool removed = phfwdRemoveLocked(pf, num);
+        phfwdUnlockStripes(pf, mask);
+        PROBE1(remove__return, removed);
+    }
+}
+
+size_t phfwdApplyChanges(struct PhoneForward *pf,
+                         const struct PhoneForwardChange *changes,
+                         size_t count) {
+    size_t applied = 0;
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    for (; applied < count; applied++) {
+        const char *num1 = changes[applied].num1;
+        const char *num2 = changes[applied].num2;
+        if (num2 == NULL) {
+            if (phfwdIsNumber(num1)) {
+                PROBE1(remove__entry, num1);
+                bool removed = phfwdRemoveLocked(pf, num1);
+                PROBE1(remove__return, removed);
+            }
         } else {
+            PROBE2(add__entry, num1, num2);
+            bool added = phfwdIsNumber(num1) && phfwdIsNumber(num2)
+                         && strcmp(num1, num2) != 0
+                         && phfwdAddLocked(pf, num1, num2, PHFWD_NO_EXPIRY);
+            PROBE1(add__return, added);
+            if (!added) {
+                break;
+            }
+        }
+    }
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+    return applied;
+}
+
+/**
+ * @brief Wyznacza pas celu przekierowania numeru.
+ * @see phfwdLockValidated
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] num - wskaźnik na numer.
+ * @return Maska pasa celu przekierowania lub 0.
+ */
+static unsigned int phfwdGetStripes(struct PhoneForward *pf,
+                                    const char *num) {
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+
+    phfwdFindRedirection(pf->forward, num, &ptr, &matchedTxt);
+    if (radixTreeIsRoot(ptr)) {
+        return 0;
+    } else {
+        ForwardData fd = (ForwardData) radixTreeGetNodeData(ptr);
+        return 1u << fd->stripe;
+    }
+}
+
+/**
+ * @brief Buduje przekierowany numer.
+ * @see phfwdFindRedirection
+ * @param[in] ptr - węzeł z przekierowaniem lub korzeń.
+ * @param[in] matchedTxt - część numeru następująca po prefiksie
+ *        reprezentowanym przez @p ptr.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ * @return Przekierowany numer, NULL w przypadku problemów z pamięcią.
+ */
+static const char *phfwdRedirectedNumber(RadixTreeNode ptr,
+                                         const char *matchedTxt,
+                                         struct RadixTreeStats *stats) {
+    char *result = NULL;
+    if (radixTreeIsRoot(ptr)) {
+        result = malloc(strlen(matchedTxt) + (size_t) 1);
+        if (result != NULL) {
             strcpy(result, matchedTxt);
-            return result;
         }
     } else {
         ForwardData fd = (ForwardData) radixTreeGetNodeData(ptr);
         assert(fd != NULL);
-        char *prefix = radixGetFullText(fd->treeNode);
-        if (prefix == NULL) {
-            return NULL;
-        } else {
-            result = concatenate(prefix, matchedTxt);
-            free(prefix);
-            return result;
-        }
+        result = radixGetFullTextWithSuffix(fd->treeNode, matchedTxt);
+    }
+    if (result != NULL && stats != NULL) {
+        stats->allocations++;
     }
+    return result;
+}
+
+/**
+ * @brief Pobiera przekierowany numer.
+ * @param[in] forward - wskaźnik na węzeł reprezentujący drzewo.
+ * @param[in] num - wskaźnik na numer.
+ * @param[in] countHit - czy zwiększyć licznik użyć przekierowania.
+ * @return Przekierowany numer.
+ */
+static const char *phfwdGetNumber(RadixTree forward, const char *num,
+                                  bool countHit) {
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+
+    phfwdFindRedirection(forward, num, &ptr, &matchedTxt);
 
+    if (radixTreeIsRoot(ptr)) {
+        assert(matchedTxt == num);
+    } else if (countHit) {
+        ((ForwardData) radixTreeGetNodeData(ptr))->hits++;
+    }
+    return phfwdRedirectedNumber(ptr, matchedTxt, NULL);
 }
 
 const struct PhoneNumbers *phfwdGet(struct PhoneForward *pf, const char *num) {
     if (!phfwdIsNumber(num)) {
         return phfwdEmptySequenceResult();
     } else {
+        PROBE1(get__entry, num);
         struct PhoneNumbers *result = phfwdCreatePhoneNumbersStructure(1);
         if (result == NULL) {
             return NULL;
         } else {
-            const char *number = phfwdGetNumber(pf->forward, num);
+            unsigned int mask = phfwdLockValidated(pf, phfwdStripeOf(num),
+                                                   phfwdGetStripes, num);
+            const char *number = phfwdGetNumber(pf->forward, num,
+                                                pf->countHits);
+            phfwdUnlockStripes(pf, mask);
+            PROBE1(get__return, number);
             if (number == NULL) {
                 phnumDelete(result);
                 return NULL;
@@ -497,112 +1435,300 @@ void phnumDelete(const struct PhoneNumbers *pnum) {
         for (i = 0; i < pnum->howMany; i++) {
             free(pnum->numbers[i]);
             pnum->numbers[i] = NULL;
+            if (pnum->prefixes != NULL) {
+                free(pnum->prefixes[i]);
+            }
         }
         free(pnum->numbers);
+        free(pnum->prefixes);
+        free(pnum->suffixes);
+        free(pnum->query);
+        free(pnum->ranks);
         free((void *) pnum);
     }
 }
 
+size_t phnumSize(const struct PhoneNumbers *pnum) {
+    return pnum == NULL ? 0 : pnum->howMany;
+}
+
 const char *phnumGet(const struct PhoneNumbers *pnum, size_t idx) {
     if (pnum == NULL
         || pnum->howMany <= idx) {
         return NULL;
-    } else {
-        return pnum->numbers[idx];
+    } else if (pnum->numbers[idx] == NULL && pnum->prefixes != NULL) {
+        const char *prefix = pnum->prefixes[idx] == NULL
+                             ? "" : pnum->prefixes[idx];
+        pnum->numbers[idx] = concatenate(prefix,
+                                         pnum->query + pnum->suffixes[idx]);
     }
+    return pnum->numbers[idx];
 }
 
 /**
  * @brief Maksymalna liczba numerów zwróconych w wyniku phfwdGetReverse.
  * Razem z powtórzeniami.
+ * @param[in] backward - wskaźnik na drzewo zawierające @p node.
  * @param[in] node - wskaźnik na węzeł
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
  * @return Maksymalna liczba numerów zwróconych w wyniku phfwdGetReverse od
  *         tekstu reprezentowanego przez węzeł @p node.
  */
-static size_t phfwdHowManyRedirections(RadixTreeNode node) {
+static size_t phfwdHowManyRedirections(RadixTree backward,
+                                       RadixTreeNode node,
+                                       struct RadixTreeStats *stats) {
     size_t result = 1;
-    RadixTreeNode pos = node;
+    RadixTreeNode pos;
 
-    while (!radixTreeIsRoot(pos)) {
-        if (radixTreeGetNodeData(pos) != NULL) {
-            List list = radixTreeGetNodeData(pos);
-            result += listSize(list, SIZE_MAX);
-        }
-        pos = radixTreeFather(pos);
+    for (pos = radixTreeDataAncestorCounted(backward, node, stats);
+         pos != NULL;
+         pos = radixTreeDataFatherCounted(backward, pos, stats)) {
+        List list = radixTreeGetNodeData(pos);
+        result += listSize(list, SIZE_MAX);
+    }
+    if (stats != NULL) {
+        stats->listEntries += result - 1;
     }
     return result;
 }
 
 /**
  * @brief Dodaje numery które powstają w wyniku phfwdReverse do @p storage.
- * @param[out] storage - wskaźnik na strukturę przechowującą numery, gotową
- *        do przyjęcia numerów (razem z powtórzeniami).
- * @param[in] node - wskaźnik na węzeł reprezentujący najdłuższy
+ * Numer jest zapisywany jako pełny tekst źródła przekierowania i pozycja
+ * niedopasowanej części numeru w @p storage->query, więc niedopasowana
+ * część nie jest kopiowana dla każdego numeru. Odwiedzane są tylko węzły
+ * z danymi na ścieżce do korzenia (@ref radixTreeDataFather).
+ * @param[out] storage - wskaźnik na strukturę utworzoną przez
+ *        phfwdCreateRopeStructure dla numeru, gotową do przyjęcia numerów
+ *        (razem z powtórzeniami).
+ * @param[in] backward - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - wskaźnik na węzeł reprezentujący najdłuższy
  *        dopasowany prefiks numeru,
  *        z wyłączeniem częściowego dopasowania krawędzi.
- * @param[in] matchedTxt - wskaźnik na dopasowanie numeru (wszystkie znaki
- *        występujące za tym wskaźnikiem nie zostały dopasowane).
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
  * @return W przypadku udanego dodania true, w przypadku problemów
  *         false.
  */
-static bool phfwdAddRedir(struct PhoneNumbers *storage,
-                          RadixTreeNode node,
-                          const char *matchedTxt) {
-    RadixTreeNode pos = node;
+static bool phfwdAddRedir(struct PhoneNumbers *storage, RadixTree backward,
+                          RadixTreeNode node, struct RadixTreeStats *stats) {
+    RadixTreeNode pos;
     size_t insertPtr = 0;
-    while (!radixTreeIsRoot(pos)) {
-        if (radixTreeGetNodeData(pos) != NULL) {
-            List list = radixTreeGetNodeData(pos);
-            ListNode p = listFirstNode(list);
-            while (p != NULL) {
-                char *prefix = radixGetFullText(listNodeGetValue(p));
-                if (prefix == NULL) {
-                    return false;
-                } else {
-                    char *toAdd = concatenate(prefix, matchedTxt);
-                    free(prefix);
-                    if (toAdd == NULL) {
-                        return false;
-                    } else {
-                        assert(insertPtr < storage->howMany);
-                        storage->numbers[insertPtr] = toAdd;
-                        insertPtr++;
-                    }
+    for (pos = radixTreeDataAncestorCounted(backward, node, stats);
+         pos != NULL;
+         pos = radixTreeDataFatherCounted(backward, pos, stats)) {
+        List list = radixTreeGetNodeData(pos);
+        size_t suffix = radixTreeTextLength(pos);
+        ListNode p = listFirstNode(list);
+        while (p != NULL) {
+            char *prefix = radixGetFullText(listNodeGetValue(p));
+            if (prefix == NULL) {
+                return false;
+            } else {
+                assert(insertPtr < storage->howMany);
+                storage->prefixes[insertPtr] = prefix;
+                storage->suffixes[insertPtr] = suffix;
+                insertPtr++;
+                if (stats != NULL) {
+                    stats->listEntries++;
+                    stats->allocations++;
                 }
-                p = listNextNode(p);
             }
+            p = listNextNode(p);
         }
-        matchedTxt = matchedTxt - radixTreeHowManyChars(pos);
-        pos = radixTreeFather(pos);
+    }
+    assert(insertPtr < storage->howMany);
+    storage->suffixes[insertPtr] = 0;
+    return true;
+}
 
+/**
+ * @brief Porównuje sufiksy numeru zapytania.
+ * Porównuje bezpośrednio co najwyżej PHFWD_ROPE_SCAN znaków, a dalej
+ * korzysta z pozycji sufiksów wyznaczanych przy pierwszej potrzebie.
+ * @param[in, out] pnum - wskaźnik na strukturę z numerami.
+ * @param[in] a - pozycja pierwszego sufiksu w @p pnum->query.
+ * @param[in] b - pozycja drugiego sufiksu w @p pnum->query.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ * @return Liczba ujemna, zero lub dodatnia, jeżeli pierwszy sufiks jest
+ *         odpowiednio mniejszy, równy lub większy od drugiego.
+ */
+static int phfwdCompareQuerySuffixes(struct PhoneNumbers *pnum,
+                                     size_t a, size_t b,
+                                     struct RadixTreeStats *stats) {
+    if (a == b) {
+        return 0;
     }
-    char *toAdd = duplicateText(matchedTxt);
-    if (toAdd == NULL) {
-        return false;
-    } else {
-        assert(insertPtr < storage->howMany);
-        storage->numbers[insertPtr] = toAdd;
-        insertPtr++;
+    const char *x = pnum->query + a, *y = pnum->query + b;
+    size_t i;
+    for (i = 0; i < PHFWD_ROPE_SCAN; i++) {
+        if (x[i] != y[i] || x[i] == '\0') {
+            return (unsigned char) x[i] - (unsigned char) y[i];
+        }
     }
-    return true;
+    if (pnum->ranks == NULL) {
+        pnum->ranks = suffixRanks(pnum->query, pnum->queryLength,
+                                  stats == NULL ? NULL : &stats->allocations);
+        if (pnum->ranks == NULL) {
+            return strcmp(x + i, y + i);
+        }
+    }
+    return pnum->ranks[a] < pnum->ranks[b] ? -1 : 1;
 }
 
 /**
- * @brief Przygotowuje podane struktury do sortowania numerów
- * @param[out] tree - wskaźnik na wskaźnik na drzewo wykorzystane do sortowania.
- *        Po wykonaniu @p *tree wskazuje na nowe puste drzewo.
- * @param[out] ids - wskaźnik na wskaźnik na tablicę indeksów.
- *        Po wykonaniu @p *ids wskazuje na tablicę indeksów od 0 do
- *        @p out->howMany - 1.
- * @param[in] out - wskaźnik na strukturę przechowującą numery.
- * @return Jeżeli operacja się powiedzie to true, false
- *         w przeciwnym przypadku.
+ * @brief Porównuje numery zapisane jako prefiks i sufiks zapytania.
+ * Numery nie są tworzone. Po przejściu prefiksów porównanie dwóch sufiksów
+ * zapytania zajmuje czas stały lub O(PHFWD_ROPE_SCAN), poza jednorazowym
+ * wyznaczeniem pozycji sufiksów.
+ * @param[in, out] pnum - wskaźnik na strukturę z numerami.
+ * @param[in] a - indeks pierwszego numeru.
+ * @param[in] b - indeks drugiego numeru.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ * @return Liczba ujemna, zero lub dodatnia, jeżeli pierwszy numer jest
+ *         odpowiednio mniejszy, równy lub większy od drugiego.
  */
-static bool phfwdPrepareForSort(RadixTree *tree, size_t **ids,
-                                const struct PhoneNumbers *out) {
-    *tree = radixTreeCreate();
-    if (*tree == NULL) {
-        return false;
+static int phfwdRopeCompare(struct PhoneNumbers *pnum, size_t a, size_t b,
+                            struct RadixTreeStats *stats) {
+    const char *x = pnum->prefixes[a] == NULL ? "" : pnum->prefixes[a];
+    const char *y = pnum->prefixes[b] == NULL ? "" : pnum->prefixes[b];
+    size_t suffixA = pnum->suffixes[a], suffixB = pnum->suffixes[b];
+
+    while (*x != '\0' && *y != '\0') {
+        if (*x != *y) {
+            return (unsigned char) *x - (unsigned char) *y;
+        }
+        x++;
+        y++;
+    }
+    for (; *x != '\0'; x++, suffixB++) {
+        char c = pnum->query[suffixB];
+        if (*x != c) {
+            return (unsigned char) *x - (unsigned char) c;
+        }
+    }
+    for (; *y != '\0'; y++, suffixA++) {
+        char c = pnum->query[suffixA];
+        if (c != *y) {
+            return (unsigned char) c - (unsigned char) *y;
+        }
+    }
+    return phfwdCompareQuerySuffixes(pnum, suffixA, suffixB, stats);
+}
+
+/**
+ * @brief Sortuje indeksy numerów przez scalanie.
+ * @param[in, out] pnum - wskaźnik na strukturę z numerami.
+ * @param[in, out] ids - tablica @p count indeksów do posortowania.
+ * @param[in, out] buffer - tablica pomocnicza @p count elementów.
+ * @param[in] count - liczba indeksów.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ */
+static void phfwdRopeMergeSort(struct PhoneNumbers *pnum, size_t *ids,
+                               size_t *buffer, size_t count,
+                               struct RadixTreeStats *stats) {
+    size_t width;
+    for (width = 1; width < count; width *= 2) {
+        size_t left;
+        for (left = 0; left < count; left += 2 * width) {
+            size_t middle = left + width < count ? left + width : count;
+            size_t right = middle + width < count ? middle + width : count;
+            size_t i = left, j = middle, k = left;
+            while (i < middle && j < right) {
+                if (phfwdRopeCompare(pnum, ids[j], ids[i], stats) < 0) {
+                    buffer[k++] = ids[j++];
+                } else {
+                    buffer[k++] = ids[i++];
+                }
+            }
+            while (i < middle) {
+                buffer[k++] = ids[i++];
+            }
+            while (j < right) {
+                buffer[k++] = ids[j++];
+            }
+        }
+        memcpy(ids, buffer, count * sizeof(size_t));
+    }
+}
+
+/**
+ * @brief Sortuje numery zapisane jako prefiks i sufiks zapytania.
+ * Sortuje numery z @p out i usuwa powtórzenia bez tworzenia numerów.
+ * #### Złożoność
+ * O(k log k * (p + PHFWD_ROPE_SCAN)), gdzie k to liczba numerów, a p to
+ * długość najdłuższego prefiksu, oraz jednorazowo O(n log n) dla
+ * numeru zapytania długości n, jeżeli jego sufiksy mają długie wspólne
+ * prefiksy.
+ * @param[in, out] out - wskaźnik na strukturę utworzoną przez
+ *        phfwdCreateRopeStructure.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ * @return W przypadku sukcesu true, w przypadku problemów false.
+ */
+static bool phfwdRopeSortOut(struct PhoneNumbers *out,
+                             struct RadixTreeStats *stats) {
+    if (out->howMany <= 1) {
+        return true;
+    }
+
+    size_t *ids = malloc(2 * out->howMany * sizeof(size_t));
+    char **prefixes = malloc(out->howMany * sizeof(char *));
+    if (ids == NULL || prefixes == NULL) {
+        free(ids);
+        free(prefixes);
+        return false;
+    }
+    if (stats != NULL) {
+        stats->allocations += 2;
+    }
+    size_t i;
+    for (i = 0; i < out->howMany; i++) {
+        ids[i] = i;
+    }
+    phfwdRopeMergeSort(out, ids, ids + out->howMany, out->howMany, stats);
+
+    size_t *suffixes = out->suffixes;
+    size_t howManyUnique = 0;
+    for (i = 0; i < out->howMany; i++) {
+        if (howManyUnique > 0
+            && phfwdRopeCompare(out, ids[howManyUnique - 1], ids[i],
+                                stats) == 0) {
+            free(out->prefixes[ids[i]]);
+            out->prefixes[ids[i]] = NULL;
+        } else {
+            ids[howManyUnique++] = ids[i];
+        }
+    }
+    for (i = 0; i < howManyUnique; i++) {
+        prefixes[i] = out->prefixes[ids[i]];
+        ids[i] = suffixes[ids[i]];
+    }
+    memcpy(out->prefixes, prefixes, howManyUnique * sizeof(char *));
+    memcpy(out->suffixes, ids, howManyUnique * sizeof(size_t));
+    out->howMany = howManyUnique;
+
+    free(ids);
+    free(prefixes);
+    free(out->ranks);
+    out->ranks = NULL;
+    return true;
+}
+
+/**
+ * @brief Przygotowuje podane struktury do sortowania numerów
+ * @param[out] tree - wskaźnik na wskaźnik na drzewo wykorzystane do sortowania.
+ *        Po wykonaniu @p *tree wskazuje na nowe puste drzewo.
+ * @param[out] ids - wskaźnik na wskaźnik na tablicę indeksów.
+ *        Po wykonaniu @p *ids wskazuje na tablicę indeksów od 0 do
+ *        @p out->howMany - 1.
+ * @param[in] out - wskaźnik na strukturę przechowującą numery.
+ * @return Jeżeli operacja się powiedzie to true, false
+ *         w przeciwnym przypadku.
+ */
+static bool phfwdPrepareForSort(RadixTree *tree, size_t **ids,
+                                const struct PhoneNumbers *out) {
+    *tree = radixTreeCreate();
+    if (*tree == NULL) {
+        return false;
     } else {
         *ids = malloc(out->howMany * sizeof(size_t));
         if (*ids == NULL) {
@@ -689,6 +1815,10 @@ static void phfwdRadixSortOutOrganize(void *data, void *fData) {
  * @return W przypadku sukcesu true, w przypadku problemów false.
  */
 static bool phfwdRadixSortOut(struct PhoneNumbers **out) {
+    if ((*out)->howMany <= 1) {
+        return true;
+    }
+
     RadixTree tree;
     size_t *ids;
     if (phfwdPrepareForSort(&tree, &ids, *out)) {
@@ -743,18 +1873,19 @@ static const struct PhoneNumbers *phfwdGetReverse(RadixTree backward,
 
     phfwdSetPointersForGettingText(backward, num, &ptr, &matchedTxt);
 
-    size_t numberOfRedirections = phfwdHowManyRedirections(ptr);
+    size_t numberOfRedirections = phfwdHowManyRedirections(backward, ptr,
+                                                           NULL);
 
     struct PhoneNumbers *result =
-            phfwdCreatePhoneNumbersStructure(numberOfRedirections);
+            phfwdCreateRopeStructure(numberOfRedirections, num, NULL);
     if (result == NULL) {
         return NULL;
     } else {
-        if (!phfwdAddRedir(result, ptr, matchedTxt)) {
+        if (!phfwdAddRedir(result, backward, ptr, NULL)) {
             phnumDelete(result);
             return NULL;
         } else {
-            if (phfwdRadixSortOut(&result)) {
+            if (phfwdRopeSortOut(result, NULL)) {
                 return result;
             } else {
                 phnumDelete(result);
@@ -772,7 +1903,12 @@ const struct PhoneNumbers *phfwdReverse(struct PhoneForward *pf,
     if (!phfwdIsNumber(num)) {
         return phfwdEmptySequenceResult();
     } else {
-        return phfwdGetReverse(pf->backward, num);
+        PROBE1(reverse__entry, num);
+        phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+        const struct PhoneNumbers *result = phfwdGetReverse(pf->backward, num);
+        phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+        PROBE1(reverse__return, result == NULL ? (size_t) 0 : result->howMany);
+        return result;
     }
 }
 
@@ -808,21 +1944,1459 @@ static size_t phfwdNonTrivialCountExtractDigitsFromSet(const char *set,
     return howMany;
 }
 
-size_t phfwdNonTrivialCount(struct PhoneForward *pf, const char *set, size_t len) {
-    if (pf == NULL || set == NULL || len == 0) {
+/**
+ * @brief Stan wyznaczania wyniku phfwdReverseFiltered.
+ * @see phfwdReverseFiltered
+ */
+struct ReverseFilterState {
+    /**
+     * @brief Filtr.
+     */
+    const struct PhoneForwardReverseFilter *filter;
+
+    /**
+     * @brief Dozwolone cyfry (allowed[kod_ascii - '0']).
+     */
+    bool allowed[CHARACTER_NUMBER_OF_DIGITS];
+
+    /**
+     * @brief Bufor na tekst źródła przekierowania.
+     */
+    char *buffer;
+
+    /**
+     * @brief Rozmiar bufora @p buffer.
+     */
+    size_t bufferSize;
+
+    /**
+     * @brief Zebrane numery.
+     * Przy ograniczonej liczbie wyników posortowane i bez powtórzeń.
+     */
+    struct PhoneNumbers *out;
+
+    /**
+     * @brief Liczba zebranych numerów.
+     */
+    size_t count;
+
+    /**
+     * @brief Czy zbierane jest tylko @p out->howMany najmniejszych numerów.
+     */
+    bool bounded;
+};
+
+/**
+ * @brief Sprawdza czy napis składa się z dozwolonych cyfr.
+ * @param[in] allowed - dozwolone cyfry (allowed[kod_ascii - '0']).
+ * @param[in] txt - wskaźnik na napis.
+ * @param[in] length - długość napisu.
+ * @return true jeżeli wszystkie znaki są dozwolone, false w przeciwnym
+ *         przypadku.
+ */
+static bool phfwdDigitsAllowed(const bool *allowed, const char *txt,
+                               size_t length) {
+    size_t i;
+    for (i = 0; i < length; i++) {
+        if (!allowed[txt[i] - '0']) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Porównuje leksykograficznie sklejenie dwóch napisów z napisem.
+ * @param[in] a - wskaźnik na początek sklejenia.
+ * @param[in] aLength - długość @p a.
+ * @param[in] b - wskaźnik na koniec sklejenia (zakończony znakiem '\0').
+ * @param[in] other - wskaźnik na porównywany napis.
+ * @return Wartość ujemna, zero lub dodatnia, jeżeli sklejenie @p a i @p b
+ *         jest odpowiednio mniejsze, równe lub większe od @p other.
+ */
+static int phfwdCompareConcat(const char *a, size_t aLength, const char *b,
+                              const char *other) {
+    size_t i;
+    for (i = 0; i < aLength; i++, other++) {
+        if (*other == '\0' || a[i] != *other) {
+            return *other == '\0' ? 1 : (unsigned char) a[i]
+                                         - (unsigned char) *other;
+        }
+    }
+    return strcmp(b, other);
+}
+
+/**
+ * @brief Sprawdza czy sklejenie dwóch napisów ma prefiks @p prefix.
+ * @param[in] a - wskaźnik na początek sklejenia.
+ * @param[in] aLength - długość @p a.
+ * @param[in] b - wskaźnik na koniec sklejenia (zakończony znakiem '\0').
+ * @param[in] prefix - wskaźnik na prefiks.
+ * @return true jeżeli sklejenie ma prefiks @p prefix, false w przeciwnym
+ *         przypadku.
+ */
+static bool phfwdConcatHasPrefix(const char *a, size_t aLength, const char *b,
+                                 const char *prefix) {
+    size_t i;
+    for (i = 0; i < aLength && *prefix != '\0'; i++, prefix++) {
+        if (a[i] != *prefix) {
+            return false;
+        }
+    }
+    return strncmp(b, prefix, strlen(prefix)) == 0;
+}
+
+/**
+ * @brief Rozpatruje numer będący wynikiem odwrócenia przekierowania.
+ * Numer jest sklejeniem tekstu węzła @p source i @p suffix. Sprawdza
+ * filtr na tekście zapisanym w buforze, a numer tworzy tylko wtedy, gdy
+ * spełnia filtr i (przy ograniczonej liczbie wyników) jest mniejszy od
+ * największego dotychczas zebranego.
+ * @param[in, out] state - wskaźnik na stan.
+ * @param[in] source - węzeł drzewa PhoneForward->forward lub NULL dla
+ *        samego numeru.
+ * @param[in] suffix - wskaźnik na niedopasowaną część numeru.
+ * @param[in] suffixLength - długość @p suffix.
+ * @return false w przypadku problemów z przydzieleniem pamięci, true
+ *         w przeciwnym przypadku.
+ */
+static bool phfwdReverseFilterCandidate(struct ReverseFilterState *state,
+                                        RadixTreeNode source,
+                                        const char *suffix,
+                                        size_t suffixLength) {
+    const struct PhoneForwardReverseFilter *filter = state->filter;
+    size_t length = source == NULL ? 0 : radixTreeTextLength(source);
+    size_t total = length + suffixLength;
+    if (total < filter->minLength
+        || (filter->maxLength != 0 && total > filter->maxLength)) {
+        return true;
+    }
+
+    if (length >= state->bufferSize) {
+        size_t size = 2 * (length + 1);
+        char *buffer = realloc(state->buffer, size);
+        if (buffer == NULL) {
+            return false;
+        }
+        state->buffer = buffer;
+        state->bufferSize = size;
+    }
+    if (source != NULL) {
+        radixTreeWriteText(source, length, state->buffer);
+    }
+    if (!phfwdDigitsAllowed(state->allowed, state->buffer, length)
+        || (filter->prefix != NULL
+            && !phfwdConcatHasPrefix(state->buffer, length, suffix,
+                                     filter->prefix))) {
+        return true;
+    }
+
+    char **numbers = state->out->numbers;
+    size_t position = state->count;
+    if (state->bounded) {
+        size_t low = 0, high = state->count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (phfwdCompareConcat(state->buffer, length, suffix,
+                                   numbers[middle]) > 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        position = low;
+        if (position == state->out->howMany
+            || (position < state->count
+                && phfwdCompareConcat(state->buffer, length, suffix,
+                                      numbers[position]) == 0)) {
+            return true;
+        }
+    }
+
+    state->buffer[length] = '\0';
+    char *number = concatenate(state->buffer, suffix);
+    if (number == NULL) {
+        return false;
+    }
+    if (state->count == state->out->howMany) {
+        assert(state->bounded);
+        free(numbers[state->count - 1]);
+        state->count--;
+    }
+    memmove(numbers + position + 1, numbers + position,
+            (state->count - position) * sizeof(char *));
+    numbers[position] = number;
+    state->count++;
+    return true;
+}
+
+/**
+ * @brief Zbiera numery dla phfwdReverseFiltered.
+ * Przechodzi od węzła najdłuższego dopasowanego prefiksu numeru do korzenia
+ * jak @ref phfwdAddRedir. Niedopasowana część numeru rośnie przy przejściu
+ * w górę, więc gdy przekroczy maksymalną długość lub zawiera niedozwoloną
+ * cyfrę, wyższe węzły nie są przeglądane.
+ * @param[in, out] state - wskaźnik na stan.
+ * @param[in] backward - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - wskaźnik na węzeł reprezentujący najdłuższy
+ *        dopasowany prefiks numeru,
+ *        z wyłączeniem częściowego dopasowania krawędzi.
+ * @param[in] num - wskaźnik na numer.
+ * @return W przypadku udanego dodania true, w przypadku problemów
+ *         false.
+ */
+static bool phfwdReverseFilterCollect(struct ReverseFilterState *state,
+                                      RadixTree backward, RadixTreeNode node,
+                                      const char *num) {
+    const struct PhoneForwardReverseFilter *filter = state->filter;
+    size_t numLength = strlen(num);
+    const char *checked = num + numLength;
+    RadixTreeNode pos = radixTreeDataAncestor(backward, node);
+    while (true) {
+        const char *matchedTxt = num;
+        if (pos != NULL) {
+            matchedTxt += radixTreeTextLength(pos);
+        }
+        size_t suffixLength = numLength - (size_t) (matchedTxt - num);
+        if ((filter->maxLength != 0 && suffixLength > filter->maxLength)
+            || !phfwdDigitsAllowed(state->allowed, matchedTxt,
+                                   (size_t) (checked - matchedTxt))) {
+            return true;
+        }
+        checked = matchedTxt;
+
+        if (pos == NULL) {
+            return phfwdReverseFilterCandidate(state, NULL, matchedTxt,
+                                               suffixLength);
+        }
+        ListNode p = listFirstNode(radixTreeGetNodeData(pos));
+        while (p != NULL) {
+            if (!phfwdReverseFilterCandidate(state, listNodeGetValue(p),
+                                             matchedTxt, suffixLength)) {
+                return false;
+            }
+            p = listNextNode(p);
+        }
+        pos = radixTreeDataFather(backward, pos);
+    }
+}
+
+/**
+ * @brief Pobiera numery dla phfwdReverseFiltered.
+ * @see phfwdReverseFiltered
+ * @param[in] backward - wskaźnik na drzewo z informacjami o
+ *          odwróconych przekierowaniach.
+ * @param[in] num - wskaźnik na numer dla którego wykonujemy operację
+ *        odwrócenia przekierowania.
+ * @param[in] filter - wskaźnik na filtr.
+ * @return Struktura z numerami dla phfwdReverseFiltered.
+ */
+static const struct PhoneNumbers *
+phfwdGetReverseFiltered(RadixTree backward, const char *num,
+                        const struct PhoneForwardReverseFilter *filter) {
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+
+    phfwdSetPointersForGettingText(backward, num, &ptr, &matchedTxt);
+
+    size_t capacity = phfwdHowManyRedirections(backward, ptr, NULL);
+    struct ReverseFilterState state;
+    state.filter = filter;
+    state.bounded = filter->limit != 0 && filter->limit < capacity;
+    if (state.bounded) {
+        capacity = filter->limit;
+    }
+    if (filter->digits != NULL) {
+        phfwdNonTrivialCountExtractDigitsFromSet(filter->digits,
+                                                 state.allowed);
+    } else {
+        size_t i;
+        for (i = 0; i < CHARACTER_NUMBER_OF_DIGITS; i++) {
+            state.allowed[i] = true;
+        }
+    }
+    state.buffer = NULL;
+    state.bufferSize = 0;
+    state.count = 0;
+    state.out = phfwdCreatePhoneNumbersStructure(capacity);
+    if (state.out == NULL) {
+        return NULL;
+    }
+
+    bool success = phfwdReverseFilterCollect(&state, backward, ptr, num);
+    free(state.buffer);
+    state.out->howMany = state.count;
+    if (!success || (!state.bounded && !phfwdRadixSortOut(&state.out))) {
+        phnumDelete(state.out);
+        return NULL;
+    }
+    return state.out;
+}
+
+const struct PhoneNumbers *phfwdReverseFiltered(struct PhoneForward *pf,
+                                                const char *num,
+                                                const struct PhoneForwardReverseFilter *filter) {
+    if (filter == NULL) {
+        return phfwdReverse(pf, num);
+    } else if (!phfwdIsNumber(num)) {
+        return phfwdEmptySequenceResult();
+    } else {
+        phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+        const struct PhoneNumbers *result =
+                phfwdGetReverseFiltered(pf->backward, num, filter);
+        phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+        return result;
+    }
+}
+
+size_t phfwdReverseCount(struct PhoneForward *pf, const char *num) {
+    if (pf == NULL || !phfwdIsNumber(num)) {
         return 0;
     } else {
-        bool availableDigits[CHARACTER_NUMBER_OF_DIGITS];
-        size_t howManyDigitsAvailable =
-                phfwdNonTrivialCountExtractDigitsFromSet(set, availableDigits);
+        unsigned int mask = phfwdStripeOf(num);
+        phfwdLockStripes(pf, mask);
+        size_t result = radixTreePathWeight(pf->backward, num);
+        phfwdUnlockStripes(pf, mask);
+        return result;
+    }
+}
 
-        if (howManyDigitsAvailable == 0) {
-            return 0;
-        } else {
-            return radixTreeNonTrivialCount(pf->backward,
-                                            len,
-                                            availableDigits,
-                                            howManyDigitsAvailable);
+size_t phfwdSourcesCount(struct PhoneForward *pf, const char *prefix) {
+    if (pf == NULL || !phfwdIsNumber(prefix)) {
+        return 0;
+    } else {
+        unsigned int mask = phfwdStripeOf(prefix);
+        phfwdLockStripes(pf, mask);
+        size_t result = radixTreeCountData(pf->forward, prefix);
+        phfwdUnlockStripes(pf, mask);
+        return result;
+    }
+}
+
+size_t phfwdTargetsCount(struct PhoneForward *pf, const char *prefix) {
+    if (pf == NULL || !phfwdIsNumber(prefix)) {
+        return 0;
+    } else {
+        unsigned int mask = phfwdStripeOf(prefix);
+        phfwdLockStripes(pf, mask);
+        size_t result = radixTreeCountData(pf->backward, prefix);
+        phfwdUnlockStripes(pf, mask);
+        return result;
+    }
+}
+
+/**
+ * @brief Poziom ścieżki w drzewie PhoneForward->backward wspólny dla
+ * kolejnych numerów przetwarzanych przez @ref phfwdReverseBatch.
+ */
+struct ReverseBatchLevel {
+    /**
+     * @brief Długość prefiksu reprezentowanego przez węzeł z danymi.
+     */
+    size_t depth;
+
+    /**
+     * @brief Liczba prefiksów przekierowywanych na węzeł.
+     */
+    size_t count;
+
+    /**
+     * @brief Prefiksy przekierowywane na węzeł.
+     */
+    char **prefixes;
+};
+
+/**
+ * @brief Stos poziomów ścieżki do aktualnie przetwarzanego numeru.
+ */
+struct ReverseBatchStack {
+    /**
+     * @brief Poziomy od najpłytszego.
+     */
+    struct ReverseBatchLevel *levels;
+
+    /**
+     * @brief Liczba poziomów na stosie.
+     */
+    size_t size;
+
+    /**
+     * @brief Liczba zaalokowanych poziomów.
+     */
+    size_t capacity;
+
+    /**
+     * @brief Łączna liczba prefiksów na stosie.
+     */
+    size_t prefixes;
+};
+
+/**
+ * @brief Numer wejściowy wraz z pozycją w tablicy wejściowej.
+ */
+struct ReverseBatchInput {
+    /**
+     * @brief Numer.
+     */
+    const char *num;
+
+    /**
+     * @brief Pozycja numeru w tablicy wejściowej.
+     */
+    size_t index;
+};
+
+/**
+ * @brief Porównuje numery wejściowe leksykograficznie.
+ * @param[in] a - wskaźnik na ReverseBatchInput.
+ * @param[in] b - wskaźnik na ReverseBatchInput.
+ * @return Wynik strcmp numerów.
+ */
+static int phfwdReverseBatchCompare(const void *a, const void *b) {
+    return strcmp(((const struct ReverseBatchInput *) a)->num,
+                  ((const struct ReverseBatchInput *) b)->num);
+}
+
+/**
+ * @brief Zdejmuje poziom ze stosu i zwalnia jego prefiksy.
+ * @param[in, out] stack - wskaźnik na stos.
+ */
+static void phfwdReverseBatchPop(struct ReverseBatchStack *stack) {
+    struct ReverseBatchLevel *level = &stack->levels[--stack->size];
+    size_t i;
+    for (i = 0; i < level->count; i++) {
+        free(level->prefixes[i]);
+    }
+    free(level->prefixes);
+    stack->prefixes -= level->count;
+}
+
+/**
+ * @brief Odkłada na stos poziom węzła z danymi.
+ * Wyznacza pełne teksty prefiksów przekierowywanych na węzeł @p node.
+ * @param[in, out] stack - wskaźnik na stos.
+ * @param[in] node - węzeł drzewa PhoneForward->backward z danymi.
+ * @param[in] depth - długość prefiksu reprezentowanego przez @p node.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool phfwdReverseBatchPush(struct ReverseBatchStack *stack,
+                                  RadixTreeNode node, size_t depth) {
+    if (stack->size == stack->capacity) {
+        size_t capacity = stack->capacity == 0 ? 8 : 2 * stack->capacity;
+        struct ReverseBatchLevel *levels =
+                realloc(stack->levels,
+                        capacity * sizeof(struct ReverseBatchLevel));
+        if (levels == NULL) {
+            return false;
         }
+        stack->levels = levels;
+        stack->capacity = capacity;
+    }
+
+    List list = radixTreeGetNodeData(node);
+    struct ReverseBatchLevel *level = &stack->levels[stack->size];
+    level->depth = depth;
+    level->count = 0;
+    level->prefixes = malloc(listSize(list, SIZE_MAX) * sizeof(char *));
+    if (level->prefixes == NULL) {
+        return false;
     }
+    stack->size++;
+
+    ListNode p;
+    for (p = listFirstNode(list); p != NULL; p = listNextNode(p)) {
+        char *prefix = radixGetFullText(listNodeGetValue(p));
+        if (prefix == NULL) {
+            return false;
+        }
+        level->prefixes[level->count++] = prefix;
+        stack->prefixes++;
+    }
+    return true;
+}
+
+/**
+ * @brief Uzupełnia stos o poziomy ścieżki do węzła @p node.
+ * Odkłada węzły z danymi głębsze niż szczyt stosu, od najpłytszego.
+ * @param[in, out] stack - wskaźnik na stos.
+ * @param[in] backward - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - węzeł reprezentujący najdłuższy dopasowany prefiks
+ *        numeru.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool phfwdReverseBatchDescend(struct ReverseBatchStack *stack,
+                                     RadixTree backward, RadixTreeNode node) {
+    size_t top = stack->size == 0 ? 0 : stack->levels[stack->size - 1].depth;
+    size_t firstNew = stack->size;
+
+    for (node = radixTreeDataAncestor(backward, node);
+         node != NULL && radixTreeTextLength(node) > top;
+         node = radixTreeDataFather(backward, node)) {
+        if (!phfwdReverseBatchPush(stack, node, radixTreeTextLength(node))) {
+            return false;
+        }
+    }
+
+    size_t i = firstNew, j = stack->size;
+    while (j > i + 1) {
+        struct ReverseBatchLevel tmp = stack->levels[i];
+        stack->levels[i++] = stack->levels[--j];
+        stack->levels[j] = tmp;
+    }
+    return true;
+}
+
+/**
+ * @brief Tworzy wynik dla numeru z poziomów na stosie.
+ * @param[in] stack - wskaźnik na stos poziomów ścieżki numeru.
+ * @param[in] num - numer.
+ * @return Posortowany ciąg numerów bez powtórzeń lub NULL w przypadku
+ *         problemów z pamięcią.
+ */
+static const struct PhoneNumbers *
+phfwdReverseBatchResult(const struct ReverseBatchStack *stack,
+                        const char *num) {
+    struct PhoneNumbers *result =
+            phfwdCreateRopeStructure(stack->prefixes + 1, num, NULL);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    size_t insertPtr = 0, i, j;
+    for (i = 0; i < stack->size; i++) {
+        const struct ReverseBatchLevel *level = &stack->levels[i];
+        for (j = 0; j < level->count; j++) {
+            result->prefixes[insertPtr] = duplicateText(level->prefixes[j]);
+            result->suffixes[insertPtr] = level->depth;
+            if (result->prefixes[insertPtr++] == NULL) {
+                phnumDelete(result);
+                return NULL;
+            }
+        }
+    }
+    if (!phfwdRopeSortOut(result, NULL)) {
+        phnumDelete(result);
+        return NULL;
+    }
+    return result;
+}
+
+/**
+ * @brief Wyznacza wyniki phfwdReverseBatch dla posortowanych numerów.
+ * @param[in] backward - wskaźnik na drzewo PhoneForward->backward.
+ * @param[in] inputs - posortowane poprawne numery wejściowe.
+ * @param[in] count - liczba numerów.
+ * @param[out] results - tablica wyników indeksowana pozycjami wejściowymi.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool phfwdReverseBatchSorted(RadixTree backward,
+                                    const struct ReverseBatchInput *inputs,
+                                    size_t count,
+                                    const struct PhoneNumbers **results) {
+    struct ReverseBatchStack stack = {NULL, 0, 0, 0};
+    bool success = true;
+    const char *previous = "";
+
+    size_t i;
+    for (i = 0; i < count && success; i++) {
+        const char *num = inputs[i].num;
+        size_t common = 0;
+        while (num[common] != '\0' && num[common] == previous[common]) {
+            common++;
+        }
+        while (stack.size > 0 && stack.levels[stack.size - 1].depth > common) {
+            phfwdReverseBatchPop(&stack);
+        }
+
+        RadixTreeNode ptr;
+        const char *matchedTxt;
+        phfwdSetPointersForGettingText(backward, num, &ptr, &matchedTxt);
+
+        success = phfwdReverseBatchDescend(&stack, backward, ptr);
+        if (success) {
+            results[inputs[i].index] = phfwdReverseBatchResult(&stack, num);
+            success = results[inputs[i].index] != NULL;
+        }
+        previous = num;
+    }
+
+    while (stack.size > 0) {
+        phfwdReverseBatchPop(&stack);
+    }
+    free(stack.levels);
+    return success;
+}
+
+bool phfwdReverseBatch(struct PhoneForward *pf, const char *const *nums,
+                       size_t count, const struct PhoneNumbers **results) {
+    size_t i, valid = 0;
+    for (i = 0; i < count; i++) {
+        results[i] = NULL;
+    }
+
+    struct ReverseBatchInput *inputs =
+            malloc((count + 1) * sizeof(struct ReverseBatchInput));
+    if (inputs == NULL) {
+        return false;
+    }
+
+    bool success = true;
+    for (i = 0; i < count && success; i++) {
+        if (phfwdIsNumber(nums[i])) {
+            inputs[valid].num = nums[i];
+            inputs[valid].index = i;
+            valid++;
+        } else {
+            results[i] = phfwdEmptySequenceResult();
+            success = results[i] != NULL;
+        }
+    }
+
+    if (success) {
+        qsort(inputs, valid, sizeof(struct ReverseBatchInput),
+              phfwdReverseBatchCompare);
+        phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+        success = phfwdReverseBatchSorted(pf->backward, inputs, valid,
+                                          results);
+        phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+    }
+    free(inputs);
+
+    if (!success) {
+        for (i = 0; i < count; i++) {
+            phnumDelete(results[i]);
+            results[i] = NULL;
+        }
+    }
+    return success;
+}
+
+size_t phfwdNonTrivialCount(struct PhoneForward *pf, const char *set, size_t len) {
+    if (pf == NULL || set == NULL || len == 0) {
+        return 0;
+    } else {
+        bool availableDigits[CHARACTER_NUMBER_OF_DIGITS];
+        size_t howManyDigitsAvailable =
+                phfwdNonTrivialCountExtractDigitsFromSet(set, availableDigits);
+
+        if (howManyDigitsAvailable == 0) {
+            return 0;
+        } else {
+            PROBE2(nontrivial__entry, howManyDigitsAvailable, len);
+            phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+            size_t result = radixTreeNonTrivialCount(pf->backward,
+                                                     len,
+                                                     availableDigits,
+                                                     howManyDigitsAvailable);
+            phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+            PROBE1(nontrivial__return, result);
+            return result;
+        }
+    }
+}
+
+bool phfwdNonTrivialCountMany(struct PhoneForward *pf,
+                              const char *const *sets, const size_t *lens,
+                              size_t n, size_t *out) {
+    size_t i;
+    if (pf == NULL || sets == NULL || lens == NULL) {
+        for (i = 0; i < n; i++) {
+            out[i] = 0;
+        }
+        return true;
+    }
+
+    size_t *digitMasks = malloc((n + 1) * sizeof(size_t));
+    size_t *howManyDigits = malloc((n + 1) * sizeof(size_t));
+    if (digitMasks == NULL || howManyDigits == NULL) {
+        free(digitMasks);
+        free(howManyDigits);
+        return false;
+    }
+
+    for (i = 0; i < n; i++) {
+        bool availableDigits[CHARACTER_NUMBER_OF_DIGITS];
+        digitMasks[i] = 0;
+        howManyDigits[i] = 0;
+        if (sets[i] != NULL) {
+            howManyDigits[i] = phfwdNonTrivialCountExtractDigitsFromSet(
+                    sets[i], availableDigits);
+            size_t j;
+            for (j = 0; j < CHARACTER_NUMBER_OF_DIGITS; j++) {
+                if (availableDigits[j]) {
+                    digitMasks[i] |= (size_t) 1 << j;
+                }
+            }
+        }
+    }
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    bool result = radixTreeNonTrivialCountMany(pf->backward, n, digitMasks,
+                                               lens, howManyDigits, out);
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    free(digitMasks);
+    free(howManyDigits);
+    return result;
+}
+
+/**
+ * @brief Liczba próbek losowanych między sprawdzeniami warunku stopu.
+ */
+#define PHFWD_ESTIMATE_BATCH 64
+
+/**
+ * @brief Kwantyl rozkładu normalnego dla 95% przedziału ufności.
+ */
+#define PHFWD_ESTIMATE_Z 1.96
+
+/**
+ * @return Czas w sekundach od ustalonej chwili.
+ */
+static double phfwdEstimateNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+bool phfwdNonTrivialCountEstimate(struct PhoneForward *pf, const char *set,
+                                  size_t len,
+                                  const struct PhoneForwardEstimateBudget *budget,
+                                  struct PhoneForwardEstimate *result) {
+    if (budget == NULL || result == NULL) {
+        return false;
+    }
+    result->estimate = result->low = result->high = 0;
+    result->samples = 0;
+    result->exact = true;
+    if (pf == NULL || set == NULL || len == 0) {
+        return true;
+    }
+
+    bool availableDigits[CHARACTER_NUMBER_OF_DIGITS];
+    size_t howManyDigitsAvailable =
+            phfwdNonTrivialCountExtractDigitsFromSet(set, availableDigits);
+    if (howManyDigitsAvailable == 0) {
+        return true;
+    }
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    size_t exact;
+    if (radixTreeNonTrivialCountLimited(pf->backward, len, availableDigits,
+                                        howManyDigitsAvailable,
+                                        budget->exactLimit, &exact, NULL)) {
+        phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+        result->estimate = result->low = result->high = (double) exact;
+        return true;
+    }
+
+    uint64_t random = budget->seed;
+    if (random == 0) {
+        random = (uint64_t) (phfwdEstimateNow() * 1e9) ^ (uintptr_t) result;
+    }
+    random |= 1;
+
+    size_t maxSamples = budget->maxSamples;
+    if (maxSamples == 0 && budget->relativeError <= 0
+        && budget->timeLimit <= 0) {
+        maxSamples = PHFWD_ESTIMATE_DEFAULT_SAMPLES;
+    }
+    double deadline = phfwdEstimateNow() + budget->timeLimit;
+    double sum = 0, sumSquares = 0, mean = 0, halfWidth = 0;
+    size_t samples = 0;
+    bool stop = false;
+
+    while (!stop) {
+        size_t i;
+        for (i = 0; i < PHFWD_ESTIMATE_BATCH
+                    && (maxSamples == 0 || samples < maxSamples); i++) {
+            double x = radixTreeNonTrivialCountSample(pf->backward, len,
+                                                      availableDigits,
+                                                      howManyDigitsAvailable,
+                                                      &random);
+            sum += x;
+            sumSquares += x * x;
+            samples++;
+        }
+
+        mean = sum / (double) samples;
+        double variance = 0;
+        if (samples > 1) {
+            variance = (sumSquares - sum * mean) / (double) (samples - 1);
+        }
+        halfWidth = PHFWD_ESTIMATE_Z
+                    * sqrt(variance / (double) samples);
+
+        stop = (maxSamples != 0 && samples >= maxSamples)
+               || (budget->timeLimit > 0 && phfwdEstimateNow() >= deadline)
+               || (budget->relativeError > 0
+                   && halfWidth <= budget->relativeError * mean);
+    }
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    result->estimate = mean;
+    result->low = mean > halfWidth ? mean - halfWidth : 0;
+    result->high = mean + halfWidth;
+    result->samples = samples;
+    result->exact = false;
+    return true;
+}
+
+/**
+ * @return Czas w nanosekundach od ustalonej chwili.
+ */
+static uint64_t phfwdExplainNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+/**
+ * @brief Zeruje koszt zapytania.
+ * @param[out] explain - koszt zapytania.
+ */
+static void phfwdExplainClear(struct PhoneForwardExplain *explain) {
+    explain->nodes = 0;
+    explain->chars = 0;
+    explain->blocks = 0;
+    explain->listEntries = 0;
+    explain->allocations = 0;
+    explain->descentTime = 0;
+    explain->climbTime = 0;
+    explain->buildTime = 0;
+    explain->sortTime = 0;
+}
+
+/**
+ * @brief Dolicza koszt przejścia po drzewie do kosztu zapytania.
+ * @param[in, out] explain - koszt zapytania.
+ * @param[in] stats - koszt przejścia po drzewie.
+ */
+static void phfwdExplainAddStats(struct PhoneForwardExplain *explain,
+                                 const struct RadixTreeStats *stats) {
+    explain->nodes += stats->nodes;
+    explain->chars += stats->chars;
+    explain->blocks += stats->blocks;
+    explain->listEntries += stats->listEntries;
+    explain->allocations += stats->allocations;
+}
+
+/**
+ * @brief Tworzy wszystkie numery zapisane jako prefiks i sufiks zapytania.
+ * Po wykonaniu phnumGet nie alokuje już pamięci.
+ * @param[in, out] pnum - wskaźnik na strukturę z numerami.
+ * @param[in, out] stats - wskaźnik na licznik kosztu.
+ * @return W przypadku sukcesu true, w przypadku problemów z pamięcią false.
+ */
+static bool phfwdExplainMaterialize(struct PhoneNumbers *pnum,
+                                    struct RadixTreeStats *stats) {
+    size_t i;
+    for (i = 0; i < pnum->howMany; i++) {
+        if (pnum->numbers[i] == NULL) {
+            if (phnumGet(pnum, i) == NULL) {
+                return false;
+            }
+            stats->allocations++;
+        }
+    }
+    return true;
+}
+
+const struct PhoneNumbers *phfwdExplainGet(struct PhoneForward *pf,
+                                           const char *num,
+                                           struct PhoneForwardExplain *explain) {
+    phfwdExplainClear(explain);
+    if (!phfwdIsNumber(num)) {
+        return phfwdEmptySequenceResult();
+    }
+
+    struct RadixTreeStats stats = {0, 0, 0, 0, 0};
+    struct PhoneNumbers *result =
+            phfwdCreatePhoneNumbersStructureCounted(1, &stats);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    unsigned int mask = phfwdLockValidated(pf, phfwdStripeOf(num),
+                                           phfwdGetStripes, num);
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+
+    uint64_t start = phfwdExplainNow();
+    phfwdSetPointersForGettingTextCounted(pf->forward, num, &ptr,
+                                          &matchedTxt, &stats);
+    uint64_t descended = phfwdExplainNow();
+    RadixTreeNode redirection =
+            radixTreeDataAncestorCounted(pf->forward, ptr, &stats);
+    ptr = redirection == NULL ? pf->forward : redirection;
+    matchedTxt = num + radixTreeTextLength(ptr);
+    uint64_t climbed = phfwdExplainNow();
+    const char *number = phfwdRedirectedNumber(ptr, matchedTxt, &stats);
+    uint64_t built = phfwdExplainNow();
+    phfwdUnlockStripes(pf, mask);
+
+    phfwdExplainAddStats(explain, &stats);
+    explain->descentTime = descended - start;
+    explain->climbTime = climbed - descended;
+    explain->buildTime = built - climbed;
+    if (number == NULL) {
+        phnumDelete(result);
+        return NULL;
+    }
+    result->numbers[0] = (char *) number;
+    return result;
+}
+
+const struct PhoneNumbers *phfwdExplainReverse(struct PhoneForward *pf,
+                                               const char *num,
+                                               struct PhoneForwardExplain *explain) {
+    phfwdExplainClear(explain);
+    if (!phfwdIsNumber(num)) {
+        return phfwdEmptySequenceResult();
+    }
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    struct RadixTreeStats stats = {0, 0, 0, 0, 0};
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+
+    uint64_t start = phfwdExplainNow();
+    phfwdSetPointersForGettingTextCounted(pf->backward, num, &ptr,
+                                          &matchedTxt, &stats);
+    uint64_t descended = phfwdExplainNow();
+    size_t numberOfRedirections = phfwdHowManyRedirections(pf->backward,
+                                                           ptr, &stats);
+    uint64_t climbed = phfwdExplainNow();
+
+    struct PhoneNumbers *result =
+            phfwdCreateRopeStructure(numberOfRedirections, num, &stats);
+    bool success = result != NULL
+                   && phfwdAddRedir(result, pf->backward, ptr, &stats);
+    uint64_t built = phfwdExplainNow();
+    success = success && phfwdRopeSortOut(result, &stats);
+    uint64_t sorted = phfwdExplainNow();
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    success = success && phfwdExplainMaterialize(result, &stats);
+    uint64_t materialized = phfwdExplainNow();
+
+    phfwdExplainAddStats(explain, &stats);
+    explain->descentTime = descended - start;
+    explain->climbTime = climbed - descended;
+    explain->buildTime = (built - climbed) + (materialized - sorted);
+    explain->sortTime = sorted - built;
+    if (!success) {
+        phnumDelete(result);
+        return NULL;
+    }
+    return result;
+}
+
+size_t phfwdExplainNonTrivialCount(struct PhoneForward *pf, const char *set,
+                                   size_t len,
+                                   struct PhoneForwardExplain *explain) {
+    phfwdExplainClear(explain);
+    if (pf == NULL || set == NULL || len == 0) {
+        return 0;
+    }
+
+    bool availableDigits[CHARACTER_NUMBER_OF_DIGITS];
+    size_t howManyDigitsAvailable =
+            phfwdNonTrivialCountExtractDigitsFromSet(set, availableDigits);
+    if (howManyDigitsAvailable == 0) {
+        return 0;
+    }
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    struct RadixTreeStats stats = {0, 0, 0, 0, 0};
+    size_t result;
+    uint64_t start = phfwdExplainNow();
+    radixTreeNonTrivialCountLimited(pf->backward, len, availableDigits,
+                                    howManyDigitsAvailable, SIZE_MAX, &result,
+                                    &stats);
+    explain->descentTime = phfwdExplainNow() - start;
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    phfwdExplainAddStats(explain, &stats);
+    return result;
+}
+
+/**
+ * @brief Dane dla funkcji przeglądającej przekierowania.
+ * @see phfwdForEach
+ */
+struct ForEachFoldData {
+    /**
+     * @brief Funkcja przetwarzająca przekierowanie.
+     */
+    bool (*f)(const char *, const char *, void *);
+
+    /**
+     * @brief Dane do funkcji @p f.
+     */
+    void *data;
+
+    /**
+     * @brief Czy przeglądanie zostało przerwane.
+     */
+    bool stopped;
+};
+
+/**
+ * @brief Przekazuje przekierowanie z węzła @p node do funkcji użytkownika.
+ * @see ForEachFoldData
+ * @see radixTreeFoldNodes
+ * @param[in] node - węzeł drzewa PhoneForward->forward z przypisanymi danymi.
+ * @param[in, out] fData - wskaźnik na ForEachFoldData.
+ */
+static void phfwdForEachVisit(RadixTreeNode node, void *fData) {
+    struct ForEachFoldData *fefd = (struct ForEachFoldData *) fData;
+    if (fefd->stopped) {
+        return;
+    }
+
+    ForwardData fd = (ForwardData) radixTreeGetNodeData(node);
+    char *num1 = radixGetFullText(node);
+    char *num2 = radixGetFullText(fd->treeNode);
+
+    if (num1 == NULL || num2 == NULL
+        || !fefd->f(num1, num2, fefd->data)) {
+        fefd->stopped = true;
+    }
+
+    free(num1);
+    free(num2);
+}
+
+bool phfwdForEach(struct PhoneForward *pf,
+                  bool (*f)(const char *, const char *, void *), void *data) {
+    struct ForEachFoldData fefd;
+    fefd.f = f;
+    fefd.data = data;
+    fefd.stopped = false;
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    radixTreeFoldNodes(pf->forward, phfwdForEachVisit, &fefd);
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    return !fefd.stopped;
+}
+
+void phfwdSetHitCounting(struct PhoneForward *pf, bool enabled) {
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    pf->countHits = enabled;
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+}
+
+/**
+ * @brief Dane dla funkcji przeglądającej liczniki użyć przekierowań.
+ * @see phfwdForEachHits
+ */
+struct HitsFoldData {
+    /**
+     * @brief Funkcja przetwarzająca przekierowanie.
+     */
+    bool (*f)(const char *, const char *, uint64_t, void *);
+
+    /**
+     * @brief Dane do funkcji @p f.
+     */
+    void *data;
+
+    /**
+     * @brief Największa liczba użyć przekazywanego przekierowania.
+     */
+    uint64_t maxHits;
+
+    /**
+     * @brief Czy wyzerować liczniki.
+     */
+    bool reset;
+
+    /**
+     * @brief Czy przeglądanie zostało przerwane.
+     */
+    bool stopped;
+};
+
+/**
+ * @brief Przekazuje przekierowanie i jego licznik do funkcji użytkownika.
+ * @see HitsFoldData
+ * @see radixTreeFoldNodes
+ * @param[in] node - węzeł drzewa PhoneForward->forward z przypisanymi danymi.
+ * @param[in, out] fData - wskaźnik na HitsFoldData.
+ */
+static void phfwdForEachHitsVisit(RadixTreeNode node, void *fData) {
+    struct HitsFoldData *hfd = (struct HitsFoldData *) fData;
+    ForwardData fd = (ForwardData) radixTreeGetNodeData(node);
+    uint64_t hits = fd->hits;
+    if (hfd->reset) {
+        fd->hits = 0;
+    }
+    if (hfd->stopped || hits > hfd->maxHits) {
+        return;
+    }
+
+    char *num1 = radixGetFullText(node);
+    char *num2 = radixGetFullText(fd->treeNode);
+
+    if (num1 == NULL || num2 == NULL
+        || !hfd->f(num1, num2, hits, hfd->data)) {
+        hfd->stopped = true;
+    }
+
+    free(num1);
+    free(num2);
+}
+
+bool phfwdForEachHits(struct PhoneForward *pf, uint64_t maxHits, bool reset,
+                      bool (*f)(const char *, const char *, uint64_t, void *),
+                      void *data) {
+    struct HitsFoldData hfd;
+    hfd.f = f;
+    hfd.data = data;
+    hfd.maxHits = maxHits;
+    hfd.reset = reset;
+    hfd.stopped = false;
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    radixTreeFoldNodes(pf->forward, phfwdForEachHitsVisit, &hfd);
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    return !hfd.stopped;
+}
+
+/**
+ * @brief Porównuje przekierowanie przedziału numerów w dwóch strukturach.
+ * @see phfwdEquivalent
+ * @param[in] a - wskaźnik na pierwszą strukturę.
+ * @param[in] b - wskaźnik na drugą strukturę.
+ * @param[in] region - prefiks przedziału.
+ * @param[in] f - wskaźnik na funkcję przetwarzającą różnicę lub NULL.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p f.
+ * @param[in, out] equivalent - ustawiany na false, jeżeli przedział jest
+ *        przekierowywany różnie.
+ * @param[out] stop - ustawiany na true, jeżeli należy przerwać porównywanie
+ *        (@p f zwróciła false lub ma wartość NULL).
+ * @return false w przypadku problemów z przydzieleniem pamięci, true
+ *         w przeciwnym przypadku.
+ */
+static bool phfwdEquivalentRegion(struct PhoneForward *a,
+                                  struct PhoneForward *b, const char *region,
+                                  bool (*f)(const char *, const char *,
+                                            const char *, void *),
+                                  void *data, bool *equivalent, bool *stop) {
+    const char *resultA = phfwdGetNumber(a->forward, region, false);
+    const char *resultB = phfwdGetNumber(b->forward, region, false);
+    bool result = resultA != NULL && resultB != NULL;
+    if (result && strcmp(resultA, resultB) != 0) {
+        *equivalent = false;
+        if (f == NULL || !f(region, resultA, resultB, data)) {
+            *stop = true;
+        }
+    }
+    free((char *) resultA);
+    free((char *) resultB);
+    return result;
+}
+
+bool phfwdEquivalent(struct PhoneForward *a, struct PhoneForward *b,
+                     bool (*f)(const char *, const char *, const char *,
+                               void *),
+                     void *data, bool *equivalent) {
+    *equivalent = true;
+    if (a == b) {
+        return true;
+    }
+
+    struct PhoneForward *first = a < b ? a : b;
+    struct PhoneForward *second = a < b ? b : a;
+    phfwdLockStripes(first, PHFWD_ALL_STRIPES);
+    phfwdLockStripes(second, PHFWD_ALL_STRIPES);
+
+    bool success = true;
+    bool stop = false;
+    RadixTreeNode nodeA = radixTreeNextData(a->forward, NULL);
+    RadixTreeNode nodeB = radixTreeNextData(b->forward, NULL);
+    char *textA = nodeA == NULL ? NULL : radixGetFullText(nodeA);
+    char *textB = nodeB == NULL ? NULL : radixGetFullText(nodeB);
+    while (success && !stop && (nodeA != NULL || nodeB != NULL)) {
+        if ((nodeA != NULL && textA == NULL)
+            || (nodeB != NULL && textB == NULL)) {
+            success = false;
+            break;
+        }
+
+        int cmp = nodeA == NULL ? 1 : nodeB == NULL ? -1 : strcmp(textA, textB);
+        success = phfwdEquivalentRegion(a, b, cmp <= 0 ? textA : textB,
+                                        f, data, equivalent, &stop);
+        if (cmp <= 0) {
+            free(textA);
+            nodeA = radixTreeNextData(a->forward, nodeA);
+            textA = nodeA == NULL ? NULL : radixGetFullText(nodeA);
+        }
+        if (cmp >= 0) {
+            free(textB);
+            nodeB = radixTreeNextData(b->forward, nodeB);
+            textB = nodeB == NULL ? NULL : radixGetFullText(nodeB);
+        }
+    }
+    free(textA);
+    free(textB);
+
+    phfwdUnlockStripes(second, PHFWD_ALL_STRIPES);
+    phfwdUnlockStripes(first, PHFWD_ALL_STRIPES);
+    return success;
+}
+
+/**
+ * @brief Dane dla funkcji przeglądającej przedziały numerów.
+ * @see phfwdResolveRange
+ */
+struct RangeFoldData {
+    /**
+     * @brief Funkcja przetwarzająca przedział.
+     */
+    bool (*f)(const char *, const char *, const char *, const char *, void *);
+
+    /**
+     * @brief Dane do funkcji @p f.
+     */
+    void *data;
+
+    /**
+     * @brief Węzeł już zgłoszony jako pierwszy przedział lub NULL.
+     */
+    RadixTreeNode skip;
+
+    /**
+     * @brief Czy przeglądanie zostało przerwane.
+     */
+    bool stopped;
+};
+
+/**
+ * @brief Zgłasza przedział numerów przekierowywanych przez jedno
+ * przekierowanie.
+ * @param[in, out] rfd - wskaźnik na RangeFoldData.
+ * @param[in] prefix - prefiks przedziału.
+ * @param[in] node - węzeł drzewa PhoneForward->forward z przekierowaniem
+ *        stosowanym w przedziale lub korzeń, jeżeli numery z przedziału nie
+ *        są przekierowywane.
+ * @param[in] suffix - część @p prefix następująca po prefiksie
+ *        reprezentowanym przez @p node.
+ */
+static void phfwdRangeEmit(struct RangeFoldData *rfd, const char *prefix,
+                           RadixTreeNode node, const char *suffix) {
+    char *source = NULL;
+    char *target = NULL;
+    char *result = NULL;
+    if (radixTreeIsRoot(node)) {
+        result = duplicateText(prefix);
+    } else {
+        ForwardData fd = (ForwardData) radixTreeGetNodeData(node);
+        source = radixGetFullText(node);
+        target = radixGetFullText(fd->treeNode);
+        result = target == NULL ? NULL : concatenate(target, suffix);
+    }
+
+    if (result == NULL || (!radixTreeIsRoot(node) && source == NULL)
+        || !rfd->f(prefix, source, target, result, rfd->data)) {
+        rfd->stopped = true;
+    }
+
+    free(source);
+    free(target);
+    free(result);
+}
+
+/**
+ * @brief Zgłasza przedział numerów z prefiksem reprezentowanym przez węzeł.
+ * @see RangeFoldData
+ * @see radixTreeFoldNodes
+ * @param[in] node - węzeł drzewa PhoneForward->forward z przypisanymi danymi.
+ * @param[in, out] fData - wskaźnik na RangeFoldData.
+ */
+static void phfwdResolveRangeVisit(RadixTreeNode node, void *fData) {
+    struct RangeFoldData *rfd = (struct RangeFoldData *) fData;
+    if (rfd->stopped || node == rfd->skip) {
+        return;
+    }
+
+    char *prefix = radixGetFullText(node);
+    if (prefix == NULL) {
+        rfd->stopped = true;
+    } else {
+        phfwdRangeEmit(rfd, prefix, node, prefix + strlen(prefix));
+        free(prefix);
+    }
+}
+
+bool phfwdResolveRange(struct PhoneForward *pf, const char *prefix,
+                       bool (*f)(const char *, const char *, const char *,
+                                 const char *, void *),
+                       void *data) {
+    if (!phfwdIsNumber(prefix)) {
+        return false;
+    }
+
+    struct RangeFoldData rfd;
+    rfd.f = f;
+    rfd.data = data;
+    rfd.skip = NULL;
+    rfd.stopped = false;
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+    phfwdFindRedirection(pf->forward, prefix, &ptr, &matchedTxt);
+    phfwdRangeEmit(&rfd, prefix, ptr, matchedTxt);
+
+    RadixTreeNode subTreeNode;
+    int findResult = radixTreeFindLite(pf->forward, prefix, &subTreeNode);
+    if (!rfd.stopped && (findResult == RADIX_TREE_FOUND
+                         || findResult == RADIX_TREE_SUBSTR)) {
+        rfd.skip = ptr;
+        radixTreeFoldNodes(subTreeNode, phfwdResolveRangeVisit, &rfd);
+    }
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    return !rfd.stopped;
+}
+
+/**
+ * @brief Dane dla funkcji przeglądającej najczęstsze cele przekierowań.
+ * @see phfwdForEachTopTarget
+ */
+struct TopTargetsData {
+    /**
+     * @brief Funkcja przetwarzająca cel.
+     */
+    bool (*f)(const char *, size_t, void *);
+
+    /**
+     * @brief Dane do funkcji @p f.
+     */
+    void *data;
+};
+
+/**
+ * @brief Przekazuje cel przekierowań do funkcji użytkownika.
+ * @see fanInForEachTop
+ * @param[in] node - węzeł drzewa PhoneForward->backward.
+ * @param[in] count - liczba przekierowań na węzeł.
+ * @param[in, out] data - wskaźnik na TopTargetsData.
+ * @return false jeżeli należy przerwać przeglądanie.
+ */
+static bool phfwdTopTargetsVisit(void *node, size_t count, void *data) {
+    struct TopTargetsData *ttd = (struct TopTargetsData *) data;
+    char *target = radixGetFullText(node);
+    bool result = target != NULL && ttd->f(target, count, ttd->data);
+    free(target);
+    return result;
+}
+
+bool phfwdForEachTopTarget(struct PhoneForward *pf, size_t k,
+                           bool (*f)(const char *, size_t, void *),
+                           void *data) {
+    struct TopTargetsData ttd;
+    ttd.f = f;
+    ttd.data = data;
+
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    bool result = fanInForEachTop(pf->fanIn, k, phfwdTopTargetsVisit, &ttd);
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    return result;
+}
+
+/**
+ * @brief Dane dla funkcji przeglądającej zmiany.
+ * @see phfwdForEachChange
+ */
+struct ChangesFoldData {
+    /**
+     * @brief Funkcja przetwarzająca usunięty prefiks.
+     */
+    bool (*removed)(const char *, void *);
+
+    /**
+     * @brief Dane do przeglądania przekierowań w zmienionych poddrzewach.
+     */
+    struct ForEachFoldData rules;
+};
+
+/**
+ * @brief Przekazuje zawartość zmienionego poddrzewa do funkcji użytkownika.
+ * Zgłasza prefiks reprezentowany przez @p node jako usunięty,
+ * a następnie wszystkie przekierowania z poddrzewa @p node.
+ * @see radixTreeFoldDirty
+ * @param[in] node - węzeł drzewa PhoneForward->forward.
+ * @param[in, out] fData - wskaźnik na ChangesFoldData.
+ */
+static void phfwdForEachChangeVisit(RadixTreeNode node, void *fData) {
+    struct ChangesFoldData *cfd = (struct ChangesFoldData *) fData;
+    assert(!radixTreeIsRoot(node));
+    if (cfd->rules.stopped) {
+        return;
+    }
+
+    char *prefix = radixGetFullText(node);
+    if (prefix == NULL || !cfd->removed(prefix, cfd->rules.data)) {
+        cfd->rules.stopped = true;
+    } else {
+        radixTreeFoldNodes(node, phfwdForEachVisit, &cfd->rules);
+    }
+    free(prefix);
+}
+
+bool phfwdForEachChange(struct PhoneForward *pf,
+                        bool (*removed)(const char *, void *),
+                        bool (*f)(const char *, const char *, void *),
+                        void *data) {
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    const char *ptr = vectorBegin(pf->removed);
+    const char *end = vectorEnd(pf->removed);
+    while (ptr != end) {
+        if (!removed(ptr, data)) {
+            phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+            return false;
+        }
+        ptr += strlen(ptr) + 1;
+    }
+
+    struct ChangesFoldData cfd;
+    cfd.removed = removed;
+    cfd.rules.f = f;
+    cfd.rules.data = data;
+    cfd.rules.stopped = false;
+
+    radixTreeFoldDirty(pf->forward, phfwdForEachChangeVisit, &cfd);
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+
+    return !cfd.rules.stopped;
+}
+
+bool phfwdHasChanges(struct PhoneForward *pf) {
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    bool result = pf->changesLost
+                  || vectorSize(pf->removed) != 0
+                  || radixTreeIsDirty(pf->forward);
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+    return result;
+}
+
+bool phfwdChangesComplete(struct PhoneForward *pf) {
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    bool result = !pf->changesLost;
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
+    return result;
+}
+
+void phfwdClearChanges(struct PhoneForward *pf) {
+    phfwdLockStripes(pf, PHFWD_ALL_STRIPES);
+    radixTreeClearDirty(pf->forward);
+    vectorClear(pf->removed);
+    pf->changesLost = false;
+    phfwdUnlockStripes(pf, PHFWD_ALL_STRIPES);
 }
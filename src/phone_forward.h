@@ -11,8 +11,21 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+/**
+ * @brief Liczba próbek losowanych przez @ref phfwdNonTrivialCountEstimate,
+ * gdy żadne ograniczenie próbkowania nie jest ustawione.
+ */
+#define PHFWD_ESTIMATE_DEFAULT_SAMPLES 4096
+
+/**
+ * @brief Termin wygaśnięcia oznaczający przekierowanie bez terminu.
+ * @see phfwdAddExpiring
+ */
+#define PHFWD_NO_EXPIRY 0
+
 /**
  * Struktura przechowująca przekierowania numerów telefonów.
  */
@@ -23,6 +36,11 @@ struct PhoneForward;
  */
 struct PhoneNumbers;
 
+/**
+ * Struktura przechowująca obserwatora numeru.
+ */
+struct PhoneForwardWatch;
+
 /** @brief Tworzy nową strukturę.
  * Tworzy nową strukturę niezawierającą żadnych przekierowań.
  * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
@@ -42,6 +60,10 @@ void phfwdDelete(struct PhoneForward *pf);
  * w których ten prefiks zamieniono odpowiednio na prefiks @p num2. Każdy numer
  * jest swoim własnym prefiksem. Jeśli wcześniej zostało dodane przekierowanie
  * z takim samym parametrem @p num1, to jest ono zastępowane.
+ * #### Złożoność
+ * Proporcjonalna do długości @p num1 i @p num2 oraz, gdy przekierowanie
+ * jest zastępowane, długości celu zastępowanego przekierowania.
+ * Każde drzewo rozcina co najwyżej jedną krawędź.
  * @param[in, out] pf   – wskaźnik na strukturę przechowującą przekierowania numerów;
  * @param[in] num1 – wskaźnik na napis reprezentujący prefiks numerów
  *                   przekierowywanych;
@@ -54,22 +76,96 @@ void phfwdDelete(struct PhoneForward *pf);
  */
 bool phfwdAdd(struct PhoneForward *pf, const char *num1, const char *num2);
 
+/** @brief Dodaje przekierowanie, które wygasa.
+ * Działa jak @ref phfwdAdd, ale dodane przekierowanie zostanie usunięte
+ * przez @ref phfwdAdvanceClock, gdy czas logiczny osiągnie @p expiresAt.
+ * Usuwane jest tylko to przekierowanie, a nie wszystkie z prefiksem
+ * @p num1. Zastąpienie przekierowania (także przez @ref phfwdAdd) lub jego
+ * usunięcie anuluje termin.
+ * @param[in, out] pf   – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num1 – wskaźnik na napis reprezentujący prefiks numerów
+ *                   przekierowywanych;
+ * @param[in] num2 – wskaźnik na napis reprezentujący prefiks numerów, na które
+ *                   jest wykonywane przekierowanie;
+ * @param[in] expiresAt – termin wygaśnięcia w czasie logicznym lub
+ *                   PHFWD_NO_EXPIRY.
+ * @return Wartość @p true, jeśli przekierowanie zostało dodane.
+ *         Wartość @p false w tych samych przypadkach co @ref phfwdAdd.
+ */
+bool phfwdAddExpiring(struct PhoneForward *pf, const char *num1,
+                      const char *num2, uint64_t expiresAt);
+
+/** @brief Przesuwa czas logiczny.
+ * Ustawia czas logiczny na @p now (jeśli jest późniejszy niż bieżący)
+ * i usuwa wszystkie przekierowania, których termin wygaśnięcia nie jest
+ * późniejszy niż @p now. Koszt jest proporcjonalny do liczby usuniętych
+ * przekierowań (zamortyzowany O(1) na przekierowanie, nie licząc
+ * wyrównania drzew). Początkowo czas logiczny wynosi 0.
+ * @param[in, out] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] now – nowy czas logiczny.
+ * @return Liczba usuniętych przekierowań.
+ */
+size_t phfwdAdvanceClock(struct PhoneForward *pf, uint64_t now);
+
 /** @brief Usuwa przekierowania.
  * Usuwa wszystkie przekierowania, w których parametr @p num jest prefiksem
  * parametru @p num1 użytego przy dodawaniu. Jeśli nie ma takich przekierowań
  * lub napis nie reprezentuje numeru, nic nie robi.
+ * Po usunięciu zbędne węzły drzew są usuwane lub scalane, więc naprzemienne
+ * dodawanie i usuwanie przekierowań nie zwiększa rozmiaru drzew.
+ * #### Złożoność
+ * Proporcjonalna do długości @p num, liczby węzłów usuwanego poddrzewa
+ * i łącznej długości celów usuwanych przekierowań.
  *
  * @param[in, out] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
  * @param[in] num – wskaźnik na napis reprezentujący prefiks numerów.
  */
 void phfwdRemove(struct PhoneForward *pf, const char *num);
 
+/**
+ * @brief Zmiana stosowana przez @ref phfwdApplyChanges.
+ */
+struct PhoneForwardChange {
+    /**
+     * @brief Prefiks przekierowywany lub usuwany.
+     */
+    const char *num1;
+
+    /**
+     * @brief Prefiks, na który jest przekierowywany @p num1, lub NULL, jeśli
+     * należy usunąć przekierowania z prefiksem @p num1.
+     */
+    const char *num2;
+};
+
+/** @brief Stosuje ciąg zmian.
+ * Stosuje kolejno zmiany z tablicy @p changes: zmiana z polem num2 różnym
+ * od NULL działa jak @ref phfwdAdd, a pozostałe jak @ref phfwdRemove.
+ * Wszystkie pasy są blokowane raz na cały ciąg zamiast osobno dla każdej
+ * zmiany, więc inne wątki widzą stan sprzed ciągu albo wynik jego
+ * zastosowanej części. Obserwatorzy są powiadamiani tak jak przy
+ * pojedynczych zmianach.
+ * #### Złożoność
+ * Suma złożoności pojedynczych zmian.
+ * @param[in, out] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] changes – tablica zmian;
+ * @param[in] count – liczba zmian.
+ * @return Liczba zastosowanych zmian. Stosowanie kończy się na pierwszym
+ *         dodaniu, które się nie powiodło (z tych samych powodów co
+ *         @ref phfwdAdd), więc wynik mniejszy od @p count wskazuje tę zmianę.
+ */
+size_t phfwdApplyChanges(struct PhoneForward *pf,
+                         const struct PhoneForwardChange *changes,
+                         size_t count);
+
 /** @brief Wyznacza przekierowanie numeru.
  * Wyznacza przekierowanie podanego numeru. Szuka najdłuższego pasującego
  * prefiksu. Wynikiem jest co najwyżej jeden numer. Jeśli dany numer nie został
  * przekierowany, to wynikiem jest ten numer. Jeśli podany napis nie
  * reprezentuje numeru, wynikiem jest pusty ciąg. Alokuje strukturę
  * @p PhoneNumbers, która musi być zwolniona za pomocą funkcji @ref phnumDelete.
+ * #### Złożoność
+ * Proporcjonalna do długości @p num i długości wyniku.
  * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
  * @param[in] num – wskaźnik na napis reprezentujący numer.
  * @return Wskaźnik na strukturę przechowującą ciąg numerów lub NULL, gdy nie
@@ -83,6 +179,18 @@ const struct PhoneNumbers *phfwdGet(struct PhoneForward *pf, const char *num);
  * powtarzać. Jeśli podany napis nie reprezentuje numeru, wynikiem jest pusty
  * ciąg. Alokuje strukturę @p PhoneNumbers, która musi być zwolniona za pomocą
  * funkcji @ref phnumDelete.
+ * Numery wyniku są przechowywane jako pełny tekst źródła przekierowania
+ * i pozycja w jednej, wspólnej kopii @p num, a napis numeru powstaje
+ * dopiero przy pierwszym wywołaniu @ref phnumGet dla niego.
+ * #### Złożoność
+ * O(n + s + k log k * (p + 64)), gdzie n to długość @p num, k to liczba
+ * numerów wyniku (z powtórzeniami), p to długość najdłuższego źródła
+ * przekierowania, a s to łączna długość źródeł. Jeżeli sufiksy @p num mają
+ * wspólne prefiksy dłuższe niż 64 znaki, dochodzi jednorazowo O(n log n).
+ * Czas nie zależy od iloczynu k i n. Przy przejściu do korzenia
+ * odwiedzane są tylko węzły, na które coś jest przekierowane. Pierwsze
+ * zapytanie po zmianie przekierowań na numery o tej samej pierwszej cyfrze
+ * może dodatkowo raz przejść ścieżkę zejścia.
  * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
  * @param[in] num – wskaźnik na napis reprezentujący numer.
  * @return Wskaźnik na strukturę przechowującą ciąg numerów lub NULL, gdy nie
@@ -90,6 +198,109 @@ const struct PhoneNumbers *phfwdGet(struct PhoneForward *pf, const char *num);
  */
 const struct PhoneNumbers *phfwdReverse(struct PhoneForward *pf, const char *num);
 
+/**
+ * @brief Ograniczenia wyniku @ref phfwdReverseFiltered.
+ * @see phfwdReverseFiltered
+ */
+struct PhoneForwardReverseFilter {
+    /**
+     * @brief Minimalna długość numeru (0 - bez ograniczenia).
+     */
+    size_t minLength;
+
+    /**
+     * @brief Maksymalna długość numeru (0 - bez ograniczenia).
+     */
+    size_t maxLength;
+
+    /**
+     * @brief Napis zawierający dozwolone cyfry numeru
+     * (NULL - bez ograniczenia).
+     */
+    const char *digits;
+
+    /**
+     * @brief Wymagany prefiks numeru (NULL - bez ograniczenia).
+     */
+    const char *prefix;
+
+    /**
+     * @brief Maksymalna liczba numerów; zwracane są leksykograficznie
+     * najmniejsze (0 - bez ograniczenia).
+     */
+    size_t limit;
+};
+
+/** @brief Wyznacza przekierowania na dany numer z ograniczeniami.
+ * Wynik jest równy wynikowi @ref phfwdReverse, z którego usunięto numery
+ * niespełniające ograniczeń @p filter, a z pozostałych zostawiono
+ * @p filter->limit pierwszych. Ograniczenia są sprawdzane na tekście
+ * źródła przekierowania przed utworzeniem numeru, więc odrzucone numery
+ * nie są tworzone ani sortowane. Przy ograniczonej liczbie wyników
+ * przechowywane są tylko najmniejsze numery, a numer większy od
+ * największego z nich nie jest tworzony.
+ * Wynik musi być zwolniony za pomocą funkcji @ref phnumDelete.
+ * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num – wskaźnik na napis reprezentujący numer;
+ * @param[in] filter – wskaźnik na ograniczenia lub NULL (wtedy wynik jest
+ *                     równy wynikowi @ref phfwdReverse).
+ * @return Wskaźnik na strukturę przechowującą ciąg numerów lub NULL, gdy nie
+ *         udało się zaalokować pamięci.
+ */
+const struct PhoneNumbers *phfwdReverseFiltered(struct PhoneForward *pf,
+                                                const char *num,
+                                                const struct PhoneForwardReverseFilter *filter);
+
+/** @brief Liczy przekierowania na prefiksy numeru.
+ * Wyznacza liczbę przekierowań, których celem jest prefiks numeru @p num,
+ * bez wyznaczania wyniku @ref phfwdReverse. Wynik phfwdReverse(pf, num)
+ * ma co najwyżej o jeden numer więcej.
+ * #### Złożoność
+ * Proporcjonalna do długości @p num.
+ * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num – wskaźnik na napis reprezentujący numer.
+ * @return Liczba przekierowań lub 0, jeśli napis nie reprezentuje numeru.
+ */
+size_t phfwdReverseCount(struct PhoneForward *pf, const char *num);
+
+/** @brief Liczy przekierowywane prefiksy o danym prefiksie.
+ * #### Złożoność
+ * Proporcjonalna do długości @p prefix.
+ * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] prefix – wskaźnik na napis reprezentujący prefiks.
+ * @return Liczba przekierowań, których parametr @p num1 ma prefiks
+ *         @p prefix, lub 0, jeśli napis nie reprezentuje numeru.
+ */
+size_t phfwdSourcesCount(struct PhoneForward *pf, const char *prefix);
+
+/** @brief Liczy różne cele przekierowań o danym prefiksie.
+ * #### Złożoność
+ * Proporcjonalna do długości @p prefix.
+ * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] prefix – wskaźnik na napis reprezentujący prefiks.
+ * @return Liczba różnych numerów @p num2 przekierowań, które mają prefiks
+ *         @p prefix, lub 0, jeśli napis nie reprezentuje numeru.
+ */
+size_t phfwdTargetsCount(struct PhoneForward *pf, const char *prefix);
+
+/** @brief Wyznacza przekierowania na wiele numerów.
+ * Dla każdego i wyznacza @p results[i] taki jak wynik
+ * phfwdReverse(pf, nums[i]). Numery są przetwarzane w porządku
+ * leksykograficznym w jednym przejściu drzewa odwróconych przekierowań:
+ * prefiksy przekierowywane na wspólną część ścieżek kolejnych numerów
+ * są wyznaczane tylko raz. Każdy wynik musi być zwolniony za pomocą
+ * funkcji @ref phnumDelete.
+ * @param[in] pf  – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] nums – tablica wskaźników na napisy reprezentujące numery;
+ * @param[in] count – liczba numerów;
+ * @param[out] results – tablica na @p count wyników.
+ * @return Wartość @p true w przypadku sukcesu. Wartość @p false, gdy nie
+ *         udało się zaalokować pamięci, wtedy wszystkie wyniki mają wartość
+ *         NULL.
+ */
+bool phfwdReverseBatch(struct PhoneForward *pf, const char *const *nums,
+                       size_t count, const struct PhoneNumbers **results);
+
 /** @brief Usuwa strukturę.
  * Usuwa strukturę wskazywaną przez @p pnum. Nic nie robi, jeśli wskaźnik ten ma
  * wartość NULL.
@@ -97,13 +308,30 @@ const struct PhoneNumbers *phfwdReverse(struct PhoneForward *pf, const char *num
  */
 void phnumDelete(const struct PhoneNumbers *pnum);
 
+/** @brief Podaje liczbę numerów.
+ * Nie tworzy napisów numerów.
+ * #### Złożoność
+ * O(1)
+ * @param[in] pnum – wskaźnik na strukturę przechowującą ciąg napisów.
+ * @return Liczba numerów w @p pnum, 0 jeśli wskaźnik @p pnum ma wartość
+ *         NULL.
+ */
+size_t phnumSize(const struct PhoneNumbers *pnum);
+
 /** @brief Udostępnia numer.
  * Udostępnia wskaźnik na napis reprezentujący numer. Napisy są indeksowane
- * kolejno od zera.
+ * kolejno od zera. Napis numeru wyniku @ref phfwdReverse jest tworzony przy
+ * pierwszym wywołaniu dla danego indeksu i pozostaje ważny do usunięcia
+ * struktury, dlatego tej samej struktury nie należy odczytywać
+ * jednocześnie z kilku wątków.
+ * #### Złożoność
+ * Proporcjonalna do długości numeru przy pierwszym wywołaniu, O(1)
+ * przy kolejnych.
  * @param[in] pnum – wskaźnik na strukturę przechowującą ciąg napisów;
  * @param[in] idx  – indeks napisu.
  * @return Wskaźnik na napis. Wartość NULL, jeśli wskaźnik @p pnum ma wartość
- *         NULL lub indeks ma za dużą wartość.
+ *         NULL, indeks ma za dużą wartość lub nie udało się zaalokować
+ *         pamięci na napis.
  */
 const char *phnumGet(const struct PhoneNumbers *pnum, size_t idx);
 
@@ -114,6 +342,11 @@ const char *phnumGet(const struct PhoneNumbers *pnum, size_t idx);
  * lub parametr @p len jest równy zeru, wynikiem jest zero.
  * Obliczenia wykonywane są modulo dwa do potęgi liczba bitów reprezentacji typu
  * size_t.
+ * #### Złożoność
+ * Proporcjonalna do długości @p set oraz liczby odwiedzonych węzłów drzewa
+ * celów przekierowań (osiągalnych krawędziami z cyframi z @p set, płytszych
+ * niż @p len i bez celu na ścieżce) pomnożonej przez log(@p len).
+ * W najgorszym przypadku jest to rozmiar drzewa celów.
  * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
  * @param[in] set - wskaźnik na napis zawierający dozwolone cyfry.
  * @param[in] len - maksymalna długość numeru.
@@ -121,5 +354,404 @@ const char *phnumGet(const struct PhoneNumbers *pnum, size_t idx);
  */
 size_t phfwdNonTrivialCount(struct PhoneForward *pf, const char *set, size_t len);
 
+/** @brief Oblicza liczby nietrywialnych numerów dla wielu zapytań.
+ * Dla każdego i oblicza @p out[i] równe
+ * phfwdNonTrivialCount(pf, sets[i], lens[i]). Wszystkie zapytania są
+ * obliczane w jednym przejściu drzewa odwróconych przekierowań.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] sets - tablica wskaźników na napisy zawierające dozwolone cyfry;
+ * @param[in] lens - tablica długości numerów;
+ * @param[in] n - liczba zapytań;
+ * @param[out] out - tablica na @p n wyników.
+ * @return Wartość @p true w przypadku sukcesu, @p false gdy nie udało się
+ *         zaalokować pamięci.
+ */
+bool phfwdNonTrivialCountMany(struct PhoneForward *pf,
+                              const char *const *sets, const size_t *lens,
+                              size_t n, size_t *out);
+
+/**
+ * @brief Ograniczenia obliczania przybliżonej liczby nietrywialnych numerów.
+ * @see phfwdNonTrivialCountEstimate
+ */
+struct PhoneForwardEstimateBudget {
+    /**
+     * @brief Maksymalna liczba węzłów przeglądanych przez algorytm dokładny.
+     * Jeżeli wystarczy, wynik jest dokładny.
+     */
+    size_t exactLimit;
+
+    /**
+     * @brief Docelowy błąd względny: połowa szerokości przedziału ufności
+     * podzielona przez oszacowanie (0 - bez ograniczenia).
+     */
+    double relativeError;
+
+    /**
+     * @brief Maksymalny czas losowania próbek w sekundach
+     * (0 - bez ograniczenia).
+     */
+    double timeLimit;
+
+    /**
+     * @brief Maksymalna liczba próbek (0 - bez ograniczenia).
+     */
+    size_t maxSamples;
+
+    /**
+     * @brief Ziarno generatora liczb pseudolosowych (0 - losowe).
+     */
+    unsigned long long seed;
+};
+
+/**
+ * @brief Przybliżona liczba nietrywialnych numerów.
+ * @see phfwdNonTrivialCountEstimate
+ */
+struct PhoneForwardEstimate {
+    /**
+     * @brief Oszacowanie (bez obliczeń modulo).
+     */
+    double estimate;
+
+    /**
+     * @brief Dolny koniec 95% przedziału ufności.
+     */
+    double low;
+
+    /**
+     * @brief Górny koniec 95% przedziału ufności.
+     */
+    double high;
+
+    /**
+     * @brief Liczba wylosowanych próbek (0, gdy wynik jest dokładny).
+     */
+    size_t samples;
+
+    /**
+     * @brief Czy wynik został policzony dokładnie.
+     */
+    bool exact;
+};
+
+/** @brief Szacuje liczbę nietrywialnych numerów.
+ * Oblicza przybliżenie wyniku phfwdNonTrivialCount(pf, set, len).
+ * Najpierw próbuje policzyć wynik dokładnie, przeglądając co najwyżej
+ * budget->exactLimit węzłów drzewa odwróconych przekierowań (wtedy
+ * @p low i @p high są równe wynikowi). W przeciwnym przypadku losuje ścieżki
+ * w drzewie, dopóki połowa 95% przedziału ufności nie spadnie poniżej
+ * budget->relativeError oszacowania lub nie zostanie wyczerpany limit czasu
+ * albo liczby próbek. Jeżeli żadne ograniczenie próbkowania nie jest
+ * ustawione, losowanych jest PHFWD_ESTIMATE_DEFAULT_SAMPLES próbek.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] set - wskaźnik na napis zawierający dozwolone cyfry;
+ * @param[in] len - maksymalna długość numeru;
+ * @param[in] budget - ograniczenia obliczeń;
+ * @param[out] result - wynik.
+ * @return Wartość @p true w przypadku sukcesu, @p false gdy parametry są
+ *         niepoprawne.
+ */
+bool phfwdNonTrivialCountEstimate(struct PhoneForward *pf, const char *set,
+                                  size_t len,
+                                  const struct PhoneForwardEstimateBudget *budget,
+                                  struct PhoneForwardEstimate *result);
+
+/**
+ * @brief Koszt wykonania zapytania.
+ * @see phfwdExplainGet
+ * @see phfwdExplainReverse
+ * @see phfwdExplainNonTrivialCount
+ */
+struct PhoneForwardExplain {
+    /**
+     * @brief Liczba odwiedzonych węzłów drzewa (przy schodzeniu
+     * i wspinaniu się).
+     */
+    size_t nodes;
+
+    /**
+     * @brief Liczba porównanych znaków krawędzi.
+     */
+    size_t chars;
+
+    /**
+     * @brief Liczba przejrzanych bloków ciągów znaków krawędzi.
+     */
+    size_t blocks;
+
+    /**
+     * @brief Liczba przejrzanych pozycji list odwróconych przekierowań
+     * (przy liczeniu numerów i przy ich kopiowaniu).
+     */
+    size_t listEntries;
+
+    /**
+     * @brief Liczba bloków pamięci zaalokowanych na wynik i jego numery,
+     * numery pośrednie oraz tablice pomocnicze sortowania.
+     */
+    size_t allocations;
+
+    /**
+     * @brief Czas schodzenia w drzewie w nanosekundach.
+     */
+    uint64_t descentTime;
+
+    /**
+     * @brief Czas wspinania się do przekierowań w nanosekundach.
+     */
+    uint64_t climbTime;
+
+    /**
+     * @brief Czas budowania numerów wyniku w nanosekundach.
+     */
+    uint64_t buildTime;
+
+    /**
+     * @brief Czas sortowania wyniku w nanosekundach.
+     */
+    uint64_t sortTime;
+};
+
+/** @brief Wyznacza przekierowanie numeru, mierząc koszt zapytania.
+ * Działa jak @ref phfwdGet (nie zwiększa jednak liczników użyć
+ * przekierowań) i zapisuje koszt w @p explain.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num - wskaźnik na napis reprezentujący numer;
+ * @param[out] explain - koszt zapytania.
+ * @return Jak w @ref phfwdGet.
+ */
+const struct PhoneNumbers *phfwdExplainGet(struct PhoneForward *pf,
+                                           const char *num,
+                                           struct PhoneForwardExplain *explain);
+
+/** @brief Wyznacza przekierowania na dany numer, mierząc koszt zapytania.
+ * Działa jak @ref phfwdReverse i zapisuje koszt w @p explain. Numery wyniku
+ * są tworzone przed zakończeniem funkcji, a nie przy pierwszym
+ * @ref phnumGet, więc ich koszt wlicza się do czasu budowania i liczby
+ * alokacji.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num - wskaźnik na napis reprezentujący numer;
+ * @param[out] explain - koszt zapytania.
+ * @return Jak w @ref phfwdReverse.
+ */
+const struct PhoneNumbers *phfwdExplainReverse(struct PhoneForward *pf,
+                                               const char *num,
+                                               struct PhoneForwardExplain *explain);
+
+/** @brief Oblicza liczbę nietrywialnych numerów, mierząc koszt zapytania.
+ * Działa jak @ref phfwdNonTrivialCount i zapisuje koszt w @p explain
+ * (czas przeglądania drzewa jest czasem schodzenia).
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] set - wskaźnik na napis zawierający dozwolone cyfry;
+ * @param[in] len - maksymalna długość numeru;
+ * @param[out] explain - koszt zapytania.
+ * @return Jak w @ref phfwdNonTrivialCount.
+ */
+size_t phfwdExplainNonTrivialCount(struct PhoneForward *pf, const char *set,
+                                   size_t len,
+                                   struct PhoneForwardExplain *explain);
+
+/** @brief Przegląda przekierowania.
+ * Dla każdego przekierowania @p num1 na @p num2 przechowywanego przez @p pf
+ * wywołuje f(num1, num2, data). Przekierowania są przeglądane w porządku
+ * leksykograficznym względem @p num1. Przeglądanie zostaje przerwane, jeżeli
+ * @p f zwróci false.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] f - wskaźnik na funkcję przetwarzającą przekierowanie.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p f.
+ * @return Wartość @p true, jeśli przejrzano wszystkie przekierowania.
+ *         Wartość @p false, jeśli @p f zwróciła false lub nie udało się
+ *         zaalokować pamięci.
+ */
+bool phfwdForEach(struct PhoneForward *pf,
+                  bool (*f)(const char *, const char *, void *), void *data);
+
+/** @brief Sprawdza, czy dwie struktury przekierowują numery tak samo.
+ * Struktury są równoważne, gdy dla każdego numeru @p num wyniki
+ * phfwdGet(a, num) i phfwdGet(b, num) są równe, nawet jeśli zawierają
+ * różne przekierowania (np. 1 na 2 i 12 na 22 wobec samego 1 na 2).
+ * Prefiksy przekierowań obu struktur dzielą numery na przedziały: numer
+ * należy do przedziału o najdłuższym takim prefiksie, a w całym
+ * przedziale obie struktury dopisują do wyniku dla prefiksu tę samą
+ * końcówkę. Wystarczy więc porównać wyniki dla prefiksów, przeglądanych
+ * równolegle w obu drzewach w porządku leksykograficznym.
+ * Dla każdego przedziału przekierowywanego różnie wywołuje
+ * f(prefiks, wynikA, wynikB, data). Porównywanie zostaje przerwane, jeżeli
+ * @p f zwróci false lub ma wartość NULL (wtedy tylko sprawdza
+ * równoważność). Funkcja @p f jest wywoływana przy zablokowanych obu
+ * strukturach i nie może wywoływać na nich żadnych funkcji.
+ * #### Złożoność
+ * Proporcjonalna do łącznej długości prefiksów przekierowań obu struktur.
+ * @param[in] a – wskaźnik na pierwszą strukturę przechowującą przekierowania;
+ * @param[in] b – wskaźnik na drugą strukturę przechowującą przekierowania;
+ * @param[in] f – wskaźnik na funkcję przetwarzającą różnicę lub NULL;
+ * @param[in, out] data – wskaźnik na dane do funkcji @p f;
+ * @param[out] equivalent – czy nie znaleziono różnicy.
+ * @return Wartość @p true w przypadku sukcesu, @p false gdy nie udało się
+ *         zaalokować pamięci (wtedy @p equivalent nie rozstrzyga).
+ */
+bool phfwdEquivalent(struct PhoneForward *a, struct PhoneForward *b,
+                     bool (*f)(const char *, const char *, const char *,
+                               void *),
+                     void *data, bool *equivalent);
+
+/** @brief Opisuje przekierowanie wszystkich numerów z danym prefiksem.
+ * Przegląda raz poddrzewo przekierowań z prefiksem @p prefix i dzieli
+ * numery z tym prefiksem na przedziały przekierowywane przez jedno
+ * przekierowanie. Dla każdego przedziału wywołuje
+ * f(podprefiks, num1, num2, wynik, data), gdzie numery z prefiksem
+ * @p podprefiks są przekierowywane przekierowaniem @p num1 na @p num2,
+ * a @p wynik to prefiks, na który przechodzi @p podprefiks. Jeżeli numery
+ * z przedziału nie są przekierowywane, @p num1 i @p num2 mają wartość NULL,
+ * a @p wynik jest równy @p podprefiks.
+ * Pierwszy przedział ma podprefiks @p prefix, a kolejne są przeglądane
+ * w porządku leksykograficznym; numer należy do przedziału o najdłuższym
+ * podprefiksie będącym jego prefiksem. Każdy przedział odpowiada innemu
+ * przekierowaniu, więc lista jest najkrótsza możliwa w takim zapisie.
+ * Poza napisami przekazywanymi do @p f nie przydziela pamięci zależnej od
+ * liczby przedziałów. Przeglądanie zostaje przerwane, jeżeli @p f zwróci
+ * false.
+ * @param[in] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] prefix – wskaźnik na napis reprezentujący prefiks;
+ * @param[in] f – wskaźnik na funkcję przetwarzającą przedział.
+ * @param[in, out] data – wskaźnik na dane do funkcji @p f.
+ * @return Wartość @p true, jeśli przejrzano wszystkie przedziały.
+ *         Wartość @p false, jeśli @p prefix nie reprezentuje numeru,
+ *         @p f zwróciła false lub nie udało się zaalokować pamięci.
+ */
+bool phfwdResolveRange(struct PhoneForward *pf, const char *prefix,
+                       bool (*f)(const char *, const char *, const char *,
+                                 const char *, void *),
+                       void *data);
+
+/** @brief Włącza lub wyłącza zliczanie użyć przekierowań.
+ * Gdy zliczanie jest włączone, @ref phfwdGet zwiększa licznik
+ * przekierowania, które wyznaczyło wynik (przekierowania o najdłuższym
+ * pasującym prefiksie). Licznik jest zmieniany przy zablokowanym pasie
+ * numeru, więc zliczanie nie wprowadza dodatkowej synchronizacji.
+ * Nowe przekierowanie ma licznik 0, również gdy zastępuje poprzednie.
+ * Początkowo zliczanie jest wyłączone.
+ * @param[in, out] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] enabled – czy zliczać użycia.
+ */
+void phfwdSetHitCounting(struct PhoneForward *pf, bool enabled);
+
+/** @brief Przegląda rzadko używane przekierowania.
+ * Dla każdego przekierowania @p num1 na @p num2 użytego co najwyżej
+ * @p maxHits razy wywołuje f(num1, num2, użycia, data), w porządku
+ * leksykograficznym względem @p num1. Dla @p maxHits równego 0 są to
+ * przekierowania nieużyte ani razu, które można usunąć. Przeglądanie
+ * zostaje przerwane, jeżeli @p f zwróci false.
+ * @param[in, out] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] maxHits – największa liczba użyć przeglądanego przekierowania;
+ * @param[in] reset – czy wyzerować liczniki wszystkich przekierowań
+ *                    (także po przerwaniu przeglądania);
+ * @param[in] f – wskaźnik na funkcję przetwarzającą przekierowanie.
+ * @param[in, out] data – wskaźnik na dane do funkcji @p f.
+ * @return Wartość @p true, jeśli przejrzano wszystkie przekierowania.
+ *         Wartość @p false, jeśli @p f zwróciła false lub nie udało się
+ *         zaalokować pamięci.
+ */
+bool phfwdForEachHits(struct PhoneForward *pf, uint64_t maxHits, bool reset,
+                      bool (*f)(const char *, const char *, uint64_t, void *),
+                      void *data);
+
+/** @brief Obserwuje wynik @ref phfwdGet dla numeru.
+ * Po każdej zmianie przekierowań (@ref phfwdAdd, @ref phfwdAddExpiring,
+ * @ref phfwdRemove, @ref phfwdAdvanceClock), po której wynik
+ * phfwdGet(pf, num) jest wyznaczany przez inne przekierowanie niż
+ * wcześniej, wywołuje f(num, data). Zmiana przekierowań z prefiksem
+ * @p p sprawdza tylko obserwatorów numerów z prefiksem @p p, więc zmiany
+ * nieobserwowanych numerów kosztują jedno wyszukiwanie.
+ * Funkcja @p f jest wywoływana przy zablokowanej strukturze @p pf i nie może
+ * wywoływać na niej żadnych funkcji; aktualny wynik należy pobrać po
+ * powrocie z operacji, która ją wywołała.
+ * @param[in, out] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num – wskaźnik na napis reprezentujący obserwowany numer;
+ * @param[in] f – wskaźnik na funkcję powiadamianą o zmianie;
+ * @param[in] data – wskaźnik na dane do funkcji @p f.
+ * @return Wskaźnik na obserwatora lub NULL, gdy @p num nie reprezentuje
+ *         numeru, @p f ma wartość NULL lub nie udało się zaalokować pamięci.
+ */
+struct PhoneForwardWatch *phfwdWatch(struct PhoneForward *pf, const char *num,
+                                     void (*f)(const char *, void *),
+                                     void *data);
+
+/** @brief Kończy obserwowanie numeru.
+ * Usuwa obserwatora utworzonego przez @ref phfwdWatch dla struktury @p pf.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL. Obserwatorzy nieusunięci
+ * przed @ref phfwdDelete są usuwani razem ze strukturą.
+ * @param[in, out] pf – wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] watch – wskaźnik na obserwatora.
+ */
+void phfwdUnwatch(struct PhoneForward *pf, struct PhoneForwardWatch *watch);
+
+/** @brief Przegląda najczęstsze cele przekierowań.
+ * Wywołuje f(num2, liczba, data) dla co najwyżej @p k różnych numerów
+ * @p num2, na które przekierowano najwięcej prefiksów, w kolejności
+ * nierosnącej liczby przekierowań (liczba). Liczby przekierowań są
+ * utrzymywane przy dodawaniu i usuwaniu przekierowań, więc koszt jest
+ * proporcjonalny do @p k i długości wypisywanych numerów. Przeglądanie
+ * zostaje przerwane, jeżeli @p f zwróci false.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] k - maksymalna liczba przeglądanych numerów;
+ * @param[in] f - wskaźnik na funkcję przetwarzającą numer.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p f.
+ * @return Wartość @p true, jeśli przejrzano wszystkie numery.
+ *         Wartość @p false, jeśli @p f zwróciła false lub nie udało się
+ *         zaalokować pamięci.
+ */
+bool phfwdForEachTopTarget(struct PhoneForward *pf, size_t k,
+                           bool (*f)(const char *, size_t, void *),
+                           void *data);
+
+/** @brief Przegląda zmiany przekierowań.
+ * Przegląda zmiany wykonane od ostatniego wywołania @ref phfwdClearChanges
+ * (lub od utworzenia struktury) w postaci pozwalającej odtworzyć aktualny
+ * stan ze stanu poprzedniego: najpierw dla każdego prefiksu, którego
+ * przekierowania należy usunąć wywołuje removed(prefiks, data), a następnie
+ * dla każdego przekierowania, które należy dodać wywołuje
+ * f(num1, num2, data). Przekierowania są zgłaszane całymi zmienionymi
+ * poddrzewami, więc koszt jest proporcjonalny do rozmiaru zmian,
+ * a nie do liczby wszystkich przekierowań. Przeglądanie zostaje przerwane,
+ * jeżeli któraś z funkcji zwróci false.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] removed - wskaźnik na funkcję przetwarzającą usunięty prefiks.
+ * @param[in] f - wskaźnik na funkcję przetwarzającą przekierowanie.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p removed i @p f.
+ * @return Wartość @p true, jeśli przejrzano wszystkie zmiany.
+ *         Wartość @p false, jeśli któraś z funkcji zwróciła false lub nie
+ *         udało się zaalokować pamięci.
+ */
+bool phfwdForEachChange(struct PhoneForward *pf,
+                        bool (*removed)(const char *, void *),
+                        bool (*f)(const char *, const char *, void *),
+                        void *data);
+
+/** @brief Sprawdza czy wystąpiły zmiany.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów.
+ * @return Wartość @p true, jeśli od ostatniego wywołania
+ *         @ref phfwdClearChanges zmieniły się przekierowania.
+ */
+bool phfwdHasChanges(struct PhoneForward *pf);
+
+/** @brief Sprawdza czy wszystkie zmiany zostały zapamiętane.
+ * Zapamiętanie usuniętego prefiksu może się nie udać z powodu braku pamięci,
+ * wtedy @ref phfwdForEachChange nie opisuje wszystkich zmian.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów.
+ * @return Wartość @p true, jeśli @ref phfwdForEachChange opisuje wszystkie
+ *         zmiany, @p false w przeciwnym przypadku.
+ */
+bool phfwdChangesComplete(struct PhoneForward *pf);
+
+/** @brief Zapomina zmiany.
+ * Po wykonaniu aktualny stan jest punktem odniesienia dla
+ * @ref phfwdForEachChange.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania
+ *        numerów.
+ */
+void phfwdClearChanges(struct PhoneForward *pf);
+
 
 #endif /* TELEFONY_PHONE_FORWARD_H */
@@ -0,0 +1,545 @@
+/** @file
+ * Implementacja asynchronicznego dostępu do struktur przechowujących
+ * przekierowania numerów telefonicznych.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "phone_forward_async.h"
+
+/**
+ * @brief Rodzaj zlecenia: phfwdGet.
+ */
+#define PHFWD_ASYNC_GET 0
+
+/**
+ * @brief Rodzaj zlecenia: phfwdReverse.
+ */
+#define PHFWD_ASYNC_REVERSE 1
+
+/**
+ * @brief Rodzaj zlecenia: phfwdAdd.
+ */
+#define PHFWD_ASYNC_ADD 2
+
+/**
+ * @brief Zlecenie.
+ */
+struct PhoneForwardAsyncRequest {
+    /**
+     * @brief Rodzaj zlecenia (PHFWD_ASYNC_*).
+     */
+    int type;
+
+    /**
+     * @brief Struktura, której dotyczy zlecenie.
+     */
+    struct PhoneForward *pf;
+
+    /**
+     * @brief Kopia pierwszego argumentu.
+     */
+    char *num1;
+
+    /**
+     * @brief Kopia drugiego argumentu lub NULL.
+     */
+    char *num2;
+
+    /**
+     * @brief Funkcja zwrotna.
+     */
+    PhoneForwardAsyncCallback callback;
+
+    /**
+     * @brief Dane do funkcji zwrotnej.
+     */
+    void *data;
+
+    /**
+     * @brief Wynik zlecenia phfwdGet lub phfwdReverse.
+     */
+    const struct PhoneNumbers *pnum;
+
+    /**
+     * @brief Wynik zlecenia.
+     */
+    bool result;
+
+    /**
+     * @brief Następne zlecenie w kolejce.
+     */
+    struct PhoneForwardAsyncRequest *next;
+};
+
+/**
+ * @brief Kolejka zleceń dotyczących jednej struktury PhoneForward.
+ * Istnieje, dopóki struktura ma niezakończone zlecenia. Jest wykonywana
+ * przez co najwyżej jeden wątek roboczy jednocześnie.
+ */
+struct PhoneForwardAsyncStrand {
+    /**
+     * @brief Struktura, której dotyczą zlecenia.
+     */
+    struct PhoneForward *pf;
+
+    /**
+     * @brief Pierwsze oczekujące zlecenie.
+     */
+    struct PhoneForwardAsyncRequest *head;
+
+    /**
+     * @brief Ostatnie oczekujące zlecenie.
+     */
+    struct PhoneForwardAsyncRequest *tail;
+
+    /**
+     * @brief Następna kolejka na liście istniejących kolejek.
+     */
+    struct PhoneForwardAsyncStrand *nextActive;
+
+    /**
+     * @brief Następna kolejka oczekująca na wątek roboczy.
+     */
+    struct PhoneForwardAsyncStrand *nextReady;
+};
+
+/**
+ * @brief Struktura przechowująca pulę wątków roboczych i kolejki zleceń.
+ */
+struct PhoneForwardAsync {
+    /**
+     * @brief Chroni wszystkie pozostałe pola poza @p threads,
+     * @p workers, @p deliver i @p eventFd.
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     * @brief Sygnalizowana, gdy pojawi się kolejka gotowa do wykonania
+     * lub pula jest usuwana.
+     */
+    pthread_cond_t workAvailable;
+
+    /**
+     * @brief Wątki robocze.
+     */
+    pthread_t *threads;
+
+    /**
+     * @brief Liczba wątków roboczych.
+     */
+    size_t workers;
+
+    /**
+     * @brief Sposób zgłaszania zakończenia zleceń.
+     */
+    int deliver;
+
+    /**
+     * @brief Deskryptor eventfd lub -1.
+     */
+    int eventFd;
+
+    /**
+     * @brief Lista istniejących kolejek.
+     */
+    struct PhoneForwardAsyncStrand *active;
+
+    /**
+     * @brief Pierwsza kolejka oczekująca na wątek roboczy.
+     */
+    struct PhoneForwardAsyncStrand *readyHead;
+
+    /**
+     * @brief Ostatnia kolejka oczekująca na wątek roboczy.
+     */
+    struct PhoneForwardAsyncStrand *readyTail;
+
+    /**
+     * @brief Pierwsze zakończone i niezgłoszone zlecenie.
+     */
+    struct PhoneForwardAsyncRequest *completedHead;
+
+    /**
+     * @brief Ostatnie zakończone i niezgłoszone zlecenie.
+     */
+    struct PhoneForwardAsyncRequest *completedTail;
+
+    /**
+     * @brief Czy pula jest usuwana.
+     */
+    bool stopping;
+};
+
+/**
+ * @brief Dodaje kolejkę na koniec kolejki oczekujących na wątek roboczy.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych.
+ * @param[in, out] strand - wskaźnik na kolejkę.
+ */
+static void phfwdAsyncPushReady(struct PhoneForwardAsync *async,
+                                struct PhoneForwardAsyncStrand *strand) {
+    strand->nextReady = NULL;
+    if (async->readyTail == NULL) {
+        async->readyHead = strand;
+    } else {
+        async->readyTail->nextReady = strand;
+    }
+    async->readyTail = strand;
+    pthread_cond_signal(&async->workAvailable);
+}
+
+/**
+ * @brief Usuwa kolejkę z listy istniejących kolejek i ją zwalnia.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych.
+ * @param[in] strand - wskaźnik na pustą kolejkę.
+ */
+static void phfwdAsyncRemoveStrand(struct PhoneForwardAsync *async,
+                                   struct PhoneForwardAsyncStrand *strand) {
+    struct PhoneForwardAsyncStrand **it = &async->active;
+    while (*it != strand) {
+        it = &(*it)->nextActive;
+    }
+    *it = strand->nextActive;
+    free(strand);
+}
+
+/**
+ * @brief Wykonuje zlecenie.
+ * @param[in, out] request - wskaźnik na zlecenie.
+ */
+static void phfwdAsyncExecute(struct PhoneForwardAsyncRequest *request) {
+    switch (request->type) {
+        case PHFWD_ASYNC_GET:
+            request->pnum = phfwdGet(request->pf, request->num1);
+            request->result = request->pnum != NULL;
+            break;
+        case PHFWD_ASYNC_REVERSE:
+            request->pnum = phfwdReverse(request->pf, request->num1);
+            request->result = request->pnum != NULL;
+            break;
+        default:
+            request->result = phfwdAdd(request->pf, request->num1,
+                                       request->num2);
+            break;
+    }
+}
+
+/**
+ * @brief Zwalnia zlecenie (bez wyniku).
+ * @param[in] request - wskaźnik na zlecenie.
+ */
+static void phfwdAsyncFreeRequest(struct PhoneForwardAsyncRequest *request) {
+    free(request->num1);
+    free(request->num2);
+    free(request);
+}
+
+/**
+ * @brief Zgłasza zakończenie zlecenia zgodnie z trybem puli.
+ * Wywoływana bez blokady.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych.
+ * @param[in] request - wskaźnik na wykonane zlecenie.
+ */
+static void phfwdAsyncComplete(struct PhoneForwardAsync *async,
+                               struct PhoneForwardAsyncRequest *request) {
+    if (async->deliver == PHFWD_ASYNC_DELIVER_WORKER) {
+        request->callback(request->pnum, request->result, request->data);
+        phfwdAsyncFreeRequest(request);
+        return;
+    }
+
+    request->next = NULL;
+    pthread_mutex_lock(&async->mutex);
+    if (async->completedTail == NULL) {
+        async->completedHead = request;
+    } else {
+        async->completedTail->next = request;
+    }
+    async->completedTail = request;
+    pthread_mutex_unlock(&async->mutex);
+
+    uint64_t one = 1;
+    while (write(async->eventFd, &one, sizeof(one)) < 0 && errno == EINTR) {
+        continue;
+    }
+}
+
+/**
+ * @brief Pętla wątku roboczego.
+ * Pobiera kolejkę oczekującą na wątek, wykonuje jej pierwsze zlecenie
+ * i, jeśli kolejka nie jest pusta, odkłada ją na koniec kolejki
+ * oczekujących, dzięki czemu struktury są obsługiwane sprawiedliwie.
+ * @param[in, out] arg - wskaźnik na pulę wątków roboczych.
+ * @return NULL.
+ */
+static void *phfwdAsyncWorker(void *arg) {
+    struct PhoneForwardAsync *async = arg;
+
+    pthread_mutex_lock(&async->mutex);
+    while (true) {
+        while (async->readyHead == NULL && !async->stopping) {
+            pthread_cond_wait(&async->workAvailable, &async->mutex);
+        }
+        if (async->readyHead == NULL) {
+            break;
+        }
+
+        struct PhoneForwardAsyncStrand *strand = async->readyHead;
+        async->readyHead = strand->nextReady;
+        if (async->readyHead == NULL) {
+            async->readyTail = NULL;
+        }
+        struct PhoneForwardAsyncRequest *request = strand->head;
+        strand->head = request->next;
+        if (strand->head == NULL) {
+            strand->tail = NULL;
+        }
+        pthread_mutex_unlock(&async->mutex);
+
+        phfwdAsyncExecute(request);
+        phfwdAsyncComplete(async, request);
+
+        pthread_mutex_lock(&async->mutex);
+        if (strand->head != NULL) {
+            phfwdAsyncPushReady(async, strand);
+        } else {
+            phfwdAsyncRemoveStrand(async, strand);
+        }
+    }
+    pthread_mutex_unlock(&async->mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief Zatrzymuje i łączy wątki robocze.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych.
+ * @param[in] started - liczba uruchomionych wątków.
+ */
+static void phfwdAsyncJoin(struct PhoneForwardAsync *async, size_t started) {
+    pthread_mutex_lock(&async->mutex);
+    async->stopping = true;
+    pthread_cond_broadcast(&async->workAvailable);
+    pthread_mutex_unlock(&async->mutex);
+
+    size_t i;
+    for (i = 0; i < started; i++) {
+        pthread_join(async->threads[i], NULL);
+    }
+}
+
+/**
+ * @brief Zwalnia zasoby puli poza wątkami.
+ * @param[in] async - wskaźnik na pulę wątków roboczych.
+ */
+static void phfwdAsyncFree(struct PhoneForwardAsync *async) {
+    if (async->eventFd >= 0) {
+        close(async->eventFd);
+    }
+    pthread_cond_destroy(&async->workAvailable);
+    pthread_mutex_destroy(&async->mutex);
+    free(async->threads);
+    free(async);
+}
+
+struct PhoneForwardAsync *phfwdAsyncNew(size_t workers, int deliver) {
+    if (workers == 0 || (deliver != PHFWD_ASYNC_DELIVER_WORKER
+                         && deliver != PHFWD_ASYNC_DELIVER_EVENTFD)) {
+        return NULL;
+    }
+
+    struct PhoneForwardAsync *async = calloc(1, sizeof(struct PhoneForwardAsync));
+    if (async == NULL) {
+        return NULL;
+    }
+    async->threads = malloc(sizeof(pthread_t) * workers);
+    async->workers = workers;
+    async->deliver = deliver;
+    async->eventFd = -1;
+    if (async->threads == NULL) {
+        free(async);
+        return NULL;
+    }
+    pthread_mutex_init(&async->mutex, NULL);
+    pthread_cond_init(&async->workAvailable, NULL);
+
+    if (deliver == PHFWD_ASYNC_DELIVER_EVENTFD) {
+        async->eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (async->eventFd < 0) {
+            phfwdAsyncFree(async);
+            return NULL;
+        }
+    }
+
+    size_t i;
+    for (i = 0; i < workers; i++) {
+        if (pthread_create(&async->threads[i], NULL,
+                           phfwdAsyncWorker, async) != 0) {
+            phfwdAsyncJoin(async, i);
+            phfwdAsyncFree(async);
+            return NULL;
+        }
+    }
+
+    return async;
+}
+
+void phfwdAsyncDelete(struct PhoneForwardAsync *async) {
+    if (async == NULL) {
+        return;
+    }
+    phfwdAsyncJoin(async, async->workers);
+    phfwdAsyncDispatch(async);
+    phfwdAsyncFree(async);
+}
+
+/**
+ * @brief Kopiuje napis.
+ * @param[in] text - napis.
+ * @return Wskaźnik na kopię lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+static char *phfwdAsyncCopy(const char *text) {
+    size_t length = strlen(text);
+    char *copy = malloc(length + 1);
+    if (copy != NULL) {
+        memcpy(copy, text, length + 1);
+    }
+    return copy;
+}
+
+/**
+ * @brief Przyjmuje zlecenie.
+ * Dołącza zlecenie do kolejki struktury @p pf, tworząc ją w razie potrzeby.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych;
+ * @param[in] type - rodzaj zlecenia;
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num1 - pierwszy argument;
+ * @param[in] num2 - drugi argument lub NULL;
+ * @param[in] callback - funkcja zwrotna;
+ * @param[in, out] data - wskaźnik na dane do funkcji @p callback.
+ * @return Wartość @p true, jeśli zlecenie zostało przyjęte, @p false jeśli
+ *         nie udało się zaalokować pamięci.
+ */
+static bool phfwdAsyncSubmit(struct PhoneForwardAsync *async, int type,
+                             struct PhoneForward *pf, const char *num1,
+                             const char *num2,
+                             PhoneForwardAsyncCallback callback, void *data) {
+    if (async == NULL || num1 == NULL || callback == NULL) {
+        return false;
+    }
+
+    struct PhoneForwardAsyncRequest *request =
+            calloc(1, sizeof(struct PhoneForwardAsyncRequest));
+    if (request == NULL) {
+        return false;
+    }
+    request->type = type;
+    request->pf = pf;
+    request->callback = callback;
+    request->data = data;
+    request->num1 = phfwdAsyncCopy(num1);
+    if (num2 != NULL) {
+        request->num2 = phfwdAsyncCopy(num2);
+    }
+    if (request->num1 == NULL || (num2 != NULL && request->num2 == NULL)) {
+        phfwdAsyncFreeRequest(request);
+        return false;
+    }
+
+    pthread_mutex_lock(&async->mutex);
+    struct PhoneForwardAsyncStrand *strand = async->active;
+    while (strand != NULL && strand->pf != pf) {
+        strand = strand->nextActive;
+    }
+
+    if (strand == NULL) {
+        strand = calloc(1, sizeof(struct PhoneForwardAsyncStrand));
+        if (strand == NULL) {
+            pthread_mutex_unlock(&async->mutex);
+            phfwdAsyncFreeRequest(request);
+            return false;
+        }
+        strand->pf = pf;
+        strand->nextActive = async->active;
+        async->active = strand;
+        strand->head = strand->tail = request;
+        phfwdAsyncPushReady(async, strand);
+    } else {
+        if (strand->tail == NULL) {
+            strand->head = request;
+        } else {
+            strand->tail->next = request;
+        }
+        strand->tail = request;
+    }
+    pthread_mutex_unlock(&async->mutex);
+
+    return true;
+}
+
+bool phfwdSubmitGet(struct PhoneForwardAsync *async, struct PhoneForward *pf,
+                    const char *num, PhoneForwardAsyncCallback callback,
+                    void *data) {
+    return phfwdAsyncSubmit(async, PHFWD_ASYNC_GET, pf, num, NULL,
+                            callback, data);
+}
+
+bool phfwdSubmitReverse(struct PhoneForwardAsync *async,
+                        struct PhoneForward *pf, const char *num,
+                        PhoneForwardAsyncCallback callback, void *data) {
+    return phfwdAsyncSubmit(async, PHFWD_ASYNC_REVERSE, pf, num, NULL,
+                            callback, data);
+}
+
+bool phfwdSubmitAdd(struct PhoneForwardAsync *async, struct PhoneForward *pf,
+                    const char *num1, const char *num2,
+                    PhoneForwardAsyncCallback callback, void *data) {
+    if (num2 == NULL) {
+        return false;
+    }
+    return phfwdAsyncSubmit(async, PHFWD_ASYNC_ADD, pf, num1, num2,
+                            callback, data);
+}
+
+int phfwdAsyncEventFd(const struct PhoneForwardAsync *async) {
+    return async->eventFd;
+}
+
+size_t phfwdAsyncDispatch(struct PhoneForwardAsync *async) {
+    if (async->deliver != PHFWD_ASYNC_DELIVER_EVENTFD) {
+        return 0;
+    }
+
+    uint64_t counter;
+    while (read(async->eventFd, &counter, sizeof(counter)) < 0
+           && errno == EINTR) {
+        continue;
+    }
+
+    pthread_mutex_lock(&async->mutex);
+    struct PhoneForwardAsyncRequest *request = async->completedHead;
+    async->completedHead = async->completedTail = NULL;
+    pthread_mutex_unlock(&async->mutex);
+
+    size_t dispatched = 0;
+    while (request != NULL) {
+        struct PhoneForwardAsyncRequest *next = request->next;
+        request->callback(request->pnum, request->result, request->data);
+        phfwdAsyncFreeRequest(request);
+        request = next;
+        dispatched++;
+    }
+    return dispatched;
+}
@@ -0,0 +1,132 @@
+/** @file
+ * Interfejs asynchronicznego dostępu do struktur przechowujących
+ * przekierowania numerów telefonicznych.
+ * Zlecenia wykonuje pula wątków roboczych. Zlecenia dotyczące tej samej
+ * struktury PhoneForward są wykonywane pojedynczo i w kolejności zlecenia,
+ * zlecenia dotyczące różnych struktur mogą być wykonywane równolegle.
+ * Zakończenie zlecenia jest zgłaszane wywołaniem funkcji zwrotnej:
+ * bezpośrednio w wątku roboczym (PHFWD_ASYNC_DELIVER_WORKER) albo
+ * w wątku wywołującym @ref phfwdAsyncDispatch, gdy deskryptor zwracany
+ * przez @ref phfwdAsyncEventFd jest gotowy do odczytu
+ * (PHFWD_ASYNC_DELIVER_EVENTFD).
+ * Dopóki struktura PhoneForward ma niezakończone zlecenia, nie wolno jej
+ * używać funkcjami synchronicznymi.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_PHONE_FORWARD_ASYNC_H
+#define TELEFONY_PHONE_FORWARD_ASYNC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "phone_forward.h"
+
+/**
+ * @brief Funkcje zwrotne są wywoływane w wątkach roboczych.
+ */
+#define PHFWD_ASYNC_DELIVER_WORKER 0
+
+/**
+ * @brief Funkcje zwrotne są wywoływane przez @ref phfwdAsyncDispatch.
+ */
+#define PHFWD_ASYNC_DELIVER_EVENTFD 1
+
+/**
+ * Struktura przechowująca pulę wątków roboczych i kolejki zleceń.
+ */
+struct PhoneForwardAsync;
+
+/**
+ * @brief Funkcja zwrotna zgłaszająca zakończenie zlecenia.
+ * Wywoływana jako callback(pnum, result, data). Dla zleceń
+ * @ref phfwdSubmitGet i @ref phfwdSubmitReverse @p pnum jest wynikiem
+ * (lub NULL, gdy nie udało się zaalokować pamięci), który należy zwolnić
+ * funkcją @ref phnumDelete, a @p result ma wartość pnum != NULL.
+ * Dla zlecenia @ref phfwdSubmitAdd @p pnum ma wartość NULL, a @p result
+ * jest wynikiem @ref phfwdAdd.
+ */
+typedef void (*PhoneForwardAsyncCallback)(const struct PhoneNumbers *pnum,
+                                          bool result, void *data);
+
+/** @brief Tworzy pulę wątków roboczych.
+ * @param[in] workers - liczba wątków roboczych (co najmniej 1).
+ * @param[in] deliver - sposób zgłaszania zakończenia zleceń
+ *                      (PHFWD_ASYNC_DELIVER_*).
+ * @return Wskaźnik na utworzoną strukturę lub NULL, gdy nie udało się
+ *         zaalokować pamięci, utworzyć wątków lub parametry są niepoprawne.
+ */
+struct PhoneForwardAsync *phfwdAsyncNew(size_t workers, int deliver);
+
+/** @brief Usuwa pulę wątków roboczych.
+ * Czeka na wykonanie wszystkich zleceń, a w trybie
+ * PHFWD_ASYNC_DELIVER_EVENTFD zgłasza pozostałe zakończenia w wątku
+ * wywołującym. Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] async - wskaźnik na usuwaną strukturę.
+ */
+void phfwdAsyncDelete(struct PhoneForwardAsync *async);
+
+/** @brief Zleca wyznaczenie przekierowania numeru.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych;
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num - wskaźnik na napis reprezentujący numer (kopiowany);
+ * @param[in] callback - funkcja zwrotna;
+ * @param[in, out] data - wskaźnik na dane do funkcji @p callback.
+ * @return Wartość @p true, jeśli zlecenie zostało przyjęte, @p false jeśli
+ *         nie udało się zaalokować pamięci.
+ */
+bool phfwdSubmitGet(struct PhoneForwardAsync *async, struct PhoneForward *pf,
+                    const char *num, PhoneForwardAsyncCallback callback,
+                    void *data);
+
+/** @brief Zleca wyznaczenie przekierowań na dany numer.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych;
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num - wskaźnik na napis reprezentujący numer (kopiowany);
+ * @param[in] callback - funkcja zwrotna;
+ * @param[in, out] data - wskaźnik na dane do funkcji @p callback.
+ * @return Wartość @p true, jeśli zlecenie zostało przyjęte, @p false jeśli
+ *         nie udało się zaalokować pamięci.
+ */
+bool phfwdSubmitReverse(struct PhoneForwardAsync *async,
+                        struct PhoneForward *pf, const char *num,
+                        PhoneForwardAsyncCallback callback, void *data);
+
+/** @brief Zleca dodanie przekierowania.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych;
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania numerów;
+ * @param[in] num1 - wskaźnik na napis reprezentujący prefiks numerów
+ *                   przekierowywanych (kopiowany);
+ * @param[in] num2 - wskaźnik na napis reprezentujący prefiks numerów, na
+ *                   które jest wykonywane przekierowanie (kopiowany);
+ * @param[in] callback - funkcja zwrotna;
+ * @param[in, out] data - wskaźnik na dane do funkcji @p callback.
+ * @return Wartość @p true, jeśli zlecenie zostało przyjęte, @p false jeśli
+ *         nie udało się zaalokować pamięci.
+ */
+bool phfwdSubmitAdd(struct PhoneForwardAsync *async, struct PhoneForward *pf,
+                    const char *num1, const char *num2,
+                    PhoneForwardAsyncCallback callback, void *data);
+
+/** @brief Udostępnia deskryptor sygnalizujący zakończenie zleceń.
+ * Deskryptor jest gotowy do odczytu, gdy są zakończenia do zgłoszenia przez
+ * @ref phfwdAsyncDispatch. Można go obserwować funkcjami poll, select
+ * lub epoll.
+ * @param[in] async - wskaźnik na pulę wątków roboczych.
+ * @return Deskryptor lub -1, jeżeli pula działa w trybie
+ *         PHFWD_ASYNC_DELIVER_WORKER.
+ */
+int phfwdAsyncEventFd(const struct PhoneForwardAsync *async);
+
+/** @brief Zgłasza zakończone zlecenia.
+ * W trybie PHFWD_ASYNC_DELIVER_EVENTFD wywołuje w wątku wywołującym funkcje
+ * zwrotne wszystkich zakończonych zleceń. Nie blokuje.
+ * @param[in, out] async - wskaźnik na pulę wątków roboczych.
+ * @return Liczba zgłoszonych zakończeń.
+ */
+size_t phfwdAsyncDispatch(struct PhoneForwardAsync *async);
+
+#endif /* TELEFONY_PHONE_FORWARD_ASYNC_H */
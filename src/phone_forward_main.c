@@ -6,17 +6,30 @@
  * @date 25.05.2018
  */
 
+#define _XOPEN_SOURCE 700
+
+#include <ctype.h>
+#include <errno.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <poll.h>
 
-#include "parser.h"
 #include "phone_bases_system.h"
 #include "vector.h"
-#include "input.h"
 #include "character.h"
 #include "stdfunc.h"
+#include "snapshot.h"
+#include "replication.h"
+#include "operation.h"
+#include "compiled_script.h"
+#include "stream_parser.h"
+#include "trace.h"
+#include "slow_log.h"
+#include "probes.h"
 
 /**
  * @brief Bazowy prefiks informacji o błędzie.
@@ -64,6 +77,65 @@
     (CONCAT(" ", PARSER_OPERATOR_NONTRIVIAL_STRING, " "))
 
 
+/**
+ * @brief Infiks informacji o błędzie operatora SAVE.
+ */
+#define SAVE_OPERATOR_ERROR_INFIX \
+    (CONCAT(" ", PARSER_OPERATOR_SAVE, " "))
+
+/**
+ * @brief Infiks informacji o błędzie operatora TOP.
+ */
+#define TOP_OPERATOR_ERROR_INFIX \
+    (CONCAT(" ", PARSER_OPERATOR_TOP, " "))
+
+/**
+ * @brief Prefiks wiersza z kosztem zapytania wypisywanego po EXPLAIN.
+ */
+#define EXPLAIN_PREFIX PARSER_OPERATOR_EXPLAIN
+
+/**
+ * @brief Opcja wiersza poleceń wskazująca plik migawki.
+ */
+#define SNAPSHOT_OPTION "--snapshot"
+
+/**
+ * @brief Opcja wiersza poleceń uruchamiająca tryb lidera replikacji.
+ */
+#define LEADER_OPTION "--leader"
+
+/**
+ * @brief Opcja wiersza poleceń uruchamiająca tryb naśladowcy replikacji.
+ */
+#define FOLLOW_OPTION "--follow"
+
+/**
+ * @brief Opcja wiersza poleceń włączająca kompilację skryptu.
+ */
+#define COMPILE_OPTION "--compile"
+
+/**
+ * @brief Opcja wiersza poleceń wskazująca skompilowany skrypt do wykonania.
+ */
+#define EXEC_OPTION "--exec"
+
+/**
+ * @brief Opcja wiersza poleceń wskazująca plik, do którego zapisywany jest
+ * ślad wykonanych operacji.
+ */
+#define TRACE_OPTION "--trace"
+
+/**
+ * @brief Opcja wskazująca plik dziennika wolnych operacji.
+ */
+#define SLOW_LOG_OPTION "--slow-log"
+
+/**
+ * @brief Opcja ustawiająca próg czasu wykonania (w mikrosekundach)
+ * operacji zapisywanych w dzienniku wolnych operacji.
+ */
+#define SLOW_THRESHOLD_OPTION "--slow-threshold"
+
 /**
  * @brief Kod błędu zwracany przez program.
  */
@@ -75,25 +147,26 @@
 #define SUCCESS_EXIT_CODE 0
 
 /**
- * Przesunięcie pozycji błędu operatora PARSER_OPERATOR_[NEW/DELETE]
- * przy użyciu nazwy zastrzeżonej (PARSER_OPERATOR_[NEW/DELETE]).
+ * @brief Rozmiar fragmentu wejścia wczytywanego jednorazowo.
  */
-#define OPERATOR_POSITION_OFFSET 2
+#define INPUT_BUFFER_SIZE 4096
 
 /**
- * @brief Wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @brief Liczba stałych pozycji w tablicy @ref pollFds
+ * (standardowe wejście i migawka).
  */
-static PhoneBases bases = NULL;
+#define POLL_FIXED_FDS 2
+
 
 /**
- * @brief Wskaźniki na pomocniczy Vector do buforowania wejścia.
+ * @brief Wskaźnik na strukturę przechowującą bazy przekierowań.
  */
-static Vector word1 = NULL;
+static PhoneBases bases = NULL;
 
 /**
- * @brief Wskaźniki na pomocniczy Vector do buforowania wejścia.
+ * @brief Operacja wczytywana ze skompilowanego skryptu.
  */
-static Vector word2 = NULL;
+static struct Operation operation = {OPERATION_NONE, NULL, NULL, 0, 0};
 
 /**
  * @brief Wskaźnik na aktualnie aktywną bazę przekierowań.
@@ -102,9 +175,112 @@ static Vector word2 = NULL;
 static struct PhoneForward *currentBase = NULL;
 
 /**
- * @brief Struktura opisująca stan parsowania.
+ * @brief Struktura opisująca stan parsowania standardowego wejścia.
+ */
+static struct StreamParser parser = {0};
+
+/**
+ * @brief Deskryptory, na których główna pętla czeka funkcją poll:
+ * standardowe wejście, raport migawki, a dalej deskryptory replikacji.
+ */
+static struct pollfd *pollFds = NULL;
+
+/**
+ * @brief Rozmiar tablicy @ref pollFds.
+ */
+static size_t pollFdsSize = 0;
+
+/**
+ * @brief Ścieżka do pliku, w którym zapisywana jest migawka baz.
+ * NULL w przypadku braku.
+ */
+static const char *snapshotPath = NULL;
+
+/**
+ * @brief Ścieżka gniazda, na którym lider przyjmuje naśladowców.
+ * NULL w przypadku braku.
+ */
+static const char *leaderSocketPath = NULL;
+
+/**
+ * @brief Ścieżka gniazda lidera, którego naśladuje program.
+ * NULL w przypadku braku.
+ */
+static const char *followSocketPath = NULL;
+
+/**
+ * @brief Czy program kompiluje skrypt zamiast go wykonywać.
+ */
+static bool compileMode = false;
+
+/**
+ * @brief Ścieżka skompilowanego skryptu wykonywanego przed wejściem.
+ * NULL w przypadku braku.
+ */
+static const char *execPath = NULL;
+
+/**
+ * @brief Pozycja końca ostatniej operacji zapisanej w trybie kompilacji.
+ */
+static size_t compiledEndPos = 0;
+
+/**
+ * @brief Ścieżka pliku śladu wykonanych operacji.
+ * NULL w przypadku braku.
+ */
+static const char *tracePath = NULL;
+
+/**
+ * @brief Plik śladu wykonanych operacji.
+ * NULL, jeżeli ślad nie jest zapisywany.
  */
-static struct Parser parser;
+static FILE *traceFile = NULL;
+
+/**
+ * @brief Pozycja końca ostatniej operacji zapisanej w śladzie.
+ */
+static size_t traceEndPos = 0;
+
+/**
+ * @brief Liczba wierszy wypisanych na standardowe wyjście.
+ * Różnica przed i po wykonaniu operacji to rozmiar jej wyniku w śladzie.
+ */
+static size_t outputLines = 0;
+
+/**
+ * @brief Ścieżka pliku dziennika wolnych operacji.
+ * NULL w przypadku braku.
+ */
+static const char *slowLogPath = NULL;
+
+/**
+ * @brief Próg czasu wykonania operacji zapisywanych w dzienniku wolnych
+ * operacji w nanosekundach.
+ */
+static uint64_t slowThreshold = (uint64_t) SLOW_LOG_DEFAULT_THRESHOLD * 1000;
+
+/**
+ * @brief Czy uruchomiono dziennik wolnych operacji.
+ */
+static bool slowLogEnabled = false;
+
+/**
+ * @brief Czas wypisania pierwszego wiersza wyniku wykonywanej operacji.
+ * 0, jeżeli operacja nic jeszcze nie wypisała.
+ */
+static uint64_t outputStart = 0;
+
+/**
+ * @brief Koszt zapytania wykonywanej operacji ?, @ lub EXPLAIN.
+ * Dla operacji ? i @ jest wyznaczany tylko wtedy, gdy działa dziennik
+ * wolnych operacji.
+ */
+static struct PhoneForwardExplain queryExplain;
+
+/**
+ * @brief Czy @ref queryExplain opisuje wykonywaną operację.
+ */
+static bool queryExplained = false;
 
 /**
  * @brief Kończy program.
@@ -113,18 +289,31 @@ static struct Parser parser;
  */
 static void exit_and_clean(int exit_code) {
 
-    if (bases != NULL) {
-        phoneBasesDestroyPhoneBases(bases);
+    snapshotPoll(true);
+    replicationStop();
+
+    if (compileMode && fflush(stdout) != 0 && exit_code == SUCCESS_EXIT_CODE) {
+        exit_code = ERROR_EXIT_CODE;
     }
 
-    if (word1 != NULL) {
-        vectorDelete(word1);
+    if (!slowLogStop() && exit_code == SUCCESS_EXIT_CODE) {
+        fprintf(stderr, "Cannot write slow log %s\n", slowLogPath);
+        exit_code = ERROR_EXIT_CODE;
     }
 
-    if (word2 != NULL) {
-        vectorDelete(word2);
+    if (traceFile != NULL && fclose(traceFile) != 0
+        && exit_code == SUCCESS_EXIT_CODE) {
+        fprintf(stderr, "Cannot write trace %s\n", tracePath);
+        exit_code = ERROR_EXIT_CODE;
     }
 
+    if (bases != NULL) {
+        phoneBasesDestroyPhoneBases(bases);
+    }
+
+    operationDestroy(&operation);
+    streamParserDestroy(&parser);
+    free(pollFds);
 
     exit(exit_code);
 }
@@ -151,498 +340,755 @@ static void printEofError() {
  * Inicjuje struktury:
  * @ref parser
  * @ref bases
- * @ref word1
- * @ref word2
+ * @ref operation
  * w przypadku problemów z pamięcią kończy program
  * i wypisuje informacje o błędzie.
  */
 static void initProgram() {
-    parser = parserCreateNew();
     bases = phoneBasesCreateNewPhoneBases();
     if (bases == NULL) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
+        printErrorMessage(MEMORY_ERROR_INFIX, 0);
         exit_and_clean(ERROR_EXIT_CODE);
     }
 
-    word1 = vectorCreate();
+    if (!operationInit(&operation) || !streamParserInit(&parser)) {
+        printErrorMessage(MEMORY_ERROR_INFIX, 0);
+        exit_and_clean(ERROR_EXIT_CODE);
+    }
 
-    if (word1 == NULL) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
+    if (compileMode && !compiledScriptWriteHeader(stdout)) {
+        fprintf(stderr, "Cannot write compiled script\n");
         exit_and_clean(ERROR_EXIT_CODE);
     }
 
-    word2 = vectorCreate();
+    if (tracePath != NULL) {
+        traceFile = fopen(tracePath, "wb");
+        if (traceFile == NULL || !traceWriteHeader(traceFile)) {
+            fprintf(stderr, "Cannot write trace %s\n", tracePath);
+            exit_and_clean(ERROR_EXIT_CODE);
+        }
+    }
+
+    if (slowLogPath != NULL) {
+        if (!slowLogStart(slowLogPath)) {
+            fprintf(stderr, "Cannot write slow log %s\n", slowLogPath);
+            exit_and_clean(ERROR_EXIT_CODE);
+        }
+        slowLogEnabled = true;
+    }
+
+    if (leaderSocketPath != NULL && !replicationLeaderStart(leaderSocketPath)) {
+        fprintf(stderr, "Cannot listen on %s\n", leaderSocketPath);
+        exit_and_clean(ERROR_EXIT_CODE);
+    }
 
-    if (word2 == NULL) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
+    if (followSocketPath != NULL
+        && !replicationFollowerStart(followSocketPath, bases)) {
+        fprintf(stderr, "Cannot follow %s\n", followSocketPath);
         exit_and_clean(ERROR_EXIT_CODE);
     }
 }
 
 /**
- * @brief Dodaje do Vectora '\0' na koniec.
- * W przypadku problemów z pamięcią kończy program
- * i wypisuje informacje o błędzie.
- * @param[in] v - dany Vector.
+ * @brief Sprawdza stan parsowania.
+ * Jeżeli wystąpił błąd, to wypisuje odpowiednią informację
+ * i kończy program.
+ * @param[in] status - stan parsowania (STREAM_PARSER_*).
  */
-static void makeVectorCStringCompatible(Vector v) {
-    if (!vectorPushBack(v, '\0')) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
+static void checkParserStatus(int status) {
+    if (status == STREAM_PARSER_EOF_ERROR) {
+        printEofError();
+        exit_and_clean(ERROR_EXIT_CODE);
+    } else if (status == STREAM_PARSER_ERROR) {
+        printErrorMessage(BASIC_ERROR_INFIX, streamParserErrorPosition(&parser));
+        exit_and_clean(ERROR_EXIT_CODE);
+    } else if (status == STREAM_PARSER_MEMORY_ERROR) {
+        printErrorMessage(MEMORY_ERROR_INFIX, streamParserErrorPosition(&parser));
         exit_and_clean(ERROR_EXIT_CODE);
     }
 }
 
 /**
- * @brief Czyści Vectory @p word1 @p word2.
+ * @brief Zaznacza rozpoczęcie wypisywania wyniku operacji.
+ * Zapamiętuje czas tylko przy pierwszym wywołaniu dla operacji i tylko
+ * wtedy, gdy działa dziennik wolnych operacji.
  */
-static void loopStepClear() {
-    vectorSoftClear(word1);
-    vectorSoftClear(word2);
+static void beginOutput() {
+    if (slowLogEnabled && outputStart == 0) {
+        outputStart = traceClock();
+    }
 }
 
 /**
- * @brief Sprawdza czy wystąpił błąd parsowania.
- * Jeżeli wystąpił to wypisuje odpowiednią informację
+ * @brief Sprawdza czy wybrano bazę, na której można wykonać operację.
+ * Jeżeli nie, to wypisuje informację o błędzie operacji @p op
  * i kończy program.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ * @param[in] infix - infiks informacji o błędzie.
+ * @param[in] modifies - czy operacja modyfikuje bazę (niedozwolone
+ *       w trybie naśladowcy).
  */
-static void checkParserError() {
-    if (parserIsCommentEofError(&parser)) {
-        printEofError();
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
-    if (parserError(&parser)) {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser));
+static void checkCurrentBase(const struct Operation *op, const char *infix,
+                             bool modifies) {
+    if (currentBase == NULL || (modifies && replicationIsFollower())) {
+        printErrorMessage(infix, op->operatorPos);
         exit_and_clean(ERROR_EXIT_CODE);
     }
 }
 
-
 /**
- * @brief Sprawdza czy wystąpił błąd parsowania typu EOF.
- * Jeżeli wystąpił to wypisuje odpowiednią informację
- * i kończy program.
+ * @brief Sprawdza wynik operacji wymagającej pamięci.
+ * Jeżeli @p success jest równe false, to wypisuje informację o błędzie
+ * pamięci i kończy program.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ * @param[in] success - wynik operacji.
  */
-static void checkEofError() {
-    if (inputIsEOF()) {
-        printEofError();
+static void checkMemory(const struct Operation *op, bool success) {
+    if (!success) {
+        printErrorMessage(MEMORY_ERROR_INFIX, op->endPos);
         exit_and_clean(ERROR_EXIT_CODE);
     }
 }
 
 /**
- * @brief Sprawdza czy parsowanie się zakończyło.
- * Jeżeli tak to kończy program.
+ * @brief Wypisuje numery.
+ * Jeżeli nie uda się utworzyć napisu numeru, wypisuje informację o błędzie
+ * pamięci operacji @p op i kończy program.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ * @param[in] numbers - struktura przechowująca numery do wypisania.
  */
-static void checkParserFinished() {
-    if (parserFinished(&parser)) {
-        exit_and_clean(SUCCESS_EXIT_CODE);
+static void printNumbers(const struct Operation *op,
+                         const struct PhoneNumbers *numbers) {
+    beginOutput();
+    size_t i, howMany = phnumSize(numbers);
+    for (i = 0; i < howMany; i++) {
+        const char *number = phnumGet(numbers, i);
+        checkMemory(op, number != NULL);
+        fprintf(stdout, "%s\n", number);
     }
+    outputLines += howMany;
 }
 
 /**
- * @brief Pomija zbędne znaki.
- * Wywołuje @ref parserSkipSkipable,
- * oraz @ref checkParserError.
+ * @brief Wykonuje operację dodania nowej bazy.
+ * @param[in] op - wskaźnik na wykonywaną operację.
  */
-static void skipSkipable() {
-    parserSkipSkipable(&parser);
-    checkParserError();
+static void executeOperationNew(const struct Operation *op) {
+    currentBase = phoneBasesAddBase(bases, vectorBegin(op->arg1));
+
+    checkMemory(op, currentBase != NULL
+                    && replicationLogNew(vectorBegin(op->arg1)));
 }
 
 /**
- * @brief Obsługuje operację dodania nowej bazy.
- * Zakłada, że poprzednio wczytaną operacją jest PARSER_OPERATOR_NEW.
- * W przypadku problemów wypisuje odpowiedni komunikat
- * i kończy program.
+ * @brief Wykonuje operację phfwdRemove(numer).
+ * @param[in] op - wskaźnik na wykonywaną operację.
  */
-static void readOperationNew() {
-    skipSkipable();
-    checkEofError();
+static void executeOperationDeleteNumber(const struct Operation *op) {
+    checkCurrentBase(op, DEL_OPERATOR_ERROR_INFIX, true);
 
-    int nextType = parserNextType(&parser);
-    checkParserError();
+    phfwdRemove(currentBase, vectorBegin(op->arg1));
 
+    checkMemory(op, replicationLogRemove(vectorBegin(op->arg1)));
+}
+
+/**
+ * @brief Wykonuje operację usunięcia bazy przekierowań.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperationDeleteBase(const struct Operation *op) {
+    struct PhoneForward *toDel = phoneBasesGetBase(bases, vectorBegin(op->arg1));
 
-    if (nextType != PARSER_ELEMENT_TYPE_WORD) {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser) + 1);
+    if (toDel == NULL || replicationIsFollower()) {
+        printErrorMessage(DEL_OPERATOR_ERROR_INFIX, op->operatorPos);
         exit_and_clean(ERROR_EXIT_CODE);
     }
 
-    if (!parserReadIdentificator(&parser, word1)) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
+    if (toDel == currentBase) {
+        currentBase = NULL;
     }
-    checkParserError();
 
-    makeVectorCStringCompatible(word1);
+    phoneBasesDelBase(bases, vectorBegin(op->arg1));
 
-    if (strcmp(vectorBegin(word1), PARSER_OPERATOR_DELETE) == 0
-        || strcmp(vectorBegin(word1), PARSER_OPERATOR_NEW) == 0) {
-        printErrorMessage(BASIC_ERROR_INFIX,
-                          parserGetReadBytes(&parser) - OPERATOR_POSITION_OFFSET);
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
+    checkMemory(op, replicationLogDelBase(vectorBegin(op->arg1)));
+}
 
-    if (vectorSize(word1) <= 1) {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
+/**
+ * @brief Wykonuje operację phfwdReverse.
+ * Jeżeli działa dziennik wolnych operacji, to zapamiętuje koszt zapytania
+ * w @ref queryExplain.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperationReverse(const struct Operation *op) {
+    checkCurrentBase(op, QM_OPERATOR_ERROR_INFIX, false);
 
-    currentBase = phoneBasesAddBase(bases, vectorBegin(word1));
+    const struct PhoneNumbers *numbers
+            = slowLogEnabled
+              ? phfwdExplainReverse(currentBase, vectorBegin(op->arg1),
+                                    &queryExplain)
+              : phfwdReverse(currentBase, vectorBegin(op->arg1));
+    queryExplained = slowLogEnabled;
 
-    if (currentBase == NULL) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
+    checkMemory(op, numbers != NULL);
 
+    printNumbers(op, numbers);
+
+    phnumDelete(numbers);
 }
 
 /**
- * @brief Obsługuje operację phfwdRemove(numer).
- * Oczekuje, że poprzednio wczytano operator PARSER_OPERATOR_DELETE
- * oraz że na wczytanie według @p parserNextType oczekuje numer.
- * @param[in] operatorPos - pozycja operatora usunięcia.
- * W przypadku problemów wypisuje odpowiedni komunikat
- * i kończy program.
+ * @param[in] op - wskaźnik na operację.
+ * @return Długość numeru dla phfwdNonTrivialCount wyznaczona z długości
+ *         argumentu operacji @ (o 12 mniejsza, nie mniejsza niż 0).
  */
-static void readOperationDeleteNumber(size_t operatorPos) {
-    if (!parserReadNumber(&parser, word1)) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
-    checkParserError();
+static size_t nonTrivialLength(const struct Operation *op) {
+    size_t len = strlen(vectorBegin(op->arg1));
+    return len <= 12 ? 0 : len - 12;
+}
 
-    if (currentBase == NULL) {
-        printErrorMessage(DEL_OPERATOR_ERROR_INFIX, operatorPos);
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
+/**
+ * @brief Wykonuje operację phfwdNonTrivialCount.
+ * Jeżeli działa dziennik wolnych operacji, to zapamiętuje koszt zapytania
+ * w @ref queryExplain.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperationNonTrivial(const struct Operation *op) {
+    checkCurrentBase(op, NONTRIVIAL_OPERATOR_ERROR_INFIX, false);
+
+    size_t result = slowLogEnabled
+                    ? phfwdExplainNonTrivialCount(currentBase,
+                                                  vectorBegin(op->arg1),
+                                                  nonTrivialLength(op),
+                                                  &queryExplain)
+                    : phfwdNonTrivialCount(currentBase, vectorBegin(op->arg1),
+                                           nonTrivialLength(op));
+    queryExplained = slowLogEnabled;
+
+    beginOutput();
+    fprintf(stdout, "%zu\n", result);
+    outputLines++;
+}
 
-    makeVectorCStringCompatible(word1);
-    phfwdRemove(currentBase, vectorBegin(word1));
+/**
+ * @brief Wypisuje koszt zapytania.
+ * @param[in] explain - wskaźnik na koszt zapytania.
+ */
+static void printExplain(const struct PhoneForwardExplain *explain) {
+    fprintf(stdout, "%s nodes=%zu chars=%zu blocks=%zu entries=%zu "
+                    "allocations=%zu descent_ns=%llu climb_ns=%llu "
+                    "build_ns=%llu sort_ns=%llu\n",
+            EXPLAIN_PREFIX, explain->nodes, explain->chars, explain->blocks,
+            explain->listEntries, explain->allocations,
+            (unsigned long long) explain->descentTime,
+            (unsigned long long) explain->climbTime,
+            (unsigned long long) explain->buildTime,
+            (unsigned long long) explain->sortTime);
+    outputLines++;
 }
 
 /**
- * @brief Obsługuje operację usunięcia bazy przekierowań.
- * Oczekuje, że poprzednio wczytano operator PARSER_OPERATOR_DELETE
- * oraz że na wczytanie według @p parserNextType oczekuje identyfikator.
- * @param[in] operatorPos - pozycja (nr bajtu) operatora usunięcia.
- * W przypadku problemów wypisuje odpowiedni komunikat
- * i kończy program.
+ * @brief Wykonuje operację EXPLAIN ?, lub EXPLAIN @.
+ * Wypisuje wynik jak operacja bez przedrostka, a po nim koszt zapytania.
+ * @param[in] op - wskaźnik na wykonywaną operację.
  */
-static void readOperationDeleteBase(size_t operatorPos) {
-    if (!parserReadIdentificator(&parser, word1)) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
-    checkParserError();
+static void executeOperationExplain(const struct Operation *op) {
+    struct PhoneForwardExplain explain;
+    if (op->type == OPERATION_EXPLAIN_NONTRIVIAL) {
+        checkCurrentBase(op, NONTRIVIAL_OPERATOR_ERROR_INFIX, false);
+
+        size_t result = phfwdExplainNonTrivialCount(currentBase,
+                                                    vectorBegin(op->arg1),
+                                                    nonTrivialLength(op),
+                                                    &explain);
+        beginOutput();
+        fprintf(stdout, "%zu\n", result);
+        outputLines++;
+    } else {
+        checkCurrentBase(op, QM_OPERATOR_ERROR_INFIX, false);
 
-    makeVectorCStringCompatible(word1);
+        const struct PhoneNumbers *numbers
+                = op->type == OPERATION_EXPLAIN_GET
+                  ? phfwdExplainGet(currentBase, vectorBegin(op->arg1),
+                                    &explain)
+                  : phfwdExplainReverse(currentBase, vectorBegin(op->arg1),
+                                        &explain);
 
-    if (strcmp(vectorBegin(word1), PARSER_OPERATOR_DELETE) == 0
-        || strcmp(vectorBegin(word1), PARSER_OPERATOR_NEW) == 0) {
-        printErrorMessage(BASIC_ERROR_INFIX,
-                          parserGetReadBytes(&parser) - OPERATOR_POSITION_OFFSET);
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
+        checkMemory(op, numbers != NULL);
 
-    struct PhoneForward *toDel = phoneBasesGetBase(bases, vectorBegin(word1));
+        printNumbers(op, numbers);
 
-    if (toDel == NULL) {
-        printErrorMessage(DEL_OPERATOR_ERROR_INFIX, operatorPos);
-        exit_and_clean(ERROR_EXIT_CODE);
+        phnumDelete(numbers);
     }
+    printExplain(&explain);
+    queryExplain = explain;
+    queryExplained = true;
+}
 
-    if (toDel == currentBase) {
-        currentBase = NULL;
-    }
+/**
+ * @brief Wykonuje operację phfwdGet(numer).
+ * Jeżeli działa dziennik wolnych operacji, to zapamiętuje koszt zapytania
+ * w @ref queryExplain.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperationGet(const struct Operation *op) {
+    checkCurrentBase(op, QM_OPERATOR_ERROR_INFIX, false);
+
+    const struct PhoneNumbers *numbers
+            = slowLogEnabled
+              ? phfwdExplainGet(currentBase, vectorBegin(op->arg1),
+                                &queryExplain)
+              : phfwdGet(currentBase, vectorBegin(op->arg1));
+    queryExplained = slowLogEnabled;
 
-    phoneBasesDelBase(bases, vectorBegin(word1));
+    checkMemory(op, numbers != NULL);
 
+    printNumbers(op, numbers);
+
+    phnumDelete(numbers);
 }
 
 /**
- * @brief Obsługuje operację zadaną przez operator PARSER_OPERATOR_DELETE.
- * Oczekuje, że poprzednio wczytano operator PARSER_OPERATOR_DELETE.
+ * @brief Wykonuje operację przekierowania numerów arg1 > arg2.
+ * @param[in] op - wskaźnik na wykonywaną operację.
  */
-static void readOperationDelete() {
-    size_t operatorPos =
-            parserGetReadBytes(&parser) - strlen(PARSER_OPERATOR_DELETE) + 1;
-    skipSkipable();
-    checkEofError();
+static void executeOperationRedirect(const struct Operation *op) {
+    checkCurrentBase(op, REDIRECT_OPERATOR_ERROR_INFIX, true);
 
-    int nextType = parserNextType(&parser);
-    checkParserError();
-
-    if (nextType == PARSER_ELEMENT_TYPE_NUMBER) {
-        readOperationDeleteNumber(operatorPos);
-    } else if (nextType == PARSER_ELEMENT_TYPE_WORD) {
-        readOperationDeleteBase(operatorPos);
-    } else {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser) + 1);
+    if (strcmp(vectorBegin(op->arg1), vectorBegin(op->arg2)) == 0) {
+        printErrorMessage(REDIRECT_OPERATOR_ERROR_INFIX, op->operatorPos);
         exit_and_clean(ERROR_EXIT_CODE);
     }
 
+    checkMemory(op, phfwdAdd(currentBase, vectorBegin(op->arg1),
+                             vectorBegin(op->arg2))
+                    && replicationLogAdd(vectorBegin(op->arg1),
+                                         vectorBegin(op->arg2)));
 }
 
 /**
- * @brief Wypisuje numery.
- * @param[in] numbers - struktura przechowująca numery do wypisania.
+ * @brief Wykonuje operację zapisania migawki baz.
+ * Migawka jest zapisywana w tle do pliku @ref snapshotPath.
+ * Jeżeli poprzednia migawka jest jeszcze zapisywana, to operacja jest
+ * pomijana, a informacja o tym trafia na standardowe wyjście błędów.
+ * @param[in] op - wskaźnik na wykonywaną operację.
  */
-static void printNumbers(const struct PhoneNumbers *numbers) {
-    size_t i;
-    for (i = 0; phnumGet(numbers, i) != NULL; i++) {
-        fprintf(stdout, "%s\n", phnumGet(numbers, i));
+static void executeOperationSave(const struct Operation *op) {
+    if (snapshotPath != NULL) {
+        snapshotPoll(false);
+        if (snapshotInProgress()) {
+            fprintf(stderr, "SNAPSHOT BUSY, SAVE skipped\n");
+            return;
+        }
+    }
+    if (snapshotPath == NULL || !snapshotStart(bases, snapshotPath)) {
+        printErrorMessage(SAVE_OPERATOR_ERROR_INFIX, op->operatorPos);
+        exit_and_clean(ERROR_EXIT_CODE);
     }
 }
 
 /**
- * @brief Obsługuje operację phwfdReverse.
- * Oczekuje, że poprzednio wczytano PARSER_OPERATOR_QM.
+ * @brief Wypisuje cel przekierowań i liczbę przekierowań na niego.
+ * @see phfwdForEachTopTarget
+ * @param[in] target - numer.
+ * @param[in] count - liczba przekierowań.
+ * @param[in] data - nieużywane.
+ * @return true
  */
-static void readOperationReverse() {
-    size_t operatorPos = parserGetReadBytes(&parser);
-    skipSkipable();
-    checkEofError();
-
-    int nextType = parserNextType(&parser);
-    checkParserError();
-
-    if (nextType == PARSER_ELEMENT_TYPE_NUMBER) {
-        if (!parserReadNumber(&parser, word1)) {
-            printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-            exit_and_clean(ERROR_EXIT_CODE);
-        }
-        checkParserError();
-
-
-        if (currentBase == NULL) {
-            printErrorMessage(QM_OPERATOR_ERROR_INFIX, operatorPos);
-            exit_and_clean(ERROR_EXIT_CODE);
-        }
-        makeVectorCStringCompatible(word1);
-        const struct PhoneNumbers *numbers
-                = phfwdReverse(currentBase, vectorBegin(word1));
+static bool printTopTarget(const char *target, size_t count, void *data) {
+    (void) data;
+    beginOutput();
+    fprintf(stdout, "%s %zu\n", target, count);
+    outputLines++;
+    return true;
+}
 
-        if (numbers == NULL) {
-            printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
+/**
+ * @brief Wykonuje operację phfwdForEachTopTarget.
+ * Argumentem jest liczba wypisywanych celów zapisana cyframi dziesiętnymi.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperationTop(const struct Operation *op) {
+    checkCurrentBase(op, TOP_OPERATOR_ERROR_INFIX, false);
+
+    size_t k = 0;
+    const char *ptr;
+    for (ptr = vectorBegin(op->arg1); *ptr != '\0'; ptr++) {
+        if (!isdigit((unsigned char) *ptr)) {
+            printErrorMessage(TOP_OPERATOR_ERROR_INFIX, op->operatorPos);
             exit_and_clean(ERROR_EXIT_CODE);
         }
+        size_t digit = (size_t) (*ptr - '0');
+        k = k > (SIZE_MAX - digit) / 10 ? SIZE_MAX : k * 10 + digit;
+    }
 
-        printNumbers(numbers);
-
-        phnumDelete(numbers);
-
+    checkMemory(op, phfwdForEachTopTarget(currentBase, k, printTopTarget,
+                                          NULL));
+}
 
-    } else {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser) + 1);
-        exit_and_clean(ERROR_EXIT_CODE);
+/**
+ * @brief Wykonuje operację bez zapisywania jej w śladzie.
+ * W przypadku problemów wypisuje odpowiedni komunikat
+ * i kończy program.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperationUntraced(const struct Operation *op) {
+    switch (op->type) {
+        case OPERATION_NEW:
+            executeOperationNew(op);
+            break;
+        case OPERATION_DELETE_NUMBER:
+            executeOperationDeleteNumber(op);
+            break;
+        case OPERATION_DELETE_BASE:
+            executeOperationDeleteBase(op);
+            break;
+        case OPERATION_REVERSE:
+            executeOperationReverse(op);
+            break;
+        case OPERATION_NONTRIVIAL:
+            executeOperationNonTrivial(op);
+            break;
+        case OPERATION_GET:
+            executeOperationGet(op);
+            break;
+        case OPERATION_REDIRECT:
+            executeOperationRedirect(op);
+            break;
+        case OPERATION_SAVE:
+            executeOperationSave(op);
+            break;
+        case OPERATION_TOP:
+            executeOperationTop(op);
+            break;
+        case OPERATION_EXPLAIN_GET:
+        case OPERATION_EXPLAIN_REVERSE:
+        case OPERATION_EXPLAIN_NONTRIVIAL:
+            executeOperationExplain(op);
+            break;
+        default:
+            break;
     }
-
 }
 
 /**
- * @brief Obsługuje operację phfwdNonTrivialCount.
- * Oczekuje, że poprzednio wczytano PARSER_OPERATOR_NONTRIVIAL.
+ * @brief Zapamiętuje identyfikator bazy, jeżeli jest to aktywna baza.
+ * @see phoneBasesForEach
+ * @param[in] id - identyfikator bazy.
+ * @param[in] base - wskaźnik na bazę.
+ * @param[out] data - wskaźnik na opis wolnej operacji.
+ * @return false jeżeli @p base jest aktywną bazą, true w przeciwnym
+ *         przypadku.
  */
-static void readOperationNonTrivial() {
-    size_t operatorPos = parserGetReadBytes(&parser);
-    skipSkipable();
-    checkEofError();
+static bool findCurrentBaseId(const char *id, struct PhoneForward *base,
+                              void *data) {
+    if (base != currentBase) {
+        return true;
+    }
+    struct SlowLogRecord *record = data;
+    snprintf(record->base, sizeof(record->base), "%s", id);
+    return false;
+}
 
-    int nextType = parserNextType(&parser);
-    checkParserError();
+/**
+ * @brief Przekazuje opis wolnej operacji do dziennika wolnych operacji.
+ * Identyfikator aktywnej bazy jest wyszukiwany tylko dla wolnych operacji,
+ * więc nie spowalnia to pozostałych operacji. Dla operacji ?, @ i EXPLAIN
+ * opis zawiera czasy faz zapytania zmierzone przez bibliotekę.
+ * @param[in] op - wskaźnik na wykonaną operację.
+ * @param[in] resultSize - rozmiar wyniku (liczba wypisanych wierszy).
+ * @param[in] start - czas rozpoczęcia operacji.
+ * @param[in] end - czas zakończenia operacji.
+ */
+static void logSlowOperation(const struct Operation *op, size_t resultSize,
+                             uint64_t start, uint64_t end) {
+    int args = operationArgumentsNumber(op->type);
+    uint64_t queryEnd = outputStart == 0 ? end : outputStart;
+    struct SlowLogRecord record = {
+            op->type, op->endPos, op->operatorPos, "-",
+            args >= 1 ? strlen(vectorBegin(op->arg1)) : 0,
+            args >= 2 ? strlen(vectorBegin(op->arg2)) : 0,
+            resultSize, end - start, queryExplained,
+            queryExplained ? queryExplain.descentTime : 0,
+            queryExplained ? queryExplain.climbTime : 0,
+            queryExplained ? queryExplain.buildTime : 0,
+            queryExplained ? queryExplain.sortTime : 0,
+            end - queryEnd
+    };
+    if (currentBase != NULL) {
+        phoneBasesForEach(bases, findCurrentBaseId, &record);
+    }
+    slowLogPush(&record);
+}
 
-    if (nextType == PARSER_ELEMENT_TYPE_NUMBER) {
-        if (!parserReadNumber(&parser, word1)) {
-            printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-            exit_and_clean(ERROR_EXIT_CODE);
-        }
-        checkParserError();
+/**
+ * @brief Wykonuje operację.
+ * Jeżeli zapisywany jest ślad, to dopisuje do niego operację, rozmiar jej
+ * wyniku i czas wykonania. Jeżeli działa dziennik wolnych operacji,
+ * a czas wykonania osiągnął @ref slowThreshold, to przekazuje do niego
+ * opis operacji. Operacje kończące program błędem nie trafiają
+ * do śladu ani do dziennika. W przypadku problemów wypisuje odpowiedni
+ * komunikat i kończy program.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ */
+static void executeOperation(const struct Operation *op) {
+    PROBE2(operation__entry, op->type, op->operatorPos);
+    if (traceFile == NULL && !slowLogEnabled) {
+        executeOperationUntraced(op);
+        PROBE2(operation__return, op->type, op->endPos);
+        return;
+    }
 
-        if (currentBase == NULL) {
-            printErrorMessage(NONTRIVIAL_OPERATOR_ERROR_INFIX, operatorPos);
+    size_t lines = outputLines;
+    outputStart = 0;
+    queryExplained = false;
+    uint64_t start = traceClock();
+    executeOperationUntraced(op);
+    uint64_t end = traceClock();
+    uint64_t duration = end - start;
+
+    if (traceFile != NULL) {
+        struct TraceRecord record = {outputLines - lines,
+                                     duration > SIZE_MAX ? SIZE_MAX
+                                                         : (size_t) duration};
+        if (!traceWriteRecord(traceFile, op, &record, &traceEndPos)) {
+            fprintf(stderr, "Cannot write trace %s\n", tracePath);
             exit_and_clean(ERROR_EXIT_CODE);
         }
+    }
 
-        size_t len = vectorSize(word1);
-        if (len <= 12) {
-            len = 0;
-        } else {
-            len -= 12;
-        }
-        makeVectorCStringCompatible(word1);
-        size_t result = phfwdNonTrivialCount(currentBase, vectorBegin(word1), len);
-
-        fprintf(stdout, "%zu\n", result);
-
-
-    } else {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser) + 1);
-        exit_and_clean(ERROR_EXIT_CODE);
+    if (slowLogEnabled && duration >= slowThreshold) {
+        logSlowOperation(op, outputLines - lines, start, end);
     }
+    PROBE2(operation__return, op->type, op->endPos);
 }
 
-
 /**
- * @brief Obsługuje operację phfwdGet(word1).
+ * @brief Obsługuje wczytaną operację.
+ * W trybie kompilacji zapisuje ją na standardowe wyjście,
+ * w przeciwnym przypadku ją wykonuje.
+ * @see StreamParserHandler
+ * @param[in] op - wskaźnik na wczytaną operację.
+ * @param[in] data - nieużywane.
  */
-static void readOperatorGetFromWord1() {
-    makeVectorCStringCompatible(word1);
-
-    if (currentBase == NULL) {
-        printErrorMessage(QM_OPERATOR_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
-    }
-
-    const struct PhoneNumbers *numbers = phfwdGet(currentBase, vectorBegin(word1));
+static void handleOperation(const struct Operation *op, void *data) {
+    (void) data;
 
-    if (numbers == NULL) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
+    if (compileMode) {
+        if (!compiledScriptWriteOperation(stdout, op, &compiledEndPos)) {
+            fprintf(stderr, "Cannot write compiled script\n");
+            exit_and_clean(ERROR_EXIT_CODE);
+        }
+    } else {
+        executeOperation(op);
     }
-
-    printNumbers(numbers);
-
-    phnumDelete(numbers);
-
 }
 
 /**
- * @brief Obsługuje operację przekierowania numerów word1 > word2.
- * Oczekuje wczytania pierwszego numeru do word1
- * i wczytania operatora przekierowania.
+ * @brief Wykonuje skompilowany skrypt @ref execPath.
+ * W przypadku uszkodzonego skryptu wypisuje informację o błędzie
+ * i kończy program.
  */
-static void readOperatorRedirectWord1() {
-    size_t operatorPos = parserGetReadBytes(&parser);
-    skipSkipable();
-    checkEofError();
-
-    int nextType = parserNextType(&parser);
-    checkParserError();
-
-    if (nextType != PARSER_ELEMENT_TYPE_NUMBER) {
-        printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser) + 1);
+static void executeCompiledScript() {
+    FILE *in = fopen(execPath, "rb");
+    if (in == NULL || !compiledScriptReadHeader(in)) {
+        fprintf(stderr, "Cannot execute %s\n", execPath);
+        if (in != NULL) {
+            fclose(in);
+        }
         exit_and_clean(ERROR_EXIT_CODE);
     }
 
-    if (!parserReadNumber(&parser, word2)) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-        exit_and_clean(ERROR_EXIT_CODE);
+    int result;
+    size_t endPos = 0;
+    while ((result = compiledScriptReadOperation(in, &operation, &endPos))
+           == COMPILED_SCRIPT_OPERATION) {
+        executeOperation(&operation);
     }
-    checkParserError();
+    fclose(in);
 
-    if (currentBase == NULL) {
-        printErrorMessage(REDIRECT_OPERATOR_ERROR_INFIX, operatorPos);
+    if (result == COMPILED_SCRIPT_MEMORY_ERROR) {
+        printErrorMessage(MEMORY_ERROR_INFIX, operation.endPos);
         exit_and_clean(ERROR_EXIT_CODE);
-    }
-    makeVectorCStringCompatible(word1);
-    makeVectorCStringCompatible(word2);
-
-    if (strcmp(vectorBegin(word1), vectorBegin(word2)) == 0) {
-        printErrorMessage(REDIRECT_OPERATOR_ERROR_INFIX, operatorPos);
+    } else if (result == COMPILED_SCRIPT_MALFORMED) {
+        fprintf(stderr, "Malformed compiled script %s\n", execPath);
         exit_and_clean(ERROR_EXIT_CODE);
     }
+}
 
-    if (!phfwdAdd(currentBase, vectorBegin(word1), vectorBegin(word2))) {
-        printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
+/**
+ * @brief Obsługuje replikację.
+ * Lider wysyła naśladowcom nowe rekordy dziennika, a naśladowca
+ * stosuje rekordy otrzymane od lidera. W przypadku problemów z pamięcią
+ * wypisuje informację o błędzie i kończy program.
+ */
+static void pollReplication() {
+    if (!replicationPoll(bases, &currentBase)) {
+        printErrorMessage(MEMORY_ERROR_INFIX, streamParserGetReadBytes(&parser));
         exit_and_clean(ERROR_EXIT_CODE);
     }
 }
 
 /**
- * @brief Wczytuje operację / jej fragment i obsługuje ją.
- * @param[in] nextType - oczekiwany typ wczytanych danych,
- *       pochodzący z wywołania @ref parserNextType.
+ * @brief Czeka na dane na standardowym wejściu lub zdarzenia
+ * migawki i replikacji.
+ * Obsługuje zakończenie zapisu migawki i replikację, dzięki czemu działają
+ * one także wtedy, gdy na standardowym wejściu nie pojawiają się dane.
+ * W przypadku problemów z pamięcią lub błędu funkcji poll wypisuje
+ * informację o błędzie i kończy program.
+ * @return true jeżeli można czytać ze standardowego wejścia, false
+ *         w przeciwnym przypadku.
  */
-static void readOperation(int nextType) {
-    if (nextType == PARSER_ELEMENT_TYPE_WORD) {
-        int operator = parserReadOperator(&parser);
-        checkParserError();
-        checkEofError();
-
-        if (operator == PARSER_ELEMENT_TYPE_OPERATOR_NEW) {
-            readOperationNew();
-        } else if (operator == PARSER_ELEMENT_TYPE_OPERATOR_DELETE) {
-            readOperationDelete();
-        } else {
-            printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser));
+static bool waitForInput() {
+    size_t count = POLL_FIXED_FDS + replicationPollFds(
+            pollFds + POLL_FIXED_FDS,
+            pollFdsSize > POLL_FIXED_FDS ? pollFdsSize - POLL_FIXED_FDS : 0);
+    if (count > pollFdsSize) {
+        struct pollfd *fds = realloc(pollFds, count * sizeof(struct pollfd));
+        if (fds == NULL) {
+            printErrorMessage(MEMORY_ERROR_INFIX,
+                              streamParserGetReadBytes(&parser));
             exit_and_clean(ERROR_EXIT_CODE);
         }
+        pollFds = fds;
+        pollFdsSize = count;
+        replicationPollFds(pollFds + POLL_FIXED_FDS, count - POLL_FIXED_FDS);
+    }
 
-    } else if (nextType == PARSER_ELEMENT_TYPE_SINGLE_CHARACTER_OPERATOR) {
-        int operator = parserReadOperator(&parser);
-        checkParserError();
-        checkEofError();
+    pollFds[0].fd = STDIN_FILENO;
+    pollFds[0].events = POLLIN;
+    pollFds[1].fd = snapshotFd();
+    pollFds[1].events = POLLIN;
 
-        if (operator == PARSER_ELEMENT_TYPE_OPERATOR_QM) {
-            readOperationReverse();
-        } else if (operator == PARSER_ELEMENT_TYPE_OPERATOR_NONTRIVIAL) {
-            readOperationNonTrivial();
-        } else {
-            printErrorMessage(BASIC_ERROR_INFIX, parserGetReadBytes(&parser));
-            exit_and_clean(ERROR_EXIT_CODE);
+    if (poll(pollFds, (nfds_t) count, -1) < 0) {
+        if (errno == EINTR) {
+            return false;
         }
+        fprintf(stderr, "Cannot wait for input\n");
+        exit_and_clean(ERROR_EXIT_CODE);
+    }
 
-    } else if (nextType == PARSER_ELEMENT_TYPE_NUMBER) {
-        if (!parserReadNumber(&parser, word1)) {
-            printErrorMessage(MEMORY_ERROR_INFIX, parserGetReadBytes(&parser));
-            exit_and_clean(ERROR_EXIT_CODE);
-        }
-        checkParserError();
-
-        skipSkipable();
-        checkEofError();
-
-        int midType = parserNextType(&parser);
-        checkParserError();
-
-        if (midType == PARSER_ELEMENT_TYPE_SINGLE_CHARACTER_OPERATOR) {
-            int operator = parserReadOperator(&parser);
-            checkParserError();
+    snapshotPoll(pollFds[1].revents != 0);
+    pollReplication();
+    return pollFds[0].revents != 0;
+}
 
-            if (operator == PARSER_ELEMENT_TYPE_OPERATOR_QM) {
-                readOperatorGetFromWord1();
-            } else if (operator == PARSER_ELEMENT_TYPE_OPERATOR_REDIRECT) {
-                checkEofError();
-                readOperatorRedirectWord1();
-            } else {
-                printErrorMessage(BASIC_ERROR_INFIX,
-                                  parserGetReadBytes(&parser) + 1);
-                exit_and_clean(ERROR_EXIT_CODE);
-            }
+/**
+ * @brief Wypisuje informację o użyciu i kończy program.
+ * @param[in] name - nazwa programu.
+ */
+static void printUsage(const char *name) {
+    fprintf(stderr, "Usage: %s [%s <file>] [%s <socket> | %s <socket>] "
+                    "[%s <file> | %s] [%s <file>] [%s <file> [%s <us>]]\n",
+            name, SNAPSHOT_OPTION, LEADER_OPTION, FOLLOW_OPTION,
+            EXEC_OPTION, COMPILE_OPTION, TRACE_OPTION, SLOW_LOG_OPTION,
+            SLOW_THRESHOLD_OPTION);
+    exit(ERROR_EXIT_CODE);
+}
 
+/**
+ * @brief Wczytuje próg dziennika wolnych operacji.
+ * @param[in] text - próg w mikrosekundach zapisany cyframi dziesiętnymi.
+ * @return true jeżeli @p text jest poprawnym progiem, false w przeciwnym
+ *         przypadku.
+ */
+static bool readSlowThreshold(const char *text) {
+    uint64_t us = 0;
+    const char *ptr;
+    for (ptr = text; *ptr != '\0'; ptr++) {
+        if (!isdigit((unsigned char) *ptr)) {
+            return false;
+        }
+        uint64_t digit = (uint64_t) (*ptr - '0');
+        if (us > (UINT64_MAX / 1000 - digit) / 10) {
+            return false;
+        }
+        us = us * 10 + digit;
+    }
+    slowThreshold = us * 1000;
+    return ptr != text;
+}
 
+/**
+ * @brief Wczytuje opcje wiersza poleceń.
+ * W przypadku niepoprawnych opcji wypisuje informację o użyciu
+ * i kończy program.
+ * @param[in] argc - liczba argumentów.
+ * @param[in] argv - argumenty.
+ */
+static void readOptions(int argc, char *argv[]) {
+    bool threshold = false;
+    int i;
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], SNAPSHOT_OPTION) == 0 && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (strcmp(argv[i], LEADER_OPTION) == 0 && i + 1 < argc) {
+            leaderSocketPath = argv[++i];
+        } else if (strcmp(argv[i], FOLLOW_OPTION) == 0 && i + 1 < argc) {
+            followSocketPath = argv[++i];
+        } else if (strcmp(argv[i], EXEC_OPTION) == 0 && i + 1 < argc) {
+            execPath = argv[++i];
+        } else if (strcmp(argv[i], TRACE_OPTION) == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], SLOW_LOG_OPTION) == 0 && i + 1 < argc) {
+            slowLogPath = argv[++i];
+        } else if (strcmp(argv[i], SLOW_THRESHOLD_OPTION) == 0
+                   && i + 1 < argc && readSlowThreshold(argv[i + 1])) {
+            threshold = true;
+            i++;
+        } else if (strcmp(argv[i], COMPILE_OPTION) == 0) {
+            compileMode = true;
         } else {
-            printErrorMessage(BASIC_ERROR_INFIX,
-                              parserGetReadBytes(&parser) + 1);
-            exit_and_clean(ERROR_EXIT_CODE);
+            printUsage(argv[0]);
         }
+    }
 
-
-    } else {
-        printErrorMessage(BASIC_ERROR_INFIX,
-                          parserGetReadBytes(&parser) + 1);
-        exit_and_clean(ERROR_EXIT_CODE);
+    if ((leaderSocketPath != NULL && followSocketPath != NULL)
+        || (compileMode && (execPath != NULL || snapshotPath != NULL
+                            || leaderSocketPath != NULL
+                            || followSocketPath != NULL
+                            || tracePath != NULL || slowLogPath != NULL))
+        || (threshold && slowLogPath == NULL)) {
+        printUsage(argv[0]);
     }
 }
 
 /**
  * @brief Główna pętla programu.
+ * @param[in] argc - liczba argumentów.
+ * @param[in] argv - argumenty.
  * @return
  */
-int main() {
+int main(int argc, char *argv[]) {
+    readOptions(argc, argv);
     initProgram();
 
+    if (execPath != NULL) {
+        executeCompiledScript();
+    }
+
+    char buffer[INPUT_BUFFER_SIZE];
     while (true) {
-        loopStepClear();
-        skipSkipable();
-        checkParserFinished();
+        if (!waitForInput()) {
+            continue;
+        }
 
-        int nextType = parserNextType(&parser);
-        checkParserError();
+        ssize_t size = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (size < 0 && errno == EINTR) {
+            continue;
+        } else if (size < 0) {
+            fprintf(stderr, "Cannot read input\n");
+            exit_and_clean(ERROR_EXIT_CODE);
+        } else if (size == 0) {
+            break;
+        }
 
-        readOperation(nextType);
+        pollReplication();
+        checkParserStatus(streamParserFeed(&parser, buffer, (size_t) size,
+                                           handleOperation, NULL));
     }
 
+    checkParserStatus(streamParserFinish(&parser, handleOperation, NULL));
+    exit_and_clean(SUCCESS_EXIT_CODE);
+
     return 0;
 }
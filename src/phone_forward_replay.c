@@ -0,0 +1,390 @@
+/** @file
+ * Program odtwarzający ślad wykonania zapisany opcją --trace.
+ * Wykonuje operacje ze śladu na nowych bazach przekierowań, mierzy czas
+ * wykonania każdej z nich i wypisuje przepustowość oraz percentyle
+ * opóźnień dla każdego rodzaju operacji, obok mediany zapisanej w śladzie.
+ * Wyniki operacji nie są wypisywane, a jedynie liczone; operacje, których
+ * rozmiar wyniku różni się od zapisanego, są zliczane jako rozbieżne.
+ * Operacja SAVE jest pomijana.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "phone_bases_system.h"
+#include "operation.h"
+#include "trace.h"
+
+/**
+ * @brief Kod błędu zwracany przez program.
+ */
+#define ERROR_EXIT_CODE 1
+
+/**
+ * @brief Kod zwracany przez program w przypadku braku błędów.
+ */
+#define SUCCESS_EXIT_CODE 0
+
+/**
+ * @brief Początkowy rozmiar tablicy czasów wykonania.
+ */
+#define REPLAY_INITIAL_CAPACITY 64
+
+/**
+ * @brief Liczba nanosekund w sekundzie.
+ */
+#define NANOSECONDS_PER_SECOND 1000000000.0
+
+/**
+ * @brief Czasy wykonania operacji jednego rodzaju.
+ */
+struct ReplayStats {
+    /**
+     * @brief Czasy wykonania podczas odtwarzania.
+     */
+    uint64_t *replayed;
+
+    /**
+     * @brief Czasy wykonania zapisane w śladzie.
+     */
+    uint64_t *recorded;
+
+    /**
+     * @brief Liczba operacji.
+     */
+    size_t count;
+
+    /**
+     * @brief Rozmiar tablic @p replayed i @p recorded.
+     */
+    size_t capacity;
+
+    /**
+     * @brief Liczba operacji o rozmiarze wyniku innym niż zapisany.
+     */
+    size_t mismatches;
+};
+
+/**
+ * @brief Wskaźnik na strukturę przechowującą bazy przekierowań.
+ */
+static PhoneBases bases = NULL;
+
+/**
+ * @brief Wskaźnik na aktualnie aktywną bazę przekierowań.
+ * NULL w przypadku braku.
+ */
+static struct PhoneForward *currentBase = NULL;
+
+/**
+ * @brief Statystyki kolejnych rodzajów operacji.
+ */
+static struct ReplayStats stats[OPERATION_TYPES_NUMBER];
+
+/**
+ * @brief Statystyki wszystkich operacji łącznie.
+ */
+static struct ReplayStats total;
+
+/**
+ * @brief Dodaje czasy wykonania operacji do statystyk.
+ * @param[in, out] s - wskaźnik na statystyki.
+ * @param[in] replayed - czas wykonania podczas odtwarzania.
+ * @param[in] recorded - czas wykonania zapisany w śladzie.
+ * @param[in] mismatch - czy rozmiar wyniku różni się od zapisanego.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replayStatsAdd(struct ReplayStats *s, uint64_t replayed,
+                           uint64_t recorded, bool mismatch) {
+    if (s->count == s->capacity) {
+        size_t capacity = s->capacity == 0
+                          ? REPLAY_INITIAL_CAPACITY : 2 * s->capacity;
+        uint64_t *newReplayed = realloc(s->replayed,
+                                        capacity * sizeof(uint64_t));
+        if (newReplayed == NULL) {
+            return false;
+        }
+        s->replayed = newReplayed;
+        uint64_t *newRecorded = realloc(s->recorded,
+                                        capacity * sizeof(uint64_t));
+        if (newRecorded == NULL) {
+            return false;
+        }
+        s->recorded = newRecorded;
+        s->capacity = capacity;
+    }
+
+    s->replayed[s->count] = replayed;
+    s->recorded[s->count] = recorded;
+    s->count++;
+    if (mismatch) {
+        s->mismatches++;
+    }
+    return true;
+}
+
+/**
+ * @brief Porównuje czasy wykonania.
+ * @param[in] a - wskaźnik na pierwszy czas.
+ * @param[in] b - wskaźnik na drugi czas.
+ * @return Liczba ujemna, zero lub dodatnia, gdy pierwszy czas jest
+ *         odpowiednio mniejszy, równy lub większy od drugiego.
+ */
+static int replayCompareDurations(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @param[in] sorted - posortowane czasy.
+ * @param[in] count - liczba czasów (dodatnia).
+ * @param[in] percent - numer percentyla.
+ * @return Percentyl @p percent metodą najbliższej pozycji.
+ */
+static uint64_t replayPercentile(const uint64_t *sorted, size_t count,
+                                 size_t percent) {
+    size_t rank = (count * percent + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+/**
+ * @brief Wypisuje wiersz raportu dla statystyk i zwalnia ich pamięć.
+ * @param[in] name - nazwa wiersza.
+ * @param[in, out] s - wskaźnik na statystyki.
+ */
+static void replayStatsReport(const char *name, struct ReplayStats *s) {
+    if (s->count > 0) {
+        qsort(s->replayed, s->count, sizeof(uint64_t), replayCompareDurations);
+        qsort(s->recorded, s->count, sizeof(uint64_t), replayCompareDurations);
+
+        uint64_t sum = 0;
+        size_t i;
+        for (i = 0; i < s->count; i++) {
+            sum += s->replayed[i];
+        }
+
+        fprintf(stdout, "%-18s %10zu %10.0f %10llu %10llu %10llu %10llu "
+                        "%12llu %10zu\n",
+                name, s->count, (double) sum / (double) s->count,
+                (unsigned long long) replayPercentile(s->replayed, s->count, 50),
+                (unsigned long long) replayPercentile(s->replayed, s->count, 90),
+                (unsigned long long) replayPercentile(s->replayed, s->count, 99),
+                (unsigned long long) s->replayed[s->count - 1],
+                (unsigned long long) replayPercentile(s->recorded, s->count, 50),
+                s->mismatches);
+    }
+
+    free(s->replayed);
+    free(s->recorded);
+    s->replayed = NULL;
+    s->recorded = NULL;
+}
+
+/**
+ * @brief Zlicza numery.
+ * @param[in] numbers - struktura przechowująca numery lub NULL.
+ * @return Liczba numerów w @p numbers, 0 gdy @p numbers ma wartość NULL.
+ */
+static size_t replayCountNumbers(const struct PhoneNumbers *numbers) {
+    size_t howMany = phnumSize(numbers);
+    phnumDelete(numbers);
+    return howMany;
+}
+
+/**
+ * @brief Zlicza cele przekierowań.
+ * @see phfwdForEachTopTarget
+ * @param[in] target - nieużywane.
+ * @param[in] count - nieużywane.
+ * @param[in, out] data - wskaźnik na licznik.
+ * @return true
+ */
+static bool replayCountTarget(const char *target, size_t count, void *data) {
+    (void) target;
+    (void) count;
+    (*(size_t *) data)++;
+    return true;
+}
+
+/**
+ * @brief Wykonuje operację TOP.
+ * @param[in] arg - liczba wypisywanych celów zapisana cyframi dziesiętnymi.
+ * @return Liczba wierszy, które wypisałby program.
+ */
+static size_t replayTop(const char *arg) {
+    size_t k = 0, lines = 0;
+    for (; *arg != '\0'; arg++) {
+        if (!isdigit((unsigned char) *arg)) {
+            return 0;
+        }
+        size_t digit = (size_t) (*arg - '0');
+        k = k > (SIZE_MAX - digit) / 10 ? SIZE_MAX : k * 10 + digit;
+    }
+    phfwdForEachTopTarget(currentBase, k, replayCountTarget, &lines);
+    return lines;
+}
+
+/**
+ * @brief Wykonuje operację tak jak phone_forward, zliczając wypisywane
+ * wiersze zamiast je wypisywać.
+ * Operacje niewykonalne (np. bez wybranej bazy) są pomijane.
+ * @param[in] op - wskaźnik na wykonywaną operację.
+ * @return Liczba wierszy, które wypisałby program.
+ */
+static size_t replayExecute(const struct Operation *op) {
+    const char *arg1 = vectorBegin(op->arg1);
+    if (op->type == OPERATION_NEW) {
+        currentBase = phoneBasesAddBase(bases, arg1);
+        return 0;
+    } else if (op->type == OPERATION_DELETE_BASE) {
+        if (phoneBasesGetBase(bases, arg1) == currentBase) {
+            currentBase = NULL;
+        }
+        phoneBasesDelBase(bases, arg1);
+        return 0;
+    } else if (currentBase == NULL) {
+        return 0;
+    }
+
+    size_t len;
+    struct PhoneForwardExplain explain;
+    switch (op->type) {
+        case OPERATION_DELETE_NUMBER:
+            phfwdRemove(currentBase, arg1);
+            return 0;
+        case OPERATION_REVERSE:
+            return replayCountNumbers(phfwdReverse(currentBase, arg1));
+        case OPERATION_NONTRIVIAL:
+            len = strlen(arg1);
+            phfwdNonTrivialCount(currentBase, arg1, len <= 12 ? 0 : len - 12);
+            return 1;
+        case OPERATION_GET:
+            return replayCountNumbers(phfwdGet(currentBase, arg1));
+        case OPERATION_REDIRECT:
+            phfwdAdd(currentBase, arg1, vectorBegin(op->arg2));
+            return 0;
+        case OPERATION_TOP:
+            return replayTop(arg1);
+        case OPERATION_EXPLAIN_GET:
+            return replayCountNumbers(phfwdExplainGet(currentBase, arg1,
+                                                      &explain)) + 1;
+        case OPERATION_EXPLAIN_REVERSE:
+            return replayCountNumbers(phfwdExplainReverse(currentBase, arg1,
+                                                          &explain)) + 1;
+        case OPERATION_EXPLAIN_NONTRIVIAL:
+            len = strlen(arg1);
+            phfwdExplainNonTrivialCount(currentBase, arg1,
+                                        len <= 12 ? 0 : len - 12, &explain);
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Odtwarza ślad i wypisuje raport.
+ * @param[in] path - ścieżka pliku śladu.
+ * @return Kod zakończenia programu.
+ */
+static int replay(const char *path) {
+    FILE *in = fopen(path, "rb");
+    if (in == NULL || !traceReadHeader(in)) {
+        fprintf(stderr, "Cannot replay %s\n", path);
+        if (in != NULL) {
+            fclose(in);
+        }
+        return ERROR_EXIT_CODE;
+    }
+
+    struct Operation op = {OPERATION_NONE, NULL, NULL, 0, 0};
+    bases = phoneBasesCreateNewPhoneBases();
+    if (bases == NULL || !operationInit(&op)) {
+        fprintf(stderr, "Out of memory\n");
+        fclose(in);
+        if (bases != NULL) {
+            phoneBasesDestroyPhoneBases(bases);
+        }
+        return ERROR_EXIT_CODE;
+    }
+
+    int result = TRACE_END;
+    bool memory = true;
+    size_t endPos = 0;
+    struct TraceRecord record;
+    uint64_t elapsed = 0;
+    while (memory && (result = traceReadRecord(in, &op, &record, &endPos))
+                     == TRACE_RECORD) {
+        if (op.type == OPERATION_SAVE) {
+            continue;
+        }
+        uint64_t start = traceClock();
+        size_t lines = replayExecute(&op);
+        uint64_t duration = traceClock() - start;
+        elapsed += duration;
+
+        bool mismatch = lines != record.resultSize;
+        memory = replayStatsAdd(&stats[op.type], duration, record.duration,
+                                mismatch)
+                 && replayStatsAdd(&total, duration, record.duration,
+                                   mismatch);
+    }
+    fclose(in);
+    operationDestroy(&op);
+    phoneBasesDestroyPhoneBases(bases);
+
+    if (!memory || result == TRACE_MEMORY_ERROR) {
+        fprintf(stderr, "Out of memory\n");
+    } else if (result == TRACE_MALFORMED) {
+        fprintf(stderr, "Malformed trace %s\n", path);
+    } else {
+        fprintf(stdout, "operations %zu\n", total.count);
+        fprintf(stdout, "elapsed_ns %llu\n", (unsigned long long) elapsed);
+        fprintf(stdout, "throughput_ops_per_s %.0f\n",
+                elapsed == 0 ? 0.0 : (double) total.count
+                                     * NANOSECONDS_PER_SECOND
+                                     / (double) elapsed);
+        fprintf(stdout, "%-18s %10s %10s %10s %10s %10s %10s %12s %10s\n",
+                "operation", "count", "mean_ns", "p50_ns", "p90_ns", "p99_ns",
+                "max_ns", "recorded_p50", "mismatches");
+    }
+
+    int i;
+    for (i = 0; i < OPERATION_TYPES_NUMBER; i++) {
+        if (memory && result == TRACE_END) {
+            replayStatsReport(operationName(i), &stats[i]);
+        } else {
+            free(stats[i].replayed);
+            free(stats[i].recorded);
+        }
+    }
+    if (memory && result == TRACE_END) {
+        replayStatsReport("ALL", &total);
+        return total.mismatches == 0 ? SUCCESS_EXIT_CODE : ERROR_EXIT_CODE;
+    }
+    free(total.replayed);
+    free(total.recorded);
+    return ERROR_EXIT_CODE;
+}
+
+/**
+ * @brief Odtwarza ślad wskazany w argumencie.
+ * @param[in] argc - liczba argumentów.
+ * @param[in] argv - argumenty.
+ * @return Kod zakończenia programu: ERROR_EXIT_CODE, jeżeli ślad jest
+ *         niepoprawny lub wynik którejś operacji różni się od zapisanego.
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <trace>\n", argv[0]);
+        return ERROR_EXIT_CODE;
+    }
+    return replay(argv[1]);
+}
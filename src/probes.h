@@ -0,0 +1,69 @@
+/** @file
+ * Statyczne punkty śledzenia (USDT) dostawcy telefony.
+ * Jeżeli przy kompilacji dostępny jest nagłówek sys/sdt.h
+ * (zdefiniowane HAVE_SYS_SDT_H), punkty są znacznikami sys/sdt.h,
+ * które nic nie kosztują, dopóki nie podłączy się do nich narzędzie
+ * śledzące (np. bpftrace -e 'usdt:./phone_forward:telefony:get__entry').
+ * W przeciwnym przypadku makra nie generują kodu, a ich argumenty nie są
+ * obliczane.
+ * Nazwy punktów z sufiksem __entry i __return oznaczają wejście
+ * i wyjście z funkcji (w narzędziach śledzących __ jest zamieniane na -).
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_PROBES_H
+#define TELEFONY_PROBES_H
+
+#ifdef HAVE_SYS_SDT_H
+
+#include <sys/sdt.h>
+
+/**
+ * @brief Punkt śledzenia bez argumentów.
+ */
+#define PROBE0(name) DTRACE_PROBE(telefony, name)
+
+/**
+ * @brief Punkt śledzenia z jednym argumentem.
+ */
+#define PROBE1(name, a) DTRACE_PROBE1(telefony, name, a)
+
+/**
+ * @brief Punkt śledzenia z dwoma argumentami.
+ */
+#define PROBE2(name, a, b) DTRACE_PROBE2(telefony, name, a, b)
+
+/**
+ * @brief Punkt śledzenia z trzema argumentami.
+ */
+#define PROBE3(name, a, b, c) DTRACE_PROBE3(telefony, name, a, b, c)
+
+#else
+
+/**
+ * @brief Punkt śledzenia bez argumentów.
+ */
+#define PROBE0(name) do {} while (0)
+
+/**
+ * @brief Punkt śledzenia z jednym argumentem.
+ */
+#define PROBE1(name, a) do { (void) sizeof(a); } while (0)
+
+/**
+ * @brief Punkt śledzenia z dwoma argumentami.
+ */
+#define PROBE2(name, a, b) do { (void) sizeof(a); (void) sizeof(b); } while (0)
+
+/**
+ * @brief Punkt śledzenia z trzema argumentami.
+ */
+#define PROBE3(name, a, b, c) \
+    do { (void) sizeof(a); (void) sizeof(b); (void) sizeof(c); } while (0)
+
+#endif
+
+#endif //TELEFONY_PROBES_H
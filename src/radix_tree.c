@@ -12,9 +12,11 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdio.h>
+#include <stdint.h>
 #include "radix_tree.h"
 #include "text.h"
 #include "stdfunc.h"
+#include "probes.h"
 
 /**
  * @brief Kod operacji zakończonej sukcesem.
@@ -26,6 +28,18 @@
  */
 #define RADIX_TREE_OPERATION_FAIL 0
 
+/**
+ * @brief Znacznik węzła, którego poddrzewo zmieniło się od ostatniego
+ * wywołania @ref radixTreeClearDirty.
+ */
+#define RADIX_TREE_DIRTY_NODE 1
+
+/**
+ * @brief Znacznik węzła, w którego poddrzewie znajduje się węzeł
+ * oznaczony RADIX_TREE_DIRTY_NODE.
+ */
+#define RADIX_TREE_DIRTY_PATH 2
+
 /**
  * @brief Struktura reprezentująca węzeł drzewa.
  */
@@ -60,6 +74,38 @@ struct RadixTreeNode {
      */
     size_t helper;
 
+    /**
+     * @brief Znaczniki zmian (RADIX_TREE_DIRTY_NODE, RADIX_TREE_DIRTY_PATH).
+     * Jeżeli węzeł ma ustawiony którykolwiek znacznik, to wszyscy jego
+     * przodkowie poza korzeniem mają ustawiony znacznik
+     * RADIX_TREE_DIRTY_PATH. Znacznik korzenia nie jest ustawiany przy
+     * oznaczaniu zmian, dzięki czemu wstawianie do różnych poddrzew korzenia
+     * nie zapisuje wspólnej pamięci.
+     * @see radixTreeFoldDirty
+     */
+    unsigned char dirty;
+
+    /**
+     * @brief Numer syna korzenia, w którego poddrzewie leży węzeł.
+     * Nie zmienia się przez cały czas życia węzła.
+     * @see RadixTreeNode->epochs
+     */
+    unsigned char top;
+
+    /**
+     * @brief Waga węzła ustalana przez użytkownika drzewa.
+     * @see radixTreePathWeight
+     */
+    size_t weight;
+
+    /**
+     * @brief Liczba węzłów z danymi w poddrzewie węzła (łącznie z nim).
+     * Wartość korzenia nie jest utrzymywana, z tego samego powodu co jego
+     * znacznik zmian.
+     * @see radixTreeCountData
+     */
+    size_t dataCount;
+
     /**
      * @brief Synowie węzła w drzewie.
      * @see RADIX_TREE_NUMBER_OF_SONS
@@ -70,11 +116,44 @@ struct RadixTreeNode {
      * @brief Ojciec węzła w drzewie.
      */
     RadixTreeNode father;
+
+    /**
+     * @brief Zapamiętany najbliższy przodek węzła (bez korzenia) z danymi
+     * lub NULL.
+     * Aktualny tylko wtedy, gdy @p epoch jest równe licznikowi epochs[top]
+     * korzenia.
+     * @see radixTreeDataFather
+     */
+    RadixTreeNode dataFather;
+
+    /**
+     * @brief Wartość licznika epochs[top] korzenia z chwili zapamiętania
+     * @p dataFather, 0 jeżeli nic nie zapamiętano.
+     */
+    size_t epoch;
+
+    /**
+     * @brief Długość tekstu reprezentowanego przez węzeł (bez tekstu
+     * korzenia).
+     * @see radixTreeTextLength
+     */
+    size_t depth;
+
+    /**
+     * @brief Liczniki zmian poddrzew korzenia (tylko w korzeniu).
+     * Licznik poddrzewa syna korzenia jest zwiększany przy każdym
+     * przypisaniu danych węzłowi bez danych i usunięciu danych z węzła
+     * tego poddrzewa, co unieważnia zapamiętane w nim RadixTreeNode->dataFather.
+     * Zmiany w jednym poddrzewie nie zapisują liczników pozostałych, więc
+     * poddrzewa mogą być zmieniane równolegle. Usunięcie poddrzewa nie zmienia
+     * licznika, bo zapamiętane wskaźniki na usuwane węzły mają jedynie ich
+     * potomkowie.
+     */
+    size_t epochs[];
 };
 
 int radixTreeIsRoot(RadixTreeNode node) {
-    return node->txt != NULL
-           && charSequenceEqualToString(node->txt, RADIX_TREE_ROOT_TXT);
+    return node->father == NULL;
 }
 
 /**
@@ -87,8 +166,15 @@ static void radixTreeInitNode(RadixTreeNode node) {
     node->data = NULL;
     node->txt = NULL;
     node->txtLength = 0;
+    node->dirty = 0;
+    node->top = 0;
+    node->weight = 0;
+    node->dataCount = 0;
 
     node->father = NULL;
+    node->dataFather = NULL;
+    node->epoch = 0;
+    node->depth = 0;
 
     size_t i;
     for (i = 0; i < RADIX_TREE_NUMBER_OF_SONS; i++) {
@@ -124,6 +210,10 @@ static void radixTreeFreeNode(RadixTreeNode node) {
  */
 static int radixTreeInitTree(RadixTree tree) {
     radixTreeInitNode(tree);
+    size_t i;
+    for (i = 0; i < RADIX_TREE_NUMBER_OF_SONS; i++) {
+        tree->epochs[i] = 1;
+    }
     tree->txt = charSequenceFromCString(RADIX_TREE_ROOT_TXT);
 
     if (tree->txt == NULL) {
@@ -152,7 +242,8 @@ static RadixTreeNode radixTreeCreateNode() {
 }
 
 RadixTree radixTreeCreate() {
-    RadixTree result = malloc(sizeof(struct RadixTreeNode));
+    RadixTree result = malloc(sizeof(struct RadixTreeNode)
+                              + RADIX_TREE_NUMBER_OF_SONS * sizeof(size_t));
     if (result == NULL) {
         return NULL;
     } else {
@@ -258,6 +349,44 @@ static void radixTreeChangeSon(RadixTreeNode node, char son,
     }
 }
 
+/**
+ * @brief Oznacza poddrzewo węzła @p node jako zmienione.
+ * Ustawia znacznik RADIX_TREE_DIRTY_NODE węzła @p node oraz
+ * znacznik RADIX_TREE_DIRTY_PATH jego przodków poza korzeniem.
+ * #### Złożoność
+ * Zamortyzowana O(1) - przechodzenie w górę kończy się na pierwszym
+ * oznaczonym już przodku.
+ * @param[in, out] node - wskaźnik na węzeł.
+ */
+static void radixTreeMarkDirty(RadixTreeNode node) {
+    node->dirty |= RADIX_TREE_DIRTY_NODE;
+    RadixTreeNode pos = node->father;
+    while (pos != NULL && pos->father != NULL
+           && !(pos->dirty & RADIX_TREE_DIRTY_PATH)) {
+        pos->dirty |= RADIX_TREE_DIRTY_PATH;
+        pos = pos->father;
+    }
+}
+
+/**
+ * @brief Dodaje @p delta do liczników węzłów z danymi.
+ * Zmienia RadixTreeNode->dataCount węzła @p node i jego przodków poza
+ * korzeniem.
+ * #### Złożoność
+ * Proporcjonalna do głębokości węzła.
+ * @param[in, out] node - wskaźnik na węzeł.
+ * @param[in] delta - zmiana licznika (modulo 2^bity size_t).
+ * @return Korzeń drzewa węzła @p node lub NULL, jeżeli @p node nie ma ojca.
+ */
+static RadixTree radixTreeAddDataCount(RadixTreeNode node, size_t delta) {
+    RadixTreeNode pos = node;
+    while (pos != NULL && pos->father != NULL) {
+        pos->dataCount += delta;
+        pos = pos->father;
+    }
+    return pos != node ? pos : NULL;
+}
+
 /**
  * @brief Przesuwa dopasowanie w ramach węzła.
  * Po wykonaniu się procedury wartość wkaźnika @p *txt oznacza, że
@@ -316,17 +445,29 @@ static int radixTreeMoveTxt(RadixTreeNode node, const char **txt,
  *        dopasowania na '\0'.
  * @param[out] nodeTxtPtr - podobnie do @p txt tylko dotyczy dopasowania
  *        w ramach węzła.
+ * @param[in, out] stats - wskaźnik na licznik kosztu przejścia lub NULL.
  * @return RADIX_TREE_OPERATION_FAIL w przypadku niemożności dalszego
  *         dopasowania, RADIX_TREE_OPERATION_SUCCESS w przeciwnym przypadku.
  */
 static int radixTreeMove(RadixTreeNode *node, const char **txt,
-                         CharSequenceIterator *nodeTxtPtr) {
+                         CharSequenceIterator *nodeTxtPtr,
+                         struct RadixTreeStats *stats) {
     assert(*(*txt) != '\0');
     if (!radixTreeHasSon(*node, *(*txt))) {
         return RADIX_TREE_OPERATION_FAIL;
     } else {
         radixTreeMoveToSon(node, *(*txt));
-        return radixTreeMoveTxt(*node, txt, nodeTxtPtr);
+        const char *start = *txt;
+        int result = radixTreeMoveTxt(*node, txt, nodeTxtPtr);
+        if (stats != NULL) {
+            stats->nodes++;
+            stats->chars += (size_t) (*txt - start);
+            if (result != RADIX_TREE_OPERATION_SUCCESS && **txt != '\0') {
+                stats->chars++;
+            }
+            stats->blocks += charSequenceBlocksTo((*node)->txt, nodeTxtPtr);
+        }
+        return result;
     }
 
 }
@@ -343,6 +484,7 @@ static int radixTreeMove(RadixTreeNode *node, const char **txt,
  * @param[out] nodeMatchPtr - wskaźnik iterator dopasowania krawędzi wchodzącej
  *       do
  *       @p *ptr.
+ * @param[in, out] stats - wskaźnik na licznik kosztu przejścia lub NULL.
  * @return W przypadku gdy węzeł reprezentujący @p txt istnieje w drzewie
  *         RADIX_TREE_FOUND, w przypadku gdy @p txt jest podciągiem
  *         tekstu reprezentowanego przez któryś z węzłów RADIX_TREE_SUBSTR,
@@ -352,13 +494,17 @@ static int radixTreeFindEx(RadixTree tree,
                            const char *txt,
                            RadixTreeNode *ptr,
                            const char **txtMatchPtr,
-                           CharSequenceIterator *nodeMatchPtr) {
+                           CharSequenceIterator *nodeMatchPtr,
+                           struct RadixTreeStats *stats) {
     *ptr = tree;
     *txtMatchPtr = txt;
     *nodeMatchPtr = charSequenceSequenceEnd((*ptr)->txt);
+    if (stats != NULL) {
+        stats->nodes++;
+    }
 
     while (*(*txtMatchPtr) != '\0'
-           && radixTreeMove(ptr, txtMatchPtr, nodeMatchPtr)
+           && radixTreeMove(ptr, txtMatchPtr, nodeMatchPtr, stats)
               == RADIX_TREE_OPERATION_SUCCESS);
 
     if (charSequenceGetChar((nodeMatchPtr)) == '\0'
@@ -391,8 +537,16 @@ static size_t radixTreeHowManyCharsOffset(RadixTreeNode node,
 int radixTreeFind(RadixTree tree, const char *txt, RadixTreeNode *ptr,
                   const char **txtMatchPtr, size_t *nodeMatch,
                   int *nodeMatchMode) {
+    return radixTreeFindCounted(tree, txt, ptr, txtMatchPtr, nodeMatch,
+                                nodeMatchMode, NULL);
+}
+
+int radixTreeFindCounted(RadixTree tree, const char *txt, RadixTreeNode *ptr,
+                         const char **txtMatchPtr, size_t *nodeMatch,
+                         int *nodeMatchMode, struct RadixTreeStats *stats) {
     CharSequenceIterator nodeMatchPtr;
-    int result = radixTreeFindEx(tree, txt, ptr, txtMatchPtr, &nodeMatchPtr);
+    int result = radixTreeFindEx(tree, txt, ptr, txtMatchPtr, &nodeMatchPtr,
+                                 stats);
 
     if (charSequenceGetChar(&nodeMatchPtr) == '\0') {
         assert((*ptr)->txtLength == charSequenceLength((*ptr)->txt));
@@ -439,6 +593,10 @@ static int radixTreeSplitNode(RadixTreeNode node, CharSequenceIterator *splitPtr
         assert(charSequenceLength(newNode->txt) == newNode->txtLength);
 
         newNode->father = node->father;
+        newNode->top = node->top;
+        newNode->dataFather = node->dataFather;
+        newNode->epoch = node->epoch;
+        newNode->depth = node->depth - node->txtLength;
         CharSequenceIterator it = charSequenceGetIterator(newNode->txt);
         radixTreeChangeSon(node->father, charSequenceGetChar(&it),
                            newNode);
@@ -446,6 +604,12 @@ static int radixTreeSplitNode(RadixTreeNode node, CharSequenceIterator *splitPtr
         node->father = newNode;
         it = charSequenceGetIterator(node->txt);
         radixTreeChangeSon(newNode, charSequenceGetChar(&it), node);
+        newNode->dataCount = node->dataCount;
+
+        if (node->dirty != 0) {
+            newNode->dirty = RADIX_TREE_DIRTY_PATH;
+        }
+        PROBE3(split, newNode->txtLength, node->txtLength, node->dataCount);
         return RADIX_TREE_OPERATION_SUCCESS;
 
     }
@@ -472,7 +636,13 @@ static RadixTreeNode radixTreeInsertLeaf(RadixTreeNode node, const char *txt) {
             newNode->txtLength = charSequenceLength(textToInsert);
 
             newNode->father = node;
+            newNode->depth = node->depth + newNode->txtLength;
             CharSequenceIterator it = charSequenceGetIterator(newNode->txt);
+            newNode->top = radixTreeIsRoot(node)
+                           ? (unsigned char) radixTreeConvertCharToNumber(
+                                   charSequenceGetChar(&it))
+                           : node->top;
+            it = charSequenceGetIterator(newNode->txt);
             assert(!radixTreeHasSon(node, charSequenceGetChar(&it)));
             radixTreeChangeSon(node, charSequenceGetChar(&it),
                                newNode);
@@ -487,13 +657,15 @@ RadixTreeNode radixTreeInsert(RadixTree tree, const char *txt) {
     const char *matchPtr;
     CharSequenceIterator nodeMatchPtr;
     int findResult = radixTreeFindEx(tree, txt, &insertPtr,
-                                     &matchPtr, &nodeMatchPtr);
+                                     &matchPtr, &nodeMatchPtr, NULL);
 
     if (findResult == RADIX_TREE_FOUND) {
+        radixTreeMarkDirty(insertPtr);
         return insertPtr;
     } else if (findResult == RADIX_TREE_SUBSTR) {
         int splitResult = radixTreeSplitNode(insertPtr, &nodeMatchPtr);
         if (splitResult == RADIX_TREE_OPERATION_SUCCESS) {
+            radixTreeMarkDirty(insertPtr->father);
             return insertPtr->father;
         } else {
             return NULL;
@@ -502,12 +674,23 @@ RadixTreeNode radixTreeInsert(RadixTree tree, const char *txt) {
         if (charSequenceGetChar(&nodeMatchPtr) != '\0') {
             int splitResult = radixTreeSplitNode(insertPtr, &nodeMatchPtr);
             if (splitResult == RADIX_TREE_OPERATION_SUCCESS) {
-                return radixTreeInsert(tree, txt);
+                RadixTreeNode leaf = radixTreeInsertLeaf(insertPtr->father,
+                                                         matchPtr);
+                if (leaf != NULL) {
+                    radixTreeMarkDirty(leaf);
+                } else {
+                    radixTreeBalance(insertPtr->father);
+                }
+                return leaf;
             } else {
                 return NULL;
             }
         } else {
-            return radixTreeInsertLeaf(insertPtr, matchPtr);
+            RadixTreeNode leaf = radixTreeInsertLeaf(insertPtr, matchPtr);
+            if (leaf != NULL) {
+                radixTreeMarkDirty(leaf);
+            }
+            return leaf;
         }
     } else {
         return NULL;
@@ -548,6 +731,8 @@ void radixTreeDeleteSubTree(RadixTreeNode subTreeNode,
         subTreeNode->data = NULL;
     }
     if (!radixTreeIsRoot(subTreeNode)) {
+        radixTreeAddDataCount(subTreeNode->father,
+                              (size_t) 0 - subTreeNode->dataCount);
         CharSequenceIterator it = charSequenceGetIterator(subTreeNode->txt);
         radixTreeChangeSon(subTreeNode->father,
                            charSequenceGetChar(&it), NULL);
@@ -588,6 +773,55 @@ static RadixTreeNode radixTreeFirstSon(RadixTreeNode node) {
     return NULL;
 }
 
+/**
+ * @brief Następny węzeł w porządku leksykograficznym spoza poddrzewa
+ * węzła @p node.
+ * @param[in] tree - wskaźnik na drzewo (poddrzewo).
+ * @param[in] node - wskaźnik na węzeł drzewa @p tree.
+ * @return Następny węzeł drzewa @p tree spoza poddrzewa @p node lub NULL,
+ *         jeżeli takiego nie ma.
+ */
+static RadixTreeNode radixTreeNextNodeAfterSubTree(RadixTree tree,
+                                                   RadixTreeNode node) {
+    size_t i;
+    while (node != tree) {
+        RadixTreeNode father = node->father;
+        CharSequenceIterator it = charSequenceGetIterator(node->txt);
+        for (i = radixTreeConvertCharToNumber(charSequenceGetChar(&it)) + 1;
+             i < RADIX_TREE_NUMBER_OF_SONS; i++) {
+            if (father->sons[i] != NULL) {
+                return father->sons[i];
+            }
+        }
+        node = father;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Następny węzeł w porządku leksykograficznym.
+ * @param[in] tree - wskaźnik na drzewo (poddrzewo).
+ * @param[in] node - wskaźnik na węzeł drzewa @p tree.
+ * @return Następny węzeł drzewa @p tree lub NULL, jeżeli @p node jest
+ *         ostatni.
+ */
+static RadixTreeNode radixTreeNextNode(RadixTree tree, RadixTreeNode node) {
+    RadixTreeNode son = radixTreeFirstSon(node);
+    return son != NULL ? son : radixTreeNextNodeAfterSubTree(tree, node);
+}
+
+RadixTreeNode radixTreeNextData(RadixTree tree, RadixTreeNode node) {
+    if (node == NULL) {
+        node = tree;
+    } else {
+        node = radixTreeNextNode(tree, node);
+    }
+    while (node != NULL && node->data == NULL) {
+        node = radixTreeNextNode(tree, node);
+    }
+    return node;
+}
+
 /**
  * @brief Próbuje scalić węzeł @p a z węzłem @p b.
  * @remarks Zakłada że węzeł @p a spełnia
@@ -603,6 +837,8 @@ static int radixTreeMerge(RadixTreeNode a, RadixTreeNode b) {
     assert(charSequenceLength(b->txt) != 0);
     assert(charSequenceLength((b->txt)) == b->txtLength);
     assert(charSequenceLength((a->txt)) == a->txtLength);
+    assert(a->dataCount == b->dataCount);
+    PROBE3(merge, a->txtLength, b->txtLength, b->dataCount);
 
     charSequenceMerge(a->txt, b->txt);
     b->txt = a->txt;
@@ -613,6 +849,7 @@ static int radixTreeMerge(RadixTreeNode a, RadixTreeNode b) {
     assert(charSequenceLength(b->txt) != 0);
 
     b->father = a->father;
+    b->dirty |= (a->dirty & RADIX_TREE_DIRTY_NODE);
     CharSequenceIterator it = charSequenceGetIterator(b->txt);
     radixTreeChangeSon(a->father, charSequenceGetChar(&it), b);
     radixTreeFreeNode(a);
@@ -623,34 +860,147 @@ static int radixTreeMerge(RadixTreeNode a, RadixTreeNode b) {
 
 void radixTreeBalance(RadixTreeNode node) {
     RadixTreeNode pos = node, tmp;
-    size_t skipped = 0;
-    const size_t canSkip = 5;
+    size_t removed = 0, merged = 0;
+    bool reducible = true;
+    PROBE0(balance__entry);
 
-    while (!radixTreeIsRoot(pos)
-           && skipped <= canSkip) {
+    while (!radixTreeIsRoot(pos) && reducible) {
         if (radixTreeIsNodeRedundant(pos)) {
             tmp = pos;
             pos = pos->father;
             CharSequenceIterator it = charSequenceGetIterator(tmp->txt);
             radixTreeChangeSon(pos, charSequenceGetChar(&it), NULL);
             radixTreeFreeNode(tmp);
+            removed++;
         } else if (radixTreeCanBeMergedWithSon(pos)) {
             tmp = pos;
             pos = pos->father;
             int mergeResult = radixTreeMerge(tmp, radixTreeFirstSon(tmp));
             if (mergeResult != RADIX_TREE_OPERATION_SUCCESS) {
-                skipped++;
+                reducible = false;
+            } else {
+                merged++;
             }
         } else {
-            pos = pos->father;
-            skipped++;
+            reducible = false;
         }
     }
+    PROBE2(balance__return, removed, merged);
 
 }
 
 void radixTreeSetData(RadixTreeNode node, void *ptr) {
+    RadixTree tree = NULL;
+    if (node->data == NULL && ptr != NULL) {
+        tree = radixTreeAddDataCount(node, 1);
+    } else if (node->data != NULL && ptr == NULL) {
+        tree = radixTreeAddDataCount(node, (size_t) 0 - 1);
+    }
     node->data = ptr;
+    if (tree != NULL) {
+        tree->epochs[node->top]++;
+    }
+}
+
+RadixTreeNode radixTreeDataFather(RadixTree tree, RadixTreeNode node) {
+    return radixTreeDataFatherCounted(tree, node, NULL);
+}
+
+RadixTreeNode radixTreeDataFatherCounted(RadixTree tree, RadixTreeNode node,
+                                         struct RadixTreeStats *stats) {
+    if (radixTreeIsRoot(node)) {
+        return NULL;
+    }
+
+    size_t epoch = tree->epochs[node->top];
+    RadixTreeNode pos = node, result;
+    while (true) {
+        if (stats != NULL) {
+            stats->nodes++;
+        }
+        if (pos->epoch == epoch) {
+            result = pos->dataFather;
+            break;
+        } else if (radixTreeIsRoot(pos->father)) {
+            result = NULL;
+            break;
+        } else if (pos->father->data != NULL) {
+            result = pos->father;
+            break;
+        }
+        pos = pos->father;
+    }
+
+    while (node != pos) {
+        node->dataFather = result;
+        node->epoch = epoch;
+        node = node->father;
+    }
+    pos->dataFather = result;
+    pos->epoch = epoch;
+    return result;
+}
+
+RadixTreeNode radixTreeDataAncestor(RadixTree tree, RadixTreeNode node) {
+    return radixTreeDataAncestorCounted(tree, node, NULL);
+}
+
+RadixTreeNode radixTreeDataAncestorCounted(RadixTree tree, RadixTreeNode node,
+                                           struct RadixTreeStats *stats) {
+    if (node->data != NULL && !radixTreeIsRoot(node)) {
+        return node;
+    } else {
+        return radixTreeDataFatherCounted(tree, node, stats);
+    }
+}
+
+void radixTreeMarkChanged(RadixTreeNode node) {
+    radixTreeMarkDirty(node);
+}
+
+size_t radixTreeGetWeight(RadixTreeNode node) {
+    return node->weight;
+}
+
+void radixTreeSetWeight(RadixTreeNode node, size_t weight) {
+    node->weight = weight;
+}
+
+size_t radixTreePathWeight(RadixTree tree, const char *txt) {
+    RadixTreeNode ptr;
+    const char *matchedTxt;
+    size_t nodeMatch;
+    int matchMode;
+    radixTreeFind(tree, txt, &ptr, &matchedTxt, &nodeMatch, &matchMode);
+    if (matchMode != RADIX_TREE_NODE_MATCH_FULL) {
+        ptr = ptr->father;
+    }
+
+    size_t result = 0;
+    while (ptr != NULL) {
+        result += ptr->weight;
+        ptr = ptr->father;
+    }
+    return result;
+}
+
+size_t radixTreeCountData(RadixTree tree, const char *txt) {
+    RadixTreeNode ptr;
+    int findResult = radixTreeFindLite(tree, txt, &ptr);
+    if (findResult == RADIX_TREE_NOT_FOUND) {
+        return 0;
+    } else if (ptr->father != NULL) {
+        return ptr->dataCount;
+    } else {
+        size_t result = ptr->data != NULL;
+        size_t i;
+        for (i = 0; i < RADIX_TREE_NUMBER_OF_SONS; i++) {
+            if (ptr->sons[i] != NULL) {
+                result += ptr->sons[i]->dataCount;
+            }
+        }
+        return result;
+    }
 }
 
 int radixTreeFindLite(RadixTree tree, const char *txt, RadixTreeNode *ptr) {
@@ -660,37 +1010,44 @@ int radixTreeFindLite(RadixTree tree, const char *txt, RadixTreeNode *ptr) {
     return radixTreeFind(tree, txt, ptr, &unused1, &unused2, &unused3);
 }
 
-char *radixGetFullText(RadixTreeNode node) {
+size_t radixTreeTextLength(RadixTreeNode node) {
+    return node->depth;
+}
+
+void radixTreeWriteText(RadixTreeNode node, size_t length, char *out) {
     RadixTreeNode pos = node;
-    size_t length = 0;
 
     while (!radixTreeIsRoot(pos)) {
-        length += radixTreeHowManyChars(pos);
+        assert(pos->txtLength == charSequenceLength(pos->txt));
+        size_t len = pos->txtLength;
+        size_t i;
+        length -= len;
+        CharSequenceIterator ptr = charSequenceGetIterator(pos->txt);
+        char ch;
+        for (i = 0; i < len; i++) {
+            charSequenceNextChar(&ptr, &ch);
+            out[length + i] = ch;
+        }
         pos = radixTreeFather(pos);
     }
+}
+
+char *radixGetFullText(RadixTreeNode node) {
+    return radixGetFullTextWithSuffix(node, "");
+}
 
-    char *result = malloc(length + (size_t) 1);
+char *radixGetFullTextWithSuffix(RadixTreeNode node, const char *suffix) {
+    size_t length = radixTreeTextLength(node);
+    size_t suffixLength = strlen(suffix);
+
+    char *result = malloc(length + suffixLength + (size_t) 1);
     if (result == NULL) {
         return NULL;
     } else {
-        result[length] = '\0';
-        pos = node;
-        while (!radixTreeIsRoot(pos)) {
-            assert(pos->txtLength == charSequenceLength(pos->txt));
-            size_t len = pos->txtLength;
-            size_t i;
-            length -= len;
-            CharSequenceIterator ptr = charSequenceGetIterator(pos->txt);
-            char out;
-            for (i = 0; i < len; i++) {
-                charSequenceNextChar(&ptr, &out);
-                result[length + i] = out;
-            }
-            pos = radixTreeFather(pos);
-        }
+        radixTreeWriteText(node, length, result);
+        memcpy(result + length, suffix, suffixLength + (size_t) 1);
         return result;
     }
-
 }
 
 void radixTreeFold(RadixTree tree, void (*f)(void *, void *), void *fData) {
@@ -720,6 +1077,99 @@ void radixTreeFold(RadixTree tree, void (*f)(void *, void *), void *fData) {
     }
 }
 
+void radixTreeFoldNodes(RadixTree tree, void (*f)(RadixTreeNode, void *),
+                        void *fData) {
+
+    RadixTreeNode pos = tree;
+    pos->foldI = 0;
+
+    while (!(pos == tree
+             && pos->foldI == RADIX_TREE_NUMBER_OF_SONS)) {
+        size_t *i = &pos->foldI;
+        if (*i == 0) {
+            if (pos->data != NULL) {
+                f(pos, fData);
+            }
+        }
+
+        if (*i == RADIX_TREE_NUMBER_OF_SONS) {
+            pos = pos->father;
+
+        } else {
+            if (pos->sons[*i] != NULL) {
+                pos = pos->sons[*i];
+                pos->foldI = 0;
+            }
+            (*i)++;
+        }
+    }
+}
+
+void radixTreeFoldDirty(RadixTree tree, void (*f)(RadixTreeNode, void *),
+                        void *fData) {
+    if (tree->dirty & RADIX_TREE_DIRTY_NODE) {
+        f(tree, fData);
+        return;
+    }
+
+    RadixTreeNode pos = tree;
+    pos->foldI = 0;
+
+    while (!(pos == tree
+             && pos->foldI == RADIX_TREE_NUMBER_OF_SONS)) {
+        size_t *i = &pos->foldI;
+        if (*i == 0 && (pos->dirty & RADIX_TREE_DIRTY_NODE)) {
+            f(pos, fData);
+            *i = RADIX_TREE_NUMBER_OF_SONS;
+        }
+
+        if (*i == RADIX_TREE_NUMBER_OF_SONS) {
+            pos = pos->father;
+        } else {
+            if (pos->sons[*i] != NULL && pos->sons[*i]->dirty != 0) {
+                pos = pos->sons[*i];
+                pos->foldI = 0;
+            }
+            (*i)++;
+        }
+    }
+}
+
+void radixTreeClearDirty(RadixTree tree) {
+    RadixTreeNode pos = tree;
+    pos->foldI = 0;
+
+    while (!(pos == tree
+             && pos->foldI == RADIX_TREE_NUMBER_OF_SONS)) {
+        size_t *i = &pos->foldI;
+        if (*i == RADIX_TREE_NUMBER_OF_SONS) {
+            pos->dirty = 0;
+            pos = pos->father;
+        } else {
+            if (pos->sons[*i] != NULL && pos->sons[*i]->dirty != 0) {
+                pos = pos->sons[*i];
+                pos->foldI = 0;
+            }
+            (*i)++;
+        }
+    }
+    tree->dirty = 0;
+}
+
+bool radixTreeIsDirty(RadixTree tree) {
+    if (tree->dirty != 0) {
+        return true;
+    }
+
+    size_t i;
+    for (i = 0; i < RADIX_TREE_NUMBER_OF_SONS; i++) {
+        if (tree->sons[i] != NULL && tree->sons[i]->dirty != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void radixTreeCountDataFunction(void *ptrA, void *ptrB) {
     size_t *counter = (size_t *) ptrB;
     if (ptrA != NULL) {
@@ -770,8 +1220,21 @@ static bool radixTreeNonTrivialCountCheck(CharSequence seq,
 size_t radixTreeNonTrivialCount(RadixTree tree, size_t maxLen,
                                 const bool *availableDigits,
                                 size_t howManyDigitsAvailable) {
+    size_t result;
+    radixTreeNonTrivialCountLimited(tree, maxLen, availableDigits,
+                                    howManyDigitsAvailable, SIZE_MAX, &result,
+                                    NULL);
+    return result;
+}
+
+bool radixTreeNonTrivialCountLimited(RadixTree tree, size_t maxLen,
+                                     const bool *availableDigits,
+                                     size_t howManyDigitsAvailable,
+                                     size_t visitLimit, size_t *out,
+                                     struct RadixTreeStats *stats) {
 
     assert(maxLen != 0);
+    size_t visits = 0;
     size_t result = 0;
     size_t len = 0;
     RadixTreeNode pos = tree;
@@ -798,6 +1261,11 @@ size_t radixTreeNonTrivialCount(RadixTree tree, size_t maxLen,
 
             len += pos->helper;
             assert(len <= maxLen);
+            if (stats != NULL) {
+                CharSequenceIterator end = charSequenceSequenceEnd(pos->txt);
+                stats->chars += pos->helper;
+                stats->blocks += charSequenceBlocksTo(pos->txt, &end);
+            }
             if (isGreater
                 || !radixTreeNonTrivialCountCheck(pos->txt, availableDigits)) {
                 *i = RADIX_TREE_NUMBER_OF_SONS;
@@ -820,6 +1288,10 @@ size_t radixTreeNonTrivialCount(RadixTree tree, size_t maxLen,
         } else {
             if (pos->sons[*i] != NULL
                 && availableDigits[*i]) {
+                if (visits == visitLimit) {
+                    return false;
+                }
+                visits++;
                 pos = pos->sons[*i];
                 pos->foldI = 0;
                 pos->helper = 0;
@@ -827,5 +1299,272 @@ size_t radixTreeNonTrivialCount(RadixTree tree, size_t maxLen,
             (*i)++;
         }
     }
+    if (stats != NULL) {
+        stats->nodes += visits + 1;
+    }
+    *out = result;
+    return true;
+}
+
+/**
+ * @brief Podnosi @p base do potęgi @p exp w arytmetyce zmiennoprzecinkowej.
+ * @param[in] base - podstawa.
+ * @param[in] exp - wykładnik.
+ * @return @p base do potęgi @p exp.
+ */
+static double radixTreeEstimatePower(double base, size_t exp) {
+    double result = 1;
+    while (exp != 0) {
+        if (exp & (size_t) 1) {
+            result *= base;
+        }
+        base *= base;
+        exp >>= 1;
+    }
     return result;
 }
+
+/**
+ * @brief Generator liczb pseudolosowych xorshift64*.
+ * @param[in, out] state - stan generatora (różny od zera).
+ * @return Liczba pseudolosowa.
+ */
+static uint64_t radixTreeRandom(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * UINT64_C(2685821657736338717);
+}
+
+double radixTreeNonTrivialCountSample(RadixTree tree, size_t maxLen,
+                                      const bool *availableDigits,
+                                      size_t howManyDigitsAvailable,
+                                      uint64_t *random) {
+    RadixTreeNode eligible[RADIX_TREE_NUMBER_OF_SONS];
+    RadixTreeNode pos = tree;
+    size_t len = 0;
+    double weight = 1;
+
+    while (true) {
+        size_t count = 0, total = 0, i;
+        for (i = 0; i < RADIX_TREE_NUMBER_OF_SONS; i++) {
+            RadixTreeNode son = pos->sons[i];
+            if (son != NULL && availableDigits[i] && son->dataCount != 0
+                && son->txtLength <= maxLen - len
+                && radixTreeNonTrivialCountCheck(son->txt, availableDigits)) {
+                eligible[count++] = son;
+                total += son->dataCount;
+            }
+        }
+        if (count == 0) {
+            return 0;
+        }
+
+        uint64_t draw = radixTreeRandom(random);
+        if ((draw & 1) != 0) {
+            i = (size_t) ((draw >> 1) % count);
+        } else {
+            size_t pick = (size_t) ((draw >> 1) % total);
+            for (i = 0; pick >= eligible[i]->dataCount; i++) {
+                pick -= eligible[i]->dataCount;
+            }
+        }
+        pos = eligible[i];
+        weight /= 0.5 * (double) pos->dataCount / (double) total
+                  + 0.5 / (double) count;
+        len += pos->txtLength;
+        if (pos->data != NULL) {
+            return weight * radixTreeEstimatePower(
+                    (double) howManyDigitsAvailable, maxLen - len);
+        } else if (len == maxLen) {
+            return 0;
+        }
+    }
+}
+
+/**
+ * @brief Liczba bitów w słowie zbioru aktywnych zapytań.
+ * @see radixTreeNonTrivialCountMany
+ */
+#define RADIX_TREE_BITSET_WORD_BITS (sizeof(size_t) * 8)
+
+/**
+ * @brief Stos zbiorów aktywnych zapytań dla kolejnych poziomów ścieżki.
+ * @see radixTreeNonTrivialCountMany
+ */
+struct RadixTreeCountStack {
+    /**
+     * @brief Zbiory aktywnych zapytań, po @p words słów na poziom.
+     */
+    size_t *alive;
+
+    /**
+     * @brief Maska cyfr występujących na ścieżce do węzła danego poziomu.
+     */
+    size_t *pathMask;
+
+    /**
+     * @brief Liczba słów zbioru aktywnych zapytań.
+     */
+    size_t words;
+
+    /**
+     * @brief Liczba zaalokowanych poziomów.
+     */
+    size_t capacity;
+};
+
+/**
+ * @brief Zapewnia miejsce na poziom @p level.
+ * @param[in, out] stack - wskaźnik na stos.
+ * @param[in] level - numer poziomu.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool radixTreeCountStackReserve(struct RadixTreeCountStack *stack,
+                                       size_t level) {
+    if (level < stack->capacity) {
+        return true;
+    }
+    size_t capacity = MAX(2 * stack->capacity, level + 1);
+    size_t *alive = realloc(stack->alive,
+                            capacity * stack->words * sizeof(size_t));
+    if (alive == NULL) {
+        return false;
+    }
+    stack->alive = alive;
+    size_t *pathMask = realloc(stack->pathMask, capacity * sizeof(size_t));
+    if (pathMask == NULL) {
+        return false;
+    }
+    stack->pathMask = pathMask;
+    stack->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Wyznacza zapytania aktywne w synu i dolicza wyniki.
+ * Zapytanie jest aktywne w węźle, jeżeli numer reprezentowany przez węzeł
+ * składa się tylko z jego cyfr i nie jest dłuższy od jego długości.
+ * Węzeł z danymi dolicza wynik każdemu aktywnemu zapytaniu i kończy je.
+ * @param[in] stack - wskaźnik na stos.
+ * @param[in] level - poziom ojca.
+ * @param[in] son - wskaźnik na syna.
+ * @param[in] depth - długość numeru reprezentowanego przez @p son.
+ * @param[in] n - liczba zapytań.
+ * @param[in] digitMasks - maski dostępnych cyfr zapytań.
+ * @param[in] maxLens - długości zapytań.
+ * @param[in] howManyDigits - liczby dostępnych cyfr zapytań.
+ * @param[in, out] out - wyniki zapytań.
+ * @return true jeżeli w synu pozostało aktywne zapytanie.
+ */
+static bool radixTreeNonTrivialCountManyVisit(struct RadixTreeCountStack *stack,
+                                              size_t level, RadixTreeNode son,
+                                              size_t depth, size_t n,
+                                              const size_t *digitMasks,
+                                              const size_t *maxLens,
+                                              const size_t *howManyDigits,
+                                              size_t *out) {
+    const size_t *parent = &stack->alive[level * stack->words];
+    size_t *child = &stack->alive[(level + 1) * stack->words];
+    size_t mask = stack->pathMask[level + 1];
+    bool any = false;
+
+    size_t w, q;
+    for (w = 0; w < stack->words; w++) {
+        child[w] = 0;
+        if (parent[w] == 0) {
+            continue;
+        }
+        for (q = w * RADIX_TREE_BITSET_WORD_BITS;
+             q < n && q < (w + 1) * RADIX_TREE_BITSET_WORD_BITS; q++) {
+            size_t bit = (size_t) 1 << (q % RADIX_TREE_BITSET_WORD_BITS);
+            if (!(parent[w] & bit) || (mask & ~digitMasks[q]) != 0
+                || depth > maxLens[q]) {
+                continue;
+            }
+            if (son->data != NULL) {
+                out[q] += radixTreeNonTrivialCountCount(maxLens[q] - depth,
+                                                        howManyDigits[q]);
+            } else if (depth < maxLens[q]) {
+                child[w] |= bit;
+                any = true;
+            }
+        }
+    }
+    return any;
+}
+
+bool radixTreeNonTrivialCountMany(RadixTree tree, size_t n,
+                                  const size_t *digitMasks,
+                                  const size_t *maxLens,
+                                  const size_t *howManyDigits,
+                                  size_t *out) {
+    struct RadixTreeCountStack stack;
+    stack.alive = NULL;
+    stack.pathMask = NULL;
+    stack.words = MAX((n + RADIX_TREE_BITSET_WORD_BITS - 1)
+                      / RADIX_TREE_BITSET_WORD_BITS, (size_t) 1);
+    stack.capacity = 0;
+
+    bool success = radixTreeCountStackReserve(&stack, 1);
+    size_t q;
+    for (q = 0; q < n; q++) {
+        out[q] = 0;
+    }
+    if (success) {
+        size_t w;
+        for (w = 0; w < stack.words; w++) {
+            stack.alive[w] = 0;
+        }
+        for (q = 0; q < n; q++) {
+            if (maxLens[q] != 0 && howManyDigits[q] != 0) {
+                stack.alive[q / RADIX_TREE_BITSET_WORD_BITS] |=
+                        (size_t) 1 << (q % RADIX_TREE_BITSET_WORD_BITS);
+            }
+        }
+        stack.pathMask[0] = 0;
+    }
+
+    size_t level = 0;
+    size_t len = 0;
+    RadixTreeNode pos = tree;
+    pos->foldI = 0;
+
+    while (success && !(pos == tree
+                        && pos->foldI == RADIX_TREE_NUMBER_OF_SONS)) {
+        size_t *i = &pos->foldI;
+        if (*i == RADIX_TREE_NUMBER_OF_SONS) {
+            len -= pos->helper;
+            level--;
+            pos = pos->father;
+            continue;
+        }
+
+        RadixTreeNode son = pos->sons[*i];
+        (*i)++;
+        if (son == NULL) {
+            continue;
+        }
+        if (!radixTreeCountStackReserve(&stack, level + 1)) {
+            success = false;
+            break;
+        }
+
+        size_t depth = len + son->txtLength;
+        stack.pathMask[level + 1] = stack.pathMask[level]
+                                    | charSequenceDigitMask(son->txt);
+        if (radixTreeNonTrivialCountManyVisit(&stack, level, son, depth, n,
+                                              digitMasks, maxLens,
+                                              howManyDigits, out)) {
+            pos = son;
+            pos->foldI = 0;
+            pos->helper = son->txtLength;
+            len = depth;
+            level++;
+        }
+    }
+
+    free(stack.alive);
+    free(stack.pathMask);
+    return success;
+}
@@ -14,6 +14,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "character.h"
 #include "char_sequence.h"
 
@@ -69,6 +70,41 @@ typedef struct RadixTreeNode *RadixTreeNode;
  */
 struct RadixTreeNode;
 
+/**
+ * @brief Koszt przejścia po drzewie.
+ * Pola listEntries i allocations nie są zmieniane przez funkcje drzewa,
+ * tylko przez użytkownika drzewa przeglądającego dane węzłów.
+ * @see radixTreeFindCounted
+ * @see radixTreeDataFatherCounted
+ * @see radixTreeNonTrivialCountLimited
+ */
+struct RadixTreeStats {
+    /**
+     * @brief Liczba odwiedzonych węzłów (wraz z korzeniem).
+     */
+    size_t nodes;
+
+    /**
+     * @brief Liczba porównanych znaków krawędzi.
+     */
+    size_t chars;
+
+    /**
+     * @brief Liczba przejrzanych bloków ciągów znaków krawędzi.
+     */
+    size_t blocks;
+
+    /**
+     * @brief Liczba przejrzanych pozycji list przechowywanych w węzłach.
+     */
+    size_t listEntries;
+
+    /**
+     * @brief Liczba zaalokowanych bloków pamięci.
+     */
+    size_t allocations;
+};
+
 /**
  * @brief Tworzy drzewo i inicjuje je.
  * #### Złożoność
@@ -80,7 +116,10 @@ RadixTree radixTreeCreate();
 
 /**
  * @brief Sprawdza, czy @p node jest korzeniem drzewa.
- * Sprzawdza, czy @p node jest węzłem reprezentującym drzewo.
+ * Sprzawdza, czy @p node jest węzłem reprezentującym drzewo (jedynym
+ * węzłem bez ojca).
+ * #### Złożoność
+ * O(1)
  * @param[in] node - wskaźnik na węzeł drzewa.
  * @return Niezerowa wartość w przypadku gdy @p node jest korzeniem,
  *         zero w przeciwnym wypadku.
@@ -120,6 +159,23 @@ int radixTreeFind(RadixTree tree, const char *txt, RadixTreeNode *ptr,
                   const char **txtMatchPtr, size_t *nodeMatch,
                   int *nodeMatchMode);
 
+/**
+ * @brief Wyszukuje węzeł jak @ref radixTreeFind, doliczając koszt
+ * przejścia do @p stats.
+ * @see radixTreeFind
+ * @param[in] tree - wskaźnik na drzewo.
+ * @param[in] txt - wskaźnik na numer.
+ * @param[out] ptr - jak w @ref radixTreeFind.
+ * @param[out] txtMatchPtr - jak w @ref radixTreeFind.
+ * @param[out] nodeMatch - jak w @ref radixTreeFind.
+ * @param[out] nodeMatchMode - jak w @ref radixTreeFind.
+ * @param[in, out] stats - wskaźnik na licznik kosztu lub NULL.
+ * @return Jak w @ref radixTreeFind.
+ */
+int radixTreeFindCounted(RadixTree tree, const char *txt, RadixTreeNode *ptr,
+                         const char **txtMatchPtr, size_t *nodeMatch,
+                         int *nodeMatchMode, struct RadixTreeStats *stats);
+
 /**
  * @brief Okrojona wersja radixTreeFind.
  * @see radixTreeFind
@@ -137,6 +193,11 @@ int radixTreeFindLite(RadixTree tree, const char *txt, RadixTreeNode *ptr);
 
 /**
  * @brief Sprawia że w drzewie powstaje ścieżka reprezentująca numer @p txt.
+ * Rozcina co najwyżej jedną krawędź i nie przechodzi drzewa ponownie po
+ * rozcięciu. Jeżeli po rozcięciu nie uda się dodać liścia, rozcięcie
+ * jest cofane.
+ * #### Złożoność
+ * Proporcjonalna do długości @p txt.
  * @see radixGetFullText
  * @param[in, out] tree - wskaźnik na drzewo.
  * @param[in] txt - wskaźnik na tekst reprezentujący numer.
@@ -169,6 +230,9 @@ void radixTreeCountDataFunction(void *ptrA, void *ptrB);
  * Usuwa poddrzewo reprezentowane przez @p subTreeNode
  * wywołując dla węzłów z przypisanymi danymi
  * f(wskaźnik_na_dane_przechowywane_przez_węzeł, fData).
+ * Nie balansuje ojca @p subTreeNode (@ref radixTreeBalance).
+ * #### Złożoność
+ * Proporcjonalna do liczby węzłów poddrzewa i głębokości @p subTreeNode.
  * @param[in, out] subTreeNode - wskaźnik na węzeł drzewa.
  * @param[in] f - wskaźnik na funkcję czyszczącą.
  * @param fData - dane pomocnicze do funkcji czyszczącej.
@@ -198,12 +262,64 @@ void *radixTreeGetNodeData(RadixTreeNode node);
 /**
  * @brief Przypisuje dane do węzła
  * Sprawia że węzeł @p node posiada wskaźnik na dane wskazywane przez
- * @p ptr.
+ * @p ptr. Aktualizuje liczniki węzłów z danymi przodków węzła.
+ * Gdy zmienia się to, czy węzeł ma dane, unieważnia zapamiętanych
+ * najbliższych przodków z danymi (@ref radixTreeDataFather) w poddrzewie
+ * syna korzenia zawierającym węzeł.
+ * #### Złożoność
+ * Gdy zmienia się to, czy węzeł ma dane, proporcjonalna do głębokości
+ * węzła, w przeciwnym przypadku O(1).
  * @param[in, out] node - wskaźnik na węzeł.
  * @param[in] ptr - wskaźnik na dane.
  */
 void radixTreeSetData(RadixTreeNode node, void *ptr);
 
+/**
+ * @brief Oznacza poddrzewo węzła jako zmienione.
+ * Pozwala zgłosić przez @ref radixTreeFoldDirty zmianę danych wykonaną
+ * bez @ref radixTreeInsert.
+ * @param[in, out] node - wskaźnik na węzeł.
+ */
+void radixTreeMarkChanged(RadixTreeNode node);
+
+/**
+ * @param[in] node - wskaźnik na węzeł.
+ * @return Waga węzła @p node (początkowo 0).
+ */
+size_t radixTreeGetWeight(RadixTreeNode node);
+
+/**
+ * @brief Ustawia wagę węzła.
+ * Waga nie jest sumowana w poddrzewach i nie wpływa na strukturę drzewa.
+ * Przy rozcinaniu krawędzi nowy węzeł dostaje wagę 0, a przy scalaniu
+ * zachowywana jest waga syna, więc wagę powinny mieć tylko węzły z danymi.
+ * @param[in, out] node - wskaźnik na węzeł.
+ * @param[in] weight - nowa waga.
+ */
+void radixTreeSetWeight(RadixTreeNode node, size_t weight);
+
+/**
+ * @brief Sumuje wagi węzłów reprezentujących prefiksy @p txt.
+ * #### Złożoność
+ * Proporcjonalna do długości @p txt.
+ * @param[in] tree - wskaźnik na drzewo.
+ * @param[in] txt - wskaźnik na tekst.
+ * @return Suma wag węzłów, których numery są prefiksami @p txt.
+ */
+size_t radixTreePathWeight(RadixTree tree, const char *txt);
+
+/**
+ * @brief Liczy węzły z danymi, których numery mają prefiks @p txt.
+ * Korzysta z liczników utrzymywanych przy przypisywaniu danych, usuwaniu
+ * poddrzew, rozcinaniu i scalaniu węzłów.
+ * #### Złożoność
+ * Proporcjonalna do długości @p txt.
+ * @param[in] tree - wskaźnik na drzewo.
+ * @param[in] txt - wskaźnik na tekst.
+ * @return Liczba węzłów z danymi w poddrzewie @p txt.
+ */
+size_t radixTreeCountData(RadixTree tree, const char *txt);
+
 /**
  * @brief Poprzednik na ścieżce do korzenia.
  * @param[in] node - wskaźnik na węzeł.
@@ -212,23 +328,141 @@ void radixTreeSetData(RadixTreeNode node, void *ptr);
  */
 RadixTreeNode radixTreeFather(RadixTreeNode node);
 
+/**
+ * @brief Najbliższy przodek z danymi.
+ * Pozwala przejść ścieżkę do korzenia z pominięciem węzłów bez danych.
+ * Korzeń nie jest brany pod uwagę. Wynik jest zapamiętywany w węźle
+ * i w węzłach przejrzanych po drodze, aż do najbliższej zmiany tego,
+ * czy któryś węzeł poddrzewa syna korzenia zawierającego @p node ma dane.
+ * #### Złożoność
+ * O(1), jeżeli wynik jest zapamiętany, w przeciwnym przypadku
+ * proporcjonalna do liczby węzłów między @p node a wynikiem, które nie
+ * mają zapamiętanego wyniku. Przejście wszystkich przodków z danymi
+ * węzła kosztuje więc co najwyżej tyle, co przejście ścieżki do korzenia.
+ * @param[in] tree - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - wskaźnik na węzeł.
+ * @return Wskaźnik na najbliższego przodka węzła @p node (różnego od niego
+ *         i od korzenia) z przypisanymi danymi, NULL w przypadku braku
+ *         takiego węzła.
+ */
+RadixTreeNode radixTreeDataFather(RadixTree tree, RadixTreeNode node);
+
+/**
+ * @brief Najbliższy przodek z danymi, z doliczeniem kosztu.
+ * Działa jak @ref radixTreeDataFather i dolicza do @p stats->nodes węzły
+ * przejrzane przy szukaniu wyniku.
+ * #### Złożoność
+ * Taka jak @ref radixTreeDataFather.
+ * @param[in] tree - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - wskaźnik na węzeł.
+ * @param[in, out] stats - wskaźnik na licznik kosztu przejścia lub NULL.
+ * @return Jak w @ref radixTreeDataFather.
+ */
+RadixTreeNode radixTreeDataFatherCounted(RadixTree tree, RadixTreeNode node,
+                                         struct RadixTreeStats *stats);
+
+/**
+ * @brief Węzeł z danymi najbliższy na ścieżce do korzenia.
+ * @see radixTreeDataFather
+ * #### Złożoność
+ * Taka jak @ref radixTreeDataFather.
+ * @param[in] tree - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - wskaźnik na węzeł.
+ * @return Wskaźnik na węzeł @p node, jeżeli ma przypisane dane i nie jest
+ *         korzeniem, w przeciwnym przypadku radixTreeDataFather(tree, node).
+ */
+RadixTreeNode radixTreeDataAncestor(RadixTree tree, RadixTreeNode node);
+
+/**
+ * @brief Węzeł z danymi najbliższy na ścieżce do korzenia, z doliczeniem
+ * kosztu.
+ * @see radixTreeDataFatherCounted
+ * #### Złożoność
+ * Taka jak @ref radixTreeDataFather.
+ * @param[in] tree - wskaźnik na drzewo zawierające @p node.
+ * @param[in] node - wskaźnik na węzeł.
+ * @param[in, out] stats - wskaźnik na licznik kosztu przejścia lub NULL.
+ * @return Jak w @ref radixTreeDataAncestor.
+ */
+RadixTreeNode radixTreeDataAncestorCounted(RadixTree tree, RadixTreeNode node,
+                                           struct RadixTreeStats *stats);
+
+/**
+ * @brief Następny węzeł z danymi.
+ * Pozwala przeglądać węzły z danymi w porządku leksykograficznym
+ * względem przechowywanego tekstu bez funkcji przetwarzającej, np.
+ * równolegle w kilku drzewach.
+ * @see radixTreeFoldNodes
+ * @param[in] tree - wskaźnik na drzewo (poddrzewo).
+ * @param[in] node - wskaźnik na węzeł drzewa @p tree lub NULL.
+ * @return Pierwszy węzeł z danymi drzewa @p tree następujący po @p node
+ *         (dla @p node równego NULL pierwszy węzeł z danymi, łącznie
+ *         z @p tree) lub NULL, jeżeli takiego węzła nie ma.
+ */
+RadixTreeNode radixTreeNextData(RadixTree tree, RadixTreeNode node);
+
 /**
  * @brief Optymalizuje pamięć zajmowaną przez drzewo.
- * Część węzłów na ścieżce od @p node do korzenia nie przechowująca danych
- * zostaje w miarę możliwości usunięta lub scalona.
+ * Węzły na ścieżce od @p node do korzenia nie przechowujące danych
+ * zostają usunięte (gdy nie mają synów) lub scalone z jedynym synem.
+ * Zakłada, że poza @p node i przodkami, którzy staną się zbędni po
+ * przekształceniu @p node, w drzewie nie ma zbędnych węzłów, dlatego
+ * kończy się na pierwszym węźle, którego nie można usunąć ani scalić.
+ * Wywoływana po każdej operacji, po której węzeł traci dane lub syna,
+ * utrzymuje drzewo bez zbędnych węzłów.
+ * #### Złożoność
+ * Proporcjonalna do liczby usuniętych i scalonych węzłów oraz łącznej
+ * liczby bloków tekstu scalanych węzłów (@ref charSequenceMerge).
  * @param[in] node - wskaźnik na węzeł.
  */
 void radixTreeBalance(RadixTreeNode node);
 
 /**
  * @brief Tekst reprezentujący węzeł.
- * @remarks Wynik musi zostać zwolniony przy pomocy free.
+ * @remarks Wynik musi zostać zwolniony przy pomocy free.
+ * #### Złożoność
+ * Proporcjonalna do długości wyniku.
  * @param[in] node - wskaźnik na węzeł drzewa.
  * @return Wskaźnik na tekst reprezentujący ścieżkę od korzenia do węzła,
  *         w przypadku problemów z przydzieleniem pamięci zwraca NULL.
  */
 char *radixGetFullText(RadixTreeNode node);
 
+/**
+ * @brief Tekst reprezentujący węzeł z dopisanym sufiksem.
+ * Przydziela pamięć raz, bez pośredniej kopii tekstu węzła.
+ * @remarks Wynik musi zostać zwolniony przy pomocy free.
+ * #### Złożoność
+ * Proporcjonalna do długości wyniku.
+ * @param[in] node - wskaźnik na węzeł drzewa.
+ * @param[in] suffix - wskaźnik na sufiks.
+ * @return Wskaźnik na tekst reprezentujący ścieżkę od korzenia do węzła,
+ *         po którym następuje @p suffix, w przypadku problemów
+ *         z przydzieleniem pamięci zwraca NULL.
+ */
+char *radixGetFullTextWithSuffix(RadixTreeNode node, const char *suffix);
+
+/**
+ * @brief Długość tekstu reprezentującego węzeł.
+ * Długość jest przechowywana w węźle.
+ * #### Złożoność
+ * O(1)
+ * @see radixGetFullText
+ * @param[in] node - wskaźnik na węzeł drzewa.
+ * @return Długość tekstu reprezentującego ścieżkę od korzenia do węzła.
+ */
+size_t radixTreeTextLength(RadixTreeNode node);
+
+/**
+ * @brief Zapisuje tekst reprezentujący węzeł bez przydzielania pamięci.
+ * Zapisuje radixTreeTextLength(node) znaków (bez kończącego znaku '\0').
+ * @see radixGetFullText
+ * @param[in] node - wskaźnik na węzeł drzewa.
+ * @param[in] length - wynik radixTreeTextLength(node).
+ * @param[out] out - wskaźnik na bufor na co najmniej @p length znaków.
+ */
+void radixTreeWriteText(RadixTreeNode node, size_t length, char *out);
+
 /**
  * @brief Przetwarza drzewo.
  * Przechodzi po węzłach drzewa @p tree w porządku leksykograficznym
@@ -240,6 +474,50 @@ char *radixGetFullText(RadixTreeNode node);
  */
 void radixTreeFold(RadixTree tree, void (*f)(void *, void *), void *fData);
 
+/**
+ * @brief Przetwarza węzły drzewa.
+ * Przechodzi po węzłach drzewa (poddrzewa) @p tree w porządku leksykograficznym
+ * względem przechowywanego tekstu i na każdym węźle przechowującym jakieś dane
+ * wywołuje f(węzeł, fData).
+ * @see radixTreeFold
+ * @param[in, out] tree - wskaźnik na drzewo.
+ * @param[in] f - wskaźnik na funkcję przetwarzającą.
+ * @param[in,out] fData - wskaźnik na dane do funkcji @p f.
+ */
+void radixTreeFoldNodes(RadixTree tree, void (*f)(RadixTreeNode, void *),
+                        void *fData);
+
+/**
+ * @brief Przetwarza zmienione poddrzewa.
+ * Węzeł zostaje oznaczony jako zmieniony, gdy zwróci go @ref radixTreeInsert.
+ * Znaczniki zmian są zachowywane przy rozdzielaniu i scalaniu węzłów.
+ * Przechodzi w porządku leksykograficznym po najwyższych oznaczonych węzłach
+ * drzewa @p tree i na każdym z nich wywołuje f(węzeł, fData). Nie wchodzi
+ * do poddrzew, w których nic się nie zmieniło.
+ * @see radixTreeClearDirty
+ * @param[in, out] tree - wskaźnik na drzewo.
+ * @param[in] f - wskaźnik na funkcję przetwarzającą.
+ * @param[in,out] fData - wskaźnik na dane do funkcji @p f.
+ */
+void radixTreeFoldDirty(RadixTree tree, void (*f)(RadixTreeNode, void *),
+                        void *fData);
+
+/**
+ * @brief Usuwa znaczniki zmian z drzewa @p tree.
+ * #### Złożoność
+ * Proporcjonalna do liczby oznaczonych węzłów.
+ * @see radixTreeFoldDirty
+ * @param[in, out] tree - wskaźnik na drzewo.
+ */
+void radixTreeClearDirty(RadixTree tree);
+
+/**
+ * @param[in] tree - wskaźnik na drzewo.
+ * @return true jeżeli w drzewie @p tree są węzły oznaczone jako zmienione,
+ *         false w przeciwnym przypadku.
+ */
+bool radixTreeIsDirty(RadixTree tree);
+
 /**
  * @brief Funkcja licząca wynik dla  @ref phfwdNonTrivialCount
  * z wyjątkiem uwzględnionych przez @p phfwdNonTrivialCount
@@ -256,4 +534,80 @@ size_t radixTreeNonTrivialCount(RadixTree tree, size_t goalLen,
                                 const bool *availableDigits,
                                 size_t howManyDigitsAvailable);
 
+/**
+ * @brief Liczy wynik jak @ref radixTreeNonTrivialCount, przeglądając
+ * co najwyżej @p visitLimit węzłów.
+ * @param[in] tree - drzewo z informacjami pozwalającymi odwrócić przekierowanie.
+ * @param[in] goalLen - szukana długość numeru.
+ * @param[in] availableDigits - tablica z wartościami true na pozycjach
+ *       odpowiadających dostępnym cyfrom (pozycja = kod_ascii_cyfry - '0').
+ * @param[in] howManyDigitsAvailable - liczba różnych cyfr.
+ * @param[in] visitLimit - maksymalna liczba odwiedzonych węzłów.
+ * @param[out] out - wynik, jeżeli udało się go policzyć.
+ * @param[in, out] stats - wskaźnik na licznik kosztu przejścia lub NULL.
+ * @return true jeżeli wynik został policzony, false jeżeli przekroczono
+ *         limit odwiedzonych węzłów.
+ */
+bool radixTreeNonTrivialCountLimited(RadixTree tree, size_t goalLen,
+                                     const bool *availableDigits,
+                                     size_t howManyDigitsAvailable,
+                                     size_t visitLimit, size_t *out,
+                                     struct RadixTreeStats *stats);
+
+/**
+ * @brief Losuje jedną próbkę estymatora wyniku @ref radixTreeNonTrivialCount.
+ * Przechodzi losową ścieżkę od korzenia, w każdym węźle wybierając
+ * jednego z k synów, w których poddrzewach mogą być liczone numery,
+ * i dzieląc wagę przez prawdopodobieństwo wyboru (estymator Knutha
+ * z losowaniem ważonym). Syn jest wybierany z prawdopodobieństwem
+ * (c / C + 1 / k) / 2, gdzie c to liczba węzłów z danymi w jego poddrzewie,
+ * a C to suma tych liczb dla wszystkich k synów. Przy poddrzewach o bardzo
+ * różnej liczbie węzłów z danymi wariancja jest więc dużo mniejsza niż przy
+ * wyborze jednostajnym, a składnik jednostajny ogranicza wagę, gdy krótkie
+ * cele z dużą liczbą numerów leżą obok gęstych poddrzew. Wynikiem jest waga
+ * razy liczba numerów liczonych w węźle z danymi kończącym ścieżkę.
+ * Wartość oczekiwana próbki jest równa dokładnemu wynikowi (bez obliczeń
+ * modulo).
+ * #### Złożoność
+ * Proporcjonalna do długości ścieżki.
+ * @param[in] tree - drzewo z informacjami pozwalającymi odwrócić przekierowanie.
+ * @param[in] goalLen - szukana długość numeru.
+ * @param[in] availableDigits - tablica z wartościami true na pozycjach
+ *       odpowiadających dostępnym cyfrom (pozycja = kod_ascii_cyfry - '0').
+ * @param[in] howManyDigitsAvailable - liczba różnych cyfr.
+ * @param[in, out] random - stan generatora liczb pseudolosowych
+ *       (różny od zera).
+ * @return Próbka.
+ */
+double radixTreeNonTrivialCountSample(RadixTree tree, size_t goalLen,
+                                      const bool *availableDigits,
+                                      size_t howManyDigitsAvailable,
+                                      uint64_t *random);
+
+/**
+ * @brief Funkcja licząca wyniki wielu zapytań @ref phfwdNonTrivialCount
+ * w jednym przejściu drzewa.
+ * Dla każdego węzła wyznacza zbiór (bitowy) zapytań, dla których
+ * numer reprezentowany przez węzeł składa się tylko z dostępnych cyfr
+ * i nie jest za długi. Poddrzewo jest przeglądane, dopóki ten zbiór
+ * jest niepusty.
+ * #### Złożoność
+ * Jedno przejście drzewa, w każdym odwiedzonym węźle O(@p n).
+ * @see radixTreeNonTrivialCount
+ * @param[in] tree - drzewo z informacjami pozwalającymi odwrócić przekierowanie.
+ * @param[in] n - liczba zapytań.
+ * @param[in] digitMasks - maski bitowe dostępnych cyfr zapytań
+ *       (bit numer kod_ascii_cyfry - '0').
+ * @param[in] maxLens - szukane długości numerów.
+ * @param[in] howManyDigits - liczby dostępnych różnych cyfr. Zapytania
+ *       z zerową liczbą cyfr lub zerową długością mają wynik 0.
+ * @param[out] out - tablica na @p n wyników.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool radixTreeNonTrivialCountMany(RadixTree tree, size_t n,
+                                  const size_t *digitMasks,
+                                  const size_t *maxLens,
+                                  const size_t *howManyDigits,
+                                  size_t *out);
+
 #endif //TELEFONY_RADIX_TREE_H
@@ -0,0 +1,954 @@
+/** @file
+ * Implementacja modułu replikacji baz przekierowań.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "replication.h"
+#include "vector.h"
+
+/**
+ * @brief Połączenie przez gniazdo wraz z buforami.
+ */
+struct ReplicationConnection {
+    /**
+     * @brief Deskryptor gniazda, -1 gdy brak połączenia.
+     */
+    int fd;
+
+    /**
+     * @brief Odebrane i jeszcze nieprzetworzone bajty.
+     */
+    Vector input;
+
+    /**
+     * @brief Bajty oczekujące na wysłanie.
+     */
+    Vector output;
+
+    /**
+     * @brief Liczba już wysłanych bajtów z @p output.
+     */
+    size_t outputSent;
+};
+
+/**
+ * @brief Naśladowca obsługiwany przez lidera.
+ */
+struct ReplicationFollower {
+    /**
+     * @brief Połączenie z naśladowcą.
+     */
+    struct ReplicationConnection connection;
+
+    /**
+     * @brief Pozycja dziennika, od której należy kontynuować wysyłanie.
+     */
+    unsigned long long logPos;
+
+    /**
+     * @brief Ostatnia pozycja zgłoszona przez naśladowcę.
+     */
+    unsigned long long appliedPos;
+
+    /**
+     * @brief Następny naśladowca na liście.
+     */
+    struct ReplicationFollower *next;
+};
+
+/**
+ * @brief Stan lidera.
+ */
+struct ReplicationLeader {
+    /**
+     * @brief Deskryptor gniazda nasłuchującego, -1 gdy proces nie jest
+     * liderem.
+     */
+    int listenFd;
+
+    /**
+     * @brief Ścieżka gniazda.
+     */
+    const char *socketPath;
+
+    /**
+     * @brief Końcówka dziennika, której nie wysłano jeszcze
+     * wszystkim naśladowcom.
+     */
+    Vector log;
+
+    /**
+     * @brief Pozycja pierwszego bajtu @p log.
+     */
+    unsigned long long logStart;
+
+    /**
+     * @brief Identyfikator wybranej bazy zakończony '\0',
+     * pusty gdy żadna baza nie jest wybrana.
+     */
+    Vector currentId;
+
+    /**
+     * @brief Lista naśladowców.
+     */
+    struct ReplicationFollower *followers;
+};
+
+/**
+ * @brief Stan naśladowcy.
+ */
+struct ReplicationFollowerState {
+    /**
+     * @brief Połączenie z liderem.
+     */
+    struct ReplicationConnection connection;
+
+    /**
+     * @brief Pozycja ostatniego zastosowanego rekordu.
+     */
+    unsigned long long applied;
+
+    /**
+     * @brief Czy otrzymano już cały obraz baz.
+     */
+    bool bootstrapped;
+
+    /**
+     * @brief Baza wybrana przez rekordy REPLICATION_RECORD_NEW.
+     */
+    struct PhoneForward *current;
+
+    /**
+     * @brief Bufor na zmiany przekazywane do phfwdApplyChanges.
+     */
+    struct PhoneForwardChange *changes;
+
+    /**
+     * @brief Liczba zmian, które mieszczą się w buforze.
+     */
+    size_t changesCapacity;
+};
+
+/**
+ * @brief Stan lidera.
+ */
+static struct ReplicationLeader leader = {-1, NULL, NULL, 0, NULL, NULL};
+
+/**
+ * @brief Stan naśladowcy.
+ */
+static struct ReplicationFollowerState follower = {{-1, NULL, NULL, 0},
+                                                   0, false, NULL, NULL, 0};
+
+/**
+ * @brief Inicjuje połączenie.
+ * @param[out] connection - wskaźnik na połączenie.
+ * @param[in] fd - deskryptor gniazda.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationConnectionInit(struct ReplicationConnection *connection,
+                                      int fd) {
+    connection->fd = fd;
+    connection->outputSent = 0;
+    connection->input = vectorCreate();
+    connection->output = vectorCreate();
+    if (connection->input == NULL || connection->output == NULL) {
+        if (connection->input != NULL) {
+            vectorDelete(connection->input);
+        }
+        if (connection->output != NULL) {
+            vectorDelete(connection->output);
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Zamyka połączenie i zwalnia bufory.
+ * @param[in, out] connection - wskaźnik na połączenie.
+ */
+static void replicationConnectionClose(struct ReplicationConnection *connection) {
+    if (connection->fd >= 0) {
+        close(connection->fd);
+        connection->fd = -1;
+    }
+    if (connection->input != NULL) {
+        vectorDelete(connection->input);
+        connection->input = NULL;
+    }
+    if (connection->output != NULL) {
+        vectorDelete(connection->output);
+        connection->output = NULL;
+    }
+}
+
+/**
+ * @brief Ustawia tryb blokujący lub nieblokujący deskryptora.
+ * @param[in] fd - deskryptor.
+ * @param[in] nonBlocking - czy operacje mają być nieblokujące.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+static bool replicationSetNonBlocking(int fd, bool nonBlocking) {
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0) {
+        return false;
+    }
+    if (nonBlocking) {
+        flags |= O_NONBLOCK;
+    } else {
+        flags &= ~O_NONBLOCK;
+    }
+    return fcntl(fd, F_SETFL, flags) == 0;
+}
+
+/**
+ * @brief Wypełnia adres gniazda uniksowego.
+ * @param[in] path - ścieżka gniazda.
+ * @param[out] address - wypełniany adres.
+ * @return true w przypadku sukcesu, false gdy ścieżka jest zbyt długa.
+ */
+static bool replicationSocketAddress(const char *path,
+                                     struct sockaddr_un *address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address->sun_path)) {
+        return false;
+    }
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+/**
+ * @brief Dopisuje rekord do Vectora.
+ * W przypadku problemów z pamięcią Vector pozostaje niezmieniony.
+ * @param[in, out] v - Vector.
+ * @param[in] type - typ rekordu.
+ * @param[in] a - pierwszy argument.
+ * @param[in] b - drugi argument lub NULL w przypadku jego braku.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationPushRecord(Vector v, char type,
+                                  const char *a, const char *b) {
+    size_t oldSize = vectorSize(v);
+    if (vectorPushBack(v, type) == VECTOR_SUCCES
+        && vectorPushBackString(v, a) == VECTOR_SUCCES
+        && (b == NULL || vectorPushBackString(v, b) == VECTOR_SUCCES)) {
+        return true;
+    }
+    vectorSoftResize(v, oldSize);
+    return false;
+}
+
+/**
+ * @brief Dopisuje do Vectora rekord z pozycją.
+ * @param[in, out] v - Vector.
+ * @param[in] position - pozycja.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationPushPosition(Vector v, unsigned long long position) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%llu", position);
+    return replicationPushRecord(v, REPLICATION_RECORD_POSITION, buffer, NULL);
+}
+
+/**
+ * @brief Wyznacza długość rekordu.
+ * @param[in] begin - wskaźnik na początek rekordu.
+ * @param[in] end - wskaźnik za ostatni dostępny bajt.
+ * @param[out] malformed - ustawiane na true, jeżeli rekord ma nieznany typ.
+ * @return Długość rekordu lub 0, jeżeli rekord nie jest jeszcze kompletny.
+ */
+static size_t replicationRecordLength(const char *begin, const char *end,
+                                      bool *malformed) {
+    int arguments;
+    switch (*begin) {
+        case REPLICATION_RECORD_ADD:
+            arguments = 2;
+            break;
+        case REPLICATION_RECORD_NEW:
+        case REPLICATION_RECORD_DEL_BASE:
+        case REPLICATION_RECORD_REMOVE:
+        case REPLICATION_RECORD_POSITION:
+            arguments = 1;
+            break;
+        default:
+            *malformed = true;
+            return 0;
+    }
+
+    const char *ptr = begin + 1;
+    while (arguments > 0 && ptr < end) {
+        if (*ptr == '\0') {
+            arguments--;
+        }
+        ptr++;
+    }
+    return arguments == 0 ? (size_t) (ptr - begin) : 0;
+}
+
+/**
+ * @brief Usuwa z początku Vectora @p count bajtów.
+ * @param[in, out] v - Vector.
+ * @param[in] count - liczba usuwanych bajtów.
+ */
+static void replicationConsume(Vector v, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    size_t rest = vectorSize(v) - count;
+    memmove(vectorBegin(v), vectorBegin(v) + count, rest);
+    vectorSoftResize(v, rest);
+}
+
+/**
+ * @brief Odbiera dostępne dane.
+ * @param[in, out] connection - wskaźnik na połączenie.
+ * @param[in] once - czy zakończyć po pierwszym odczycie (dla gniazd
+ *        blokujących).
+ * @param[out] closed - ustawiane na true, jeżeli połączenie zostało
+ *        zamknięte.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationReceive(struct ReplicationConnection *connection,
+                               bool once, bool *closed) {
+    char buffer[REPLICATION_READ_BUFFER_SIZE];
+    while (true) {
+        ssize_t count = read(connection->fd, buffer, sizeof(buffer));
+        if (count > 0) {
+            size_t oldSize = vectorSize(connection->input);
+            if (vectorSoftResize(connection->input, oldSize + count)
+                != VECTOR_SUCCES) {
+                return false;
+            }
+            memcpy(vectorBegin(connection->input) + oldSize, buffer,
+                   (size_t) count);
+            if (once) {
+                return true;
+            }
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                *closed = true;
+            }
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Wysyła dane.
+ * @param[in] fd - deskryptor gniazda.
+ * @param[in] data - wskaźnik na dane.
+ * @param[in] size - liczba bajtów do wysłania.
+ * @param[out] closed - ustawiane na true, jeżeli połączenie zostało
+ *        zamknięte.
+ * @return Liczba wysłanych bajtów.
+ */
+static size_t replicationSend(int fd, const char *data, size_t size,
+                              bool *closed) {
+    size_t sent = 0;
+    while (sent < size) {
+        ssize_t count = send(fd, data + sent, size - sent, MSG_NOSIGNAL);
+        if (count > 0) {
+            sent += (size_t) count;
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                *closed = true;
+            }
+            break;
+        }
+    }
+    return sent;
+}
+
+/**
+ * @brief Wysyła oczekujące bajty z bufora wyjściowego połączenia.
+ * @param[in, out] connection - wskaźnik na połączenie.
+ * @param[out] closed - ustawiane na true, jeżeli połączenie zostało
+ *        zamknięte.
+ * @return true jeżeli bufor został opróżniony, false w przeciwnym przypadku.
+ */
+static bool replicationFlush(struct ReplicationConnection *connection,
+                             bool *closed) {
+    size_t size = vectorSize(connection->output);
+    connection->outputSent +=
+            replicationSend(connection->fd,
+                            vectorBegin(connection->output)
+                            + connection->outputSent,
+                            size - connection->outputSent, closed);
+    if (connection->outputSent == size) {
+        vectorSoftClear(connection->output);
+        connection->outputSent = 0;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Pozycja końca dziennika lidera.
+ * @return Pozycja, pod którą zostanie zapisany następny rekord.
+ */
+static unsigned long long replicationLogEnd() {
+    return leader.logStart + vectorSize(leader.log);
+}
+
+bool replicationLeaderStart(const char *socketPath) {
+    struct sockaddr_un address;
+    if (!replicationSocketAddress(socketPath, &address)) {
+        return false;
+    }
+
+    leader.log = vectorCreate();
+    leader.currentId = vectorCreate();
+    if (leader.log == NULL || leader.currentId == NULL) {
+        replicationStop();
+        return false;
+    }
+
+    leader.listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (leader.listenFd < 0) {
+        replicationStop();
+        return false;
+    }
+
+    unlink(socketPath);
+    leader.socketPath = socketPath;
+    if (bind(leader.listenFd, (struct sockaddr *) &address,
+             sizeof(address)) != 0
+        || listen(leader.listenFd, SOMAXCONN) != 0
+        || !replicationSetNonBlocking(leader.listenFd, true)) {
+        replicationStop();
+        return false;
+    }
+    return true;
+}
+
+bool replicationIsFollower() {
+    return follower.bootstrapped;
+}
+
+/**
+ * @brief Zapisuje rekord w dzienniku lidera.
+ * @param[in] type - typ rekordu.
+ * @param[in] a - pierwszy argument.
+ * @param[in] b - drugi argument lub NULL w przypadku jego braku.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationLogRecord(char type, const char *a, const char *b) {
+    if (leader.listenFd < 0) {
+        return true;
+    }
+    return replicationPushRecord(leader.log, type, a, b);
+}
+
+bool replicationLogNew(const char *id) {
+    if (leader.listenFd < 0) {
+        return true;
+    }
+
+    vectorSoftClear(leader.currentId);
+    if (vectorPushBackString(leader.currentId, id) != VECTOR_SUCCES) {
+        return false;
+    }
+    return replicationLogRecord(REPLICATION_RECORD_NEW, id, NULL);
+}
+
+bool replicationLogDelBase(const char *id) {
+    if (leader.listenFd < 0) {
+        return true;
+    }
+
+    if (vectorSize(leader.currentId) > 0
+        && strcmp(vectorBegin(leader.currentId), id) == 0) {
+        vectorSoftClear(leader.currentId);
+    }
+    return replicationLogRecord(REPLICATION_RECORD_DEL_BASE, id, NULL);
+}
+
+bool replicationLogAdd(const char *num1, const char *num2) {
+    return replicationLogRecord(REPLICATION_RECORD_ADD, num1, num2);
+}
+
+bool replicationLogRemove(const char *num) {
+    return replicationLogRecord(REPLICATION_RECORD_REMOVE, num, NULL);
+}
+
+/**
+ * @brief Dopisuje przekierowanie do obrazu baz.
+ * @see phfwdForEach
+ * @param[in] num1 - prefiks numerów przekierowywanych.
+ * @param[in] num2 - prefiks numerów, na które jest wykonywane przekierowanie.
+ * @param[in, out] v - Vector z obrazem baz.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationDumpRule(const char *num1, const char *num2, void *v) {
+    return replicationPushRecord((Vector) v, REPLICATION_RECORD_ADD, num1, num2);
+}
+
+/**
+ * @brief Dopisuje bazę do obrazu baz.
+ * @see phoneBasesForEach
+ * @param[in] id - identyfikator bazy.
+ * @param[in] base - wskaźnik na bazę.
+ * @param[in, out] v - Vector z obrazem baz.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationDumpBase(const char *id, struct PhoneForward *base,
+                                void *v) {
+    return replicationPushRecord((Vector) v, REPLICATION_RECORD_NEW, id, NULL)
+           && phfwdForEach(base, replicationDumpRule, v);
+}
+
+/**
+ * @brief Przyjmuje oczekujących naśladowców.
+ * Każdemu nowemu naśladowcy przygotowuje obraz baz @p pb.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationLeaderAccept(PhoneBases pb) {
+    while (true) {
+        int fd = accept(leader.listenFd, NULL, NULL);
+        if (fd < 0) {
+            return true;
+        }
+
+        struct ReplicationFollower *f = malloc(sizeof(struct ReplicationFollower));
+        if (f == NULL) {
+            close(fd);
+            return false;
+        }
+        if (!replicationConnectionInit(&f->connection, fd)) {
+            close(fd);
+            free(f);
+            return false;
+        }
+
+        Vector image = f->connection.output;
+        bool success = replicationSetNonBlocking(fd, true)
+                       && phoneBasesForEach(pb, replicationDumpBase, image)
+                       && (vectorSize(leader.currentId) == 0
+                           || replicationPushRecord(image,
+                                                    REPLICATION_RECORD_NEW,
+                                                    vectorBegin(leader.currentId),
+                                                    NULL))
+                       && replicationPushPosition(image, replicationLogEnd());
+        if (!success) {
+            replicationConnectionClose(&f->connection);
+            free(f);
+            return false;
+        }
+
+        f->logPos = replicationLogEnd();
+        f->appliedPos = f->logPos;
+        f->next = leader.followers;
+        leader.followers = f;
+    }
+}
+
+/**
+ * @brief Obsługuje naśladowcę.
+ * Odbiera zgłoszone pozycje i wysyła obraz baz oraz końcówkę dziennika.
+ * @param[in, out] f - wskaźnik na naśladowcę.
+ * @param[out] closed - ustawiane na true, jeżeli połączenie zostało
+ *        zamknięte.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationLeaderServe(struct ReplicationFollower *f,
+                                   bool *closed) {
+    struct ReplicationConnection *connection = &f->connection;
+    if (!replicationReceive(connection, false, closed)) {
+        return false;
+    }
+
+    char *begin = vectorBegin(connection->input);
+    char *end = vectorEnd(connection->input);
+    char *ptr = begin;
+    size_t length;
+    while (ptr < end
+           && (length = replicationRecordLength(ptr, end, closed)) > 0) {
+        if (*ptr == REPLICATION_RECORD_POSITION) {
+            f->appliedPos = strtoull(ptr + 1, NULL, 10);
+        }
+        ptr += length;
+    }
+    replicationConsume(connection->input, (size_t) (ptr - begin));
+
+    if (*closed || !replicationFlush(connection, closed)) {
+        return true;
+    }
+
+    size_t offset = (size_t) (f->logPos - leader.logStart);
+    f->logPos += replicationSend(connection->fd,
+                                 vectorBegin(leader.log) + offset,
+                                 vectorSize(leader.log) - offset, closed);
+    return true;
+}
+
+/**
+ * @brief Usuwa z dziennika lidera rekordy wysłane wszystkim naśladowcom.
+ */
+static void replicationLeaderTrimLog() {
+    unsigned long long minPos = replicationLogEnd();
+    struct ReplicationFollower *f;
+    for (f = leader.followers; f != NULL; f = f->next) {
+        if (f->logPos < minPos) {
+            minPos = f->logPos;
+        }
+    }
+
+    size_t toDrop = (size_t) (minPos - leader.logStart);
+    if (toDrop > 0 && 2 * toDrop >= vectorSize(leader.log)) {
+        replicationConsume(leader.log, toDrop);
+        leader.logStart = minPos;
+    }
+}
+
+/**
+ * @brief Obsługuje replikację po stronie lidera.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationLeaderPoll(PhoneBases pb) {
+    if (!replicationLeaderAccept(pb)) {
+        return false;
+    }
+
+    struct ReplicationFollower **ptr = &leader.followers;
+    while (*ptr != NULL) {
+        struct ReplicationFollower *f = *ptr;
+        bool closed = false;
+        if (!replicationLeaderServe(f, &closed)) {
+            return false;
+        }
+
+        if (closed) {
+            fprintf(stderr, "REPLICATION follower disconnected at %llu of %llu\n",
+                    f->appliedPos, replicationLogEnd());
+            *ptr = f->next;
+            replicationConnectionClose(&f->connection);
+            free(f);
+        } else {
+            ptr = &f->next;
+        }
+    }
+
+    replicationLeaderTrimLog();
+    return true;
+}
+
+/**
+ * @brief Stosuje rekord do baz naśladowcy.
+ * Rekordy dodania i usunięcia przekierowań stosuje
+ * replicationApplyChanges.
+ * @param[in] record - wskaźnik na rekord.
+ * @param[in, out] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in, out] current - wskaźnik na wskaźnik na aktywną bazę lub NULL.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationApplyRecord(const char *record, PhoneBases pb,
+                                   struct PhoneForward **current) {
+    const char *a = record + 1;
+
+    switch (*record) {
+        case REPLICATION_RECORD_NEW:
+            follower.current = phoneBasesAddBase(pb, a);
+            return follower.current != NULL;
+        case REPLICATION_RECORD_DEL_BASE: {
+            struct PhoneForward *base = phoneBasesGetBase(pb, a);
+            if (base != NULL) {
+                if (base == follower.current) {
+                    follower.current = NULL;
+                }
+                if (current != NULL && base == *current) {
+                    *current = NULL;
+                }
+                phoneBasesDelBase(pb, a);
+            }
+            return true;
+        }
+        default:
+            follower.applied = strtoull(a, NULL, 10);
+            follower.bootstrapped = true;
+            return true;
+    }
+}
+
+/**
+ * @brief Sprawdza, czy rekord dodaje lub usuwa przekierowania.
+ * @param[in] record - wskaźnik na rekord.
+ * @return true, jeżeli rekord jest typu REPLICATION_RECORD_ADD lub
+ *         REPLICATION_RECORD_REMOVE.
+ */
+static bool replicationIsChange(const char *record) {
+    return *record == REPLICATION_RECORD_ADD
+           || *record == REPLICATION_RECORD_REMOVE;
+}
+
+/**
+ * @brief Stosuje ciąg rekordów dodania i usunięcia przekierowań.
+ * Zbiera kompletne rekordy zmian od @p begin do pierwszego rekordu innego
+ * typu i stosuje je do aktywnej bazy jednym wywołaniem phfwdApplyChanges,
+ * czyli przy jednym zablokowaniu jej pasów. Bez aktywnej bazy rekordy są
+ * pomijane.
+ * @param[in] begin - wskaźnik na pierwszy rekord ciągu.
+ * @param[in] end - wskaźnik za ostatni odebrany bajt.
+ * @param[out] closed - ustawiane na true, jeżeli rekord ma nieznany typ.
+ * @param[out] failed - ustawiane na true w przypadku problemów z pamięcią.
+ * @return Łączna długość zastosowanych rekordów.
+ */
+static size_t replicationApplyChanges(const char *begin, const char *end,
+                                      bool *closed, bool *failed) {
+    const char *ptr = begin;
+    size_t count = 0;
+    size_t length;
+
+    while (ptr < end && replicationIsChange(ptr)
+           && (length = replicationRecordLength(ptr, end, closed)) > 0) {
+        if (count == follower.changesCapacity) {
+            size_t capacity = 2 * count + 16;
+            struct PhoneForwardChange *changes =
+                    realloc(follower.changes,
+                            capacity * sizeof(struct PhoneForwardChange));
+            if (changes == NULL) {
+                *failed = true;
+                return 0;
+            }
+            follower.changes = changes;
+            follower.changesCapacity = capacity;
+        }
+        const char *num1 = ptr + 1;
+        follower.changes[count].num1 = num1;
+        follower.changes[count].num2 = *ptr == REPLICATION_RECORD_ADD
+                                       ? num1 + strlen(num1) + 1 : NULL;
+        count++;
+        ptr += length;
+    }
+
+    if (follower.current == NULL) {
+        return (size_t) (ptr - begin);
+    }
+    size_t applied = phfwdApplyChanges(follower.current, follower.changes,
+                                       count);
+    if (applied == count) {
+        return (size_t) (ptr - begin);
+    }
+
+    *failed = true;
+    ptr = begin;
+    for (; applied > 0; applied--) {
+        ptr += replicationRecordLength(ptr, end, closed);
+    }
+    return (size_t) (ptr - begin);
+}
+
+/**
+ * @brief Stosuje paczkę odebranych rekordów.
+ * Po zastosowaniu rekordów z dziennika odsyła liderowi pozycję.
+ * @param[in, out] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in, out] current - wskaźnik na wskaźnik na aktywną bazę lub NULL.
+ * @param[out] closed - ustawiane na true, jeżeli połączenie należy zamknąć.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationFollowerApply(PhoneBases pb,
+                                     struct PhoneForward **current,
+                                     bool *closed) {
+    struct ReplicationConnection *connection = &follower.connection;
+    char *begin = vectorBegin(connection->input);
+    char *end = vectorEnd(connection->input);
+    char *ptr = begin;
+    bool appliedLog = false;
+    size_t length;
+
+    while (ptr < end
+           && (length = replicationRecordLength(ptr, end, closed)) > 0) {
+        bool fromLog = follower.bootstrapped;
+        if (replicationIsChange(ptr)) {
+            bool failed = false;
+            length = replicationApplyChanges(ptr, end, closed, &failed);
+            if (fromLog) {
+                follower.applied += length;
+                appliedLog = appliedLog || length > 0;
+            }
+            ptr += length;
+            if (failed) {
+                replicationConsume(connection->input, (size_t) (ptr - begin));
+                return false;
+            }
+            continue;
+        }
+        if (!replicationApplyRecord(ptr, pb, current)) {
+            replicationConsume(connection->input, (size_t) (ptr - begin));
+            return false;
+        }
+        if (fromLog) {
+            follower.applied += length;
+            appliedLog = true;
+        }
+        ptr += length;
+    }
+    replicationConsume(connection->input, (size_t) (ptr - begin));
+
+    if (appliedLog
+        && !replicationPushPosition(connection->output, follower.applied)) {
+        return false;
+    }
+    replicationFlush(connection, closed);
+    return true;
+}
+
+bool replicationFollowerStart(const char *socketPath, PhoneBases pb) {
+    struct sockaddr_un address;
+    if (!replicationSocketAddress(socketPath, &address)) {
+        return false;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) != 0
+        || !replicationConnectionInit(&follower.connection, fd)) {
+        close(fd);
+        return false;
+    }
+
+    bool closed = false;
+    while (!follower.bootstrapped && !closed) {
+        if (!replicationReceive(&follower.connection, true, &closed)
+            || !replicationFollowerApply(pb, NULL, &closed)) {
+            replicationStop();
+            return false;
+        }
+    }
+
+    if (!follower.bootstrapped || !replicationSetNonBlocking(fd, true)) {
+        replicationStop();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Obsługuje replikację po stronie naśladowcy.
+ * @param[in, out] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in, out] current - wskaźnik na wskaźnik na aktywną bazę.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool replicationFollowerPoll(PhoneBases pb,
+                                    struct PhoneForward **current) {
+    bool closed = false;
+    if (!replicationReceive(&follower.connection, false, &closed)
+        || !replicationFollowerApply(pb, current, &closed)) {
+        return false;
+    }
+
+    if (closed) {
+        fprintf(stderr, "REPLICATION leader disconnected at %llu, "
+                        "bases are read-only\n", follower.applied);
+        replicationConnectionClose(&follower.connection);
+        follower.current = NULL;
+    }
+    return true;
+}
+
+bool replicationPoll(PhoneBases pb, struct PhoneForward **current) {
+    if (leader.listenFd >= 0) {
+        return replicationLeaderPoll(pb);
+    } else if (follower.connection.fd >= 0) {
+        return replicationFollowerPoll(pb, current);
+    }
+    return true;
+}
+
+/**
+ * @brief Wpisuje deskryptor do tablicy, o ile jest w niej miejsce.
+ * @param[out] fds - tablica deskryptorów.
+ * @param[in] size - rozmiar tablicy @p fds.
+ * @param[in] count - liczba już wpisanych deskryptorów.
+ * @param[in] fd - deskryptor.
+ * @param[in] pending - czy są bajty oczekujące na wysłanie.
+ * @return Liczba deskryptorów po wpisaniu.
+ */
+static size_t replicationPutFd(struct pollfd *fds, size_t size, size_t count,
+                               int fd, bool pending) {
+    if (count < size) {
+        fds[count].fd = fd;
+        fds[count].events = (short) (POLLIN | (pending ? POLLOUT : 0));
+        fds[count].revents = 0;
+    }
+    return count + 1;
+}
+
+size_t replicationPollFds(struct pollfd *fds, size_t size) {
+    size_t count = 0;
+    if (leader.listenFd >= 0) {
+        count = replicationPutFd(fds, size, count, leader.listenFd, false);
+
+        struct ReplicationFollower *f;
+        for (f = leader.followers; f != NULL; f = f->next) {
+            bool pending = f->connection.outputSent
+                           < vectorSize(f->connection.output)
+                           || f->logPos < replicationLogEnd();
+            count = replicationPutFd(fds, size, count, f->connection.fd,
+                                     pending);
+        }
+    } else if (follower.connection.fd >= 0) {
+        bool pending = follower.connection.outputSent
+                       < vectorSize(follower.connection.output);
+        count = replicationPutFd(fds, size, count,
+                                 follower.connection.fd, pending);
+    }
+    return count;
+}
+
+void replicationStop() {
+    while (leader.followers != NULL) {
+        struct ReplicationFollower *f = leader.followers;
+        bool closed = !replicationSetNonBlocking(f->connection.fd, false);
+        if (!closed && replicationFlush(&f->connection, &closed)) {
+            size_t offset = (size_t) (f->logPos - leader.logStart);
+            replicationSend(f->connection.fd, vectorBegin(leader.log) + offset,
+                            vectorSize(leader.log) - offset, &closed);
+        }
+        leader.followers = f->next;
+        replicationConnectionClose(&f->connection);
+        free(f);
+    }
+
+    if (leader.listenFd >= 0) {
+        close(leader.listenFd);
+        leader.listenFd = -1;
+        unlink(leader.socketPath);
+    }
+    if (leader.log != NULL) {
+        vectorDelete(leader.log);
+        leader.log = NULL;
+    }
+    if (leader.currentId != NULL) {
+        vectorDelete(leader.currentId);
+        leader.currentId = NULL;
+    }
+
+    replicationConnectionClose(&follower.connection);
+    free(follower.changes);
+    follower.changes = NULL;
+    follower.changesCapacity = 0;
+}
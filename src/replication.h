@@ -0,0 +1,161 @@
+/** @file
+ * Interfejs modułu replikacji baz przekierowań.
+ * Proces lider (opcja --leader) zapisuje każdą wykonaną zmianę baz
+ * w dzienniku i przesyła go przez gniazdo uniksowe do procesów
+ * naśladowców (opcja --follow). Pozycją w dzienniku jest liczba bajtów
+ * dziennika zapisanych od uruchomienia lidera.
+ *
+ * Dziennik składa się z rekordów: jednoznakowy typ rekordu, po którym
+ * następują jego argumenty zakończone znakiem '\0'. Nowo podłączony
+ * naśladowca otrzymuje najpierw obraz baz (rekordy nieliczone do pozycji)
+ * zakończony rekordem REPLICATION_RECORD_POSITION z pozycją, od której
+ * zaczyna się przesyłana dalej końcówka dziennika. Naśladowca stosuje
+ * rekordy paczkami i po każdej paczce odsyła liderowi rekord
+ * REPLICATION_RECORD_POSITION z pozycją ostatniego zastosowanego rekordu.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_REPLICATION_H
+#define TELEFONY_REPLICATION_H
+
+#include <poll.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "phone_bases_system.h"
+
+/**
+ * @brief Typ rekordu: utworzenie lub wybranie bazy (identyfikator).
+ */
+#define REPLICATION_RECORD_NEW 'N'
+
+/**
+ * @brief Typ rekordu: usunięcie bazy (identyfikator).
+ */
+#define REPLICATION_RECORD_DEL_BASE 'B'
+
+/**
+ * @brief Typ rekordu: dodanie przekierowania (num1, num2).
+ */
+#define REPLICATION_RECORD_ADD 'A'
+
+/**
+ * @brief Typ rekordu: usunięcie przekierowań z prefiksem (prefiks).
+ */
+#define REPLICATION_RECORD_REMOVE 'R'
+
+/**
+ * @brief Typ rekordu: pozycja w dzienniku (liczba dziesiętna).
+ */
+#define REPLICATION_RECORD_POSITION 'P'
+
+/**
+ * @brief Rozmiar bufora używanego przy odczycie z gniazda.
+ */
+#define REPLICATION_READ_BUFFER_SIZE 4096
+
+/**
+ * @brief Uruchamia proces w trybie lidera.
+ * Tworzy gniazdo uniksowe @p socketPath, na którym przyjmowani są
+ * naśladowcy.
+ * @param[in] socketPath - ścieżka gniazda.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+bool replicationLeaderStart(const char *socketPath);
+
+/**
+ * @brief Uruchamia proces w trybie naśladowcy.
+ * Łączy się z liderem przez gniazdo @p socketPath i czeka na otrzymanie
+ * pełnego obrazu baz, który zostaje zastosowany do @p pb.
+ * @param[in] socketPath - ścieżka gniazda lidera.
+ * @param[in, out] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+bool replicationFollowerStart(const char *socketPath, PhoneBases pb);
+
+/**
+ * @brief Sprawdza, czy proces jest naśladowcą.
+ * Proces pozostaje naśladowcą także po utracie połączenia z liderem,
+ * więc jego bazy nie mogą już być zmieniane i nie rozejdą się z bazami
+ * lidera.
+ * @return true jeżeli proces działa w trybie naśladowcy, false
+ *         w przeciwnym przypadku.
+ */
+bool replicationIsFollower();
+
+/**
+ * @brief Zapisuje w dzienniku utworzenie lub wybranie bazy.
+ * Nic nie robi, jeżeli proces nie jest liderem.
+ * @param[in] id - identyfikator bazy.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool replicationLogNew(const char *id);
+
+/**
+ * @brief Zapisuje w dzienniku usunięcie bazy.
+ * Nic nie robi, jeżeli proces nie jest liderem.
+ * @param[in] id - identyfikator bazy.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool replicationLogDelBase(const char *id);
+
+/**
+ * @brief Zapisuje w dzienniku dodanie przekierowania w wybranej bazie.
+ * Nic nie robi, jeżeli proces nie jest liderem.
+ * @param[in] num1 - prefiks numerów przekierowywanych.
+ * @param[in] num2 - prefiks numerów, na które jest wykonywane przekierowanie.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool replicationLogAdd(const char *num1, const char *num2);
+
+/**
+ * @brief Zapisuje w dzienniku usunięcie przekierowań w wybranej bazie.
+ * Nic nie robi, jeżeli proces nie jest liderem.
+ * @param[in] num - prefiks numerów.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool replicationLogRemove(const char *num);
+
+/**
+ * @brief Obsługuje replikację bez blokowania.
+ * Lider przyjmuje nowych naśladowców (wysyłając im obraz baz @p pb),
+ * odbiera ich pozycje i przesyła im końcówkę dziennika.
+ * Naśladowca odbiera dostępne rekordy, stosuje je paczką do @p pb
+ * i odsyła pozycję. Jeżeli usuwana jest baza wskazywana przez @p current,
+ * to *current jest ustawiane na NULL.
+ * @param[in, out] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in, out] current - wskaźnik na wskaźnik na aktywną bazę.
+ * @return false w przypadku problemów z pamięcią, true w przeciwnym
+ *         przypadku.
+ */
+bool replicationPoll(PhoneBases pb, struct PhoneForward **current);
+
+/**
+ * @brief Podaje deskryptory, na których replikacja oczekuje zdarzeń.
+ * Pozwala czekać funkcją poll na zdarzenia replikacji razem z innymi
+ * deskryptorami, dzięki czemu bezczynny lider przyjmuje naśladowców
+ * i wysyła im dziennik, a naśladowca stosuje rekordy bez względu
+ * na to, czy na jego standardowym wejściu pojawiają się dane.
+ * Po zgłoszeniu zdarzenia na którymkolwiek z nich należy wywołać
+ * @ref replicationPoll.
+ * #### Złożoność
+ * O(f), gdzie f to liczba naśladowców.
+ * @param[out] fds - tablica, do której zostaną wpisane deskryptory
+ *        wraz z oczekiwanymi zdarzeniami.
+ * @param[in] size - rozmiar tablicy @p fds.
+ * @return Liczba deskryptorów replikacji. Jeżeli jest większa od @p size,
+ *         to wpisane zostało tylko pierwszych @p size z nich.
+ */
+size_t replicationPollFds(struct pollfd *fds, size_t size);
+
+/**
+ * @brief Kończy replikację.
+ * Lider przed zamknięciem połączeń przesyła naśladowcom cały dziennik
+ * i usuwa gniazdo.
+ */
+void replicationStop();
+
+#endif //TELEFONY_REPLICATION_H
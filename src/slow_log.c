@@ -0,0 +1,225 @@
+/** @file
+ * Implementacja dziennika wolnych operacji.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "slow_log.h"
+#include "operation.h"
+
+/**
+ * @brief Stan dziennika wolnych operacji.
+ */
+struct SlowLogState {
+    /**
+     * @brief Czy dziennik jest uruchomiony.
+     */
+    bool running;
+
+    /**
+     * @brief Plik dziennika.
+     */
+    FILE *out;
+
+    /**
+     * @brief Bufor cykliczny opisów (SLOW_LOG_CAPACITY elementów).
+     */
+    struct SlowLogRecord *records;
+
+    /**
+     * @brief Indeks najstarszego opisu w buforze.
+     */
+    size_t head;
+
+    /**
+     * @brief Liczba opisów w buforze.
+     */
+    size_t count;
+
+    /**
+     * @brief Liczba odrzuconych opisów.
+     */
+    size_t dropped;
+
+    /**
+     * @brief Czy wątek zapisujący ma się zakończyć po opróżnieniu bufora.
+     */
+    bool stopping;
+
+    /**
+     * @brief Czy zapis do pliku się nie powiódł.
+     */
+    bool failed;
+
+    /**
+     * @brief Muteks chroniący bufor.
+     */
+    pthread_mutex_t mutex;
+
+    /**
+     * @brief Zmienna warunkowa sygnalizująca nowe opisy i zatrzymanie.
+     */
+    pthread_cond_t recordAvailable;
+
+    /**
+     * @brief Wątek zapisujący.
+     */
+    pthread_t thread;
+};
+
+/**
+ * @brief Stan dziennika.
+ */
+static struct SlowLogState state = {false, NULL, NULL, 0, 0, 0, false, false,
+                                    PTHREAD_MUTEX_INITIALIZER,
+                                    PTHREAD_COND_INITIALIZER, 0};
+
+/**
+ * @brief Zapisuje opis operacji w pliku dziennika.
+ * @param[in] record - wskaźnik na opis operacji.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+static bool slowLogWrite(const struct SlowLogRecord *record) {
+    if (fprintf(state.out, "SLOW offset=%zu operator=%zu op=%s base=%s "
+                           "arg1_len=%zu arg2_len=%zu results=%zu "
+                           "total_ns=%llu",
+                record->offset, record->operatorPos,
+                operationName(record->type), record->base,
+                record->arg1Length, record->arg2Length, record->resultSize,
+                (unsigned long long) record->duration) < 0) {
+        return false;
+    }
+    if (record->hasPhases
+        && fprintf(state.out, " descent_ns=%llu climb_ns=%llu build_ns=%llu "
+                              "sort_ns=%llu",
+                   (unsigned long long) record->descentTime,
+                   (unsigned long long) record->climbTime,
+                   (unsigned long long) record->buildTime,
+                   (unsigned long long) record->sortTime) < 0) {
+        return false;
+    }
+    return fprintf(state.out, " output_ns=%llu\n",
+                   (unsigned long long) record->outputTime) >= 0;
+}
+
+/**
+ * @brief Pętla wątku zapisującego.
+ * Pobiera opisy z bufora i zapisuje je poza muteksem. Plik jest opróżniany,
+ * gdy bufor staje się pusty, dzięki czemu wpisy pojawiają się w pliku
+ * na bieżąco.
+ * @param[in] arg - nieużywane.
+ * @return NULL.
+ */
+static void *slowLogWriter(void *arg) {
+    (void) arg;
+
+    pthread_mutex_lock(&state.mutex);
+    while (true) {
+        while (state.count == 0 && !state.stopping) {
+            pthread_cond_wait(&state.recordAvailable, &state.mutex);
+        }
+        if (state.count == 0) {
+            break;
+        }
+
+        struct SlowLogRecord record = state.records[state.head];
+        state.head = (state.head + 1) % SLOW_LOG_CAPACITY;
+        state.count--;
+        bool empty = state.count == 0;
+        pthread_mutex_unlock(&state.mutex);
+
+        bool written = slowLogWrite(&record)
+                       && (!empty || fflush(state.out) == 0);
+
+        pthread_mutex_lock(&state.mutex);
+        if (!written) {
+            state.failed = true;
+        }
+    }
+    pthread_mutex_unlock(&state.mutex);
+
+    return NULL;
+}
+
+bool slowLogStart(const char *path) {
+    if (state.running) {
+        return false;
+    }
+
+    state.records = malloc(sizeof(struct SlowLogRecord) * SLOW_LOG_CAPACITY);
+    state.out = state.records == NULL ? NULL : fopen(path, "w");
+    if (state.out == NULL) {
+        free(state.records);
+        state.records = NULL;
+        return false;
+    }
+
+    state.head = 0;
+    state.count = 0;
+    state.dropped = 0;
+    state.stopping = false;
+    state.failed = false;
+    if (pthread_create(&state.thread, NULL, slowLogWriter, NULL) != 0) {
+        fclose(state.out);
+        free(state.records);
+        state.out = NULL;
+        state.records = NULL;
+        return false;
+    }
+
+    state.running = true;
+    return true;
+}
+
+bool slowLogPush(const struct SlowLogRecord *record) {
+    if (!state.running) {
+        return false;
+    }
+
+    bool result = false;
+    pthread_mutex_lock(&state.mutex);
+    if (state.count < SLOW_LOG_CAPACITY) {
+        state.records[(state.head + state.count) % SLOW_LOG_CAPACITY] = *record;
+        state.count++;
+        result = true;
+        pthread_cond_signal(&state.recordAvailable);
+    } else {
+        state.dropped++;
+    }
+    pthread_mutex_unlock(&state.mutex);
+
+    return result;
+}
+
+bool slowLogStop(void) {
+    if (!state.running) {
+        return true;
+    }
+
+    pthread_mutex_lock(&state.mutex);
+    state.stopping = true;
+    pthread_cond_signal(&state.recordAvailable);
+    pthread_mutex_unlock(&state.mutex);
+    pthread_join(state.thread, NULL);
+
+    bool result = !state.failed;
+    if (state.dropped > 0
+        && fprintf(state.out, "SLOW dropped=%zu\n", state.dropped) < 0) {
+        result = false;
+    }
+    if (fclose(state.out) != 0) {
+        result = false;
+    }
+
+    free(state.records);
+    state.out = NULL;
+    state.records = NULL;
+    state.running = false;
+    return result;
+}
@@ -0,0 +1,145 @@
+/** @file
+ * Interfejs dziennika wolnych operacji.
+ * Wątek główny przekazuje opisy operacji, których wykonanie przekroczyło
+ * próg, do ograniczonego bufora cyklicznego, a osobny wątek formatuje je
+ * i zapisuje do pliku, dzięki czemu zgłoszenie operacji nie czeka na
+ * zapis. Gdy bufor jest pełny, opis jest odrzucany, a liczba odrzuconych
+ * opisów trafia do dziennika przy zatrzymaniu.
+ * Każda operacja zajmuje jeden wiersz postaci
+ * SLOW offset=.. operator=.. op=.. base=.. arg1_len=.. arg2_len=..
+ * results=.. total_ns=.. descent_ns=.. climb_ns=.. build_ns=.. sort_ns=..
+ * output_ns=..
+ * Czasy faz zapytania (descent_ns, climb_ns, build_ns, sort_ns) są
+ * zapisywane tylko dla operacji ?, @ i EXPLAIN.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_SLOW_LOG_H
+#define TELEFONY_SLOW_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Liczba opisów mieszczących się w buforze.
+ */
+#define SLOW_LOG_CAPACITY 1024
+
+/**
+ * @brief Maksymalna długość zapisywanego identyfikatora bazy.
+ * Dłuższe identyfikatory są obcinane.
+ */
+#define SLOW_LOG_BASE_LENGTH 63
+
+/**
+ * @brief Domyślny próg czasu wykonania w mikrosekundach.
+ */
+#define SLOW_LOG_DEFAULT_THRESHOLD 1000
+
+/**
+ * @brief Opis wolnej operacji.
+ */
+struct SlowLogRecord {
+    /**
+     * @brief Rodzaj operacji (OPERATION_*).
+     */
+    int type;
+
+    /**
+     * @brief Liczba bajtów wejścia wczytanych po zakończeniu operacji.
+     */
+    size_t offset;
+
+    /**
+     * @brief Pozycja operatora.
+     */
+    size_t operatorPos;
+
+    /**
+     * @brief Identyfikator aktywnej bazy lub "-" w przypadku braku.
+     */
+    char base[SLOW_LOG_BASE_LENGTH + 1];
+
+    /**
+     * @brief Długość pierwszego argumentu.
+     */
+    size_t arg1Length;
+
+    /**
+     * @brief Długość drugiego argumentu.
+     */
+    size_t arg2Length;
+
+    /**
+     * @brief Rozmiar wyniku (liczba wypisanych wierszy).
+     */
+    size_t resultSize;
+
+    /**
+     * @brief Czas wykonania w nanosekundach.
+     */
+    uint64_t duration;
+
+    /**
+     * @brief Czy zapisano czasy faz zapytania.
+     */
+    bool hasPhases;
+
+    /**
+     * @brief Czas schodzenia w drzewie w nanosekundach.
+     */
+    uint64_t descentTime;
+
+    /**
+     * @brief Czas wspinania się do przekierowań w nanosekundach.
+     */
+    uint64_t climbTime;
+
+    /**
+     * @brief Czas budowania numerów wyniku w nanosekundach.
+     */
+    uint64_t buildTime;
+
+    /**
+     * @brief Czas sortowania wyniku w nanosekundach.
+     */
+    uint64_t sortTime;
+
+    /**
+     * @brief Czas od wypisania pierwszego wiersza wyniku do zakończenia
+     * w nanosekundach.
+     */
+    uint64_t outputTime;
+};
+
+/**
+ * @brief Otwiera plik dziennika i uruchamia wątek zapisujący.
+ * @param[in] path - ścieżka pliku dziennika.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+bool slowLogStart(const char *path);
+
+/**
+ * @brief Przekazuje opis operacji do zapisania.
+ * Nie czeka na zapis. Nic nie robi, jeśli dziennik nie jest uruchomiony.
+ * #### Złożoność
+ * O(1)
+ * @param[in] record - wskaźnik na opis operacji.
+ * @return true jeżeli opis trafił do bufora, false jeżeli został
+ *         odrzucony lub dziennik nie jest uruchomiony.
+ */
+bool slowLogPush(const struct SlowLogRecord *record);
+
+/**
+ * @brief Zapisuje pozostałe opisy, zatrzymuje wątek i zamyka plik.
+ * Nic nie robi, jeśli dziennik nie jest uruchomiony.
+ * @return false jeżeli zapis do pliku się nie powiódł, true w przeciwnym
+ *         przypadku.
+ */
+bool slowLogStop(void);
+
+#endif //TELEFONY_SLOW_LOG_H
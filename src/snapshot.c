@@ -0,0 +1,459 @@
+/** @file
+ * Implementacja modułu zapisującego migawki baz przekierowań.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "snapshot.h"
+#include "text.h"
+
+/**
+ * @brief Liczba nanosekund w sekundzie.
+ */
+#define SNAPSHOT_NSEC_IN_SEC 1000000000LL
+
+/**
+ * @brief Raport przekazywany przez proces zapisujący migawkę.
+ */
+struct SnapshotReport {
+    /**
+     * @brief Czy zapis się powiódł.
+     */
+    bool success;
+
+    /**
+     * @brief Czas zapisu w nanosekundach.
+     */
+    long long durationNs;
+};
+
+/**
+ * @brief Opis zapisywanej migawki.
+ */
+struct SnapshotJob {
+    /**
+     * @brief Czy zapisywana jest pełna migawka (w przeciwnym wypadku warstwa).
+     */
+    bool full;
+
+    /**
+     * @brief Pokolenie migawki.
+     */
+    unsigned long generation;
+
+    /**
+     * @brief Numer zapisywanej warstwy (0 dla pełnej migawki).
+     */
+    unsigned layer;
+
+    /**
+     * @brief Pokolenie poprzedniej pełnej migawki.
+     */
+    unsigned long oldGeneration;
+
+    /**
+     * @brief Liczba warstw poprzedniego pokolenia do usunięcia po zapisie
+     * pełnej migawki.
+     */
+    unsigned oldLayers;
+};
+
+/**
+ * @brief Stan zapisywanej migawki.
+ */
+struct SnapshotState {
+    /**
+     * @brief Identyfikator procesu zapisującego, 0 gdy żaden nie działa.
+     */
+    pid_t pid;
+
+    /**
+     * @brief Deskryptor końca łącza, którym przychodzi raport.
+     */
+    int reportFd;
+
+    /**
+     * @brief Czas wstrzymania procesu głównego przez fork (w nanosekundach).
+     */
+    long long forkNs;
+
+    /**
+     * @brief Liczba drobnych błędów stron procesu głównego w chwili
+     * utworzenia procesu zapisującego.
+     */
+    long minorFaultsAtStart;
+
+    /**
+     * @brief Opis zapisywanej migawki.
+     */
+    struct SnapshotJob job;
+
+    /**
+     * @brief Pokolenie ostatniej zapisanej pełnej migawki.
+     */
+    unsigned long generation;
+
+    /**
+     * @brief Liczba warstw zapisanych na ostatniej pełnej migawce.
+     */
+    unsigned layers;
+
+    /**
+     * @brief Czy następna migawka musi być pełna.
+     */
+    bool needsConsolidation;
+};
+
+/**
+ * @brief Stan zapisywanej migawki.
+ */
+static struct SnapshotState state = {0, -1, 0, 0, {false, 0, 0, 0, 0},
+                                     0, 0, true};
+
+/**
+ * @return Aktualny czas monotoniczny w nanosekundach.
+ */
+static long long snapshotNow() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long) ts.tv_sec * SNAPSHOT_NSEC_IN_SEC + ts.tv_nsec;
+}
+
+/**
+ * @return Liczba drobnych błędów stron (m.in. kopii copy-on-write)
+ *         wywołanego procesu.
+ */
+static long snapshotMinorFaults() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_minflt;
+}
+
+/**
+ * @brief Zapisuje przekierowanie.
+ * @see phfwdForEach
+ * @param[in] num1 - numer przekierowywany.
+ * @param[in] num2 - numer na który następuje przekierowanie.
+ * @param[in, out] out - strumień wyjściowy.
+ * @return true w przypadku udanego zapisu, false w przeciwnym przypadku.
+ */
+static bool snapshotWriteRedirection(const char *num1, const char *num2,
+                                     void *out) {
+    return fprintf((FILE *) out, "%s>%s\n", num1, num2) >= 0;
+}
+
+/**
+ * @brief Zapisuje bazę przekierowań.
+ * @see phoneBasesForEach
+ * @param[in] id - identyfikator bazy.
+ * @param[in] base - wskaźnik na bazę.
+ * @param[in, out] out - strumień wyjściowy.
+ * @return true w przypadku udanego zapisu, false w przeciwnym przypadku.
+ */
+static bool snapshotWriteBase(const char *id, struct PhoneForward *base,
+                              void *out) {
+    return fprintf((FILE *) out, "NEW %s\n", id) >= 0
+           && phfwdForEach(base, snapshotWriteRedirection, out);
+}
+
+bool snapshotWrite(PhoneBases pb, FILE *out, unsigned long generation) {
+    return fprintf(out, SNAPSHOT_HEADER "\n", generation) >= 0
+           && phoneBasesForEach(pb, snapshotWriteBase, out);
+}
+
+/**
+ * @brief Zapisuje polecenie usunięcia (bazy lub przekierowań z prefiksem).
+ * @see phoneBasesForEachChange
+ * @see phfwdForEachChange
+ * @param[in] idOrPrefix - identyfikator bazy lub prefiks numerów.
+ * @param[in, out] out - strumień wyjściowy.
+ * @return true w przypadku udanego zapisu, false w przeciwnym przypadku.
+ */
+static bool snapshotWriteRemoved(const char *idOrPrefix, void *out) {
+    return fprintf((FILE *) out, "DEL %s\n", idOrPrefix) >= 0;
+}
+
+/**
+ * @brief Zapisuje zmiany w bazie przekierowań.
+ * @see phoneBasesForEachChange
+ * @param[in] id - identyfikator bazy.
+ * @param[in] base - wskaźnik na bazę.
+ * @param[in] isNew - czy baza jest nowa (należy zapisać ją całą).
+ * @param[in, out] out - strumień wyjściowy.
+ * @return true w przypadku udanego zapisu, false w przeciwnym przypadku.
+ */
+static bool snapshotWriteChangedBase(const char *id, struct PhoneForward *base,
+                                     bool isNew, void *out) {
+    if (isNew) {
+        return snapshotWriteBase(id, base, out);
+    } else {
+        return fprintf((FILE *) out, "NEW %s\n", id) >= 0
+               && phfwdForEachChange(base, snapshotWriteRemoved,
+                                     snapshotWriteRedirection, out);
+    }
+}
+
+bool snapshotWriteChanges(PhoneBases pb, FILE *out,
+                          unsigned long generation, unsigned layer) {
+    return fprintf(out, SNAPSHOT_LAYER_HEADER "\n", generation, layer) >= 0
+           && phoneBasesForEachChange(pb, snapshotWriteRemoved,
+                                      snapshotWriteChangedBase, out);
+}
+
+/**
+ * @brief Tworzy nazwę pliku z warstwą.
+ * @remarks Wynik musi zostać zwolniony przy pomocy free.
+ * @param[in] path - ścieżka do pliku z pełną migawką.
+ * @param[in] generation - pokolenie.
+ * @param[in] layer - numer warstwy.
+ * @return Wskaźnik na nazwę pliku, NULL w przypadku problemów z pamięcią.
+ */
+static char *snapshotLayerPath(const char *path, unsigned long generation,
+                               unsigned layer) {
+    int length = snprintf(NULL, 0, SNAPSHOT_LAYER_PATH, path, generation,
+                          layer);
+    if (length < 0) {
+        return NULL;
+    }
+
+    char *result = malloc((size_t) length + 1);
+    if (result != NULL) {
+        snprintf(result, (size_t) length + 1, SNAPSHOT_LAYER_PATH, path,
+                 generation, layer);
+    }
+    return result;
+}
+
+/**
+ * @brief Zapisuje migawkę do pliku.
+ * Zapisuje do pliku tymczasowego, a po udanym zapisie przemianowuje go
+ * na @p path, tak aby pod @p path zawsze znajdowała się kompletna migawka.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in] path - ścieżka do pliku docelowego.
+ * @param[in] job - opis zapisywanej migawki.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+static bool snapshotWriteFile(PhoneBases pb, const char *path,
+                              const struct SnapshotJob *job) {
+    char *tmpPath = concatenate(path, SNAPSHOT_TMP_SUFFIX);
+    if (tmpPath == NULL) {
+        return false;
+    }
+
+    bool result = false;
+    FILE *out = fopen(tmpPath, "w");
+    if (out != NULL) {
+        if (job->full) {
+            result = snapshotWrite(pb, out, job->generation);
+        } else {
+            result = snapshotWriteChanges(pb, out, job->generation,
+                                          job->layer);
+        }
+        result = result
+                 && fflush(out) == 0
+                 && fsync(fileno(out)) == 0;
+        result = (fclose(out) == 0) && result;
+        result = result && rename(tmpPath, path) == 0;
+        if (!result) {
+            remove(tmpPath);
+        }
+    }
+
+    free(tmpPath);
+    return result;
+}
+
+/**
+ * @brief Zapisuje migawkę opisaną przez @p job.
+ * Po zapisaniu pełnej migawki usuwa warstwy poprzedniego pokolenia.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in] path - ścieżka do pliku z pełną migawką.
+ * @param[in] job - opis zapisywanej migawki.
+ * @return true w przypadku sukcesu, false w przeciwnym przypadku.
+ */
+static bool snapshotWriteJob(PhoneBases pb, const char *path,
+                             const struct SnapshotJob *job) {
+    if (job->full) {
+        if (!snapshotWriteFile(pb, path, job)) {
+            return false;
+        }
+
+        unsigned i;
+        for (i = 1; i <= job->oldLayers; i++) {
+            char *layerPath = snapshotLayerPath(path, job->oldGeneration, i);
+            if (layerPath != NULL) {
+                remove(layerPath);
+                free(layerPath);
+            }
+        }
+        return true;
+    } else {
+        char *layerPath = snapshotLayerPath(path, job->generation, job->layer);
+        if (layerPath == NULL) {
+            return false;
+        }
+        bool result = snapshotWriteFile(pb, layerPath, job);
+        free(layerPath);
+        return result;
+    }
+}
+
+/**
+ * @brief Kod wykonywany przez proces zapisujący migawkę.
+ * Nie wraca.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in] path - ścieżka do pliku z pełną migawką.
+ * @param[in] job - opis zapisywanej migawki.
+ * @param[in] reportFd - deskryptor, do którego zostanie wysłany raport.
+ */
+static void snapshotChild(PhoneBases pb, const char *path,
+                          const struct SnapshotJob *job, int reportFd) {
+    struct SnapshotReport report;
+    long long start = snapshotNow();
+
+    report.success = snapshotWriteJob(pb, path, job);
+    report.durationNs = snapshotNow() - start;
+
+    ssize_t written = write(reportFd, &report, sizeof(report));
+    close(reportFd);
+
+    _exit(report.success && written == (ssize_t) sizeof(report) ? 0 : 1);
+}
+
+/**
+ * @brief Ustala jaka migawka zostanie zapisana.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[out] job - opis migawki.
+ */
+static void snapshotPlanJob(PhoneBases pb, struct SnapshotJob *job) {
+    job->full = state.needsConsolidation
+                || state.layers >= SNAPSHOT_LAYERS_LIMIT
+                || !phoneBasesChangesComplete(pb);
+    job->oldGeneration = state.generation;
+    job->oldLayers = state.layers;
+
+    if (job->full) {
+        unsigned long now = (unsigned long) time(NULL);
+        job->generation = now > state.generation ? now : state.generation + 1;
+        job->layer = 0;
+    } else {
+        job->generation = state.generation;
+        job->layer = state.layers + 1;
+    }
+}
+
+bool snapshotStart(PhoneBases pb, const char *path) {
+    snapshotPoll(false);
+    if (snapshotInProgress()) {
+        return false;
+    }
+
+    struct SnapshotJob job;
+    snapshotPlanJob(pb, &job);
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+
+    long minorFaults = snapshotMinorFaults();
+    long long start = snapshotNow();
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    } else if (pid == 0) {
+        close(fds[0]);
+        snapshotChild(pb, path, &job, fds[1]);
+        return false;
+    } else {
+        state.forkNs = snapshotNow() - start;
+        close(fds[1]);
+        phoneBasesClearChanges(pb);
+        state.pid = pid;
+        state.reportFd = fds[0];
+        state.minorFaultsAtStart = minorFaults;
+        state.job = job;
+        return true;
+    }
+}
+
+void snapshotPoll(bool wait) {
+    if (state.pid == 0) {
+        return;
+    }
+
+    int status;
+    pid_t result;
+    while ((result = waitpid(state.pid, &status, wait ? 0 : WNOHANG)) < 0
+           && errno == EINTR) {
+        continue;
+    }
+    if (result != state.pid) {
+        return;
+    }
+
+    struct SnapshotReport report;
+    report.success = false;
+    report.durationNs = 0;
+    if (read(state.reportFd, &report, sizeof(report))
+        != (ssize_t) sizeof(report)) {
+        report.success = false;
+    }
+    close(state.reportFd);
+
+    bool success = report.success
+                   && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+
+    long copiedPages = snapshotMinorFaults() - state.minorFaultsAtStart;
+    long pageSize = sysconf(_SC_PAGESIZE);
+
+    if (!success) {
+        state.needsConsolidation = true;
+    } else if (state.job.full) {
+        state.generation = state.job.generation;
+        state.layers = 0;
+        state.needsConsolidation = false;
+    } else {
+        state.layers = state.job.layer;
+    }
+
+    fprintf(stderr, "SNAPSHOT %s %s %lld ms, fork %lld us, "
+                    "%ld pages (%ld KiB) copied\n",
+            state.job.full ? "FULL" : "LAYER",
+            success ? "OK" : "FAIL",
+            report.durationNs / (SNAPSHOT_NSEC_IN_SEC / 1000),
+            state.forkNs / 1000,
+            copiedPages,
+            copiedPages * (pageSize / 1024));
+
+    state.pid = 0;
+    state.reportFd = -1;
+}
+
+bool snapshotInProgress() {
+    return state.pid != 0;
+}
+
+int snapshotFd() {
+    return state.pid != 0 ? state.reportFd : -1;
+}
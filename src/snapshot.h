@@ -0,0 +1,126 @@
+/** @file
+ * Interfejs modułu zapisującego migawki baz przekierowań.
+ * Migawka jest ciągiem poleceń w języku programu, więc można ją
+ * odtworzyć przekazując ją programowi na standardowe wejście.
+ * Zapis odbywa się w procesie potomnym (fork), który korzysta
+ * ze stron pamięci współdzielonych w trybie copy-on-write,
+ * dzięki czemu proces główny nie wstrzymuje obsługi poleceń.
+ *
+ * Pierwsza migawka jest pełna i trafia do pliku PLIK. Kolejne są
+ * przyrostowe (warstwy) - zawierają jedynie zmienione poddrzewa
+ * i trafiają do plików PLIK.POKOLENIE.NNNN, gdzie POKOLENIE jest zapisane
+ * w nagłówku pełnej migawki, a NNNN to numer warstwy. Co
+ * SNAPSHOT_LAYERS_LIMIT warstw zapisywana jest ponownie pełna migawka,
+ * a warstwy poprzedniego pokolenia są usuwane. Stan odtwarza polecenie
+ * cat PLIK PLIK.POKOLENIE.* | phone_forward
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_SNAPSHOT_H
+#define TELEFONY_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "phone_bases_system.h"
+
+/**
+ * @brief Format komentarza rozpoczynającego plik z pełną migawką.
+ */
+#define SNAPSHOT_HEADER "$$ phone_forward snapshot generation %lu $$"
+
+/**
+ * @brief Format komentarza rozpoczynającego plik z warstwą.
+ */
+#define SNAPSHOT_LAYER_HEADER \
+    "$$ phone_forward checkpoint generation %lu layer %u $$"
+
+/**
+ * @brief Format nazwy pliku z warstwą (plik, pokolenie, numer warstwy).
+ */
+#define SNAPSHOT_LAYER_PATH "%s.%lu.%04u"
+
+/**
+ * @brief Liczba warstw, po której zapisywana jest pełna migawka.
+ */
+#define SNAPSHOT_LAYERS_LIMIT 16
+
+/**
+ * @brief Sufiks pliku tymczasowego, do którego zapisywana jest migawka.
+ * Po udanym zapisie plik tymczasowy zostaje przemianowany na docelowy.
+ */
+#define SNAPSHOT_TMP_SUFFIX ".tmp"
+
+/**
+ * @brief Zapisuje bazy przekierowań w postaci poleceń programu.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] generation - pokolenie zapisywane w nagłówku.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią
+ *         lub zapisem.
+ */
+bool snapshotWrite(PhoneBases pb, FILE *out, unsigned long generation);
+
+/**
+ * @brief Zapisuje zmiany baz przekierowań w postaci poleceń programu.
+ * Zapisuje zmiany od ostatniego wywołania @ref phoneBasesClearChanges.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] generation - pokolenie zapisywane w nagłówku.
+ * @param[in] layer - numer warstwy zapisywany w nagłówku.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią
+ *         lub zapisem.
+ */
+bool snapshotWriteChanges(PhoneBases pb, FILE *out,
+                          unsigned long generation, unsigned layer);
+
+/**
+ * @brief Rozpoczyna zapis migawki w tle.
+ * Tworzy proces potomny, który zapisuje bazy @p pb do pliku @p path
+ * (pełna migawka) lub zmiany do kolejnej warstwy. Pełna migawka jest
+ * zapisywana, gdy nie ma jeszcze poprzedniej, gdy zapis poprzedniej się nie
+ * udał, gdy nie wszystkie zmiany zostały zapamiętane lub gdy liczba warstw
+ * osiągnęła SNAPSHOT_LAYERS_LIMIT. Po utworzeniu procesu zmiany w @p pb
+ * zostają zapomniane.
+ * Nie czeka na zakończenie zapisu poprzedniej migawki - jeżeli jest ona
+ * jeszcze zapisywana, to nie rozpoczyna nowego zapisu, a zmiany w @p pb
+ * trafią do następnej migawki.
+ * @param[in] pb - wskaźnik na strukturę przechowującą bazy przekierowań.
+ * @param[in] path - ścieżka do pliku docelowego.
+ * @return true jeżeli udało się uruchomić zapis, false w przeciwnym przypadku
+ *         (także gdy poprzednia migawka jest jeszcze zapisywana).
+ */
+bool snapshotStart(PhoneBases pb, const char *path);
+
+/**
+ * @brief Sprawdza stan zapisywanej migawki.
+ * Jeżeli proces zapisujący migawkę zakończył działanie, to wypisuje
+ * na standardowe wyjście błędów raport zawierający czas zapisu,
+ * czas wstrzymania procesu głównego przez fork oraz szacowaną liczbę
+ * stron pamięci skopiowanych przez mechanizm copy-on-write.
+ * Oczekiwanie przerwane sygnałem jest wznawiane. Migawka jest uznawana
+ * za zakończoną tylko po odebraniu stanu procesu zapisującego, więc błąd
+ * waitpid nie gubi procesu, który może jeszcze zapisywać.
+ * @param[in] wait - czy czekać na zakończenie zapisu.
+ */
+void snapshotPoll(bool wait);
+
+/**
+ * @return true jeżeli migawka jest w trakcie zapisu, false w przeciwnym
+ *         przypadku.
+ */
+bool snapshotInProgress();
+
+/**
+ * @brief Podaje deskryptor, na którym można czekać na koniec zapisu migawki.
+ * Deskryptor staje się gotowy do odczytu, gdy proces zapisujący migawkę
+ * przesłał raport lub zakończył działanie - wtedy należy wywołać
+ * @ref snapshotPoll.
+ * @return Deskryptor lub -1, jeżeli żadna migawka nie jest zapisywana.
+ */
+int snapshotFd();
+
+#endif //TELEFONY_SNAPSHOT_H
@@ -0,0 +1,568 @@
+/** @file
+ * Implementacja parsera strumieniowego.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stream_parser.h"
+#include "character.h"
+#include "probes.h"
+
+/**
+ * @brief Oczekiwanie na początek operacji.
+ */
+#define STREAM_PARSER_STATE_START 0
+
+/**
+ * @brief Po operatorze przekierowania na początku operacji.
+ */
+#define STREAM_PARSER_STATE_START_REDIRECT 1
+
+/**
+ * @brief Wczytywanie słowa kluczowego.
+ */
+#define STREAM_PARSER_STATE_KEYWORD 2
+
+/**
+ * @brief Oczekiwanie na identyfikator po PARSER_OPERATOR_NEW.
+ */
+#define STREAM_PARSER_STATE_NEW_ARGUMENT 3
+
+/**
+ * @brief Oczekiwanie na argument PARSER_OPERATOR_DELETE.
+ */
+#define STREAM_PARSER_STATE_DELETE_ARGUMENT 4
+
+/**
+ * @brief Oczekiwanie na numer po operatorze ?, @ lub PARSER_OPERATOR_TOP.
+ */
+#define STREAM_PARSER_STATE_PREFIXED_ARGUMENT 5
+
+/**
+ * @brief Oczekiwanie na numer po operatorze przekierowania.
+ */
+#define STREAM_PARSER_STATE_REDIRECT_ARGUMENT 6
+
+/**
+ * @brief Wczytywanie numeru rozpoczynającego operację.
+ */
+#define STREAM_PARSER_STATE_FIRST_NUMBER 7
+
+/**
+ * @brief Oczekiwanie na operator po numerze rozpoczynającym operację.
+ */
+#define STREAM_PARSER_STATE_OPERATOR 8
+
+/**
+ * @brief Wczytywanie numeru będącego ostatnim argumentem operacji.
+ */
+#define STREAM_PARSER_STATE_NUMBER 9
+
+/**
+ * @brief Wczytywanie identyfikatora.
+ */
+#define STREAM_PARSER_STATE_IDENTIFICATOR 10
+
+/**
+ * @brief Wejście zostało przetworzone.
+ */
+#define STREAM_PARSER_STATE_FINISHED 11
+
+/**
+ * @brief Nie jest pomijany komentarz.
+ */
+#define STREAM_PARSER_SKIP_NONE 0
+
+/**
+ * @brief Wczytano pierwszy znak rozpoczęcia komentarza.
+ */
+#define STREAM_PARSER_SKIP_OPENING 1
+
+/**
+ * @brief Wewnątrz komentarza.
+ */
+#define STREAM_PARSER_SKIP_COMMENT 2
+
+/**
+ * @brief Wewnątrz komentarza, wczytano pierwszy znak zakończenia.
+ */
+#define STREAM_PARSER_SKIP_CLOSING 3
+
+/**
+ * @brief Znak został pominięty.
+ * @see streamParserSkip
+ */
+#define STREAM_PARSER_SKIPPED 0
+
+/**
+ * @brief Znaku nie można pominąć.
+ * @see streamParserSkip
+ */
+#define STREAM_PARSER_NOT_SKIPPABLE 1
+
+bool streamParserInit(struct StreamParser *sp) {
+    sp->state = STREAM_PARSER_STATE_START;
+    sp->skipState = STREAM_PARSER_SKIP_NONE;
+    sp->readBytes = 0;
+    sp->startPos = 0;
+    sp->keywordRest = NULL;
+    sp->keywordType = OPERATION_NONE;
+    sp->explain = false;
+    sp->status = STREAM_PARSER_OK;
+    sp->errorPos = 0;
+    if (!operationInit(&sp->operation)) {
+        return false;
+    }
+    sp->numberDestination = sp->operation.arg1;
+    return true;
+}
+
+void streamParserDestroy(struct StreamParser *sp) {
+    operationDestroy(&sp->operation);
+}
+
+/**
+ * @brief Zgłasza błąd.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] status - rodzaj błędu.
+ * @param[in] pos - pozycja błędu.
+ */
+static void streamParserSetError(struct StreamParser *sp, int status,
+                                 size_t pos) {
+    sp->status = status;
+    sp->errorPos = pos;
+}
+
+/**
+ * @param[in] c - kod znaku.
+ * @return true jeżeli @p c jest znakiem białym lub znakiem nowej linii.
+ */
+static bool streamParserIsSpace(int c) {
+    return characterIsWhite(c) || characterIsNewLine(c);
+}
+
+/**
+ * @param[in] c - kod znaku.
+ * @return true jeżeli @p c jest operatorem jednoznakowym.
+ */
+static bool streamParserIsSingleCharacterOperator(int c) {
+    return c == PARSER_OPERATOR_QM
+           || c == PARSER_OPERATOR_REDIRECT
+           || c == PARSER_OPERATOR_NONTRIVIAL;
+}
+
+/**
+ * @brief Pomija białe znaki i komentarze.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @return STREAM_PARSER_SKIPPED jeżeli znak został pominięty (lub wystąpił
+ *         błąd), STREAM_PARSER_NOT_SKIPPABLE jeżeli znak należy przetworzyć.
+ */
+static int streamParserSkip(struct StreamParser *sp, int c) {
+    switch (sp->skipState) {
+        case STREAM_PARSER_SKIP_NONE:
+            if (c == PARSER_COMMENT_SEQUENCE[0]) {
+                sp->skipState = STREAM_PARSER_SKIP_OPENING;
+            } else if (!streamParserIsSpace(c)) {
+                return STREAM_PARSER_NOT_SKIPPABLE;
+            }
+            break;
+        case STREAM_PARSER_SKIP_OPENING:
+            if (c != PARSER_COMMENT_SEQUENCE[1]) {
+                streamParserSetError(sp, STREAM_PARSER_ERROR, sp->readBytes);
+                return STREAM_PARSER_SKIPPED;
+            }
+            sp->skipState = STREAM_PARSER_SKIP_COMMENT;
+            break;
+        default:
+            if (characterIsEOF(c)) {
+                streamParserSetError(sp, STREAM_PARSER_EOF_ERROR, sp->readBytes);
+                return STREAM_PARSER_SKIPPED;
+            }
+            if (c != PARSER_COMMENT_SEQUENCE[0]) {
+                sp->skipState = STREAM_PARSER_SKIP_COMMENT;
+            } else if (sp->skipState == STREAM_PARSER_SKIP_COMMENT) {
+                sp->skipState = STREAM_PARSER_SKIP_CLOSING;
+            } else {
+                sp->skipState = STREAM_PARSER_SKIP_NONE;
+            }
+            break;
+    }
+    sp->readBytes++;
+    return STREAM_PARSER_SKIPPED;
+}
+
+/**
+ * @brief Przekazuje wczytaną operację i rozpoczyna wczytywanie następnej.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ */
+static void streamParserEmit(struct StreamParser *sp,
+                             StreamParserHandler handler, void *data) {
+    if (sp->explain) {
+        sp->operation.type = operationExplained(sp->operation.type);
+        sp->explain = false;
+    }
+    sp->operation.endPos = sp->readBytes;
+    PROBE3(parse__operation, sp->operation.type, sp->operation.operatorPos,
+           sp->operation.endPos);
+    handler(&sp->operation, data);
+    operationClear(&sp->operation);
+    sp->state = STREAM_PARSER_STATE_START;
+}
+
+/**
+ * @brief Dodaje znak do Vectora.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in, out] destination - Vector.
+ * @param[in] c - kod znaku.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+static bool streamParserPush(struct StreamParser *sp, Vector destination,
+                             int c) {
+    if (vectorPushBack(destination, (char) c) != VECTOR_SUCCES) {
+        streamParserSetError(sp, STREAM_PARSER_MEMORY_ERROR, sp->readBytes);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Rozpoczyna wczytywanie numeru.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] state - stan wczytywania numeru.
+ * @param[in] destination - Vector, do którego zostanie wczytany numer.
+ */
+static void streamParserStartNumber(struct StreamParser *sp, int state,
+                                    Vector destination) {
+    sp->state = state;
+    sp->numberDestination = destination;
+}
+
+/**
+ * @brief Przetwarza znak na początku operacji.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @return true jeżeli znak został wczytany, false w przeciwnym przypadku.
+ */
+static bool streamParserStart(struct StreamParser *sp, int c) {
+    if (characterIsEOF(c)) {
+        if (sp->explain) {
+            streamParserSetError(sp, STREAM_PARSER_EOF_ERROR, sp->readBytes);
+        } else {
+            sp->state = STREAM_PARSER_STATE_FINISHED;
+        }
+        return true;
+    } else if (characterIsDigit(c)) {
+        streamParserStartNumber(sp, STREAM_PARSER_STATE_FIRST_NUMBER,
+                                sp->operation.arg1);
+        return false;
+    }
+
+    sp->readBytes++;
+    if (sp->explain && c != PARSER_OPERATOR_QM
+        && c != PARSER_OPERATOR_NONTRIVIAL) {
+        streamParserSetError(sp, STREAM_PARSER_ERROR, sp->readBytes);
+        return true;
+    } else if (c == PARSER_OPERATOR_NEW[0]) {
+        sp->keywordRest = PARSER_OPERATOR_NEW + 1;
+        sp->keywordType = OPERATION_NEW;
+    } else if (c == PARSER_OPERATOR_DELETE[0]) {
+        sp->keywordRest = PARSER_OPERATOR_DELETE + 1;
+        sp->keywordType = OPERATION_DELETE_NUMBER;
+    } else if (c == PARSER_OPERATOR_SAVE[0]) {
+        sp->keywordRest = PARSER_OPERATOR_SAVE + 1;
+        sp->keywordType = OPERATION_SAVE;
+    } else if (c == PARSER_OPERATOR_TOP[0]) {
+        sp->keywordRest = PARSER_OPERATOR_TOP + 1;
+        sp->keywordType = OPERATION_TOP;
+    } else if (c == PARSER_OPERATOR_EXPLAIN[0]) {
+        sp->keywordRest = PARSER_OPERATOR_EXPLAIN + 1;
+        sp->keywordType = OPERATION_NONE;
+    } else if (c == PARSER_OPERATOR_QM || c == PARSER_OPERATOR_NONTRIVIAL) {
+        sp->operation.type = c == PARSER_OPERATOR_QM ? OPERATION_REVERSE
+                                                     : OPERATION_NONTRIVIAL;
+        sp->operation.operatorPos = sp->readBytes;
+        sp->state = STREAM_PARSER_STATE_PREFIXED_ARGUMENT;
+        return true;
+    } else if (c == PARSER_OPERATOR_REDIRECT) {
+        sp->startPos = sp->readBytes;
+        sp->state = STREAM_PARSER_STATE_START_REDIRECT;
+        return true;
+    } else {
+        streamParserSetError(sp, STREAM_PARSER_ERROR, sp->readBytes);
+        return true;
+    }
+
+    sp->startPos = sp->readBytes;
+    sp->state = STREAM_PARSER_STATE_KEYWORD;
+    return true;
+}
+
+/**
+ * @brief Przetwarza znak słowa kluczowego lub znak następujący po nim.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return true jeżeli znak został wczytany, false w przeciwnym przypadku.
+ */
+static bool streamParserKeyword(struct StreamParser *sp, int c,
+                                StreamParserHandler handler, void *data) {
+    if (*sp->keywordRest != '\0') {
+        if (c != *sp->keywordRest) {
+            streamParserSetError(sp, STREAM_PARSER_ERROR, sp->startPos);
+        } else {
+            sp->readBytes++;
+            sp->keywordRest++;
+        }
+        return true;
+    }
+
+    if (!streamParserIsSpace(c) && c != PARSER_COMMENT_SEQUENCE[0]
+        && !streamParserIsSingleCharacterOperator(c)) {
+        streamParserSetError(sp, STREAM_PARSER_ERROR, sp->startPos);
+        return true;
+    }
+
+    sp->operation.operatorPos = sp->startPos;
+    if (sp->keywordType == OPERATION_NONE) {
+        sp->explain = true;
+        sp->state = STREAM_PARSER_STATE_START;
+    } else if (sp->keywordType == OPERATION_NEW) {
+        sp->state = STREAM_PARSER_STATE_NEW_ARGUMENT;
+    } else if (sp->keywordType == OPERATION_DELETE_NUMBER) {
+        sp->state = STREAM_PARSER_STATE_DELETE_ARGUMENT;
+    } else if (sp->keywordType == OPERATION_TOP) {
+        sp->operation.type = OPERATION_TOP;
+        sp->state = STREAM_PARSER_STATE_PREFIXED_ARGUMENT;
+    } else {
+        sp->operation.type = OPERATION_SAVE;
+        streamParserEmit(sp, handler, data);
+    }
+    return false;
+}
+
+/**
+ * @brief Przetwarza znak, od którego powinien zaczynać się argument operacji.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @return true jeżeli znak został wczytany, false w przeciwnym przypadku.
+ */
+static bool streamParserArgument(struct StreamParser *sp, int c) {
+    if (characterIsEOF(c)) {
+        streamParserSetError(sp, STREAM_PARSER_EOF_ERROR, sp->readBytes);
+        return true;
+    }
+
+    bool acceptsNumber = sp->state != STREAM_PARSER_STATE_NEW_ARGUMENT;
+    bool acceptsIdentificator = sp->state == STREAM_PARSER_STATE_NEW_ARGUMENT
+                                || sp->state == STREAM_PARSER_STATE_DELETE_ARGUMENT;
+
+    if (acceptsNumber && characterIsDigit(c)) {
+        if (sp->state == STREAM_PARSER_STATE_DELETE_ARGUMENT) {
+            sp->operation.type = OPERATION_DELETE_NUMBER;
+        }
+        if (sp->state == STREAM_PARSER_STATE_REDIRECT_ARGUMENT) {
+            streamParserStartNumber(sp, STREAM_PARSER_STATE_NUMBER,
+                                    sp->operation.arg2);
+        } else {
+            streamParserStartNumber(sp, STREAM_PARSER_STATE_NUMBER,
+                                    sp->operation.arg1);
+        }
+    } else if (acceptsIdentificator && characterIsLetter(c)) {
+        if (sp->state == STREAM_PARSER_STATE_NEW_ARGUMENT) {
+            sp->operation.type = OPERATION_NEW;
+        } else {
+            sp->operation.type = OPERATION_DELETE_BASE;
+        }
+        sp->state = STREAM_PARSER_STATE_IDENTIFICATOR;
+    } else {
+        streamParserSetError(sp, STREAM_PARSER_ERROR, sp->readBytes + 1);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Przetwarza znak następujący po numerze rozpoczynającym operację.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return true jeżeli znak został wczytany, false w przeciwnym przypadku.
+ */
+static bool streamParserOperator(struct StreamParser *sp, int c,
+                                 StreamParserHandler handler, void *data) {
+    if (characterIsEOF(c)) {
+        streamParserSetError(sp, STREAM_PARSER_EOF_ERROR, sp->readBytes);
+    } else if (c == PARSER_OPERATOR_QM) {
+        sp->readBytes++;
+        sp->operation.type = OPERATION_GET;
+        sp->operation.operatorPos = sp->readBytes;
+        streamParserEmit(sp, handler, data);
+    } else if (c == PARSER_OPERATOR_REDIRECT && !sp->explain) {
+        sp->readBytes++;
+        sp->operation.type = OPERATION_REDIRECT;
+        sp->operation.operatorPos = sp->readBytes;
+        sp->state = STREAM_PARSER_STATE_REDIRECT_ARGUMENT;
+    } else if (c == PARSER_OPERATOR_NONTRIVIAL) {
+        streamParserSetError(sp, STREAM_PARSER_ERROR, sp->readBytes + 2);
+    } else {
+        streamParserSetError(sp, STREAM_PARSER_ERROR, sp->readBytes + 1);
+    }
+    return true;
+}
+
+/**
+ * @brief Przetwarza znak numeru lub znak następujący po nim.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return true jeżeli znak został wczytany, false w przeciwnym przypadku.
+ */
+static bool streamParserNumber(struct StreamParser *sp, int c,
+                               StreamParserHandler handler, void *data) {
+    if (characterIsDigit(c)) {
+        if (streamParserPush(sp, sp->numberDestination, c)) {
+            sp->readBytes++;
+        }
+        return true;
+    }
+
+    if (streamParserPush(sp, sp->numberDestination, '\0')) {
+        if (sp->state == STREAM_PARSER_STATE_FIRST_NUMBER) {
+            sp->state = STREAM_PARSER_STATE_OPERATOR;
+        } else {
+            streamParserEmit(sp, handler, data);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Przetwarza znak identyfikatora lub znak następujący po nim.
+ * Identyfikator będący słowem kluczowym jest błędem na pozycji
+ * jego pierwszego znaku.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return true jeżeli znak został wczytany, false w przeciwnym przypadku.
+ */
+static bool streamParserIdentificator(struct StreamParser *sp, int c,
+                                      StreamParserHandler handler,
+                                      void *data) {
+    if (characterIsLetter(c) || isdigit(c)) {
+        if (streamParserPush(sp, sp->operation.arg1, c)) {
+            sp->readBytes++;
+        }
+        return true;
+    }
+
+    if (streamParserPush(sp, sp->operation.arg1, '\0')) {
+        const char *id = vectorBegin(sp->operation.arg1);
+        if (strcmp(id, PARSER_OPERATOR_DELETE) == 0
+            || strcmp(id, PARSER_OPERATOR_NEW) == 0
+            || strcmp(id, PARSER_OPERATOR_SAVE) == 0
+            || strcmp(id, PARSER_OPERATOR_TOP) == 0
+            || strcmp(id, PARSER_OPERATOR_EXPLAIN) == 0) {
+            streamParserSetError(sp, STREAM_PARSER_ERROR,
+                                 sp->readBytes + 1 - strlen(id));
+        } else {
+            streamParserEmit(sp, handler, data);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Przetwarza znak.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] c - kod znaku lub EOF.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return true jeżeli znak został wczytany, false jeżeli należy go
+ *         przetworzyć ponownie (w nowym stanie).
+ */
+static bool streamParserStep(struct StreamParser *sp, int c,
+                             StreamParserHandler handler, void *data) {
+    switch (sp->state) {
+        case STREAM_PARSER_STATE_START:
+        case STREAM_PARSER_STATE_NEW_ARGUMENT:
+        case STREAM_PARSER_STATE_DELETE_ARGUMENT:
+        case STREAM_PARSER_STATE_PREFIXED_ARGUMENT:
+        case STREAM_PARSER_STATE_REDIRECT_ARGUMENT:
+        case STREAM_PARSER_STATE_OPERATOR:
+            if (streamParserSkip(sp, c) == STREAM_PARSER_SKIPPED) {
+                return true;
+            }
+            break;
+        default:
+            break;
+    }
+
+    switch (sp->state) {
+        case STREAM_PARSER_STATE_START:
+            return streamParserStart(sp, c);
+        case STREAM_PARSER_STATE_START_REDIRECT:
+            if (characterIsEOF(c)) {
+                streamParserSetError(sp, STREAM_PARSER_EOF_ERROR, sp->readBytes);
+            } else {
+                streamParserSetError(sp, STREAM_PARSER_ERROR, sp->startPos);
+            }
+            return true;
+        case STREAM_PARSER_STATE_KEYWORD:
+            return streamParserKeyword(sp, c, handler, data);
+        case STREAM_PARSER_STATE_NEW_ARGUMENT:
+        case STREAM_PARSER_STATE_DELETE_ARGUMENT:
+        case STREAM_PARSER_STATE_PREFIXED_ARGUMENT:
+        case STREAM_PARSER_STATE_REDIRECT_ARGUMENT:
+            return streamParserArgument(sp, c);
+        case STREAM_PARSER_STATE_OPERATOR:
+            return streamParserOperator(sp, c, handler, data);
+        case STREAM_PARSER_STATE_FIRST_NUMBER:
+        case STREAM_PARSER_STATE_NUMBER:
+            return streamParserNumber(sp, c, handler, data);
+        case STREAM_PARSER_STATE_IDENTIFICATOR:
+            return streamParserIdentificator(sp, c, handler, data);
+        default:
+            return true;
+    }
+}
+
+int streamParserFeed(struct StreamParser *sp, const char *chunk, size_t size,
+                     StreamParserHandler handler, void *data) {
+    size_t i = 0;
+    while (i < size && sp->status == STREAM_PARSER_OK) {
+        if (streamParserStep(sp, (unsigned char) chunk[i], handler, data)) {
+            i++;
+        }
+    }
+    return sp->status;
+}
+
+int streamParserFinish(struct StreamParser *sp,
+                       StreamParserHandler handler, void *data) {
+    while (sp->status == STREAM_PARSER_OK
+           && sp->state != STREAM_PARSER_STATE_FINISHED) {
+        streamParserStep(sp, EOF, handler, data);
+    }
+    return sp->status;
+}
+
+size_t streamParserGetReadBytes(const struct StreamParser *sp) {
+    return sp->readBytes;
+}
+
+size_t streamParserErrorPosition(const struct StreamParser *sp) {
+    return sp->errorPos;
+}
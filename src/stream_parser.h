@@ -0,0 +1,167 @@
+/** @file
+ * Interfejs parsera strumieniowego.
+ * Parser strumieniowy nie pobiera sam znaków z wejścia, jest maszyną
+ * stanów, której przekazuje się kolejne fragmenty wejścia dowolnej długości.
+ * Każda kompletna operacja jest przekazywana funkcji obsługującej
+ * natychmiast, gdy tylko da się stwierdzić jej koniec. Cały stan
+ * parsowania jest przechowywany w strukturze StreamParser, więc jeden wątek
+ * może równocześnie obsługiwać wiele niezależnych strumieni poleceń.
+ * Pozycja błędu to numer bajtu wejścia, na którym wykryto błąd.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_STREAM_PARSER_H
+#define TELEFONY_STREAM_PARSER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "operation.h"
+
+/**
+ * @brief Parsowanie przebiega poprawnie.
+ */
+#define STREAM_PARSER_OK 0
+
+/**
+ * @brief Wystąpił błąd składniowy.
+ * @see streamParserErrorPosition
+ */
+#define STREAM_PARSER_ERROR 1
+
+/**
+ * @brief Wejście zakończyło się w trakcie operacji lub komentarza.
+ */
+#define STREAM_PARSER_EOF_ERROR 2
+
+/**
+ * @brief Wystąpił problem z pamięcią.
+ * @see streamParserErrorPosition
+ */
+#define STREAM_PARSER_MEMORY_ERROR 3
+
+/**
+ * @brief Funkcja obsługująca kompletną operację.
+ * Operacja jest ważna jedynie w trakcie wywołania.
+ */
+typedef void (*StreamParserHandler)(const struct Operation *op, void *data);
+
+/**
+ * @brief Struktura reprezentująca stan parsera strumieniowego.
+ */
+struct StreamParser {
+    /**
+     * @brief Stan maszyny stanów.
+     */
+    int state;
+
+    /**
+     * @brief Stan pomijania białych znaków i komentarzy.
+     */
+    int skipState;
+
+    /**
+     * @brief Liczba przetworzonych bajtów.
+     */
+    size_t readBytes;
+
+    /**
+     * @brief Pozycja pierwszego znaku wczytywanego słowa kluczowego
+     * lub operatora przekierowania.
+     */
+    size_t startPos;
+
+    /**
+     * @brief Pozostała do wczytania część słowa kluczowego.
+     */
+    const char *keywordRest;
+
+    /**
+     * @brief Rodzaj operacji rozpoczynanej przez wczytywane słowo kluczowe
+     * (OPERATION_NONE dla PARSER_OPERATOR_EXPLAIN).
+     */
+    int keywordType;
+
+    /**
+     * @brief Czy wczytywana operacja jest poprzedzona
+     * PARSER_OPERATOR_EXPLAIN.
+     */
+    bool explain;
+
+    /**
+     * @brief Vector, do którego wczytywany jest numer.
+     */
+    Vector numberDestination;
+
+    /**
+     * @brief Wczytywana operacja.
+     */
+    struct Operation operation;
+
+    /**
+     * @brief Stan parsowania (STREAM_PARSER_*).
+     */
+    int status;
+
+    /**
+     * @brief Pozycja błędu.
+     */
+    size_t errorPos;
+};
+
+/**
+ * @brief Inicjuje parser strumieniowy.
+ * @param[out] sp - wskaźnik na inicjowany parser.
+ * @return true w przypadku sukcesu, false w przypadku problemów z pamięcią.
+ */
+bool streamParserInit(struct StreamParser *sp);
+
+/**
+ * @brief Zwalnia pamięć zajmowaną przez parser strumieniowy.
+ * @param[in, out] sp - wskaźnik na parser.
+ */
+void streamParserDestroy(struct StreamParser *sp);
+
+/**
+ * @brief Przetwarza fragment wejścia.
+ * Dla każdej operacji zakończonej w tym fragmencie wywołuje
+ * handler(operacja, data). Po wystąpieniu błędu kolejne fragmenty
+ * są ignorowane.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] chunk - wskaźnik na fragment wejścia.
+ * @param[in] size - długość fragmentu.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return Stan parsowania (STREAM_PARSER_*).
+ */
+int streamParserFeed(struct StreamParser *sp, const char *chunk, size_t size,
+                     StreamParserHandler handler, void *data);
+
+/**
+ * @brief Kończy przetwarzanie wejścia.
+ * Przekazuje ostatnią operację, jeżeli kończy ją koniec wejścia.
+ * @param[in, out] sp - wskaźnik na parser.
+ * @param[in] handler - funkcja obsługująca operacje.
+ * @param[in, out] data - wskaźnik na dane do funkcji @p handler.
+ * @return Stan parsowania (STREAM_PARSER_*).
+ */
+int streamParserFinish(struct StreamParser *sp,
+                       StreamParserHandler handler, void *data);
+
+/**
+ * @param[in] sp - wskaźnik na parser.
+ * @return Liczba przetworzonych bajtów.
+ */
+size_t streamParserGetReadBytes(const struct StreamParser *sp);
+
+/**
+ * @param[in] sp - wskaźnik na parser.
+ * @return Pozycja błędu, jeżeli stan to STREAM_PARSER_ERROR lub
+ *         STREAM_PARSER_MEMORY_ERROR.
+ */
+size_t streamParserErrorPosition(const struct StreamParser *sp);
+
+#endif //TELEFONY_STREAM_PARSER_H
@@ -0,0 +1,131 @@
+/** @file
+ * Implementacja wyznaczania porządku sufiksów napisu.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <limits.h>
+#include <stdlib.h>
+
+#include "suffix_rank.h"
+
+/**
+ * @brief Sortuje przesunięcia cykliczne według klas przez zliczanie.
+ * @param[out] order - tablica @p n posortowanych pozycji.
+ * @param[in] source - tablica @p n pozycji posortowanych według drugiej
+ *        połowy porównywanego prefiksu.
+ * @param[in] classes - klasy pozycji (od 0 do @p classCount - 1).
+ * @param[in, out] count - tablica pomocnicza co najmniej @p classCount
+ *        elementów.
+ * @param[in] n - liczba pozycji.
+ * @param[in] classCount - liczba klas.
+ */
+static void suffixRankCountingSort(size_t *order, const size_t *source,
+                                   const size_t *classes, size_t *count,
+                                   size_t n, size_t classCount) {
+    size_t i;
+    for (i = 0; i < classCount; i++) {
+        count[i] = 0;
+    }
+    for (i = 0; i < n; i++) {
+        count[classes[source[i]]]++;
+    }
+    for (i = 1; i < classCount; i++) {
+        count[i] += count[i - 1];
+    }
+    for (i = n; i > 0; i--) {
+        order[--count[classes[source[i - 1]]]] = source[i - 1];
+    }
+}
+
+/**
+ * @brief Sortuje pozycje napisu według znaków przez zliczanie.
+ * Pozycja @p length (sufiks pusty) jest traktowana jak znak o kodzie 0.
+ * @param[out] order - tablica @p length + 1 posortowanych pozycji.
+ * @param[in] txt - wskaźnik na napis.
+ * @param[in] length - długość napisu.
+ * @param[in, out] count - tablica pomocnicza UCHAR_MAX + 1 elementów.
+ */
+static void suffixRankSortCharacters(size_t *order, const char *txt,
+                                     size_t length, size_t *count) {
+    size_t i;
+    for (i = 0; i <= UCHAR_MAX; i++) {
+        count[i] = 0;
+    }
+    count[0]++;
+    for (i = 0; i < length; i++) {
+        count[(unsigned char) txt[i]]++;
+    }
+    for (i = 1; i <= UCHAR_MAX; i++) {
+        count[i] += count[i - 1];
+    }
+    for (i = length; i > 0; i--) {
+        order[--count[(unsigned char) txt[i - 1]]] = i - 1;
+    }
+    order[--count[0]] = length;
+}
+
+size_t *suffixRanks(const char *txt, size_t length, size_t *allocations) {
+    size_t n = length + 1;
+    size_t alphabet = (size_t) UCHAR_MAX + 1;
+    size_t *classes = malloc(n * sizeof(size_t));
+    size_t *newClasses = malloc(n * sizeof(size_t));
+    size_t *order = malloc(n * sizeof(size_t));
+    size_t *shifted = malloc(n * sizeof(size_t));
+    size_t *count = malloc((n > alphabet ? n : alphabet) * sizeof(size_t));
+    if (classes == NULL || newClasses == NULL || order == NULL
+        || shifted == NULL || count == NULL) {
+        free(classes);
+        free(newClasses);
+        free(order);
+        free(shifted);
+        free(count);
+        return NULL;
+    }
+    if (allocations != NULL) {
+        *allocations += 5;
+    }
+
+    suffixRankSortCharacters(order, txt, length, count);
+    size_t classCount = 1;
+    size_t i;
+    classes[order[0]] = 0;
+    for (i = 1; i < n; i++) {
+        size_t cur = order[i], prev = order[i - 1];
+        if (cur == length || prev == length || txt[cur] != txt[prev]) {
+            classCount++;
+        }
+        classes[cur] = classCount - 1;
+    }
+
+    size_t half;
+    for (half = 1; half < n && classCount < n; half *= 2) {
+        for (i = 0; i < n; i++) {
+            shifted[i] = order[i] >= half ? order[i] - half
+                                          : order[i] + n - half;
+        }
+        suffixRankCountingSort(order, shifted, classes, count, n, classCount);
+
+        classCount = 1;
+        newClasses[order[0]] = 0;
+        for (i = 1; i < n; i++) {
+            size_t cur = order[i], prev = order[i - 1];
+            if (classes[cur] != classes[prev]
+                || classes[(cur + half) % n] != classes[(prev + half) % n]) {
+                classCount++;
+            }
+            newClasses[order[i]] = classCount - 1;
+        }
+        size_t *tmp = classes;
+        classes = newClasses;
+        newClasses = tmp;
+    }
+
+    free(newClasses);
+    free(order);
+    free(shifted);
+    free(count);
+    return classes;
+}
@@ -0,0 +1,34 @@
+/** @file
+ * Interfejs wyznaczania porządku sufiksów napisu.
+ * Pozycje sufiksów w porządku leksykograficznym pozwalają porównać dowolne
+ * dwa sufiksy w czasie stałym, niezależnie od długości ich wspólnego
+ * prefiksu.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_SUFFIX_RANK_H
+#define TELEFONY_SUFFIX_RANK_H
+
+#include <stddef.h>
+
+/**
+ * @brief Wyznacza pozycje sufiksów napisu w porządku leksykograficznym.
+ * Sufiks txt + i jest mniejszy od sufiksu txt + j wtedy i tylko wtedy, gdy
+ * ranks[i] < ranks[j]. Sufiks pusty (i = @p length) ma pozycję 0.
+ * Znaki są porównywane jako unsigned char.
+ * #### Złożoność
+ * O(n log n), gdzie n to @p length (sortowanie przez zliczanie
+ * przy podwajaniu długości porównywanych prefiksów).
+ * @param[in] txt - wskaźnik na napis.
+ * @param[in] length - długość napisu (bez znaku '\0').
+ * @param[in, out] allocations - wskaźnik na licznik zaalokowanych bloków
+ *        pamięci (także tych zwolnionych przed zakończeniem) lub NULL.
+ * @return Tablica @p length + 1 pozycji, którą należy zwolnić funkcją free,
+ *         lub NULL w przypadku problemów z pamięcią.
+ */
+size_t *suffixRanks(const char *txt, size_t length, size_t *allocations);
+
+#endif //TELEFONY_SUFFIX_RANK_H
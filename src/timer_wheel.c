@@ -0,0 +1,276 @@
+/** @file
+ * Implementacja hierarchicznego koła czasowego.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include "timer_wheel.h"
+
+/**
+ * @brief Numer poziomu listy terminów, które upłynęły przed dodaniem.
+ */
+#define TIMER_WHEEL_DUE TIMER_WHEEL_LEVELS
+
+/**
+ * @brief Maska numeru przegródki.
+ */
+#define TIMER_WHEEL_SLOT_MASK ((uint64_t) TIMER_WHEEL_SLOTS - 1)
+
+struct TimerWheelEntry {
+    /**
+     * @brief Termin.
+     */
+    uint64_t deadline;
+
+    /**
+     * @brief Dane przekazywane po upłynięciu terminu.
+     */
+    void *data;
+
+    /**
+     * @brief Poprzednia pozycja w przegródce lub NULL.
+     */
+    TimerWheelEntry previous;
+
+    /**
+     * @brief Następna pozycja w przegródce lub NULL.
+     */
+    TimerWheelEntry next;
+
+    /**
+     * @brief Poziom przegródki (TIMER_WHEEL_DUE dla listy @p due).
+     */
+    unsigned char level;
+
+    /**
+     * @brief Numer przegródki na poziomie.
+     */
+    unsigned char slot;
+};
+
+struct TimerWheel {
+    /**
+     * @brief Bieżący czas.
+     */
+    uint64_t now;
+
+    /**
+     * @brief Maski zajętych przegródek kolejnych poziomów.
+     */
+    uint64_t masks[TIMER_WHEEL_LEVELS];
+
+    /**
+     * @brief Pierwsze pozycje przegródek kolejnych poziomów.
+     */
+    TimerWheelEntry slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+
+    /**
+     * @brief Terminy, które upłynęły przed dodaniem.
+     */
+    TimerWheelEntry due;
+};
+
+TimerWheel timerWheelCreate(uint64_t now) {
+    TimerWheel result = malloc(sizeof(struct TimerWheel));
+    if (result != NULL) {
+        result->now = now;
+        result->due = NULL;
+        size_t i, j;
+        for (i = 0; i < TIMER_WHEEL_LEVELS; i++) {
+            result->masks[i] = 0;
+            for (j = 0; j < TIMER_WHEEL_SLOTS; j++) {
+                result->slots[i][j] = NULL;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Zwalnia listę pozycji.
+ * @param[in] entry - pierwsza pozycja listy.
+ */
+static void timerWheelFreeList(TimerWheelEntry entry) {
+    while (entry != NULL) {
+        TimerWheelEntry next = entry->next;
+        free(entry);
+        entry = next;
+    }
+}
+
+void timerWheelDelete(TimerWheel wheel) {
+    if (wheel != NULL) {
+        size_t i, j;
+        for (i = 0; i < TIMER_WHEEL_LEVELS; i++) {
+            for (j = 0; j < TIMER_WHEEL_SLOTS; j++) {
+                timerWheelFreeList(wheel->slots[i][j]);
+            }
+        }
+        timerWheelFreeList(wheel->due);
+        free(wheel);
+    }
+}
+
+uint64_t timerWheelNow(TimerWheel wheel) {
+    return wheel->now;
+}
+
+/**
+ * @param[in] level - numer poziomu lub TIMER_WHEEL_DUE.
+ * @param[in] wheel - wskaźnik na koło.
+ * @param[in] slot - numer przegródki.
+ * @return Wskaźnik na pierwszą pozycję przegródki.
+ */
+static TimerWheelEntry *timerWheelHead(TimerWheel wheel, size_t level,
+                                       size_t slot) {
+    return level == TIMER_WHEEL_DUE ? &wheel->due : &wheel->slots[level][slot];
+}
+
+/**
+ * @brief Umieszcza pozycję w przegródce odpowiedniej dla bieżącego czasu.
+ * @param[in, out] wheel - wskaźnik na koło.
+ * @param[in, out] entry - pozycja.
+ */
+static void timerWheelPlace(TimerWheel wheel, TimerWheelEntry entry) {
+    size_t level = TIMER_WHEEL_DUE, slot = 0;
+    if (entry->deadline > wheel->now) {
+        uint64_t diff = (entry->deadline ^ wheel->now) >> TIMER_WHEEL_BITS;
+        level = 0;
+        while (diff != 0) {
+            level++;
+            diff >>= TIMER_WHEEL_BITS;
+        }
+        slot = (size_t) ((entry->deadline >> (level * TIMER_WHEEL_BITS))
+                         & TIMER_WHEEL_SLOT_MASK);
+        wheel->masks[level] |= (uint64_t) 1 << slot;
+    }
+
+    TimerWheelEntry *head = timerWheelHead(wheel, level, slot);
+    entry->level = (unsigned char) level;
+    entry->slot = (unsigned char) slot;
+    entry->previous = NULL;
+    entry->next = *head;
+    if (*head != NULL) {
+        (*head)->previous = entry;
+    }
+    *head = entry;
+}
+
+TimerWheelEntry timerWheelAdd(TimerWheel wheel, uint64_t deadline, void *data) {
+    TimerWheelEntry entry = malloc(sizeof(struct TimerWheelEntry));
+    if (entry != NULL) {
+        entry->deadline = deadline;
+        entry->data = data;
+        timerWheelPlace(wheel, entry);
+    }
+    return entry;
+}
+
+void timerWheelCancel(TimerWheel wheel, TimerWheelEntry entry) {
+    TimerWheelEntry *head = timerWheelHead(wheel, entry->level, entry->slot);
+    if (entry->previous != NULL) {
+        entry->previous->next = entry->next;
+    } else {
+        *head = entry->next;
+        if (*head == NULL && entry->level != TIMER_WHEEL_DUE) {
+            wheel->masks[entry->level] &= ~((uint64_t) 1 << entry->slot);
+        }
+    }
+    if (entry->next != NULL) {
+        entry->next->previous = entry->previous;
+    }
+    free(entry);
+}
+
+/**
+ * @param[in] mask - niezerowa maska.
+ * @return Numer najmłodszego ustawionego bitu @p mask.
+ */
+static size_t timerWheelLowestBit(uint64_t mask) {
+    assert(mask != 0);
+    size_t result = 0;
+    size_t width = TIMER_WHEEL_SLOTS / 2;
+    while (width != 0) {
+        if ((mask & (((uint64_t) 1 << width) - 1)) == 0) {
+            mask >>= width;
+            result += width;
+        }
+        width /= 2;
+    }
+    return result;
+}
+
+/**
+ * @brief Wyznacza najbliższą zajętą przegródkę.
+ * @param[in] wheel - wskaźnik na koło.
+ * @param[out] level - poziom przegródki.
+ * @param[out] slot - numer przegródki.
+ * @param[out] start - najwcześniejszy termin, który może się w niej znaleźć.
+ * @return false jeżeli koło nie zawiera terminów późniejszych niż bieżący
+ *         czas, true w przeciwnym przypadku.
+ */
+static bool timerWheelNext(TimerWheel wheel, size_t *level, size_t *slot,
+                           uint64_t *start) {
+    for (*level = 0; *level < TIMER_WHEEL_LEVELS; (*level)++) {
+        if (wheel->masks[*level] != 0) {
+            size_t shift = *level * TIMER_WHEEL_BITS;
+            size_t highShift = shift + TIMER_WHEEL_BITS;
+            uint64_t high = highShift >= 64
+                            ? 0 : (wheel->now >> highShift) << highShift;
+            *slot = timerWheelLowestBit(wheel->masks[*level]);
+            *start = high | ((uint64_t) *slot << shift);
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t timerWheelAdvance(TimerWheel wheel, uint64_t now,
+                         void (*f)(void *, void *), void *fData) {
+    TimerWheelEntry expired = wheel->due;
+    TimerWheelEntry *tail = &expired;
+    while (*tail != NULL) {
+        tail = &(*tail)->next;
+    }
+    wheel->due = NULL;
+
+    size_t level, slot;
+    uint64_t start;
+    while (now > wheel->now) {
+        if (!timerWheelNext(wheel, &level, &slot, &start) || start > now) {
+            wheel->now = now;
+            break;
+        }
+
+        wheel->now = start;
+        TimerWheelEntry entry = wheel->slots[level][slot];
+        wheel->slots[level][slot] = NULL;
+        wheel->masks[level] &= ~((uint64_t) 1 << slot);
+        while (entry != NULL) {
+            TimerWheelEntry next = entry->next;
+            if (entry->deadline == start) {
+                entry->next = NULL;
+                *tail = entry;
+                tail = &entry->next;
+            } else {
+                timerWheelPlace(wheel, entry);
+            }
+            entry = next;
+        }
+    }
+
+    size_t result = 0;
+    while (expired != NULL) {
+        TimerWheelEntry next = expired->next;
+        f(expired->data, fData);
+        free(expired);
+        expired = next;
+        result++;
+    }
+    return result;
+}
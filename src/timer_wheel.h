@@ -0,0 +1,122 @@
+/** @file
+ * Interfejs hierarchicznego koła czasowego.
+ * Terminy są liczbami całkowitymi (czas logiczny). Poziom i koła ma
+ * TIMER_WHEEL_SLOTS przegródek obejmujących po TIMER_WHEEL_SLOTS^i
+ * jednostek czasu. Pozycja trafia na poziom najstarszej grupy bitów,
+ * którą jej termin różni się od bieżącego czasu, i przy przesuwaniu czasu
+ * schodzi na niższe poziomy, więc każda pozycja jest przenoszona co
+ * najwyżej TIMER_WHEEL_LEVELS razy. Zajęte przegródki poziomu są
+ * zapamiętane w masce bitowej, dzięki czemu przesunięcie czasu o dowolnie
+ * dużo nie przegląda pustych przegródek.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_TIMER_WHEEL_H
+#define TELEFONY_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Liczba bitów terminu wyznaczających przegródkę na poziomie.
+ */
+#define TIMER_WHEEL_BITS 6
+
+/**
+ * @brief Liczba przegródek na poziomie.
+ */
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+/**
+ * @brief Liczba poziomów (pokrywają wszystkie bity uint64_t).
+ */
+#define TIMER_WHEEL_LEVELS ((64 + TIMER_WHEEL_BITS - 1) / TIMER_WHEEL_BITS)
+
+/**
+ * @brief Wskaźnik na koło czasowe.
+ * @see struct TimerWheel
+ */
+typedef struct TimerWheel *TimerWheel;
+
+/**
+ * @brief Wskaźnik na pozycję w kole czasowym.
+ * @see struct TimerWheelEntry
+ */
+typedef struct TimerWheelEntry *TimerWheelEntry;
+
+/**
+ * @brief Struktura przechowująca koło czasowe.
+ */
+struct TimerWheel;
+
+/**
+ * @brief Struktura przechowująca termin i związane z nim dane.
+ */
+struct TimerWheelEntry;
+
+/**
+ * @brief Tworzy puste koło czasowe.
+ * @param[in] now - bieżący czas.
+ * @return Wskaźnik na koło lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+TimerWheel timerWheelCreate(uint64_t now);
+
+/**
+ * @brief Usuwa koło czasowe wraz ze wszystkimi pozycjami.
+ * Nic nie robi, jeśli wskaźnik ma wartość NULL.
+ * @param[in] wheel - wskaźnik na koło.
+ */
+void timerWheelDelete(TimerWheel wheel);
+
+/**
+ * @param[in] wheel - wskaźnik na koło.
+ * @return Bieżący czas koła.
+ */
+uint64_t timerWheelNow(TimerWheel wheel);
+
+/**
+ * @brief Dodaje termin.
+ * Termin nie późniejszy niż bieżący czas upływa przy najbliższym
+ * wywołaniu @ref timerWheelAdvance.
+ * #### Złożoność
+ * O(1)
+ * @param[in, out] wheel - wskaźnik na koło.
+ * @param[in] deadline - termin.
+ * @param[in] data - dane przekazywane po upłynięciu terminu.
+ * @return Pozycja terminu lub NULL, gdy nie udało się zaalokować pamięci.
+ */
+TimerWheelEntry timerWheelAdd(TimerWheel wheel, uint64_t deadline, void *data);
+
+/**
+ * @brief Anuluje termin i zwalnia jego pozycję.
+ * #### Złożoność
+ * O(1)
+ * @param[in, out] wheel - wskaźnik na koło.
+ * @param[in] entry - pozycja terminu.
+ */
+void timerWheelCancel(TimerWheel wheel, TimerWheelEntry entry);
+
+/**
+ * @brief Przesuwa bieżący czas.
+ * Dla każdego terminu nie późniejszego niż @p now wywołuje
+ * f(dane, fData), a następnie zwalnia jego pozycję. Upływające terminy są
+ * odłączane od koła przed pierwszym wywołaniem @p f, więc @p f może
+ * dodawać i anulować inne terminy, ale nie upływające.
+ * Jeżeli @p now jest wcześniejszy niż bieżący czas, czas się nie zmienia.
+ * #### Złożoność
+ * Zamortyzowana O(1) na termin i O(TIMER_WHEEL_LEVELS) na przegródkę
+ * zawierającą terminy.
+ * @param[in, out] wheel - wskaźnik na koło.
+ * @param[in] now - nowy bieżący czas.
+ * @param[in] f - funkcja wywoływana dla upłyniętych terminów.
+ * @param[in, out] fData - dane do funkcji @p f.
+ * @return Liczba upłyniętych terminów.
+ */
+size_t timerWheelAdvance(TimerWheel wheel, uint64_t now,
+                         void (*f)(void *, void *), void *fData);
+
+#endif /* TELEFONY_TIMER_WHEEL_H */
@@ -0,0 +1,54 @@
+/** @file
+ * Implementacja modułu śladów wykonania.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <string.h>
+#include <time.h>
+
+#include "trace.h"
+#include "compiled_script.h"
+
+uint64_t traceClock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+bool traceWriteHeader(FILE *out) {
+    return fwrite(TRACE_MAGIC, 1, TRACE_MAGIC_LENGTH, out)
+           == TRACE_MAGIC_LENGTH;
+}
+
+bool traceWriteRecord(FILE *out, const struct Operation *op,
+                      const struct TraceRecord *record, size_t *previousEnd) {
+    return compiledScriptWriteOperation(out, op, previousEnd)
+           && compiledScriptWriteVarint(out, record->resultSize)
+           && compiledScriptWriteVarint(out, record->duration);
+}
+
+bool traceReadHeader(FILE *in) {
+    char magic[TRACE_MAGIC_LENGTH];
+    return fread(magic, 1, TRACE_MAGIC_LENGTH, in) == TRACE_MAGIC_LENGTH
+           && memcmp(magic, TRACE_MAGIC, TRACE_MAGIC_LENGTH) == 0;
+}
+
+int traceReadRecord(FILE *in, struct Operation *op,
+                    struct TraceRecord *record, size_t *previousEnd) {
+    int result = compiledScriptReadOperation(in, op, previousEnd);
+    if (result == COMPILED_SCRIPT_END) {
+        return TRACE_END;
+    } else if (result == COMPILED_SCRIPT_MEMORY_ERROR) {
+        return TRACE_MEMORY_ERROR;
+    } else if (result != COMPILED_SCRIPT_OPERATION
+               || !compiledScriptReadVarint(in, &record->resultSize)
+               || !compiledScriptReadVarint(in, &record->duration)) {
+        return TRACE_MALFORMED;
+    }
+    return TRACE_RECORD;
+}
@@ -0,0 +1,116 @@
+/** @file
+ * Interfejs modułu śladów wykonania.
+ * Ślad to zapis wykonanych operacji wraz z rozmiarem ich wyniku i czasem
+ * wykonania, który można odtworzyć w innej wersji programu
+ * (phone_forward_replay). Plik zaczyna się od TRACE_MAGIC, po którym
+ * następują rekordy: operacja w postaci skompilowanego skryptu
+ * (@ref compiledScriptWriteOperation), a następnie rozmiar wyniku i czas
+ * wykonania w nanosekundach jako liczby o zmiennej długości.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_TRACE_H
+#define TELEFONY_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "operation.h"
+
+/**
+ * @brief Ciąg bajtów rozpoczynający ślad.
+ */
+#define TRACE_MAGIC "PFWDTRC1"
+
+/**
+ * @brief Długość TRACE_MAGIC.
+ */
+#define TRACE_MAGIC_LENGTH 8
+
+/**
+ * @brief Wczytano rekord.
+ * @see traceReadRecord
+ */
+#define TRACE_RECORD 1
+
+/**
+ * @brief Ślad się zakończył.
+ * @see traceReadRecord
+ */
+#define TRACE_END 0
+
+/**
+ * @brief Ślad jest uszkodzony.
+ * @see traceReadRecord
+ */
+#define TRACE_MALFORMED 2
+
+/**
+ * @brief Wystąpił problem z pamięcią.
+ * @see traceReadRecord
+ */
+#define TRACE_MEMORY_ERROR 3
+
+/**
+ * @brief Rekord śladu bez operacji.
+ */
+struct TraceRecord {
+    /**
+     * @brief Rozmiar wyniku operacji (liczba wypisanych wierszy).
+     */
+    size_t resultSize;
+
+    /**
+     * @brief Czas wykonania operacji w nanosekundach.
+     */
+    size_t duration;
+};
+
+/**
+ * @return Bieżący czas monotoniczny w nanosekundach.
+ */
+uint64_t traceClock(void);
+
+/**
+ * @brief Zapisuje nagłówek śladu.
+ * @param[in, out] out - strumień wyjściowy.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+bool traceWriteHeader(FILE *out);
+
+/**
+ * @brief Zapisuje rekord.
+ * @param[in, out] out - strumień wyjściowy.
+ * @param[in] op - wskaźnik na wykonaną operację.
+ * @param[in] record - wskaźnik na rozmiar wyniku i czas wykonania.
+ * @param[in, out] previousEnd - pozycja końca poprzedniej operacji
+ *        (początkowo 0), uaktualniana po zapisie.
+ * @return true w przypadku sukcesu, false w przypadku błędu zapisu.
+ */
+bool traceWriteRecord(FILE *out, const struct Operation *op,
+                      const struct TraceRecord *record, size_t *previousEnd);
+
+/**
+ * @brief Wczytuje i sprawdza nagłówek śladu.
+ * @param[in, out] in - strumień wejściowy.
+ * @return true jeżeli nagłówek jest poprawny, false w przeciwnym przypadku.
+ */
+bool traceReadHeader(FILE *in);
+
+/**
+ * @brief Wczytuje rekord.
+ * @param[in, out] in - strumień wejściowy.
+ * @param[out] op - wskaźnik na wczytywaną operację.
+ * @param[out] record - wskaźnik na rozmiar wyniku i czas wykonania.
+ * @param[in, out] previousEnd - pozycja końca poprzedniej operacji
+ *        (początkowo 0), uaktualniana po odczycie.
+ * @return TRACE_RECORD, TRACE_END, TRACE_MALFORMED lub TRACE_MEMORY_ERROR.
+ */
+int traceReadRecord(FILE *in, struct Operation *op,
+                    struct TraceRecord *record, size_t *previousEnd);
+
+#endif //TELEFONY_TRACE_H
@@ -172,6 +172,17 @@ int vectorPushBack(Vector vector, VECTOR_ELEMENT_TYPE element) {
     }
 }
 
+int vectorPushBackString(Vector vector, const char *str) {
+    size_t length = strlen(str) + 1;
+    size_t oldSize = vectorSize(vector);
+    if (vectorSoftResize(vector, oldSize + length) == VECTOR_MEMORY_ERROR) {
+        return VECTOR_MEMORY_ERROR;
+    } else {
+        memcpy(vector->array + oldSize, str, length);
+        return VECTOR_SUCCES;
+    }
+}
+
 int vectorPopBack(Vector vector) {
     if (vectorSize(vector) == 0) {
         return VECTOR_OPERATION_ERROR;
@@ -136,6 +136,17 @@ void vectorDelete(Vector vector);
  */
 int vectorPushBack(Vector vector, VECTOR_ELEMENT_TYPE element);
 
+/**
+ * @brief Wstawia ciąg znaków w stylu c na koniec Vectora.
+ * Wstawia wszystkie znaki @p str razem z kończącym go znakiem '\0'.
+ * W przypadku niepowodzenia @p vector pozostaje niezmieniony.
+ * @param[in] vector    - wskaźnik na strukturę Vectora.
+ * @param[in] str       - ciąg znaków do wstawienia.
+ * @return W przypadku problemów z przydzieleniem pamięci VECTOR_MEMORY_ERROR,
+ *         w przeciwnym wypadku VECTOR_SUCCESS.
+ */
+int vectorPushBackString(Vector vector, const char *str);
+
 /**
  * @brief Usuwa z końca Vectora.
  * Jeżeli vectorSize(vector) jest różne od 0 to
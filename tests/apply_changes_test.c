@@ -0,0 +1,141 @@
+/** @file
+ * Test stosowania ciągu zmian.
+ * Struktura zmieniana przez @ref phfwdApplyChanges jest porównywana
+ * z modelem, do którego zmiany są dodawane pojedynczo. Ciągi zawierają
+ * niepoprawne dodania, na których stosowanie musi się zakończyć.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define APPLY_CHANGES_TEST_ROUNDS 200
+
+/**
+ * @brief Liczba ciągów zmian stosowanych do jednej struktury.
+ */
+#define APPLY_CHANGES_TEST_BATCHES 20
+
+/**
+ * @brief Największa liczba zmian w ciągu.
+ */
+#define APPLY_CHANGES_TEST_CHANGES 30
+
+/**
+ * @brief Liczba sprawdzanych numerów po każdym ciągu.
+ */
+#define APPLY_CHANGES_TEST_QUERIES 20
+
+/**
+ * @brief Numery zmian w ciągu.
+ */
+struct ApplyChangesTestBuffer {
+    /**
+     * @brief Prefiksy przekierowywane lub usuwane.
+     */
+    char num1[APPLY_CHANGES_TEST_CHANGES][TEST_MODEL_NUMBER];
+
+    /**
+     * @brief Cele przekierowań.
+     */
+    char num2[APPLY_CHANGES_TEST_CHANGES][TEST_MODEL_NUMBER];
+};
+
+/**
+ * @brief Losuje ciąg zmian.
+ * Około co trzydziesta zmiana jest niepoprawnym dodaniem.
+ * @param[out] changes - tablica na APPLY_CHANGES_TEST_CHANGES zmian.
+ * @param[out] buffer - bufor na numery zmian.
+ * @param[out] invalid - indeks pierwszego niepoprawnego dodania lub
+ *             liczba zmian, jeśli takiego nie ma.
+ * @return Liczba zmian.
+ */
+static size_t applyChangesTestDraw(struct PhoneForwardChange *changes,
+                                   struct ApplyChangesTestBuffer *buffer,
+                                   size_t *invalid) {
+    size_t count = testRandom(APPLY_CHANGES_TEST_CHANGES + 1);
+    size_t i;
+    *invalid = count;
+    for (i = 0; i < count; i++) {
+        testRandomNumber(buffer->num1[i], 4, 3);
+        changes[i].num1 = buffer->num1[i];
+        size_t kind = testRandom(30);
+        if (kind < 8) {
+            changes[i].num2 = NULL;
+        } else if (kind == 8) {
+            strcpy(buffer->num2[i], buffer->num1[i]);
+            changes[i].num2 = buffer->num2[i];
+        } else {
+            testRandomNumber(buffer->num2[i], 3, 3);
+            changes[i].num2 = buffer->num2[i];
+        }
+        if (changes[i].num2 != NULL
+            && strcmp(changes[i].num1, changes[i].num2) == 0
+            && *invalid == count) {
+            *invalid = i;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(78);
+    static struct TestModel model;
+    static struct ApplyChangesTestBuffer buffer;
+    struct PhoneForwardChange changes[APPLY_CHANGES_TEST_CHANGES];
+    size_t stopped = 0;
+    size_t round;
+    for (round = 0; round < APPLY_CHANGES_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        size_t batch;
+        for (batch = 0; batch < APPLY_CHANGES_TEST_BATCHES; batch++) {
+            size_t invalid;
+            size_t count = applyChangesTestDraw(changes, &buffer, &invalid);
+            size_t i;
+            for (i = 0; i < invalid; i++) {
+                if (changes[i].num2 == NULL) {
+                    testModelRemove(&model, changes[i].num1);
+                } else {
+                    testModelAdd(&model, changes[i].num1, changes[i].num2,
+                                 PHFWD_NO_EXPIRY);
+                }
+            }
+            if (invalid != count) {
+                stopped++;
+            }
+
+            size_t applied = phfwdApplyChanges(pf, changes, count);
+            testCheck(applied == invalid, "%zu of %zu changes applied, "
+                                          "expected %zu", applied, count,
+                      invalid);
+            testModelCheckRules(pf, &model);
+            for (i = 0; i < APPLY_CHANGES_TEST_QUERIES; i++) {
+                char num[TEST_MODEL_NUMBER];
+                testRandomNumber(num, 6, 3);
+                testModelCheckGet(pf, &model, num);
+                const struct PhoneNumbers *pnum = phfwdReverse(pf, num);
+                testModelCheckReverse(pnum, &model, num);
+                phnumDelete(pnum);
+            }
+        }
+        testCheck(phfwdApplyChanges(pf, NULL, 0) == 0, "empty sequence");
+        phfwdDelete(pf);
+    }
+    testCheck(stopped != 0, "no sequence stopped on an invalid change");
+    return testResult("apply_changes");
+}
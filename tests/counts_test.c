@@ -0,0 +1,168 @@
+/** @file
+ * Test liczników przekierowań.
+ * Wyniki @ref phfwdReverseCount, @ref phfwdSourcesCount
+ * i @ref phfwdTargetsCount są porównywane z modelem po losowych
+ * dodaniach, zastąpieniach, usunięciach i wygaśnięciach przekierowań,
+ * które zmieniają liczniki utrzymywane w drzewach.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define COUNTS_TEST_ROUNDS 20
+
+/**
+ * @brief Liczba operacji na jednej strukturze.
+ */
+#define COUNTS_TEST_OPERATIONS 3000
+
+/**
+ * @brief Liczba zapytań po każdej operacji.
+ */
+#define COUNTS_TEST_QUERIES 3
+
+/**
+ * @brief Liczy przekierowania na prefiksy numeru według modelu.
+ * @param[in] model - model.
+ * @param[in] num - numer.
+ * @return Liczba przekierowań, których cel jest prefiksem @p num.
+ */
+static size_t countsTestReverse(const struct TestModel *model,
+                                const char *num) {
+    size_t result = 0;
+    size_t i;
+    for (i = 0; i < model->count; i++) {
+        if (testIsPrefix(model->rules[i].target, num)) {
+            result++;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Liczy przekierowywane prefiksy o danym prefiksie według modelu.
+ * @param[in] model - model.
+ * @param[in] prefix - prefiks.
+ * @return Liczba przekierowań, których źródło ma prefiks @p prefix.
+ */
+static size_t countsTestSources(const struct TestModel *model,
+                                const char *prefix) {
+    size_t result = 0;
+    size_t i;
+    for (i = 0; i < model->count; i++) {
+        if (testIsPrefix(prefix, model->rules[i].source)) {
+            result++;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Liczy różne cele przekierowań o danym prefiksie według modelu.
+ * @param[in] model - model.
+ * @param[in] prefix - prefiks.
+ * @return Liczba różnych celów z prefiksem @p prefix.
+ */
+static size_t countsTestTargets(const struct TestModel *model,
+                                const char *prefix) {
+    size_t result = 0;
+    size_t i, j;
+    for (i = 0; i < model->count; i++) {
+        const char *target = model->rules[i].target;
+        if (!testIsPrefix(prefix, target)) {
+            continue;
+        }
+        for (j = 0; j < i; j++) {
+            if (strcmp(model->rules[j].target, target) == 0) {
+                break;
+            }
+        }
+        if (j == i) {
+            result++;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Wykonuje losową operację na strukturze i modelu.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in, out] model - model.
+ * @param[in, out] now - czas logiczny.
+ */
+static void countsTestOperation(struct PhoneForward *pf,
+                                struct TestModel *model, uint64_t *now) {
+    char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+    size_t kind = testRandom(20);
+    if (kind < 12) {
+        testRandomNumber(num1, 6, 3);
+        testRandomNumber(num2, 6, 3);
+        uint64_t expiresAt = kind == 0 ? *now + 1 + testRandom(100)
+                                       : PHFWD_NO_EXPIRY;
+        if (model->count < TEST_MODEL_RULES
+            && phfwdAddExpiring(pf, num1, num2, expiresAt)) {
+            testModelAdd(model, num1, num2, expiresAt);
+        }
+    } else if (kind < 14) {
+        testRandomNumber(num1, 4, 3);
+        phfwdRemove(pf, num1);
+        testModelRemove(model, num1);
+    } else if (kind == 14) {
+        (*now)++;
+        phfwdAdvanceClock(pf, *now);
+        testModelExpire(model, *now);
+    }
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(86);
+    static struct TestModel model;
+    size_t round;
+    for (round = 0; round < COUNTS_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        uint64_t now = 0;
+        size_t operation;
+        for (operation = 0; operation < COUNTS_TEST_OPERATIONS; operation++) {
+            countsTestOperation(pf, &model, &now);
+            size_t i;
+            for (i = 0; i < COUNTS_TEST_QUERIES; i++) {
+                char num[TEST_MODEL_NUMBER];
+                testRandomNumber(num, 7, 3);
+                size_t reverse = phfwdReverseCount(pf, num);
+                size_t sources = phfwdSourcesCount(pf, num);
+                size_t targets = phfwdTargetsCount(pf, num);
+                testCheck(reverse == countsTestReverse(&model, num),
+                          "reverse count %s: %zu, expected %zu", num, reverse,
+                          countsTestReverse(&model, num));
+                testCheck(sources == countsTestSources(&model, num),
+                          "sources count %s: %zu, expected %zu", num, sources,
+                          countsTestSources(&model, num));
+                testCheck(targets == countsTestTargets(&model, num),
+                          "targets count %s: %zu, expected %zu", num, targets,
+                          countsTestTargets(&model, num));
+            }
+        }
+        testCheck(phfwdReverseCount(pf, "1x") == 0
+                  && phfwdSourcesCount(pf, "") == 0
+                  && phfwdTargetsCount(pf, NULL) == 0,
+                  "counts of strings that are not numbers");
+        phfwdDelete(pf);
+    }
+    return testResult("counts");
+}
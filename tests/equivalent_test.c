@@ -0,0 +1,246 @@
+/** @file
+ * Test porównywania dwóch struktur przekierowań.
+ * Wynik @ref phfwdEquivalent jest porównywany z porównaniem wyników
+ * @ref phfwdGet obu struktur dla wszystkich krótkich numerów. Druga
+ * struktura powstaje z kopii pierwszej przez dodanie przekierowań
+ * niezmieniających wyników, dodanie dowolnych przekierowań lub usunięcia.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba par struktur.
+ */
+#define EQUIVALENT_TEST_ROUNDS 500
+
+/**
+ * @brief Największa liczba wspólnych przekierowań.
+ */
+#define EQUIVALENT_TEST_RULES 8
+
+/**
+ * @brief Liczba zmian drugiej struktury.
+ */
+#define EQUIVALENT_TEST_CHANGES 3
+
+/**
+ * @brief Największa długość porównywanych numerów.
+ */
+#define EQUIVALENT_TEST_LENGTH 5
+
+/**
+ * @brief Liczba używanych cyfr.
+ */
+#define EQUIVALENT_TEST_DIGITS 3
+
+/**
+ * @brief Stan porównania.
+ */
+struct EquivalentTest {
+    /**
+     * @brief Model pierwszej struktury.
+     */
+    const struct TestModel *a;
+
+    /**
+     * @brief Model drugiej struktury.
+     */
+    const struct TestModel *b;
+
+    /**
+     * @brief Liczba zgłoszonych różnic.
+     */
+    size_t count;
+
+    /**
+     * @brief Po ilu różnicach przerwać porównywanie (0 - nie przerywać).
+     */
+    size_t stopAfter;
+};
+
+/**
+ * @brief Sprawdza zgłoszoną różnicę.
+ * Używana w phfwdEquivalent. Wyniki dla prefiksu muszą być równe
+ * wynikom modeli i różne od siebie.
+ * @param[in] prefix - prefiks przedziału.
+ * @param[in] resultA - wynik pierwszej struktury.
+ * @param[in] resultB - wynik drugiej struktury.
+ * @param[in, out] data - wskaźnik na EquivalentTest.
+ * @return Wartość @p false, jeśli należy przerwać porównywanie.
+ */
+static bool equivalentTestDifference(const char *prefix, const char *resultA,
+                                     const char *resultB, void *data) {
+    struct EquivalentTest *test = data;
+    char expectedA[TEST_MODEL_RESULT], expectedB[TEST_MODEL_RESULT];
+    testModelGet(test->a, prefix, expectedA);
+    testModelGet(test->b, prefix, expectedB);
+    testCheck(strcmp(resultA, expectedA) == 0
+              && strcmp(resultB, expectedB) == 0,
+              "difference at %s: %s and %s, expected %s and %s", prefix,
+              resultA, resultB, expectedA, expectedB);
+    testCheck(strcmp(resultA, resultB) != 0,
+              "difference at %s with equal results %s", prefix, resultA);
+    test->count++;
+    return test->count != test->stopAfter;
+}
+
+/**
+ * @brief Dodaje przekierowanie do modelu.
+ * Używana w phfwdForEach.
+ * @param[in] num1 - prefiks numerów przekierowywanych.
+ * @param[in] num2 - prefiks, na który jest przekierowanie.
+ * @param[in, out] data - wskaźnik na TestModel.
+ * @return Wartość @p true.
+ */
+static bool equivalentTestCollect(const char *num1, const char *num2,
+                                  void *data) {
+    testModelAdd(data, num1, num2, PHFWD_NO_EXPIRY);
+    return true;
+}
+
+/**
+ * @brief Liczy numery, dla których wyniki modeli są różne.
+ * Sprawdza przy tym, czy modele przekierowują numery tak jak struktury.
+ * @param[in] pfA - pierwsza struktura.
+ * @param[in] pfB - druga struktura.
+ * @param[in] a - model pierwszej struktury.
+ * @param[in] b - model drugiej struktury.
+ * @return Liczba numerów o długości od 1 do EQUIVALENT_TEST_LENGTH
+ *         z cyframi od '0' do '0' + EQUIVALENT_TEST_DIGITS - 1,
+ *         dla których wyniki są różne.
+ */
+static size_t equivalentTestBrute(struct PhoneForward *pfA,
+                                  struct PhoneForward *pfB,
+                                  const struct TestModel *a,
+                                  const struct TestModel *b) {
+    size_t result = 0;
+    size_t length;
+    for (length = 1; length <= EQUIVALENT_TEST_LENGTH; length++) {
+        char num[EQUIVALENT_TEST_LENGTH + 1];
+        size_t indices[EQUIVALENT_TEST_LENGTH] = {0};
+        size_t i;
+        num[length] = '\0';
+        do {
+            for (i = 0; i < length; i++) {
+                num[i] = (char) ('0' + indices[i]);
+            }
+            testModelCheckGet(pfA, a, num);
+            testModelCheckGet(pfB, b, num);
+            char resultA[TEST_MODEL_RESULT], resultB[TEST_MODEL_RESULT];
+            testModelGet(a, num, resultA);
+            testModelGet(b, num, resultB);
+            if (strcmp(resultA, resultB) != 0) {
+                result++;
+            }
+            for (i = 0; i < length && ++indices[i] == EQUIVALENT_TEST_DIGITS;
+                 i++) {
+                indices[i] = 0;
+            }
+        } while (i != length);
+    }
+    return result;
+}
+
+/**
+ * @brief Zmienia drugą strukturę.
+ * @param[in] a - pierwsza struktura.
+ * @param[in, out] b - druga struktura.
+ * @param[in] mode - rodzaj zmian: 0 - przekierowania numerów na ich wynik
+ *                   w pierwszej strukturze, 1 - dowolne przekierowania,
+ *                   2 - usunięcia.
+ */
+static void equivalentTestChange(struct PhoneForward *a, struct PhoneForward *b,
+                                 size_t mode) {
+    size_t i;
+    for (i = 0; i < EQUIVALENT_TEST_CHANGES; i++) {
+        char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+        testRandomNumber(num1, 3, EQUIVALENT_TEST_DIGITS);
+        if (mode == 0) {
+            const struct PhoneNumbers *pnum = phfwdGet(a, num1);
+            const char *result = phnumGet(pnum, 0);
+            if (result != NULL && strcmp(result, num1) != 0) {
+                phfwdAdd(b, num1, result);
+            }
+            phnumDelete(pnum);
+        } else if (mode == 1) {
+            testRandomNumber(num2, 3, EQUIVALENT_TEST_DIGITS);
+            phfwdAdd(b, num1, num2);
+        } else {
+            phfwdRemove(b, num1);
+        }
+    }
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(93);
+    static struct TestModel modelA, modelB;
+    struct EquivalentTest test;
+    size_t equal = 0;
+    size_t round;
+    for (round = 0; round < EQUIVALENT_TEST_ROUNDS; round++) {
+        struct PhoneForward *a = phfwdNew();
+        struct PhoneForward *b = phfwdNew();
+        if (!testCheck(a != NULL && b != NULL, "phfwdNew")) {
+            phfwdDelete(a);
+            phfwdDelete(b);
+            break;
+        }
+        size_t rules = testRandom(EQUIVALENT_TEST_RULES);
+        size_t i;
+        for (i = 0; i < rules; i++) {
+            char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+            testRandomNumber(num1, 3, EQUIVALENT_TEST_DIGITS);
+            testRandomNumber(num2, 3, EQUIVALENT_TEST_DIGITS);
+            phfwdAdd(a, num1, num2);
+            phfwdAdd(b, num1, num2);
+        }
+        equivalentTestChange(a, b, testRandom(3));
+
+        testModelInit(&modelA);
+        testModelInit(&modelB);
+        phfwdForEach(a, equivalentTestCollect, &modelA);
+        phfwdForEach(b, equivalentTestCollect, &modelB);
+        size_t differences = equivalentTestBrute(a, b, &modelA, &modelB);
+
+        bool equivalent = false;
+        test.a = &modelA;
+        test.b = &modelB;
+        test.count = 0;
+        test.stopAfter = testRandom(4) == 0 ? 1 : 0;
+        if (testCheck(phfwdEquivalent(a, b, equivalentTestDifference, &test,
+                                      &equivalent),
+                      "phfwdEquivalent")) {
+            testCheck(equivalent == (differences == 0),
+                      "equivalent %d, %zu numbers differ", equivalent,
+                      differences);
+            testCheck((test.count != 0) == (differences != 0),
+                      "%zu differences reported, %zu numbers differ",
+                      test.count, differences);
+            testCheck(test.stopAfter == 0 || test.count <= test.stopAfter,
+                      "comparison not stopped");
+        }
+
+        bool reversed = !equivalent;
+        testCheck(phfwdEquivalent(b, a, NULL, NULL, &reversed)
+                  && reversed == equivalent,
+                  "comparison is not symmetric");
+        if (equivalent) {
+            equal++;
+        }
+        phfwdDelete(a);
+        phfwdDelete(b);
+    }
+    testCheck(equal != 0 && equal != EQUIVALENT_TEST_ROUNDS,
+              "all pairs gave the same answer");
+    return testResult("equivalent");
+}
@@ -0,0 +1,124 @@
+/** @file
+ * Test przybliżonej liczby nietrywialnych numerów.
+ * Przy wystarczającym limicie węzłów wynik @ref phfwdNonTrivialCountEstimate
+ * musi być dokładny i równy wynikowi @ref phfwdNonTrivialCount. Przy
+ * losowaniu próbek dokładny wynik musi w większości struktur leżeć
+ * w przedziale ufności, także gdy poddrzewa mają bardzo różną liczbę
+ * przekierowań.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define ESTIMATE_TEST_ROUNDS 200
+
+/**
+ * @brief Największa liczba przekierowań w gęstym poddrzewie.
+ */
+#define ESTIMATE_TEST_RULES 300
+
+/**
+ * @brief Liczba próbek jednego oszacowania.
+ */
+#define ESTIMATE_TEST_SAMPLES 4000
+
+/**
+ * @brief Długość liczonych numerów.
+ */
+#define ESTIMATE_TEST_LENGTH 9
+
+/**
+ * @brief Największa dopuszczalna liczba struktur, dla których dokładny
+ * wynik leży poza przedziałem ufności (dla 95% przedziału oczekiwane jest
+ * około 5% struktur).
+ */
+#define ESTIMATE_TEST_MISSES (ESTIMATE_TEST_ROUNDS / 8)
+
+/**
+ * @brief Tworzy strukturę z gęstym poddrzewem celów i kilkoma innymi celami.
+ * @param[in, out] pf - wskaźnik na pustą strukturę.
+ */
+static void estimateTestFill(struct PhoneForward *pf) {
+    char dense = (char) ('0' + testRandom(10));
+    size_t rules = 1 + testRandom(ESTIMATE_TEST_RULES);
+    size_t i;
+    for (i = 0; i < rules; i++) {
+        char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+        testRandomNumber(num1, 8, 10);
+        num2[0] = dense;
+        testRandomNumber(num2 + 1, 6, 10);
+        phfwdAdd(pf, num1, num2);
+    }
+    size_t others = testRandom(4);
+    for (i = 0; i < others; i++) {
+        char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+        testRandomNumber(num1, 8, 10);
+        testRandomNumber(num2, 1 + testRandom(6), 10);
+        phfwdAdd(pf, num1, num2);
+    }
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(85);
+    size_t sampled = 0, misses = 0;
+    size_t round;
+    for (round = 0; round < ESTIMATE_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        estimateTestFill(pf);
+        const char *set = testRandom(2) == 0 ? "0123456789" : "013579";
+        double exact = (double) phfwdNonTrivialCount(pf, set,
+                                                     ESTIMATE_TEST_LENGTH);
+
+        struct PhoneForwardEstimateBudget budget;
+        struct PhoneForwardEstimate estimate;
+        memset(&budget, 0, sizeof(budget));
+        budget.exactLimit = SIZE_MAX;
+        testCheck(phfwdNonTrivialCountEstimate(pf, set, ESTIMATE_TEST_LENGTH,
+                                               &budget, &estimate)
+                  && estimate.exact && estimate.estimate == exact,
+                  "exact estimate %.0f, expected %.0f", estimate.estimate,
+                  exact);
+
+        budget.exactLimit = 0;
+        budget.maxSamples = ESTIMATE_TEST_SAMPLES;
+        budget.seed = round + 1;
+        if (testCheck(phfwdNonTrivialCountEstimate(pf, set,
+                                                   ESTIMATE_TEST_LENGTH,
+                                                   &budget, &estimate),
+                      "phfwdNonTrivialCountEstimate")) {
+            if (estimate.exact) {
+                testCheck(estimate.estimate == exact,
+                          "exact estimate %.0f without visits, expected %.0f",
+                          estimate.estimate, exact);
+            } else {
+                testCheck(estimate.samples == ESTIMATE_TEST_SAMPLES,
+                          "%zu samples", estimate.samples);
+                sampled++;
+                if (exact < estimate.low || exact > estimate.high) {
+                    misses++;
+                }
+            }
+        }
+        phfwdDelete(pf);
+    }
+    testCheck(sampled >= ESTIMATE_TEST_ROUNDS / 2,
+              "only %zu structures estimated by sampling", sampled);
+    testCheck(misses <= ESTIMATE_TEST_MISSES,
+              "exact result outside the interval for %zu structures", misses);
+    return testResult("estimate");
+}
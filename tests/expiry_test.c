@@ -0,0 +1,297 @@
+/** @file
+ * Testy koła czasowego i wygasających przekierowań.
+ * Koło czasowe jest porównywane z listą terminów, a przekierowania
+ * z terminami z modelem przekierowań, dla losowych ciągów operacji.
+ * Terminy są losowane z odległości pokrywających wszystkie poziomy koła,
+ * a czas jest przesuwany o małe i duże kroki, więc terminy są przenoszone
+ * między poziomami. Osobny przypadek usuwa naraz przekierowania
+ * z zagnieżdżonymi prefiksami, po czym drzewa są scalane.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test_model.h"
+#include "timer_wheel.h"
+
+/**
+ * @brief Liczba terminów w teście koła czasowego.
+ */
+#define EXPIRY_TEST_TIMERS 2000
+
+/**
+ * @brief Liczba operacji w teście koła czasowego.
+ */
+#define EXPIRY_TEST_WHEEL_OPERATIONS 50000
+
+/**
+ * @brief Liczba struktur w teście wygasających przekierowań.
+ */
+#define EXPIRY_TEST_ROUNDS 60
+
+/**
+ * @brief Liczba operacji na jednej strukturze.
+ */
+#define EXPIRY_TEST_OPERATIONS 400
+
+/**
+ * @brief Liczba sprawdzanych numerów po każdej operacji.
+ */
+#define EXPIRY_TEST_QUERIES 8
+
+/**
+ * @brief Długość łańcucha zagnieżdżonych prefiksów.
+ */
+#define EXPIRY_TEST_CHAIN 12
+
+/**
+ * @brief Termin w teście koła czasowego.
+ */
+struct ExpiryTestTimer {
+    /**
+     * @brief Termin.
+     */
+    uint64_t deadline;
+
+    /**
+     * @brief Pozycja w kole lub NULL, gdy termin nie jest dodany.
+     */
+    TimerWheelEntry entry;
+};
+
+/**
+ * @brief Terminy w teście koła czasowego.
+ */
+static struct ExpiryTestTimer expiryTestTimers[EXPIRY_TEST_TIMERS];
+
+/**
+ * @brief Bieżący czas w teście koła czasowego.
+ */
+static uint64_t expiryTestNow;
+
+/**
+ * @brief Losuje odległość terminu od bieżącego czasu.
+ * Odległości są rozłożone na wszystkie poziomy koła.
+ * @return Odległość.
+ */
+static uint64_t expiryTestDistance() {
+    uint64_t value = 0;
+    size_t i;
+    for (i = 0; i < 4; i++) {
+        value = (value << 16) ^ testRandom((size_t) 1 << 16);
+    }
+    return value >> testRandom(64);
+}
+
+/**
+ * @brief Sprawdza upłynięty termin.
+ * Używana w timerWheelAdvance.
+ * @param[in, out] data - wskaźnik na ExpiryTestTimer.
+ * @param[in] fData - nieużywane.
+ */
+static void expiryTestFired(void *data, void *fData) {
+    (void) fData;
+    struct ExpiryTestTimer *timer = data;
+    testCheck(timer->entry != NULL && timer->deadline <= expiryTestNow,
+              "timer %llu fired at %llu",
+              (unsigned long long) timer->deadline,
+              (unsigned long long) expiryTestNow);
+    timer->entry = NULL;
+}
+
+/**
+ * @brief Porównuje koło czasowe z listą terminów.
+ */
+static void expiryTestWheel() {
+    expiryTestNow = 1000;
+    TimerWheel wheel = timerWheelCreate(expiryTestNow);
+    if (!testCheck(wheel != NULL, "timerWheelCreate")) {
+        return;
+    }
+    size_t i;
+    for (i = 0; i < EXPIRY_TEST_TIMERS; i++) {
+        expiryTestTimers[i].entry = NULL;
+    }
+
+    size_t operation;
+    for (operation = 0; operation < EXPIRY_TEST_WHEEL_OPERATIONS; operation++) {
+        struct ExpiryTestTimer *timer =
+                &expiryTestTimers[testRandom(EXPIRY_TEST_TIMERS)];
+        size_t kind = testRandom(10);
+        if (kind < 7 && timer->entry != NULL) {
+            timerWheelCancel(wheel, timer->entry);
+            timer->entry = NULL;
+        }
+        if (kind < 5) {
+            uint64_t distance = expiryTestDistance();
+            timer->deadline = kind == 0 ? expiryTestNow - testRandom(50)
+                                        : expiryTestNow + distance;
+            if (timer->deadline < expiryTestNow && kind != 0) {
+                timer->deadline = UINT64_MAX;
+            }
+            timer->entry = timerWheelAdd(wheel, timer->deadline, timer);
+            testCheck(timer->entry != NULL, "timerWheelAdd");
+        } else if (kind >= 7) {
+            uint64_t step = testRandom(2) == 0 ? testRandom(100)
+                                               : expiryTestDistance();
+            if (expiryTestNow + step < expiryTestNow) {
+                step = 0;
+            }
+            expiryTestNow += step;
+            timerWheelAdvance(wheel, expiryTestNow, expiryTestFired, NULL);
+            testCheck(timerWheelNow(wheel) == expiryTestNow, "timerWheelNow");
+            for (i = 0; i < EXPIRY_TEST_TIMERS; i++) {
+                struct ExpiryTestTimer *pending = &expiryTestTimers[i];
+                testCheck(pending->entry == NULL
+                          || pending->deadline > expiryTestNow,
+                          "timer %llu pending at %llu",
+                          (unsigned long long) pending->deadline,
+                          (unsigned long long) expiryTestNow);
+            }
+        }
+    }
+    timerWheelDelete(wheel);
+}
+
+/**
+ * @brief Porównuje strukturę z modelem na losowych numerach.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] model - model.
+ */
+static void expiryTestCompare(struct PhoneForward *pf,
+                              const struct TestModel *model) {
+    char num[TEST_MODEL_NUMBER];
+    size_t i;
+    for (i = 0; i < EXPIRY_TEST_QUERIES; i++) {
+        testRandomNumber(num, 6, 3);
+        testModelCheckGet(pf, model, num);
+    }
+    testModelCheckRules(pf, model);
+}
+
+/**
+ * @brief Porównuje wygasające przekierowania z modelem.
+ * Zastąpienie i usunięcie przekierowania musi anulować jego termin.
+ */
+static void expiryTestRandom() {
+    struct TestModel model;
+    size_t round;
+    for (round = 0; round < EXPIRY_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            return;
+        }
+        testModelInit(&model);
+        uint64_t now = 0;
+        size_t operation;
+        for (operation = 0; operation < EXPIRY_TEST_OPERATIONS; operation++) {
+            char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+            size_t kind = testRandom(10);
+            if (kind < 5) {
+                testRandomNumber(num1, 4, 3);
+                testRandomNumber(num2, 3, 3);
+                uint64_t expiresAt = PHFWD_NO_EXPIRY;
+                if (kind < 3) {
+                    expiresAt = now + 1 + (kind == 0 ? expiryTestDistance()
+                                                     : testRandom(50));
+                    if (expiresAt <= now) {
+                        expiresAt = UINT64_MAX;
+                    }
+                }
+                bool added = phfwdAddExpiring(pf, num1, num2, expiresAt);
+                testCheck(added == (strcmp(num1, num2) != 0),
+                          "add %s>%s", num1, num2);
+                if (added) {
+                    testModelAdd(&model, num1, num2, expiresAt);
+                }
+            } else if (kind < 7) {
+                testRandomNumber(num1, 3, 3);
+                phfwdRemove(pf, num1);
+                testModelRemove(&model, num1);
+            } else {
+                uint64_t next = now + testRandom(30);
+                size_t expired = phfwdAdvanceClock(pf, next);
+                size_t expected = next > now ? testModelExpire(&model, next)
+                                             : 0;
+                testCheck(expired == expected, "expired %zu, expected %zu",
+                          expired, expected);
+                if (next > now) {
+                    now = next;
+                }
+            }
+            expiryTestCompare(pf, &model);
+        }
+        phfwdDelete(pf);
+    }
+}
+
+/**
+ * @brief Usuwa naraz przekierowania z zagnieżdżonymi prefiksami.
+ * Przekierowania z co drugiego prefiksu łańcucha i jego rozgałęzień
+ * wygasają w jednej chwili, więc ich węzły są scalane z sąsiadami.
+ * Pozostałe przekierowania wygasają później i muszą nadal wskazywać
+ * właściwe węzły drzewa.
+ */
+static void expiryTestBatch() {
+    struct PhoneForward *pf = phfwdNew();
+    if (!testCheck(pf != NULL, "phfwdNew")) {
+        return;
+    }
+    struct TestModel model;
+    testModelInit(&model);
+    char chain[EXPIRY_TEST_CHAIN + 2];
+    char num[EXPIRY_TEST_CHAIN + 2];
+    size_t i;
+    for (i = 0; i < EXPIRY_TEST_CHAIN; i++) {
+        chain[i] = (char) ('1' + i % 9);
+        chain[i + 1] = '\0';
+        uint64_t expiresAt = i % 2 == 0 ? 10 : 20 + i;
+        phfwdAddExpiring(pf, chain, "0", expiresAt);
+        testModelAdd(&model, chain, "0", expiresAt);
+        strcpy(num, chain);
+        strcat(num, "0");
+        phfwdAddExpiring(pf, num, "00", 10);
+        testModelAdd(&model, num, "00", 10);
+    }
+    phfwdAdd(pf, "123456789", "5");
+    testModelAdd(&model, "123456789", "5", PHFWD_NO_EXPIRY);
+    expiryTestCompare(pf, &model);
+
+    uint64_t now;
+    for (now = 10; now < 25 + EXPIRY_TEST_CHAIN; now += 5) {
+        size_t expired = phfwdAdvanceClock(pf, now);
+        size_t expected = testModelExpire(&model, now);
+        testCheck(expired == expected, "batch expired %zu, expected %zu",
+                  expired, expected);
+        for (i = 1; i <= EXPIRY_TEST_CHAIN; i++) {
+            strcpy(num, chain);
+            num[i] = '0';
+            num[i + 1] = '\0';
+            testModelCheckGet(pf, &model, num);
+            num[i] = '\0';
+            testModelCheckGet(pf, &model, num);
+        }
+        testModelCheckRules(pf, &model);
+        testCheck(phfwdReverseCount(pf, "00") == model.count - 1,
+                  "reverse count %zu after expiry, expected %zu",
+                  phfwdReverseCount(pf, "00"), model.count - 1);
+    }
+    testCheck(model.count == 1, "batch left %zu rules", model.count);
+    phfwdDelete(pf);
+}
+
+/**
+ * @brief Uruchamia testy.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(88);
+    expiryTestWheel();
+    expiryTestRandom();
+    expiryTestBatch();
+    return testResult("expiry");
+}
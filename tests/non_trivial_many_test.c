@@ -0,0 +1,208 @@
+/** @file
+ * Test obliczania liczby nietrywialnych numerów dla wielu zapytań.
+ * Wyniki @ref phfwdNonTrivialCountMany są porównywane z wynikami
+ * @ref phfwdNonTrivialCount, a dla krótkich numerów także z liczbą
+ * nietrywialnych numerów wyznaczoną przez przejrzenie wszystkich numerów
+ * danej długości. Zbiory cyfr zawierają powtórzenia i znaki niebędące
+ * cyframi, a długości sięgają daleko poza głębokość drzewa.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define NON_TRIVIAL_MANY_TEST_ROUNDS 100
+
+/**
+ * @brief Największa liczba przekierowań w strukturze.
+ */
+#define NON_TRIVIAL_MANY_TEST_RULES 40
+
+/**
+ * @brief Liczba zapytań dla jednej struktury.
+ */
+#define NON_TRIVIAL_MANY_TEST_QUERIES 30
+
+/**
+ * @brief Największa długość numeru porównywana z przeglądaniem
+ * wszystkich numerów.
+ */
+#define NON_TRIVIAL_MANY_TEST_BRUTE_LENGTH 5
+
+/**
+ * @brief Największa liczba numerów przeglądanych dla jednego zapytania.
+ */
+#define NON_TRIVIAL_MANY_TEST_BRUTE_NUMBERS 4096
+
+/**
+ * @brief Rozmiar bufora na zbiór cyfr.
+ */
+#define NON_TRIVIAL_MANY_TEST_SET 16
+
+/**
+ * @brief Wszystkie cyfry.
+ */
+#define NON_TRIVIAL_MANY_TEST_DIGITS "0123456789:;"
+
+/**
+ * @brief Sprawdza, czy numer jest nietrywialny według modelu.
+ * @param[in] model - model.
+ * @param[in] num - numer.
+ * @return Wartość @p true, jeśli cel któregoś przekierowania jest
+ *         prefiksem @p num.
+ */
+static bool nonTrivialManyTestIsNonTrivial(const struct TestModel *model,
+                                           const char *num) {
+    size_t i;
+    for (i = 0; i < model->count; i++) {
+        if (testIsPrefix(model->rules[i].target, num)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Liczy nietrywialne numery, przeglądając wszystkie numery.
+ * @param[in] model - model.
+ * @param[in] set - zbiór cyfr.
+ * @param[in] len - długość numeru.
+ * @param[out] result - liczba nietrywialnych numerów.
+ * @return Wartość @p false, jeśli numerów do przejrzenia jest więcej niż
+ *         NON_TRIVIAL_MANY_TEST_BRUTE_NUMBERS.
+ */
+static bool nonTrivialManyTestBrute(const struct TestModel *model,
+                                    const char *set, size_t len,
+                                    size_t *result) {
+    char digits[NON_TRIVIAL_MANY_TEST_SET];
+    size_t count = 0;
+    const char *pos;
+    for (pos = NON_TRIVIAL_MANY_TEST_DIGITS; *pos != '\0'; pos++) {
+        if (strchr(set, *pos) != NULL) {
+            digits[count++] = *pos;
+        }
+    }
+    *result = 0;
+    if (count == 0 || len == 0) {
+        return true;
+    }
+    size_t numbers = 1;
+    size_t i;
+    for (i = 0; i < len; i++) {
+        numbers *= count;
+    }
+    if (numbers > NON_TRIVIAL_MANY_TEST_BRUTE_NUMBERS) {
+        return false;
+    }
+
+    char num[NON_TRIVIAL_MANY_TEST_BRUTE_LENGTH + 1];
+    size_t indices[NON_TRIVIAL_MANY_TEST_BRUTE_LENGTH] = {0};
+    num[len] = '\0';
+    while (true) {
+        for (i = 0; i < len; i++) {
+            num[i] = digits[indices[i]];
+        }
+        if (nonTrivialManyTestIsNonTrivial(model, num)) {
+            (*result)++;
+        }
+        for (i = 0; i < len && ++indices[i] == count; i++) {
+            indices[i] = 0;
+        }
+        if (i == len) {
+            return true;
+        }
+    }
+}
+
+/**
+ * @brief Losuje zbiór cyfr zapytania.
+ * @param[out] set - bufor na NON_TRIVIAL_MANY_TEST_SET znaków.
+ */
+static void nonTrivialManyTestSet(char *set) {
+    size_t length = testRandom(NON_TRIVIAL_MANY_TEST_SET - 1);
+    size_t i;
+    for (i = 0; i < length; i++) {
+        size_t kind = testRandom(10);
+        if (kind == 0) {
+            set[i] = 'x';
+        } else if (kind < 3) {
+            set[i] = NON_TRIVIAL_MANY_TEST_DIGITS[testRandom(12)];
+        } else {
+            set[i] = (char) ('0' + testRandom(4));
+        }
+    }
+    set[length] = '\0';
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(84);
+    struct TestModel model;
+    char sets[NON_TRIVIAL_MANY_TEST_QUERIES][NON_TRIVIAL_MANY_TEST_SET];
+    const char *queries[NON_TRIVIAL_MANY_TEST_QUERIES];
+    size_t lens[NON_TRIVIAL_MANY_TEST_QUERIES];
+    size_t results[NON_TRIVIAL_MANY_TEST_QUERIES];
+    size_t checked = 0;
+
+    size_t round;
+    for (round = 0; round < NON_TRIVIAL_MANY_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        size_t rules = testRandom(NON_TRIVIAL_MANY_TEST_RULES);
+        size_t i;
+        for (i = 0; i < rules; i++) {
+            char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+            testRandomNumber(num1, 4, 12);
+            testRandomNumber(num2, 4, testRandom(4) == 0 ? 12 : 4);
+            if (phfwdAdd(pf, num1, num2)) {
+                testModelAdd(&model, num1, num2, PHFWD_NO_EXPIRY);
+            }
+        }
+
+        for (i = 0; i < NON_TRIVIAL_MANY_TEST_QUERIES; i++) {
+            nonTrivialManyTestSet(sets[i]);
+            queries[i] = testRandom(20) == 0 ? NULL : sets[i];
+            lens[i] = testRandom(4) == 0
+                      ? testRandom(1000)
+                      : testRandom(NON_TRIVIAL_MANY_TEST_BRUTE_LENGTH + 1);
+        }
+        if (!testCheck(phfwdNonTrivialCountMany(pf, queries, lens,
+                                                NON_TRIVIAL_MANY_TEST_QUERIES,
+                                                results),
+                       "phfwdNonTrivialCountMany")) {
+            phfwdDelete(pf);
+            continue;
+        }
+        for (i = 0; i < NON_TRIVIAL_MANY_TEST_QUERIES; i++) {
+            const char *set = queries[i] == NULL ? "(null)" : queries[i];
+            size_t single = phfwdNonTrivialCount(pf, queries[i], lens[i]);
+            testCheck(results[i] == single, "many %s %zu: %zu, single %zu",
+                      set, lens[i], results[i], single);
+            size_t expected;
+            if (queries[i] != NULL
+                && lens[i] <= NON_TRIVIAL_MANY_TEST_BRUTE_LENGTH
+                && nonTrivialManyTestBrute(&model, queries[i], lens[i],
+                                           &expected)) {
+                testCheck(single == expected, "count %s %zu: %zu, expected %zu",
+                          set, lens[i], single, expected);
+                checked++;
+            }
+        }
+        phfwdDelete(pf);
+    }
+    testCheck(checked != 0, "no query compared with brute force");
+    return testResult("non_trivial_many");
+}
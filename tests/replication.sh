@@ -0,0 +1,121 @@
+#!/bin/bash
+
+#Sprawdza replikację: lider i dwaj naśladowcy działają lokalnie,
+#a ich standardowe wejścia pozostają bezczynne między poleceniami.
+#Naśladowcy muszą pobrać obraz baz od bezczynnego lidera, a następnie
+#stosować i potwierdzać rekordy bez danych na swoim wejściu. Naśladowca,
+#który przeżył lidera, musi dalej odpowiadać na zapytania i odrzucać zmiany.
+#Użycie: replication.sh <program>
+
+if [ "$#" != "1" ]
+then
+	echo 'Zła liczba argumentów oczekiwano <program>'
+	exit 1
+fi
+
+PROGRAM_PATH=$1
+WAIT=1
+
+DIR=$(mktemp -d) || { echo 'Nie udało się stworzyć katalogu tymczasowego.'; exit 1; }
+pids=()
+
+#Kończy uruchomione procesy i usuwa katalog tymczasowy.
+function clean {
+	for pid in ${pids[@]}
+	do
+		kill "$pid" 2> /dev/null
+	done
+	rm -rf "$DIR"
+}
+
+trap clean EXIT
+
+#Wypisuje wiadomość $1 oraz wyjście błędów procesów i kończy skrypt kodem 1.
+function fail {
+	echo -e "$1"
+	tail -n +1 "$DIR"/*.err
+	exit 1
+}
+
+#Czeka na zakończenie procesu $1 i sprawdza, czy zakończył się kodem 0.
+#Proces jest kończony, jeżeli nie zakończy się w ciągu 10 sekund.
+function waitFor {
+	for i in $(seq 100)
+	do
+		kill -0 "$1" 2> /dev/null || break
+		sleep 0.1
+	done
+	kill "$1" 2> /dev/null && fail "Proces $1 nie zakończył się"
+	wait "$1" || fail "Proces $1 zakończony kodem $?"
+}
+
+mkfifo "$DIR/leader.in" "$DIR/f1.in" "$DIR/f2.in" "$DIR/f3.in" \
+	|| fail 'Nie udało się stworzyć kolejek.'
+
+"$PROGRAM_PATH" --leader "$DIR/sock" < "$DIR/leader.in" \
+	> "$DIR/leader.out" 2> "$DIR/leader.err" &
+leader=$!
+pids+=( $leader )
+exec 3> "$DIR/leader.in"
+
+echo -e 'NEW a\n12>34\nNEW b\n5>6' >&3
+sleep $WAIT
+
+"$PROGRAM_PATH" --follow "$DIR/sock" < "$DIR/f1.in" \
+	> "$DIR/f1.out" 2> "$DIR/f1.err" &
+f1=$!
+pids+=( $f1 )
+"$PROGRAM_PATH" --follow "$DIR/sock" < "$DIR/f2.in" \
+	> "$DIR/f2.out" 2> "$DIR/f2.err" &
+f2=$!
+pids+=( $f2 )
+"$PROGRAM_PATH" --follow "$DIR/sock" < "$DIR/f3.in" \
+	> "$DIR/f3.out" 2> "$DIR/f3.err" 3>&- &
+f3=$!
+pids+=( $f3 )
+exec 4> "$DIR/f1.in"
+exec 5> "$DIR/f2.in"
+exec 6> "$DIR/f3.in"
+sleep $WAIT
+
+echo -e 'NEW a\n56>78\nDEL 12\n9>0' >&3
+sleep $WAIT
+
+exec 4>&-
+waitFor $f1
+sleep $WAIT
+
+echo -e 'NEW a\n120 ?\n560 ?\n90 ?\nNEW b\n51 ?' >&5
+exec 5>&-
+waitFor $f2
+
+echo '$$ koniec $$' >&3
+exec 3>&-
+waitFor $leader
+sleep $WAIT
+
+grep -q 'REPLICATION leader disconnected' "$DIR/f3.err" \
+	|| fail 'Naśladowca nie zauważył odłączenia lidera.'
+(trap '' PIPE; echo -e 'NEW a\n120 ?\n1>2\n10 ?' >&6) 2> /dev/null
+exec 6>&-
+for i in $(seq 100)
+do
+	kill -0 "$f3" 2> /dev/null || break
+	sleep 0.1
+done
+wait "$f3" && fail 'Naśladowca bez lidera przyjął zmianę bazy.'
+[ "$(cat "$DIR/f3.out")" == '120' ] \
+	|| fail "Niepoprawne wyniki naśladowcy bez lidera:\n$(cat "$DIR/f3.out")"
+grep -q '^ERROR > ' "$DIR/f3.err" \
+	|| fail 'Naśladowca bez lidera nie zgłosił błędu zmiany bazy.'
+
+expected=$'120\n780\n00\n61'
+[ "$(cat "$DIR/f2.out")" == "$expected" ] \
+	|| fail "Niepoprawne wyniki naśladowcy:\n$(cat "$DIR/f2.out")"
+
+disconnected=$(grep 'REPLICATION follower disconnected' "$DIR/leader.err")
+[ -n "$disconnected" ] || fail 'Lider nie zauważył odłączenia naśladowcy.'
+echo "$disconnected" | grep -qvE ' at ([0-9]+) of \1$' \
+	&& fail "Naśladowca nie potwierdził wszystkich rekordów:\n$disconnected"
+
+exit 0
@@ -0,0 +1,237 @@
+/** @file
+ * Test opisu przekierowania wszystkich numerów z danym prefiksem.
+ * Przedziały zgłoszone przez @ref phfwdResolveRange muszą być
+ * uporządkowane, odpowiadać różnym przekierowaniom modelu i wyznaczać
+ * dla każdego numeru z prefiksem ten sam wynik co model.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define RESOLVE_RANGE_TEST_ROUNDS 300
+
+/**
+ * @brief Liczba przekierowań w strukturze.
+ */
+#define RESOLVE_RANGE_TEST_RULES 30
+
+/**
+ * @brief Liczba zapytań dla jednej struktury.
+ */
+#define RESOLVE_RANGE_TEST_QUERIES 10
+
+/**
+ * @brief Liczba sprawdzanych numerów z prefiksem zapytania.
+ */
+#define RESOLVE_RANGE_TEST_NUMBERS 40
+
+/**
+ * @brief Największa liczba przedziałów zapamiętywanych w zapytaniu.
+ */
+#define RESOLVE_RANGE_TEST_PIECES (TEST_MODEL_RULES + 1)
+
+/**
+ * @brief Przedział zgłoszony przez phfwdResolveRange.
+ */
+struct ResolveRangeTestPiece {
+    /**
+     * @brief Podprefiks przedziału.
+     */
+    char prefix[TEST_MODEL_NUMBER];
+
+    /**
+     * @brief Prefiks, na który przechodzi podprefiks.
+     */
+    char result[TEST_MODEL_RESULT];
+
+    /**
+     * @brief Źródło przekierowania lub pusty napis, gdy numery
+     * z przedziału nie są przekierowywane.
+     */
+    char source[TEST_MODEL_NUMBER];
+};
+
+/**
+ * @brief Stan zapytania.
+ */
+struct ResolveRangeTest {
+    /**
+     * @brief Model.
+     */
+    const struct TestModel *model;
+
+    /**
+     * @brief Prefiks zapytania.
+     */
+    const char *prefix;
+
+    /**
+     * @brief Liczba zgłoszonych przedziałów.
+     */
+    size_t count;
+
+    /**
+     * @brief Po ilu przedziałach przerwać przeglądanie (0 - nie przerywać).
+     */
+    size_t stopAfter;
+
+    /**
+     * @brief Zgłoszone przedziały.
+     */
+    struct ResolveRangeTestPiece pieces[RESOLVE_RANGE_TEST_PIECES];
+};
+
+/**
+ * @brief Sprawdza i zapamiętuje przedział.
+ * Używana w phfwdResolveRange.
+ * @param[in] prefix - podprefiks przedziału.
+ * @param[in] num1 - źródło przekierowania lub NULL.
+ * @param[in] num2 - cel przekierowania lub NULL.
+ * @param[in] result - prefiks, na który przechodzi podprefiks.
+ * @param[in, out] data - wskaźnik na ResolveRangeTest.
+ * @return Wartość @p false, jeśli należy przerwać przeglądanie.
+ */
+static bool resolveRangeTestPiece(const char *prefix, const char *num1,
+                                  const char *num2, const char *result,
+                                  void *data) {
+    struct ResolveRangeTest *test = data;
+    if (!testCheck(test->count < RESOLVE_RANGE_TEST_PIECES,
+                   "too many pieces for %s", test->prefix)) {
+        return false;
+    }
+    testCheck(testIsPrefix(test->prefix, prefix),
+              "piece %s outside %s", prefix, test->prefix);
+    testCheck(test->count != 0 || strcmp(prefix, test->prefix) == 0,
+              "first piece %s of %s", prefix, test->prefix);
+    testCheck(test->count == 0
+              || strcmp(test->pieces[test->count - 1].prefix, prefix) < 0,
+              "piece %s out of order", prefix);
+
+    char expected[TEST_MODEL_RESULT];
+    testModelGet(test->model, prefix, expected);
+    const struct TestModelRule *rule = testModelFind(test->model, prefix);
+    if (rule == NULL) {
+        testCheck(num1 == NULL && num2 == NULL,
+                  "piece %s has a rule but none matches", prefix);
+    } else {
+        testCheck(num1 != NULL && num2 != NULL
+                  && strcmp(num1, rule->source) == 0
+                  && strcmp(num2, rule->target) == 0,
+                  "piece %s: wrong rule, expected %s>%s", prefix,
+                  rule->source, rule->target);
+    }
+    testCheck(strcmp(result, expected) == 0, "piece %s: %s, expected %s",
+              prefix, result, expected);
+
+    struct ResolveRangeTestPiece *piece = &test->pieces[test->count++];
+    strcpy(piece->prefix, prefix);
+    strcpy(piece->result, result);
+    strcpy(piece->source, num1 == NULL ? "" : num1);
+    return test->count != test->stopAfter;
+}
+
+/**
+ * @brief Sprawdza przedziały zapytania.
+ * Przedziały muszą odpowiadać różnym przekierowaniom, a numer z prefiksem
+ * zapytania musi przechodzić według przedziału o najdłuższym podprefiksie.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] test - stan zapytania.
+ */
+static void resolveRangeTestCheck(struct PhoneForward *pf,
+                                  const struct ResolveRangeTest *test) {
+    size_t i, j;
+    for (i = 0; i < test->count; i++) {
+        for (j = 0; j < i; j++) {
+            testCheck(strcmp(test->pieces[i].source,
+                             test->pieces[j].source) != 0,
+                      "pieces %s and %s use the same rule",
+                      test->pieces[j].prefix, test->pieces[i].prefix);
+        }
+    }
+
+    for (i = 0; i < RESOLVE_RANGE_TEST_NUMBERS; i++) {
+        char num[2 * TEST_MODEL_NUMBER];
+        char suffix[TEST_MODEL_NUMBER];
+        strcpy(num, test->prefix);
+        testRandomNumber(suffix, 5, 3);
+        strncat(num, suffix, testRandom(strlen(suffix) + 1));
+
+        const struct ResolveRangeTestPiece *best = NULL;
+        for (j = 0; j < test->count; j++) {
+            const struct ResolveRangeTestPiece *piece = &test->pieces[j];
+            if (testIsPrefix(piece->prefix, num)
+                && (best == NULL
+                    || strlen(piece->prefix) > strlen(best->prefix))) {
+                best = piece;
+            }
+        }
+        if (!testCheck(best != NULL, "no piece for %s", num)) {
+            continue;
+        }
+        char expected[3 * TEST_MODEL_NUMBER];
+        strcpy(expected, best->result);
+        strcat(expected, num + strlen(best->prefix));
+        const struct PhoneNumbers *pnum = phfwdGet(pf, num);
+        const char *result = phnumGet(pnum, 0);
+        testCheck(result != NULL && strcmp(result, expected) == 0,
+                  "range of %s gives %s for %s, get gives %s", test->prefix,
+                  expected, num, result == NULL ? "NULL" : result);
+        phnumDelete(pnum);
+    }
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(92);
+    static struct TestModel model;
+    static struct ResolveRangeTest test;
+    size_t round;
+    for (round = 0; round < RESOLVE_RANGE_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        size_t i;
+        for (i = 0; i < RESOLVE_RANGE_TEST_RULES; i++) {
+            char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+            testRandomNumber(num1, 5, 3);
+            testRandomNumber(num2, 3, 3);
+            if (phfwdAdd(pf, num1, num2)) {
+                testModelAdd(&model, num1, num2, PHFWD_NO_EXPIRY);
+            }
+        }
+
+        for (i = 0; i < RESOLVE_RANGE_TEST_QUERIES; i++) {
+            char prefix[TEST_MODEL_NUMBER];
+            testRandomNumber(prefix, 3, 3);
+            test.model = &model;
+            test.prefix = prefix;
+            test.count = 0;
+            test.stopAfter = testRandom(5) == 0 ? 1 + testRandom(3) : 0;
+            bool finished = phfwdResolveRange(pf, prefix,
+                                              resolveRangeTestPiece, &test);
+            if (test.stopAfter != 0 && test.count == test.stopAfter) {
+                testCheck(!finished, "range of %s not stopped", prefix);
+            } else {
+                testCheck(finished, "phfwdResolveRange %s", prefix);
+                resolveRangeTestCheck(pf, &test);
+            }
+        }
+        testCheck(!phfwdResolveRange(pf, "1x", resolveRangeTestPiece, &test),
+                  "range of a string that is not a number");
+        phfwdDelete(pf);
+    }
+    return testResult("resolve_range");
+}
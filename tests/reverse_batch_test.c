@@ -0,0 +1,130 @@
+/** @file
+ * Test wyznaczania przekierowań na wiele numerów naraz.
+ * Każdy wynik @ref phfwdReverseBatch jest porównywany z modelem
+ * i z wynikiem @ref phfwdReverse dla tego samego numeru. Zapytania
+ * zawierają powtórzenia, numery o wspólnych prefiksach i napisy
+ * niebędące numerami.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define REVERSE_BATCH_TEST_ROUNDS 200
+
+/**
+ * @brief Największa liczba przekierowań w strukturze.
+ */
+#define REVERSE_BATCH_TEST_RULES 60
+
+/**
+ * @brief Największa liczba numerów w jednym zapytaniu.
+ */
+#define REVERSE_BATCH_TEST_QUERIES 40
+
+/**
+ * @brief Sprawdza, czy dwa wyniki są równe.
+ * @param[in] a - pierwszy wynik.
+ * @param[in] b - drugi wynik.
+ * @return Wartość @p true, jeśli wyniki zawierają te same numery.
+ */
+static bool reverseBatchTestEqual(const struct PhoneNumbers *a,
+                                  const struct PhoneNumbers *b) {
+    if (phnumSize(a) != phnumSize(b)) {
+        return false;
+    }
+    size_t i;
+    for (i = 0; i < phnumSize(a); i++) {
+        if (strcmp(phnumGet(a, i), phnumGet(b, i)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Losuje numery zapytania.
+ * @param[out] nums - bufory na numery.
+ * @param[in] count - liczba numerów.
+ */
+static void reverseBatchTestQueries(char nums[][TEST_MODEL_NUMBER],
+                                    size_t count) {
+    size_t i;
+    for (i = 0; i < count; i++) {
+        size_t kind = testRandom(10);
+        if (kind == 0 && i > 0) {
+            strcpy(nums[i], nums[testRandom(i)]);
+        } else if (kind == 1) {
+            testRandomNumber(nums[i], 3, 3);
+            nums[i][testRandom(strlen(nums[i]))] = 'x';
+        } else if (kind == 2) {
+            nums[i][0] = '\0';
+        } else {
+            testRandomNumber(nums[i], 8, kind == 3 ? 12 : 3);
+        }
+    }
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(83);
+    struct TestModel model;
+    char nums[REVERSE_BATCH_TEST_QUERIES][TEST_MODEL_NUMBER];
+    const char *queries[REVERSE_BATCH_TEST_QUERIES];
+    const struct PhoneNumbers *results[REVERSE_BATCH_TEST_QUERIES];
+    size_t i;
+    for (i = 0; i < REVERSE_BATCH_TEST_QUERIES; i++) {
+        queries[i] = nums[i];
+    }
+
+    size_t round;
+    for (round = 0; round < REVERSE_BATCH_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        size_t rules = testRandom(REVERSE_BATCH_TEST_RULES);
+        for (i = 0; i < rules; i++) {
+            char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+            testRandomNumber(num1, 5, 3);
+            testRandomNumber(num2, 4, 3);
+            if (phfwdAdd(pf, num1, num2)) {
+                testModelAdd(&model, num1, num2, PHFWD_NO_EXPIRY);
+            }
+            if (testRandom(8) == 0) {
+                testRandomNumber(num1, 2, 3);
+                phfwdRemove(pf, num1);
+                testModelRemove(&model, num1);
+            }
+        }
+
+        size_t count = testRandom(REVERSE_BATCH_TEST_QUERIES + 1);
+        reverseBatchTestQueries(nums, count);
+        if (!testCheck(phfwdReverseBatch(pf, queries, count, results),
+                       "phfwdReverseBatch")) {
+            phfwdDelete(pf);
+            continue;
+        }
+        for (i = 0; i < count; i++) {
+            const struct PhoneNumbers *single = phfwdReverse(pf, nums[i]);
+            testModelCheckReverse(results[i], &model, nums[i]);
+            testCheck(reverseBatchTestEqual(results[i], single),
+                      "batch and single reverse differ for %s", nums[i]);
+            phnumDelete(single);
+            phnumDelete(results[i]);
+        }
+        phfwdDelete(pf);
+    }
+    return testResult("reverse_batch");
+}
@@ -0,0 +1,172 @@
+/** @file
+ * Test wyznaczania przekierowań na numer z ograniczeniami.
+ * Wynik @ref phfwdReverseFiltered jest porównywany z wynikiem
+ * @ref phfwdReverse (sprawdzonym z modelem), z którego usunięto numery
+ * niespełniające losowych ograniczeń i zostawiono co najwyżej
+ * filter->limit pierwszych.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba struktur.
+ */
+#define REVERSE_FILTERED_TEST_ROUNDS 200
+
+/**
+ * @brief Liczba przekierowań w strukturze.
+ */
+#define REVERSE_FILTERED_TEST_RULES 40
+
+/**
+ * @brief Liczba zapytań dla jednej struktury.
+ */
+#define REVERSE_FILTERED_TEST_QUERIES 30
+
+/**
+ * @brief Rozmiar bufora na cyfry i prefiks ograniczenia.
+ */
+#define REVERSE_FILTERED_TEST_BUFFER 4
+
+/**
+ * @brief Sprawdza, czy numer spełnia ograniczenia.
+ * @param[in] num - numer.
+ * @param[in] filter - ograniczenia.
+ * @return Wartość @p true, jeśli numer spełnia wszystkie ograniczenia
+ *         (poza limitem liczby numerów).
+ */
+static bool reverseFilteredTestAccepts(const char *num,
+                                       const struct PhoneForwardReverseFilter *filter) {
+    size_t length = strlen(num);
+    return length >= filter->minLength
+           && (filter->maxLength == 0 || length <= filter->maxLength)
+           && (filter->digits == NULL
+               || strspn(num, filter->digits) == length)
+           && (filter->prefix == NULL || testIsPrefix(filter->prefix, num));
+}
+
+/**
+ * @brief Losuje ograniczenia.
+ * @param[out] filter - ograniczenia.
+ * @param[out] digits - bufor na dozwolone cyfry.
+ * @param[out] prefix - bufor na wymagany prefiks.
+ */
+static void reverseFilteredTestFilter(struct PhoneForwardReverseFilter *filter,
+                                      char *digits, char *prefix) {
+    filter->minLength = testRandom(2) == 0 ? 0 : testRandom(6);
+    filter->maxLength = testRandom(2) == 0 ? 0 : 1 + testRandom(8);
+    filter->digits = NULL;
+    filter->prefix = NULL;
+    filter->limit = testRandom(2) == 0 ? 0 : 1 + testRandom(5);
+    if (testRandom(2) == 0) {
+        size_t count = 0;
+        size_t d;
+        for (d = 0; d < 3; d++) {
+            if (testRandom(3) != 0) {
+                digits[count++] = (char) ('0' + d);
+            }
+        }
+        digits[count] = '\0';
+        filter->digits = digits;
+    }
+    if (testRandom(2) == 0) {
+        size_t length = testRandom(REVERSE_FILTERED_TEST_BUFFER - 1);
+        size_t i;
+        for (i = 0; i < length; i++) {
+            prefix[i] = (char) ('0' + testRandom(3));
+        }
+        prefix[length] = '\0';
+        filter->prefix = prefix;
+    }
+}
+
+/**
+ * @brief Porównuje wynik z ograniczeniami z wynikiem bez ograniczeń.
+ * @param[in] all - wynik @ref phfwdReverse.
+ * @param[in] filtered - wynik @ref phfwdReverseFiltered.
+ * @param[in] filter - ograniczenia lub NULL.
+ * @param[in] num - numer.
+ * @return Liczba numerów wyniku z ograniczeniami.
+ */
+static size_t reverseFilteredTestCompare(const struct PhoneNumbers *all,
+                                         const struct PhoneNumbers *filtered,
+                                         const struct PhoneForwardReverseFilter *filter,
+                                         const char *num) {
+    size_t count = 0;
+    size_t i;
+    for (i = 0; i < phnumSize(all); i++) {
+        const char *expected = phnumGet(all, i);
+        if (filter != NULL && !reverseFilteredTestAccepts(expected, filter)) {
+            continue;
+        }
+        if (filter != NULL && filter->limit != 0 && count == filter->limit) {
+            break;
+        }
+        const char *result = phnumGet(filtered, count);
+        testCheck(result != NULL && strcmp(result, expected) == 0,
+                  "filtered reverse %s [%zu]: %s, expected %s", num, count,
+                  result == NULL ? "NULL" : result, expected);
+        count++;
+    }
+    testCheck(phnumSize(filtered) == count,
+              "filtered reverse %s: %zu numbers, expected %zu", num,
+              phnumSize(filtered), count);
+    return count;
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(91);
+    struct TestModel model;
+    size_t total = 0;
+    size_t round;
+    for (round = 0; round < REVERSE_FILTERED_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        size_t i;
+        for (i = 0; i < REVERSE_FILTERED_TEST_RULES; i++) {
+            char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+            testRandomNumber(num1, 4, 3);
+            testRandomNumber(num2, 3, 3);
+            if (phfwdAdd(pf, num1, num2)) {
+                testModelAdd(&model, num1, num2, PHFWD_NO_EXPIRY);
+            }
+        }
+
+        for (i = 0; i < REVERSE_FILTERED_TEST_QUERIES; i++) {
+            char num[TEST_MODEL_NUMBER];
+            char digits[REVERSE_FILTERED_TEST_BUFFER];
+            char prefix[REVERSE_FILTERED_TEST_BUFFER];
+            struct PhoneForwardReverseFilter filter;
+            testRandomNumber(num, 7, 3);
+            reverseFilteredTestFilter(&filter, digits, prefix);
+            const struct PhoneForwardReverseFilter *used =
+                    testRandom(10) == 0 ? NULL : &filter;
+
+            const struct PhoneNumbers *all = phfwdReverse(pf, num);
+            const struct PhoneNumbers *filtered =
+                    phfwdReverseFiltered(pf, num, used);
+            if (testModelCheckReverse(all, &model, num)
+                && testCheck(filtered != NULL, "phfwdReverseFiltered")) {
+                total += reverseFilteredTestCompare(all, filtered, used, num);
+            }
+            phnumDelete(all);
+            phnumDelete(filtered);
+        }
+        phfwdDelete(pf);
+    }
+    testCheck(total != 0, "all filtered results empty");
+    return testResult("reverse_filtered");
+}
@@ -0,0 +1,93 @@
+/** @file
+ * Test wyznaczania porządku sufiksów napisu.
+ * Pozycje zwrócone przez @ref suffixRanks są porównywane z porównaniem
+ * sufiksów funkcją strcmp dla losowych napisów, także o długich
+ * powtórzeniach i ze znakami spoza ASCII.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "suffix_rank.h"
+#include "test_model.h"
+
+/**
+ * @brief Liczba napisów.
+ */
+#define SUFFIX_RANK_TEST_ROUNDS 2000
+
+/**
+ * @brief Największa długość napisu.
+ */
+#define SUFFIX_RANK_TEST_LENGTH 80
+
+/**
+ * @brief Losuje napis.
+ * @param[out] txt - bufor na SUFFIX_RANK_TEST_LENGTH + 1 znaków.
+ * @return Długość napisu.
+ */
+static size_t suffixRankTestText(char *txt) {
+    size_t length = testRandom(SUFFIX_RANK_TEST_LENGTH + 1);
+    size_t kind = testRandom(3);
+    size_t period = 1 + testRandom(4);
+    size_t i;
+    for (i = 0; i < length; i++) {
+        if (kind == 0) {
+            txt[i] = (char) (1 + testRandom(255));
+        } else if (kind == 1 && i >= period && testRandom(20) != 0) {
+            txt[i] = txt[i - period];
+        } else {
+            txt[i] = (char) ('0' + testRandom(2));
+        }
+    }
+    txt[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Porównuje dwie liczby jak strcmp.
+ * @param[in] a - pierwsza liczba.
+ * @param[in] b - druga liczba.
+ * @return -1, 0 lub 1.
+ */
+static int suffixRankTestSign(long long a, long long b) {
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(99);
+    char txt[SUFFIX_RANK_TEST_LENGTH + 1];
+    size_t round;
+    for (round = 0; round < SUFFIX_RANK_TEST_ROUNDS; round++) {
+        size_t length = suffixRankTestText(txt);
+        size_t allocations = 0;
+        size_t *ranks = suffixRanks(txt, length, &allocations);
+        if (!testCheck(ranks != NULL && allocations != 0, "suffixRanks")) {
+            free(ranks);
+            continue;
+        }
+        testCheck(ranks[length] == 0, "empty suffix of length %zu has %zu",
+                  length, ranks[length]);
+        size_t a, b;
+        for (a = 0; a <= length; a++) {
+            for (b = 0; b <= length; b++) {
+                int expected = strcmp(txt + a, txt + b);
+                testCheck(suffixRankTestSign((long long) ranks[a],
+                                             (long long) ranks[b])
+                          == suffixRankTestSign(expected, 0),
+                          "suffixes %zu and %zu of a string of length %zu",
+                          a, b, length);
+            }
+        }
+        free(ranks);
+    }
+    return testResult("suffix_rank");
+}
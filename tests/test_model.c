@@ -0,0 +1,304 @@
+/** @file
+ * Implementacja modelu przekierowań używanego w testach.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba błędów opisywanych na standardowym wyjściu błędów.
+ */
+#define TEST_REPORTED_FAILURES 10
+
+/**
+ * @brief Stan generatora liczb pseudolosowych.
+ */
+static unsigned long long testSeed = 1;
+
+/**
+ * @brief Liczba niespełnionych warunków.
+ */
+static size_t testFailures = 0;
+
+void testRandomSeed(unsigned long long seed) {
+    testSeed = seed;
+}
+
+size_t testRandom(size_t bound) {
+    testSeed = testSeed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (size_t) (testSeed >> 33) % bound;
+}
+
+void testRandomNumber(char *num, size_t maxLength, size_t digits) {
+    size_t length = 1 + testRandom(maxLength);
+    size_t i;
+    for (i = 0; i < length; i++) {
+        num[i] = (char) ('0' + testRandom(digits));
+    }
+    num[length] = '\0';
+}
+
+bool testCheck(bool condition, const char *format, ...) {
+    if (!condition) {
+        testFailures++;
+        if (testFailures <= TEST_REPORTED_FAILURES) {
+            va_list args;
+            va_start(args, format);
+            fprintf(stderr, "FAIL: ");
+            vfprintf(stderr, format, args);
+            fprintf(stderr, "\n");
+            va_end(args);
+        }
+    }
+    return condition;
+}
+
+int testResult(const char *name) {
+    if (testFailures != 0) {
+        fprintf(stderr, "%s: %zu failures\n", name, testFailures);
+        return 1;
+    }
+    return 0;
+}
+
+bool testIsPrefix(const char *prefix, const char *num) {
+    return strncmp(prefix, num, strlen(prefix)) == 0;
+}
+
+void testModelInit(struct TestModel *model) {
+    model->count = 0;
+    model->nextId = 1;
+}
+
+bool testModelAdd(struct TestModel *model, const char *num1, const char *num2,
+                  uint64_t expiresAt) {
+    size_t i;
+    for (i = 0; i < model->count; i++) {
+        if (strcmp(model->rules[i].source, num1) == 0) {
+            break;
+        }
+    }
+    if (i == TEST_MODEL_RULES) {
+        return false;
+    }
+    if (i == model->count) {
+        model->count++;
+    }
+    strcpy(model->rules[i].source, num1);
+    strcpy(model->rules[i].target, num2);
+    model->rules[i].expiresAt = expiresAt;
+    model->rules[i].id = model->nextId++;
+    return true;
+}
+
+/**
+ * @brief Usuwa z modelu przekierowania spełniające warunek.
+ * @param[in, out] model - model.
+ * @param[in] removed - warunek.
+ * @param[in] data - dane do warunku.
+ * @return Liczba usuniętych przekierowań.
+ */
+static size_t testModelFilter(struct TestModel *model,
+                              bool (*removed)(const struct TestModelRule *,
+                                              const void *),
+                              const void *data) {
+    size_t kept = 0;
+    size_t i;
+    for (i = 0; i < model->count; i++) {
+        if (!removed(&model->rules[i], data)) {
+            model->rules[kept++] = model->rules[i];
+        }
+    }
+    size_t result = model->count - kept;
+    model->count = kept;
+    return result;
+}
+
+/**
+ * @brief Sprawdza, czy przekierowanie ma dany prefiks.
+ * @param[in] rule - przekierowanie.
+ * @param[in] prefix - prefiks.
+ * @return Wartość @p true, jeśli @p prefix jest prefiksem źródła.
+ */
+static bool testModelHasPrefix(const struct TestModelRule *rule,
+                               const void *prefix) {
+    return testIsPrefix(prefix, rule->source);
+}
+
+/**
+ * @brief Sprawdza, czy przekierowanie wygasło.
+ * @param[in] rule - przekierowanie.
+ * @param[in] now - wskaźnik na bieżący czas.
+ * @return Wartość @p true, jeśli termin nie jest późniejszy niż @p now.
+ */
+static bool testModelExpired(const struct TestModelRule *rule,
+                             const void *now) {
+    return rule->expiresAt != PHFWD_NO_EXPIRY
+           && rule->expiresAt <= *(const uint64_t *) now;
+}
+
+void testModelRemove(struct TestModel *model, const char *prefix) {
+    testModelFilter(model, testModelHasPrefix, prefix);
+}
+
+size_t testModelExpire(struct TestModel *model, uint64_t now) {
+    return testModelFilter(model, testModelExpired, &now);
+}
+
+const struct TestModelRule *testModelFind(const struct TestModel *model,
+                                          const char *num) {
+    const struct TestModelRule *result = NULL;
+    size_t length = 0;
+    size_t i;
+    for (i = 0; i < model->count; i++) {
+        const struct TestModelRule *rule = &model->rules[i];
+        if (testIsPrefix(rule->source, num) && strlen(rule->source) > length) {
+            result = rule;
+            length = strlen(rule->source);
+        }
+    }
+    return result;
+}
+
+void testModelGet(const struct TestModel *model, const char *num,
+                  char *result) {
+    const struct TestModelRule *rule = testModelFind(model, num);
+    if (rule == NULL) {
+        strcpy(result, num);
+    } else {
+        strcpy(result, rule->target);
+        strcat(result, num + strlen(rule->source));
+    }
+}
+
+bool testModelCheckGet(struct PhoneForward *pf, const struct TestModel *model,
+                       const char *num) {
+    char expected[TEST_MODEL_RESULT];
+    testModelGet(model, num, expected);
+    const struct PhoneNumbers *pnum = phfwdGet(pf, num);
+    const char *result = phnumGet(pnum, 0);
+    bool correct = testCheck(result != NULL && strcmp(result, expected) == 0,
+                             "get %s: %s, expected %s", num,
+                             result == NULL ? "NULL" : result, expected);
+    phnumDelete(pnum);
+    return correct;
+}
+
+/**
+ * @brief Porównuje napisy w tablicy.
+ * Używana w qsort.
+ * @param[in] a - wskaźnik na pierwszy napis.
+ * @param[in] b - wskaźnik na drugi napis.
+ * @return Wynik strcmp.
+ */
+static int testCompareResults(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+/**
+ * @brief Sprawdza, czy napis reprezentuje numer.
+ * @param[in] num - napis.
+ * @return Wartość @p true, jeśli napis jest niepusty i składa się z cyfr
+ *         (także : i ;).
+ */
+static bool testIsNumber(const char *num) {
+    return *num != '\0' && strspn(num, "0123456789:;") == strlen(num);
+}
+
+bool testModelCheckReverse(const struct PhoneNumbers *pnum,
+                           const struct TestModel *model, const char *num) {
+    static char expected[TEST_MODEL_RULES + 1][TEST_MODEL_RESULT];
+    size_t count = 0;
+    if (testIsNumber(num)) {
+        strcpy(expected[count++], num);
+        size_t i;
+        for (i = 0; i < model->count; i++) {
+            const struct TestModelRule *rule = &model->rules[i];
+            if (testIsPrefix(rule->target, num)) {
+                strcpy(expected[count], rule->source);
+                strcat(expected[count++], num + strlen(rule->target));
+            }
+        }
+        qsort(expected, count, TEST_MODEL_RESULT, testCompareResults);
+        size_t unique = 1;
+        for (i = 1; i < count; i++) {
+            if (strcmp(expected[i], expected[unique - 1]) != 0) {
+                memmove(expected[unique++], expected[i], TEST_MODEL_RESULT);
+            }
+        }
+        count = unique;
+    }
+
+    if (!testCheck(pnum != NULL && phnumSize(pnum) == count,
+                   "reverse %s: %zu numbers, expected %zu", num,
+                   phnumSize(pnum), count)) {
+        return false;
+    }
+    size_t i;
+    for (i = 0; i < count; i++) {
+        const char *result = phnumGet(pnum, i);
+        if (!testCheck(result != NULL && strcmp(result, expected[i]) == 0,
+                       "reverse %s [%zu]: %s, expected %s", num, i,
+                       result == NULL ? "NULL" : result, expected[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Stan porównywania przekierowań z modelem.
+ */
+struct TestModelRulesCheck {
+    /**
+     * @brief Model.
+     */
+    const struct TestModel *model;
+
+    /**
+     * @brief Liczba przejrzanych przekierowań.
+     */
+    size_t count;
+
+    /**
+     * @brief Czy wszystkie przejrzane przekierowania są w modelu.
+     */
+    bool correct;
+};
+
+/**
+ * @brief Sprawdza, czy przekierowanie jest w modelu.
+ * Używana w phfwdForEach.
+ * @param[in] num1 - prefiks numerów przekierowywanych.
+ * @param[in] num2 - prefiks, na który jest przekierowanie.
+ * @param[in, out] data - wskaźnik na TestModelRulesCheck.
+ * @return Wartość @p true.
+ */
+static bool testModelCheckRule(const char *num1, const char *num2,
+                               void *data) {
+    struct TestModelRulesCheck *check = data;
+    const struct TestModelRule *rule = testModelFind(check->model, num1);
+    check->correct = testCheck(rule != NULL && strcmp(rule->source, num1) == 0
+                               && strcmp(rule->target, num2) == 0,
+                               "unexpected rule %s>%s", num1, num2)
+                     && check->correct;
+    check->count++;
+    return true;
+}
+
+bool testModelCheckRules(struct PhoneForward *pf,
+                         const struct TestModel *model) {
+    struct TestModelRulesCheck check = {model, 0, true};
+    bool visited = phfwdForEach(pf, testModelCheckRule, &check);
+    return testCheck(visited && check.count == model->count,
+                     "%zu rules, expected %zu", check.count, model->count)
+           && check.correct;
+}
@@ -0,0 +1,210 @@
+/** @file
+ * Interfejs modelu przekierowań używanego w testach.
+ * Model przechowuje przekierowania w tablicy i wyznacza wyniki
+ * przeglądając wszystkie przekierowania, więc jego poprawność wynika
+ * wprost z definicji operacji. Testy porównują z nim wyniki struktury
+ * PhoneForward dla losowych ciągów operacji.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#ifndef TELEFONY_TEST_MODEL_H
+#define TELEFONY_TEST_MODEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "phone_forward.h"
+
+/**
+ * @brief Największa liczba przekierowań w modelu.
+ */
+#define TEST_MODEL_RULES 512
+
+/**
+ * @brief Rozmiar bufora na numer przekierowania w modelu.
+ */
+#define TEST_MODEL_NUMBER 32
+
+/**
+ * @brief Rozmiar bufora na wynik przekierowania numeru.
+ */
+#define TEST_MODEL_RESULT (2 * TEST_MODEL_NUMBER)
+
+/**
+ * @brief Przekierowanie przechowywane w modelu.
+ */
+struct TestModelRule {
+    /**
+     * @brief Prefiks numerów przekierowywanych.
+     */
+    char source[TEST_MODEL_NUMBER];
+
+    /**
+     * @brief Prefiks, na który jest przekierowanie.
+     */
+    char target[TEST_MODEL_NUMBER];
+
+    /**
+     * @brief Termin wygaśnięcia lub PHFWD_NO_EXPIRY.
+     */
+    uint64_t expiresAt;
+
+    /**
+     * @brief Identyfikator różny dla każdego dodanego przekierowania
+     * (także zastępującego inne).
+     */
+    size_t id;
+};
+
+/**
+ * @brief Model przekierowań.
+ */
+struct TestModel {
+    /**
+     * @brief Liczba przekierowań.
+     */
+    size_t count;
+
+    /**
+     * @brief Identyfikator następnego dodanego przekierowania.
+     */
+    size_t nextId;
+
+    /**
+     * @brief Przekierowania w kolejności dodania.
+     */
+    struct TestModelRule rules[TEST_MODEL_RULES];
+};
+
+/**
+ * @brief Ustawia ziarno generatora liczb pseudolosowych.
+ * @param[in] seed - ziarno.
+ */
+void testRandomSeed(unsigned long long seed);
+
+/**
+ * @brief Losuje liczbę.
+ * @param[in] bound - liczba większa od 0.
+ * @return Liczba od 0 do @p bound - 1.
+ */
+size_t testRandom(size_t bound);
+
+/**
+ * @brief Losuje numer.
+ * @param[out] num - bufor na co najmniej @p maxLength + 1 znaków.
+ * @param[in] maxLength - największa długość numeru (co najmniej 1).
+ * @param[in] digits - liczba używanych cyfr, od '0' do '0' + @p digits - 1.
+ */
+void testRandomNumber(char *num, size_t maxLength, size_t digits);
+
+/**
+ * @brief Sprawdza warunek testu.
+ * Niespełniony warunek jest liczony jako błąd, a pierwsze błędy są
+ * opisywane na standardowym wyjściu błędów.
+ * @param[in] condition - sprawdzany warunek.
+ * @param[in] format - format opisu błędu jak w printf.
+ * @return Wartość @p condition.
+ */
+bool testCheck(bool condition, const char *format, ...);
+
+/**
+ * @brief Kończy test.
+ * @param[in] name - nazwa testu.
+ * @return 0, jeśli wszystkie warunki były spełnione, 1 w przeciwnym
+ *         przypadku.
+ */
+int testResult(const char *name);
+
+/**
+ * @brief Sprawdza, czy napis jest prefiksem numeru.
+ * @param[in] prefix - prefiks.
+ * @param[in] num - numer.
+ * @return Wartość @p true, jeśli @p prefix jest prefiksem @p num.
+ */
+bool testIsPrefix(const char *prefix, const char *num);
+
+/**
+ * @brief Tworzy pusty model.
+ * @param[out] model - model.
+ */
+void testModelInit(struct TestModel *model);
+
+/**
+ * @brief Dodaje przekierowanie do modelu jak @ref phfwdAddExpiring.
+ * @param[in, out] model - model.
+ * @param[in] num1 - prefiks numerów przekierowywanych.
+ * @param[in] num2 - prefiks, na który jest przekierowanie.
+ * @param[in] expiresAt - termin wygaśnięcia lub PHFWD_NO_EXPIRY.
+ * @return Wartość @p false, jeśli model jest pełny.
+ */
+bool testModelAdd(struct TestModel *model, const char *num1, const char *num2,
+                  uint64_t expiresAt);
+
+/**
+ * @brief Usuwa przekierowania z modelu jak @ref phfwdRemove.
+ * @param[in, out] model - model.
+ * @param[in] prefix - prefiks numerów.
+ */
+void testModelRemove(struct TestModel *model, const char *prefix);
+
+/**
+ * @brief Usuwa wygasłe przekierowania jak @ref phfwdAdvanceClock.
+ * @param[in, out] model - model.
+ * @param[in] now - bieżący czas.
+ * @return Liczba usuniętych przekierowań.
+ */
+size_t testModelExpire(struct TestModel *model, uint64_t now);
+
+/**
+ * @brief Wyszukuje przekierowanie wyznaczające wynik dla numeru.
+ * @param[in] model - model.
+ * @param[in] num - numer.
+ * @return Przekierowanie o najdłuższym prefiksie @p num lub NULL.
+ */
+const struct TestModelRule *testModelFind(const struct TestModel *model,
+                                          const char *num);
+
+/**
+ * @brief Wyznacza przekierowanie numeru jak @ref phfwdGet.
+ * @param[in] model - model.
+ * @param[in] num - numer.
+ * @param[out] result - bufor na TEST_MODEL_RESULT znaków.
+ */
+void testModelGet(const struct TestModel *model, const char *num,
+                  char *result);
+
+/**
+ * @brief Porównuje wynik @ref phfwdGet z modelem.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] model - model.
+ * @param[in] num - numer.
+ * @return Wartość @p true, jeśli wyniki są równe.
+ */
+bool testModelCheckGet(struct PhoneForward *pf, const struct TestModel *model,
+                       const char *num);
+
+/**
+ * @brief Porównuje wynik @ref phfwdReverse z modelem.
+ * @param[in] pnum - sprawdzany wynik.
+ * @param[in] model - model.
+ * @param[in] num - numer lub napis niebędący numerem.
+ * @return Wartość @p true, jeśli wyniki są równe.
+ */
+bool testModelCheckReverse(const struct PhoneNumbers *pnum,
+                           const struct TestModel *model, const char *num);
+
+/**
+ * @brief Porównuje przekierowania przeglądane przez @ref phfwdForEach
+ * z modelem.
+ * @param[in] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in] model - model.
+ * @return Wartość @p true, jeśli zbiory przekierowań są równe.
+ */
+bool testModelCheckRules(struct PhoneForward *pf,
+                         const struct TestModel *model);
+
+#endif /* TELEFONY_TEST_MODEL_H */
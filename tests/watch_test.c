@@ -0,0 +1,179 @@
+/** @file
+ * Test obserwatorów numerów.
+ * Po każdej losowej operacji obserwator musi zostać powiadomiony dokładnie
+ * raz, jeżeli według modelu wynik dla jego numeru wyznacza teraz inne
+ * przekierowanie, a w przeciwnym przypadku ani razu. Operacje obejmują
+ * zastępowanie, usuwanie i wygasanie przekierowań oraz dodawanie
+ * i usuwanie obserwatorów.
+ *
+ * @author Konrad Staniszewski
+ * @copyright Konrad Staniszewski
+ * @date 18.10.2026
+ */
+
+#include <string.h>
+
+#include "test_model.h"
+
+/**
+ * @brief Liczba obserwatorów.
+ */
+#define WATCH_TEST_WATCHERS 25
+
+/**
+ * @brief Liczba struktur.
+ */
+#define WATCH_TEST_ROUNDS 40
+
+/**
+ * @brief Liczba operacji na jednej strukturze.
+ */
+#define WATCH_TEST_OPERATIONS 300
+
+/**
+ * @brief Obserwator w teście.
+ */
+struct WatchTest {
+    /**
+     * @brief Obserwowany numer.
+     */
+    char num[TEST_MODEL_NUMBER];
+
+    /**
+     * @brief Obserwator lub NULL, gdy nie jest dodany.
+     */
+    struct PhoneForwardWatch *watch;
+
+    /**
+     * @brief Identyfikator przekierowania wyznaczającego wynik (0 - brak).
+     */
+    size_t ruleId;
+
+    /**
+     * @brief Liczba powiadomień od ostatniej operacji.
+     */
+    size_t notified;
+};
+
+/**
+ * @brief Obserwatorzy w teście.
+ */
+static struct WatchTest watchTests[WATCH_TEST_WATCHERS];
+
+/**
+ * @brief Wyznacza identyfikator przekierowania wyznaczającego wynik.
+ * @param[in] model - model.
+ * @param[in] num - numer.
+ * @return Identyfikator przekierowania lub 0.
+ */
+static size_t watchTestRuleId(const struct TestModel *model, const char *num) {
+    const struct TestModelRule *rule = testModelFind(model, num);
+    return rule == NULL ? 0 : rule->id;
+}
+
+/**
+ * @brief Zapamiętuje powiadomienie.
+ * Używana w phfwdWatch.
+ * @param[in] num - obserwowany numer.
+ * @param[in, out] data - wskaźnik na WatchTest.
+ */
+static void watchTestNotify(const char *num, void *data) {
+    struct WatchTest *test = data;
+    testCheck(strcmp(num, test->num) == 0, "notified %s for %s", num,
+              test->num);
+    testCheck(test->watch != NULL, "notified removed watcher %s", num);
+    test->notified++;
+}
+
+/**
+ * @brief Wykonuje losową operację na strukturze i modelu.
+ * @param[in, out] pf - wskaźnik na strukturę przechowującą przekierowania.
+ * @param[in, out] model - model.
+ * @param[in, out] now - czas logiczny.
+ */
+static void watchTestOperation(struct PhoneForward *pf, struct TestModel *model,
+                               uint64_t *now) {
+    char num1[TEST_MODEL_NUMBER], num2[TEST_MODEL_NUMBER];
+    struct WatchTest *test = &watchTests[testRandom(WATCH_TEST_WATCHERS)];
+    size_t kind = testRandom(12);
+    if (kind < 4) {
+        testRandomNumber(num1, 3, 3);
+        testRandomNumber(num2, 3, 3);
+        uint64_t expiresAt = testRandom(2) == 0 ? PHFWD_NO_EXPIRY
+                                                : *now + 1 + testRandom(50);
+        if (phfwdAddExpiring(pf, num1, num2, expiresAt)) {
+            testModelAdd(model, num1, num2, expiresAt);
+        }
+    } else if (kind < 6) {
+        testRandomNumber(num1, 3, 3);
+        phfwdRemove(pf, num1);
+        testModelRemove(model, num1);
+    } else if (kind < 8) {
+        uint64_t next = *now + testRandom(20);
+        phfwdAdvanceClock(pf, next);
+        if (next > *now) {
+            testModelExpire(model, next);
+            *now = next;
+        }
+    } else if (kind < 10) {
+        if (test->watch == NULL) {
+            testRandomNumber(test->num, 5, 3);
+            test->watch = phfwdWatch(pf, test->num, watchTestNotify, test);
+            testCheck(test->watch != NULL, "watch %s", test->num);
+            test->ruleId = watchTestRuleId(model, test->num);
+        }
+    } else if (test->watch != NULL) {
+        phfwdUnwatch(pf, test->watch);
+        test->watch = NULL;
+    }
+}
+
+/**
+ * @brief Uruchamia test.
+ * @return 0 w przypadku sukcesu, 1 w przeciwnym przypadku.
+ */
+int main() {
+    testRandomSeed(90);
+    struct TestModel model;
+    size_t total = 0;
+    size_t round;
+    for (round = 0; round < WATCH_TEST_ROUNDS; round++) {
+        struct PhoneForward *pf = phfwdNew();
+        if (!testCheck(pf != NULL, "phfwdNew")) {
+            break;
+        }
+        testModelInit(&model);
+        uint64_t now = 0;
+        size_t i;
+        for (i = 0; i < WATCH_TEST_WATCHERS; i++) {
+            watchTests[i].watch = NULL;
+        }
+
+        size_t operation;
+        for (operation = 0; operation < WATCH_TEST_OPERATIONS; operation++) {
+            for (i = 0; i < WATCH_TEST_WATCHERS; i++) {
+                watchTests[i].notified = 0;
+            }
+            watchTestOperation(pf, &model, &now);
+            for (i = 0; i < WATCH_TEST_WATCHERS; i++) {
+                struct WatchTest *test = &watchTests[i];
+                if (test->watch == NULL) {
+                    continue;
+                }
+                size_t ruleId = watchTestRuleId(&model, test->num);
+                size_t expected = ruleId != test->ruleId ? 1 : 0;
+                testCheck(test->notified == expected,
+                          "watcher %s notified %zu times, expected %zu",
+                          test->num, test->notified, expected);
+                test->ruleId = ruleId;
+                total += test->notified;
+            }
+        }
+        for (i = 0; i < WATCH_TEST_WATCHERS; i += 2) {
+            phfwdUnwatch(pf, watchTests[i].watch);
+        }
+        phfwdDelete(pf);
+    }
+    testCheck(total != 0, "no notifications");
+    return testResult("watch");
+}